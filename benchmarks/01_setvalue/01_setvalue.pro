@@ -0,0 +1,20 @@
+QT += core
+QT -= gui
+
+CONFIG += c++11
+
+TARGET = 01_setvalue
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/
+INCLUDEPATH += $$PWD/../common/
+
+SOURCES += main.cpp
+
+HEADERS += $$PWD/../common/quabenchmark.h
+
+include($$PWD/../../src/wrapper/quaserver.pri)
+include($$PWD/../../src/helper/add_qt_path_win.pri)
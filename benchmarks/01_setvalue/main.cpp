@@ -0,0 +1,89 @@
+#include <QCoreApplication>
+
+#include <QUaServer>
+
+#include "quabenchmark.h"
+
+// compares the generic QVariant setValue/value path against
+// the typed setValue<T>/value<T> path which writes directly to a UA_Variant
+
+static const int defaultIterations = 100000;
+
+template<typename T>
+static void benchWrite(
+	QUaBenchmark& bench,
+	QUaBaseDataVariable* var,
+	const QString& name,
+	const QVector<T>& values,
+	const int& iterations)
+{
+	// generic path
+	var->setValue(QVariant::fromValue(values.first()));
+	bench.run(name + "/setValue/qvariant", iterations, [var, &values](int i) {
+		var->setValue(QVariant::fromValue(values.at(i % values.size())));
+	});
+	// typed path
+	bench.run(name + "/setValue/typed", iterations, [var, &values](int i) {
+		var->setValue<T>(values.at(i % values.size()));
+	});
+	// generic read (without QVariant to T conversion)
+	bench.run(name + "/value/qvariant", iterations, [var](int) {
+		QVariant val = var->value();
+		Q_UNUSED(val);
+	});
+	// typed read
+	bench.run(name + "/value/typed", iterations, [var](int) {
+		T val = var->value<T>();
+		Q_UNUSED(val);
+	});
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	int iterations = defaultIterations;
+	if (a.arguments().count() > 1)
+	{
+		bool ok = false;
+		int arg = a.arguments().at(1).toInt(&ok);
+		iterations = ok && arg > 0 ? arg : iterations;
+	}
+
+	QUaServer server;
+	QUaFolderObject* objsFolder = server.objectsFolder();
+	QUaBenchmark bench("01_setvalue");
+
+	// double scalar
+	QVector<double> doubles;
+	for (int i = 0; i < 64; i++)
+	{
+		doubles << i * 0.5;
+	}
+	benchWrite<double>(bench, objsFolder->addBaseDataVariable("double"), "double", doubles, iterations);
+
+	// int32 scalar
+	QVector<qint32> ints;
+	for (int i = 0; i < 64; i++)
+	{
+		ints << i;
+	}
+	benchWrite<qint32>(bench, objsFolder->addBaseDataVariable("int32"), "int32", ints, iterations);
+
+	// float array
+	QVector<QVector<float>> arrays;
+	for (int i = 0; i < 4; i++)
+	{
+		QVector<float> arr;
+		for (int j = 0; j < 256; j++)
+		{
+			arr << static_cast<float>(i * j);
+		}
+		arrays << arr;
+	}
+	benchWrite<QVector<float>>(bench, objsFolder->addBaseDataVariable("float_array"), "QVector<float>[256]", arrays, qMax(1, iterations / 10));
+
+	bench.write();
+
+	return 0;
+}
@@ -0,0 +1,58 @@
+QT += core xml sql
+QT -= gui
+
+CONFIG += c++11
+
+TARGET = 02_hotpaths
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/
+INCLUDEPATH += $$PWD/../common/
+INCLUDEPATH += $$PWD/../../examples/09_serialization/
+INCLUDEPATH += $$PWD/../../examples/10_historizing/
+INCLUDEPATH += $$PWD/../../examples/08_events/
+
+SOURCES += \
+main.cpp \
+benchtypes.cpp \
+$$PWD/../../examples/09_serialization/quaxmlserializer.cpp \
+$$PWD/../../examples/09_serialization/quasqliteserializer.cpp
+
+HEADERS += \
+benchtypes.h \
+$$PWD/../common/quabenchmark.h \
+$$PWD/../../examples/09_serialization/quaxmlserializer.h \
+$$PWD/../../examples/09_serialization/quasqliteserializer.h
+
+ua_historizing {
+	SOURCES += \
+	$$PWD/../../examples/10_historizing/quainmemoryhistorizer.cpp \
+	$$PWD/../../examples/10_historizing/quacompressedhistorizer.cpp \
+	$$PWD/../../examples/10_historizing/quaringhistorizer.cpp \
+	$$PWD/../../examples/10_historizing/quamappedhistorizer.cpp \
+	$$PWD/../../examples/10_historizing/quatieredhistorizer.cpp \
+	$$PWD/../../examples/10_historizing/quasqlitehistorizer.cpp \
+	$$PWD/../../examples/10_historizing/quamultisqlitehistorizer.cpp
+	HEADERS += \
+	$$PWD/../../examples/10_historizing/quainmemoryhistorizer.h \
+	$$PWD/../../examples/10_historizing/quacompressedhistorizer.h \
+	$$PWD/../../examples/10_historizing/quaringhistorizer.h \
+	$$PWD/../../examples/10_historizing/quamappedhistorizer.h \
+	$$PWD/../../examples/10_historizing/quanumericbits.h \
+	$$PWD/../../examples/10_historizing/quatieredhistorizer.h \
+	$$PWD/../../examples/10_historizing/quasqlitehistorizer.h \
+	$$PWD/../../examples/10_historizing/quamultisqlitehistorizer.h
+}
+
+ua_events || ua_alarms_conditions {
+	SOURCES += \
+	$$PWD/../../examples/08_events/myevent.cpp
+	HEADERS += \
+	$$PWD/../../examples/08_events/myevent.h
+}
+
+include($$PWD/../../src/wrapper/quaserver.pri)
+include($$PWD/../../src/helper/add_qt_path_win.pri)
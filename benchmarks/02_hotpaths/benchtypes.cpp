@@ -0,0 +1,87 @@
+#include "benchtypes.h"
+
+BenchFlatType::BenchFlatType(QUaServer *server)
+	: QUaBaseObject(server)
+{
+	units()->setValue("C");
+	value1()->setValue(0.0);
+	value2()->setValue(0.0);
+	value3()->setValue(0.0);
+}
+
+QUaProperty * BenchFlatType::units()
+{
+	return this->browseChild<QUaProperty>("units");
+}
+
+QUaBaseDataVariable * BenchFlatType::value1()
+{
+	return this->browseChild<QUaBaseDataVariable>("value1");
+}
+
+QUaBaseDataVariable * BenchFlatType::value2()
+{
+	return this->browseChild<QUaBaseDataVariable>("value2");
+}
+
+QUaBaseDataVariable * BenchFlatType::value3()
+{
+	return this->browseChild<QUaBaseDataVariable>("value3");
+}
+
+BenchLeafType::BenchLeafType(QUaServer *server)
+	: QUaBaseObject(server)
+{
+	units()->setValue("C");
+	value()->setValue(0.0);
+}
+
+QUaProperty * BenchLeafType::units()
+{
+	return this->browseChild<QUaProperty>("units");
+}
+
+QUaBaseDataVariable * BenchLeafType::value()
+{
+	return this->browseChild<QUaBaseDataVariable>("value");
+}
+
+BenchMidType::BenchMidType(QUaServer *server)
+	: QUaBaseObject(server)
+{
+}
+
+BenchLeafType * BenchMidType::leaf1()
+{
+	return this->browseChild<BenchLeafType>("leaf1");
+}
+
+BenchLeafType * BenchMidType::leaf2()
+{
+	return this->browseChild<BenchLeafType>("leaf2");
+}
+
+BenchLeafType * BenchMidType::leaf3()
+{
+	return this->browseChild<BenchLeafType>("leaf3");
+}
+
+BenchDeepType::BenchDeepType(QUaServer *server)
+	: QUaBaseObject(server)
+{
+}
+
+BenchMidType * BenchDeepType::mid1()
+{
+	return this->browseChild<BenchMidType>("mid1");
+}
+
+BenchMidType * BenchDeepType::mid2()
+{
+	return this->browseChild<BenchMidType>("mid2");
+}
+
+BenchMidType * BenchDeepType::mid3()
+{
+	return this->browseChild<BenchMidType>("mid3");
+}
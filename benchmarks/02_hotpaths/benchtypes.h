@@ -0,0 +1,66 @@
+#ifndef BENCHTYPES_H
+#define BENCHTYPES_H
+
+#include <QUaBaseObject>
+#include <QUaBaseDataVariable>
+#include <QUaProperty>
+
+// flat type : a single level of variables
+class BenchFlatType : public QUaBaseObject
+{
+	Q_OBJECT
+	Q_PROPERTY(QUaProperty         * units  READ units )
+	Q_PROPERTY(QUaBaseDataVariable * value1 READ value1)
+	Q_PROPERTY(QUaBaseDataVariable * value2 READ value2)
+	Q_PROPERTY(QUaBaseDataVariable * value3 READ value3)
+public:
+	Q_INVOKABLE explicit BenchFlatType(QUaServer *server);
+
+	QUaProperty         * units ();
+	QUaBaseDataVariable * value1();
+	QUaBaseDataVariable * value2();
+	QUaBaseDataVariable * value3();
+};
+
+// deep type : 3 x 3 nested objects with variables
+class BenchLeafType : public QUaBaseObject
+{
+	Q_OBJECT
+	Q_PROPERTY(QUaProperty         * units READ units)
+	Q_PROPERTY(QUaBaseDataVariable * value READ value)
+public:
+	Q_INVOKABLE explicit BenchLeafType(QUaServer *server);
+
+	QUaProperty         * units();
+	QUaBaseDataVariable * value();
+};
+
+class BenchMidType : public QUaBaseObject
+{
+	Q_OBJECT
+	Q_PROPERTY(BenchLeafType * leaf1 READ leaf1)
+	Q_PROPERTY(BenchLeafType * leaf2 READ leaf2)
+	Q_PROPERTY(BenchLeafType * leaf3 READ leaf3)
+public:
+	Q_INVOKABLE explicit BenchMidType(QUaServer *server);
+
+	BenchLeafType * leaf1();
+	BenchLeafType * leaf2();
+	BenchLeafType * leaf3();
+};
+
+class BenchDeepType : public QUaBaseObject
+{
+	Q_OBJECT
+	Q_PROPERTY(BenchMidType * mid1 READ mid1)
+	Q_PROPERTY(BenchMidType * mid2 READ mid2)
+	Q_PROPERTY(BenchMidType * mid3 READ mid3)
+public:
+	Q_INVOKABLE explicit BenchDeepType(QUaServer *server);
+
+	BenchMidType * mid1();
+	BenchMidType * mid2();
+	BenchMidType * mid3();
+};
+
+#endif // BENCHTYPES_H
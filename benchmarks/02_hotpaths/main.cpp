@@ -0,0 +1,1187 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QtMath>
+#include <QThread>
+#include <QDebug>
+
+#include <algorithm>
+
+#include <QUaServer>
+#include <QUaVirtualFolder>
+
+#include "quabenchmark.h"
+#include "benchtypes.h"
+
+#include "quaxmlserializer.h"
+#include "quasqliteserializer.h"
+
+#ifdef UA_ENABLE_HISTORIZING
+#include "quainmemoryhistorizer.h"
+#include "quacompressedhistorizer.h"
+#include "quaringhistorizer.h"
+#include "quamappedhistorizer.h"
+#include "quasqlitehistorizer.h"
+#include "quamultisqlitehistorizer.h"
+#include "quatieredhistorizer.h"
+#endif // UA_ENABLE_HISTORIZING
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+#include "myevent.h"
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+// benchmarks the wrapper's hot paths, runs headless and prints the results as json
+
+static void printLog(QQueue<QUaLog>& logOut)
+{
+	while (!logOut.isEmpty())
+	{
+		auto log = logOut.dequeue();
+		qWarning() << "[" << log.level << "] :" << log.message;
+	}
+}
+
+static void benchCreateInstances(QUaBenchmark& bench, QUaServer& server, const int& iterations)
+{
+	QUaFolderObject* objsFolder = server.objectsFolder();
+	auto flatFolder = objsFolder->addFolderObject("Flat");
+	bench.run("createInstance/flat", iterations, [flatFolder](int i) {
+		flatFolder->addChild<BenchFlatType>(
+			QString("flat%1").arg(i),
+			QUaNodeId(1, QString("flat%1").arg(i))
+		);
+	});
+	// same population created in a single batch
+	auto batchFolder = objsFolder->addFolderObject("Batch");
+	QList<QUaQualifiedName> browseNames;
+	QList<QUaNodeId> nodeIds;
+	for (int i = 0; i < iterations; i++)
+	{
+		browseNames << QString("batch%1").arg(i);
+		nodeIds     << QUaNodeId(1, QString("batch%1").arg(i));
+	}
+	QElapsedTimer timer;
+	timer.start();
+	server.createInstances<BenchFlatType>(batchFolder, browseNames, nodeIds);
+	bench.addResult("createInstances/flat", iterations, timer.nsecsElapsed());
+	auto deepFolder = objsFolder->addFolderObject("Deep");
+	int deepIterations = qMax(1, iterations / 10);
+	bench.run("createInstance/deep", deepIterations, [deepFolder](int i) {
+		deepFolder->addChild<BenchDeepType>(
+			QString("deep%1").arg(i),
+			QUaNodeId(1, QString("deep%1").arg(i))
+		);
+	});
+}
+
+// large population of flat instances created one by one and in a single batch, each in
+// its own server so both start from the same address space
+static void benchCreateInstancesLarge(QUaBenchmark& bench, const int& instances)
+{
+	QList<QUaQualifiedName> browseNames;
+	browseNames.reserve(instances);
+	for (int i = 0; i < instances; i++)
+	{
+		browseNames << QString("inst%1").arg(i);
+	}
+	QJsonObject extra({ { "instances", instances } });
+	{
+		QUaServer server;
+		server.registerType<BenchFlatType>();
+		auto folder = server.objectsFolder()->addFolderObject("Single");
+		bench.run("createInstance/flat/large", instances, [&server, folder, &browseNames](int i) {
+			server.createInstance<BenchFlatType>(folder, browseNames.at(i));
+		}, extra);
+	}
+	{
+		QUaServer server;
+		server.registerType<BenchFlatType>();
+		auto folder = server.objectsFolder()->addFolderObject("Batch");
+		QElapsedTimer timer;
+		timer.start();
+		server.createInstances<BenchFlatType>(folder, browseNames);
+		bench.addResult("createInstances/flat/large", instances, timer.nsecsElapsed(), extra);
+	}
+}
+
+static void benchSetValue(QUaBenchmark& bench, QUaServer& server, const int& iterations)
+{
+	QUaFolderObject* objsFolder = server.objectsFolder();
+	auto varScalar = objsFolder->addBaseDataVariable("scalar");
+	varScalar->setValue(0.0);
+	bench.run("setValue/scalar", iterations, [varScalar](int i) {
+		varScalar->setValue(static_cast<double>(i));
+	});
+	auto varArray = objsFolder->addBaseDataVariable("array");
+	QVector<double> values(256);
+	varArray->setValue(QVariant::fromValue(values));
+	bench.run("setValue/array[256]", iterations, [varArray, &values](int i) {
+		values[i % values.size()] = static_cast<double>(i);
+		varArray->setValue(QVariant::fromValue(values));
+	});
+}
+
+static void benchWriteValues(QUaBenchmark& bench, QUaServer& server, const int& variables)
+{
+	auto folder = server.objectsFolder()->addFolderObject("WriteValues");
+	QVector<QUaWriteValue> values;
+	values.reserve(variables);
+	for (int i = 0; i < variables; i++)
+	{
+		auto var = folder->addBaseDataVariable(QString("var%1").arg(i));
+		var->setValue(0.0);
+		values << QUaWriteValue(var, 0.0);
+	}
+	QJsonObject extra({ { "variables", variables } });
+	bench.run("writeValues/setValue", variables, [&values](int i) {
+		values[i].variable->setValue(static_cast<double>(i));
+	}, extra);
+	for (int i = 0; i < variables; i++)
+	{
+		values[i].value = static_cast<double>(i + 1);
+	}
+	QElapsedTimer timer;
+	timer.start();
+	server.writeValues(values);
+	bench.addResult("writeValues/batch", variables, timer.nsecsElapsed(), extra);
+	delete folder;
+}
+
+static void benchLookups(QUaBenchmark& bench, QUaServer& server, const int& iterations)
+{
+	// NOTE : requires benchCreateInstances to be run first
+	auto deepInstances = server.typeInstances<BenchDeepType>();
+	auto flatInstances = server.typeInstances<BenchFlatType>();
+	if (deepInstances.isEmpty() || flatInstances.isEmpty())
+	{
+		qWarning() << "[WARNING] : No instances to look up.";
+		return;
+	}
+	QList<QUaBrowsePath> paths;
+	for (auto deep : deepInstances)
+	{
+		paths << deep->mid3()->leaf3()->value()->nodeBrowsePath();
+	}
+	bench.run("browsePath", iterations, [&server, &paths](int i) {
+		auto node = server.browsePath(paths.at(i % paths.count()));
+		Q_ASSERT(node);
+		Q_UNUSED(node);
+	}, QJsonObject({ { "depth", paths.first().count() } }));
+	QList<QUaNodeId> nodeIds;
+	for (auto flat : flatInstances)
+	{
+		nodeIds << flat->nodeId();
+	}
+	bench.run("nodeById", iterations, [&server, &nodeIds](int i) {
+		auto node = server.nodeById(nodeIds.at(i % nodeIds.count()));
+		Q_ASSERT(node);
+		Q_UNUSED(node);
+	}, QJsonObject({ { "nodes", nodeIds.count() } }));
+	QList<QByteArray> stringIds;
+	for (const auto& nodeId : nodeIds)
+	{
+		stringIds << nodeId.stringId().toUtf8();
+	}
+	bench.run("nodeById/string", iterations, [&server, &stringIds](int i) {
+		auto node = server.nodeById(1, stringIds.at(i % stringIds.count()));
+		Q_ASSERT(node);
+		Q_UNUSED(node);
+	}, QJsonObject({ { "nodes", stringIds.count() } }));
+	int typeIterations = qMax(1, iterations / 100);
+	bench.run("typeInstances", typeIterations, [&server](int) {
+		auto list = server.typeInstances<BenchFlatType>();
+		Q_UNUSED(list);
+	}, QJsonObject({ { "instances", flatInstances.count() } }));
+	bench.run("typeInstanceCount", iterations, [&server](int) {
+		int count = server.typeInstanceCount<BenchFlatType>();
+		Q_UNUSED(count);
+	}, QJsonObject({ { "instances", flatInstances.count() } }));
+	bench.run("forEachTypeInstance", typeIterations, [&server](int) {
+		int count = 0;
+		server.forEachTypeInstance<BenchFlatType>([&count](BenchFlatType*) {
+			count++;
+		});
+		Q_UNUSED(count);
+	}, QJsonObject({ { "instances", flatInstances.count() } }));
+}
+
+static void benchNodeIds(QUaBenchmark& bench, const int& iterations)
+{
+	// string node ids as used as keys of QUaServer::m_hashTypeVars and historizer maps
+	int count = qMax(1, qMin(iterations, 10000));
+	QList<QUaNodeId> nodeIds;
+	QList<QUaNodeId> equalIds;
+	QList<QUaNodeId> internedIds;
+	QHash<QUaNodeId, int> hashPlain;
+	QHash<QUaNodeId, int> hashInterned;
+	for (int i = 0; i < count; i++)
+	{
+		QString stringId = QString("Objects.Plant.Area%1.Sensor%2.Value").arg(i % 100).arg(i);
+		QUaNodeId nodeId(1, stringId);
+		nodeIds << nodeId;
+		// equal value, different buffer
+		equalIds << QUaNodeId(1, stringId);
+		internedIds << nodeId.interned();
+		hashPlain.insert(nodeId, i);
+		hashInterned.insert(nodeId.interned(), i);
+	}
+	QJsonObject extra({ { "keys", count } });
+	bench.run("nodeId/copy", iterations, [&nodeIds](int i) {
+		QUaNodeId copy = nodeIds.at(i % nodeIds.count());
+		Q_UNUSED(copy);
+	}, extra);
+	bench.run("nodeId/hash/lookup", iterations, [&hashPlain, &equalIds](int i) {
+		// NOTE : equal but not same buffer as key, compares by value
+		int value = hashPlain.value(equalIds.at(i % equalIds.count()), -1);
+		Q_ASSERT(value >= 0);
+		Q_UNUSED(value);
+	}, extra);
+	bench.run("nodeId/hash/lookup/interned", iterations, [&hashInterned, &internedIds](int i) {
+		int value = hashInterned.value(internedIds.at(i % internedIds.count()), -1);
+		Q_ASSERT(value >= 0);
+		Q_UNUSED(value);
+	}, extra);
+	bench.run("nodeId/intern", iterations, [&nodeIds](int i) {
+		QUaNodeId nodeId = nodeIds.at(i % nodeIds.count()).interned();
+		Q_UNUSED(nodeId);
+	}, extra);
+	// numeric node ids are kept inline, no buffer is allocated
+	bench.run("nodeId/numeric/create", iterations, [](int i) {
+		QUaNodeId nodeId(1, static_cast<quint32>(i));
+		Q_UNUSED(nodeId);
+	});
+}
+
+static void benchTree(QUaBenchmark& bench, const int& iterations, const int& treeNodes, const int& depth)
+{
+	QUaServer server;
+	QUaFolderObject* objsFolder = server.objectsFolder();
+	auto root = objsFolder->addFolderObject("Tree");
+	// branching factor such that a full tree of given depth holds about treeNodes
+	int branching = qMax(2, qCeil(qPow(treeNodes, 1.0 / depth)));
+	QList<QUaQualifiedName> names;
+	for (int i = 0; i < branching; i++)
+	{
+		names << QString("n%1").arg(i);
+	}
+	QList<QUaNode*> level({ root });
+	int count = 0;
+	QElapsedTimer timer;
+	timer.start();
+	for (int d = 0; d < depth && count < treeNodes; d++)
+	{
+		QList<QUaNode*> next;
+		for (auto parent : level)
+		{
+			if (count >= treeNodes)
+			{
+				break;
+			}
+			auto children = server.createInstances<QUaBaseObject>(
+				parent, 
+				names.mid(0, qMin(branching, treeNodes - count))
+			);
+			count += children.count();
+			for (auto child : children)
+			{
+				next << child;
+			}
+		}
+		level = next;
+	}
+	qint64 nsecs = timer.nsecsElapsed();
+	QJsonObject extra({ { "nodes", count }, { "depth", depth }, { "branching", branching } });
+	bench.addResult("tree/build", count, nsecs, extra);
+	// look up nodes of the deepest level
+	QList<QUaBrowsePath> paths;
+	for (int i = 0; i < level.count() && paths.count() < 1000; i += qMax(1, level.count() / 1000))
+	{
+		paths << level.at(i)->nodeBrowsePath();
+	}
+	bench.run("tree/browsePath", iterations, [&server, &paths](int i) {
+		auto node = server.browsePath(paths.at(i % paths.count()));
+		Q_ASSERT(node);
+		Q_UNUSED(node);
+	}, extra);
+	auto first = root->browseChildren().first();
+	bench.run("tree/browseChild", iterations, [first, &names](int i) {
+		auto node = first->browseChild(names.at(i % names.count()));
+		Q_UNUSED(node);
+	}, extra);
+}
+
+// two level subtree of about the given number of nodes
+static QUaNode* buildSubtree(QUaServer& server, const QString& name, const int& nodes)
+{
+	auto root = server.objectsFolder()->addFolderObject(name);
+	int branching = qMax(1, qCeil(qSqrt(nodes)));
+	QList<QUaQualifiedName> names;
+	for (int i = 0; i < branching; i++)
+	{
+		names << QString("n%1").arg(i);
+	}
+	auto folders = server.createInstances<QUaFolderObject>(root, names);
+	for (auto folder : folders)
+	{
+		server.createInstances<QUaBaseObject>(folder, names);
+	}
+	return root;
+}
+
+static void benchDeleteSubtree(QUaBenchmark& bench, const int& nodes)
+{
+	QUaServer server;
+	int branching = qMax(1, qCeil(qSqrt(nodes)));
+	int count = branching + branching * branching;
+	QJsonObject extra({ { "nodes", count } });
+	// one by one, as done by ~QUaNode
+	auto root = buildSubtree(server, "Delete", nodes);
+	QElapsedTimer timer;
+	timer.start();
+	delete root;
+	bench.addResult("delete/subtree/delete", count, timer.nsecsElapsed(), extra);
+	// bulk
+	root = buildSubtree(server, "DeleteSubtree", nodes);
+	timer.start();
+	root->deleteSubtree();
+	bench.addResult("delete/subtree/deleteSubtree", count, timer.nsecsElapsed(), extra);
+}
+
+// clone a template subtree of about the given number of nodes the given number of times
+static void benchClone(QUaBenchmark& bench, const int& nodes, const int& copies)
+{
+	int branching = qMax(1, qCeil(qSqrt(nodes)));
+	QJsonObject extra({ { "nodes", 1 + branching + branching * branching }, { "copies", copies } });
+	QList<QUaQualifiedName> names;
+	for (int i = 0; i < copies; i++)
+	{
+		names << QString("Copy%1").arg(i);
+	}
+	// one by one, each copy serialized and deserialized
+	{
+		QUaServer server;
+		auto tmpl = buildSubtree(server, "Template", nodes);
+		auto parent = server.objectsFolder()->addFolderObject("Copies");
+		QElapsedTimer timer;
+		timer.start();
+		for (const auto& name : names)
+		{
+			tmpl->cloneNode(parent, name);
+		}
+		bench.addResult("clone/template/cloneNode", copies, timer.nsecsElapsed(), extra);
+	}
+	// bulk, snapshot once
+	{
+		QUaServer server;
+		auto tmpl = buildSubtree(server, "Template", nodes);
+		auto parent = server.objectsFolder()->addFolderObject("Copies");
+		QElapsedTimer timer;
+		timer.start();
+		tmpl->cloneNodes(parent, names);
+		bench.addResult("clone/template/cloneNodes", copies, timer.nsecsElapsed(), extra);
+	}
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+static void benchChangeEvents(QUaBenchmark& bench, const int& iterations, const int& maxBatch)
+{
+	QUaServer server;
+	server.setChangeEventMaxBatch(maxBatch);
+	QUaFolderObject* objsFolder = server.objectsFolder();
+	auto root = objsFolder->addFolderObject("Changes");
+	QList<QUaQualifiedName> names;
+	for (int i = 0; i < iterations; i++)
+	{
+		names << QString("parent%1").arg(i);
+	}
+	auto parents = server.createInstances<QUaFolderObject>(root, names);
+	QCoreApplication::processEvents();
+	server.resetChangeEventStats();
+	// one distinct change per parent, buffered and emitted on next event loop iteration
+	QElapsedTimer timer;
+	timer.start();
+	for (auto parent : parents)
+	{
+		parent->addFolderObject("child");
+	}
+	QCoreApplication::processEvents();
+	qint64 nsecs = timer.nsecsElapsed();
+	bench.addResult(QString("changes/emit/batch%1").arg(maxBatch), iterations, nsecs, QJsonObject({
+		{ "events"           , static_cast<qint64>(server.changeEventsEmitted()) },
+		{ "changes"          , static_cast<qint64>(server.changesEmitted()) },
+		{ "changes_per_event", server.changesPerEvent() },
+		{ "max_latency_ns"   , server.changeEventMaxLatency() }
+	}));
+}
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+// synthetic tag set of folders x tags, nothing is stored
+struct BenchTagProvider
+{
+	int folders;
+	int tags;
+	QList<QUaQualifiedName> children(const QUaBrowsePath& path)
+	{
+		QList<QUaQualifiedName> names;
+		if (path.count() > 1)
+		{
+			return names;
+		}
+		int count = path.isEmpty() ? folders : tags;
+		QString prefix = path.isEmpty() ? "f%1" : "t%1";
+		names.reserve(count);
+		for (int i = 0; i < count; i++)
+		{
+			names << prefix.arg(i);
+		}
+		return names;
+	}
+	bool isFolder(const QUaBrowsePath& path)
+	{
+		return path.count() == 1;
+	}
+	QVariant value(const QUaBrowsePath& path)
+	{
+		return path.last().name();
+	}
+};
+
+// same tag set, also resolving a single path without listing its folder
+struct BenchTagResolver : public BenchTagProvider
+{
+	bool hasChild(const QUaBrowsePath& path)
+	{
+		if (path.isEmpty() || path.count() > 2)
+		{
+			return false;
+		}
+		QString name = path.last().name();
+		bool ok = false;
+		int index = name.mid(1).toInt(&ok);
+		return ok && index >= 0 &&
+			name.startsWith(path.count() == 1 ? QLatin1Char('f') : QLatin1Char('t')) &&
+			index < (path.count() == 1 ? folders : tags);
+	}
+};
+
+static void benchVirtualFolder(QUaBenchmark& bench, const int& iterations)
+{
+	QUaServer server;
+	BenchTagProvider provider;
+	provider.folders = 100;
+	provider.tags    = 1000;
+	auto root = server.createInstance<QUaVirtualFolder>(server.objectsFolder(), "Virtual", "ns=1;s=Virtual");
+	root->setProvider(provider);
+	QJsonObject extra({ { "folders", provider.folders }, { "tags", provider.tags } });
+	// materialize one whole level per iteration, evicting it again afterwards
+	int levels = qMin(iterations, provider.folders);
+	qint64 nsecs = 0;
+	QElapsedTimer timer;
+	for (int i = 0; i < levels; i++)
+	{
+		auto folder = root->browseVirtualPath({ QString("f%1").arg(i) });
+		auto virtualFolder = qobject_cast<QUaVirtualFolder*>(folder);
+		Q_CHECK_PTR(virtualFolder);
+		timer.start();
+		virtualFolder->materialize();
+		nsecs += timer.nsecsElapsed();
+		virtualFolder->dematerialize();
+	}
+	bench.addResult("virtual/materialize", levels * provider.tags, nsecs, extra);
+	// single leaves, half of them already materialized
+	bench.run("virtual/browseVirtualPath", iterations, [root, &provider](int i) {
+		auto node = root->browseVirtualPath({
+			QString("f%1").arg(i % provider.folders),
+			QString("t%1").arg((i / 2) % provider.tags)
+		});
+		Q_ASSERT(node);
+		Q_UNUSED(node);
+	}, extra);
+	// same leaves through a provider implementing hasChild
+	BenchTagResolver resolver;
+	resolver.folders = provider.folders;
+	resolver.tags    = provider.tags;
+	auto resolved = server.createInstance<QUaVirtualFolder>(server.objectsFolder(), "Resolved", "ns=1;s=Resolved");
+	resolved->setProvider(resolver);
+	bench.run("virtual/browseVirtualPath/hasChild", iterations, [resolved, &resolver](int i) {
+		auto node = resolved->browseVirtualPath({
+			QString("f%1").arg(i % resolver.folders),
+			QString("t%1").arg((i / 2) % resolver.tags)
+		});
+		Q_ASSERT(node);
+		Q_UNUSED(node);
+	}, extra);
+}
+
+static void benchReadLatency(
+	QUaBenchmark& bench,
+	QUaServer& server,
+	const int& reads,
+	const bool& iterateInThread)
+{
+	// NOTE : the client reads from its own thread while this thread is kept busy
+	auto var = server.objectsFolder()->addBaseDataVariable("latency", QUaNodeId(1, "latency"));
+	var->setValue(0.0);
+	server.setIterateInThread(iterateInThread);
+	server.start();
+	QByteArray url = QString("opc.tcp://localhost:%1").arg(server.port()).toUtf8();
+	QVector<qint64> latencies;
+	latencies.reserve(reads);
+	QThread* clientThread = QThread::create([&url, &latencies, reads]() {
+		UA_Client* client = UA_Client_new();
+		UA_ClientConfig_setDefault(UA_Client_getConfig(client));
+		if (UA_Client_connect(client, url.constData()) != UA_STATUSCODE_GOOD)
+		{
+			UA_Client_delete(client);
+			return;
+		}
+		UA_NodeId nodeId = UA_NODEID_STRING(1, const_cast<char*>("latency"));
+		QElapsedTimer timer;
+		for (int i = 0; i < reads; i++)
+		{
+			UA_Variant value;
+			UA_Variant_init(&value);
+			timer.start();
+			UA_Client_readValueAttribute(client, nodeId, &value);
+			latencies << timer.nsecsElapsed();
+			UA_Variant_clear(&value);
+		}
+		UA_Client_disconnect(client);
+		UA_Client_delete(client);
+	});
+	clientThread->start();
+	// busy in 20 ms slices, processing events in between as a busy application would
+	const int sliceMs = 20;
+	while (!clientThread->isFinished())
+	{
+		QElapsedTimer busy;
+		busy.start();
+		while (busy.elapsed() < sliceMs)
+		{
+		}
+		QCoreApplication::processEvents();
+	}
+	clientThread->wait();
+	delete clientThread;
+	server.stop();
+	delete var;
+	QString name = iterateInThread ? "read/busy/thread" : "read/busy/eventloop";
+	if (latencies.isEmpty())
+	{
+		qWarning() << "[WARNING] : Client could not connect to" << url;
+		return;
+	}
+	qint64 total = 0;
+	for (auto latency : latencies)
+	{
+		total += latency;
+	}
+	std::sort(latencies.begin(), latencies.end());
+	bench.addResult(name, latencies.count(), total, QJsonObject({
+		{ "busy_slice_ms", sliceMs },
+		{ "p50_ns", static_cast<double>(latencies.at(latencies.count() / 2)) },
+		{ "p99_ns", static_cast<double>(latencies.at((latencies.count() * 99) / 100)) },
+		{ "max_ns", static_cast<double>(latencies.last()) }
+	}));
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+static void onEventNotification(
+	UA_Client* client, UA_UInt32 subId, void* subContext,
+	UA_UInt32 monId, void* monContext,
+	size_t nEventFields, UA_Variant* eventFields)
+{
+	Q_UNUSED(client);
+	Q_UNUSED(subId);
+	Q_UNUSED(subContext);
+	Q_UNUSED(monId);
+	Q_UNUSED(nEventFields);
+	Q_UNUSED(eventFields);
+	(*static_cast<quint64*>(monContext))++;
+}
+
+static void benchEvents(
+	QUaBenchmark& bench,
+	QUaServer& server,
+	const int& iterations,
+	const int& monitoredItems)
+{
+	// NOTE : server must be iterating in its own thread, so this thread can block on client calls
+	Q_ASSERT(server.isRunning() && server.iterateInThread());
+	auto evt = server.createEvent<MyEvent>();
+	evt->setSourceName("Benchmark");
+	// connect in-process client through loopback
+	UA_Client* client = UA_Client_new();
+	UA_ClientConfig_setDefault(UA_Client_getConfig(client));
+	QByteArray url = QString("opc.tcp://localhost:%1").arg(server.port()).toUtf8();
+	UA_StatusCode st = UA_Client_connect(client, url.constData());
+	if (st != UA_STATUSCODE_GOOD)
+	{
+		qWarning() << "[WARNING] : Client could not connect to" << url << ":" << UA_StatusCode_name(st);
+		UA_Client_delete(client);
+		delete evt;
+		return;
+	}
+	UA_CreateSubscriptionRequest subRequest = UA_CreateSubscriptionRequest_default();
+	subRequest.requestedPublishingInterval = 10.0;
+	UA_CreateSubscriptionResponse subResponse =
+		UA_Client_Subscriptions_create(client, subRequest, nullptr, nullptr, nullptr);
+	UA_UInt32 subId = subResponse.subscriptionId;
+	// event filter selecting the message field
+	UA_QualifiedName browseName = UA_QUALIFIEDNAME(0, const_cast<char*>("Message"));
+	UA_SimpleAttributeOperand selectClause;
+	UA_SimpleAttributeOperand_init(&selectClause);
+	selectClause.typeDefinitionId = UA_NODEID_NUMERIC(0, UA_NS0ID_BASEEVENTTYPE);
+	selectClause.browsePathSize   = 1;
+	selectClause.browsePath       = &browseName;
+	selectClause.attributeId      = UA_ATTRIBUTEID_VALUE;
+	UA_EventFilter filter;
+	UA_EventFilter_init(&filter);
+	filter.selectClauses     = &selectClause;
+	filter.selectClausesSize = 1;
+	quint64 received = 0;
+	for (int i = 0; i < monitoredItems; i++)
+	{
+		UA_MonitoredItemCreateRequest item;
+		UA_MonitoredItemCreateRequest_init(&item);
+		item.itemToMonitor.nodeId      = UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER);
+		item.itemToMonitor.attributeId = UA_ATTRIBUTEID_EVENTNOTIFIER;
+		item.monitoringMode            = UA_MONITORINGMODE_REPORTING;
+		item.requestedParameters.filter.encoding             = UA_EXTENSIONOBJECT_DECODED;
+		item.requestedParameters.filter.content.decoded.data = &filter;
+		item.requestedParameters.filter.content.decoded.type = &UA_TYPES[UA_TYPES_EVENTFILTER];
+		item.requestedParameters.queueSize     = static_cast<UA_UInt32>(iterations);
+		item.requestedParameters.discardOldest = true;
+		UA_MonitoredItemCreateResult result = UA_Client_MonitoredItems_createEvent(
+			client, subId, UA_TIMESTAMPSTORETURN_BOTH, item, &received, &onEventNotification, nullptr);
+		Q_ASSERT(result.statusCode == UA_STATUSCODE_GOOD);
+		UA_MonitoredItemCreateResult_clear(&result);
+	}
+	// trigger
+	qint64 nsecs = bench.run("trigger", iterations, [evt](int i) {
+		evt->setMessage(QString("Event %1").arg(i));
+		evt->setTime(QDateTime::currentDateTimeUtc());
+		evt->trigger();
+	}, QJsonObject({ { "monitored_items", monitoredItems } }));
+	// wait for notifications to arrive (end to end)
+	quint64 expected = static_cast<quint64>(iterations) * static_cast<quint64>(monitoredItems);
+	QElapsedTimer timer;
+	timer.start();
+	while (received < expected && timer.elapsed() < 10000)
+	{
+		UA_Client_run_iterate(client, 10);
+	}
+	bench.addResult("trigger/delivered", iterations, nsecs + timer.nsecsElapsed(), QJsonObject({
+		{ "monitored_items", monitoredItems },
+		{ "expected"       , static_cast<double>(expected) },
+		{ "received"       , static_cast<double>(received) }
+	}));
+	UA_Client_disconnect(client);
+	UA_Client_delete(client);
+	delete evt;
+}
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+#ifdef UA_ENABLE_HISTORIZING
+template<typename T>
+static void benchHistorizer(QUaBenchmark& bench, const QString& name, T& historizer, const int& iterations, const bool& async = false)
+{
+	// NOTE : historizer must live at least as long as server
+	QUaServer server;
+	server.setHistorizer(historizer);
+	server.setHistoryWriteAsync(async);
+	auto var = server.objectsFolder()->addBaseDataVariable("historized", { 1, "historized" });
+	var->setHistorizing(true);
+	var->setValue(0.0);
+	// use unique timestamps, they are the samples' keys
+	QDateTime timeStart = QDateTime::currentDateTimeUtc();
+	if (!async)
+	{
+		bench.run("history/write/" + name, iterations, [var, &timeStart](int i) {
+			QDateTime time = timeStart.addMSecs(i + 1);
+			var->setValue(static_cast<double>(i), QUaStatus::Good, time, time);
+		});
+		return;
+	}
+	// time seen by the writing thread, and until all points are committed
+	server.resetHistoryWriteStats();
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < iterations; i++)
+	{
+		QDateTime time = timeStart.addMSecs(i + 1);
+		var->setValue(static_cast<double>(i), QUaStatus::Good, time, time);
+	}
+	qint64 writeNs = timer.nsecsElapsed();
+	server.flushHistoryWrites();
+	qint64 commitNs = timer.nsecsElapsed();
+	auto stats = server.historyWriteStats();
+	QJsonObject extra({
+		{ "batches"         , static_cast<qint64>(stats.batches) },
+		{ "queueMaxDepth"   , stats.queueMaxDepth                },
+		{ "commitMaxLatency", stats.commitMaxLatency             }
+	});
+	bench.addResult("history/write/" + name + "/async", iterations, writeNs, extra);
+	bench.addResult("history/commit/" + name + "/async", iterations, commitNs, extra);
+	// writer thread stops before the historizer goes out of scope
+	server.setHistoryWriteAsync(false);
+}
+#endif // UA_ENABLE_HISTORIZING
+
+#ifdef UA_ENABLE_HISTORIZING
+// memory used per sample of a slowly changing double, sampled every second
+static void benchCompressedBytes(QUaBenchmark& bench, const int& iterations)
+{
+	QQueue<QUaLog> logOut;
+	QUaCompressedHistorizer historizer;
+	QUaNodeId nodeId(1, "historized");
+	QDateTime timeStart = QDateTime::currentDateTimeUtc();
+	bench.run("history/compressed/write", iterations, [&](int i) {
+		QDateTime time = timeStart.addSecs(i);
+		historizer.writeHistoryData(nodeId, { time, 20.0 + 0.1 * (i / 100), 0 }, logOut);
+	});
+	double bytesPerSample = static_cast<double>(historizer.dataPointBytes()) /
+		static_cast<double>(qMax<quint64>(1, historizer.dataPointCount()));
+	bench.addResult("history/compressed/bytes", iterations, 0, QJsonObject({
+		{ "bytesPerSample", bytesPerSample }
+	}));
+	// paginated read of all samples
+	bench.run("history/compressed/read", 1, [&](int) {
+		auto points = historizer.readHistoryData(nodeId, timeStart, 0, static_cast<quint64>(iterations), logOut);
+		Q_UNUSED(points);
+	});
+}
+#endif // UA_ENABLE_HISTORIZING
+
+#ifdef UA_ENABLE_HISTORIZING
+// range count and paginated read over a full ring, with downsampled buckets
+static void benchRingRead(QUaBenchmark& bench, const int& iterations)
+{
+	QQueue<QUaLog> logOut;
+	QUaRingHistorizer historizer;
+	historizer.setDefaultRetention({ qMax(1, iterations / 2), 10 * 1000, qMax(1, iterations / 10) });
+	QUaNodeId nodeId(1, "historized");
+	QDateTime timeStart = QDateTime::currentDateTimeUtc();
+	for (int i = 0; i < iterations; i++)
+	{
+		historizer.writeHistoryData(nodeId, { timeStart.addSecs(i), static_cast<double>(i), 0 }, logOut);
+	}
+	auto stats = historizer.nodeStats(nodeId);
+	bench.run("history/ring/count", iterations, [&](int i) {
+		quint64 count = historizer.numDataPointsInRange(nodeId, timeStart.addSecs(i), QDateTime(), logOut);
+		Q_UNUSED(count);
+	});
+	bench.run("history/ring/read", 1, [&](int) {
+		auto points = historizer.readHistoryData(nodeId, timeStart, 0, static_cast<quint64>(stats.count + stats.downsampleCount), logOut);
+		Q_UNUSED(points);
+	});
+	bench.addResult("history/ring/occupancy", iterations, 0, QJsonObject({
+		{ "count"          , stats.count                            },
+		{ "downsampleCount", stats.downsampleCount                  },
+		{ "evicted"        , static_cast<qint64>(stats.evicted)     },
+		{ "downsampled"    , static_cast<qint64>(stats.downsampled) }
+	}));
+}
+
+// reads all the points of a node in pages, skipping all previous pages (offset) or
+// seeking to the last point read (cursor), as history read continuation points do
+template<typename T>
+static void benchPages(QUaBenchmark& bench, const QString& name, T& historizer, const int& numPoints, const int& pageSize)
+{
+	QQueue<QUaLog> logOut;
+	QUaNodeId nodeId(1, "paged");
+	QDateTime timeStart = QDateTime::currentDateTimeUtc();
+	for (int i = 0; i < numPoints; i++)
+	{
+		historizer.writeHistoryData(nodeId, { timeStart.addMSecs(i), static_cast<double>(i), 0 }, logOut);
+	}
+	int pages = (numPoints + pageSize - 1) / pageSize;
+	QJsonObject extra({ { "points", numPoints }, { "pageSize", pageSize } });
+	bench.run("history/pages/" + name + "/offset", pages, [&](int i) {
+		auto points = historizer.readHistoryData(nodeId, timeStart, static_cast<quint64>(i) * pageSize, pageSize, logOut);
+		Q_UNUSED(points);
+	}, extra);
+	QDateTime cursor = timeStart;
+	quint64   skip   = 0;
+	bench.run("history/pages/" + name + "/cursor", pages, [&](int) {
+		auto points = historizer.readHistoryData(nodeId, cursor, skip, pageSize, logOut);
+		// last page is padded with invalid points
+		if (points.last().timestamp.isValid())
+		{
+			cursor = points.last().timestamp;
+			skip   = 1;
+		}
+	}, extra);
+	printLog(logOut);
+}
+
+// history write cost per sample of a data value as received from the server, converted to a
+// QUaHistoryDataPoint for writeHistoryData (point) or passed as is to writeHistoryDataRaw (native)
+static void benchWriteValue(QUaBenchmark& bench, const int& iterations)
+{
+	QQueue<QUaLog> logOut;
+	UA_NodeId nodeId = UA_NODEID_NUMERIC(1, 1);
+	UA_DateTime timeStart = UA_DateTime_now();
+	UA_DataValue value;
+	UA_DataValue_init(&value);
+	UA_Double dblVal = 0.0;
+	UA_Variant_setScalar(&value.value, &dblVal, &UA_TYPES[UA_TYPES_DOUBLE]);
+	value.hasValue = true;
+	value.hasSourceTimestamp = true;
+	{
+		QUaCompressedHistorizer historizer;
+		QUaHistoryBackend backend;
+		backend.setHistorizer(historizer);
+		bench.run("history/write/compressed/point", iterations, [&](int i) {
+			dblVal = static_cast<double>(i);
+			value.sourceTimestamp = timeStart + i * UA_DATETIME_MSEC;
+			// what the server did before writeHistoryDataRaw
+			backend.writeHistoryData(QUaNodeId(nodeId), {
+				QUaTypesConverter::uaVariantToQVariantScalar<QDateTime, UA_DateTime>(&value.sourceTimestamp),
+				QUaTypesConverter::uaVariantToQVariant(value.value),
+				value.status
+			}, logOut);
+		});
+	}
+	{
+		QUaCompressedHistorizer historizer;
+		QUaHistoryBackend backend;
+		backend.setHistorizer(historizer);
+		bench.run("history/write/compressed/native", iterations, [&](int i) {
+			dblVal = static_cast<double>(i);
+			value.sourceTimestamp = timeStart + i * UA_DATETIME_MSEC;
+			backend.writeHistoryDataValue(nodeId, &value, logOut);
+		});
+	}
+	printLog(logOut);
+}
+
+// sustained rate of native data values (100 per iteration) appended to the mapped segments
+// of a node, and the time to reopen them (scan of the last segment)
+static void benchMapped(QUaBenchmark& bench, const QString& path, const int& iterations)
+{
+	QQueue<QUaLog> logOut;
+	UA_NodeId nodeId = UA_NODEID_NUMERIC(1, 1);
+	UA_DateTime timeStart = UA_DateTime_now();
+	UA_Double dblVal = 0.0;
+	UA_Variant value;
+	UA_Variant_setScalar(&value, &dblVal, &UA_TYPES[UA_TYPES_DOUBLE]);
+	int numPoints = iterations * 100;
+	{
+		QUaMappedHistorizer historizer;
+		if (!historizer.setPath(path, logOut))
+		{
+			printLog(logOut);
+			return;
+		}
+		bench.run("history/mapped/append", numPoints, [&](int i) {
+			dblVal = static_cast<double>(i);
+			historizer.writeHistoryDataRaw(nodeId, timeStart + i * UA_DATETIME_MSEC, value, UA_STATUSCODE_GOOD, logOut);
+		});
+	}
+	bench.run("history/mapped/recover", 1, [&](int) {
+		QUaMappedHistorizer historizer;
+		historizer.setPath(path, logOut);
+	}, QJsonObject({ { "points", numPoints } }));
+	printLog(logOut);
+}
+
+// count and read of all data points from a start time, as a history read without continuation
+template<typename T>
+static void benchRange(QUaBenchmark& bench, const QString& name, T& historizer, const QUaNodeId& nodeId,
+	const QDateTime& timeStart, const int& reads, const QJsonObject& extra)
+{
+	QQueue<QUaLog> logOut;
+	bench.run(name, reads, [&](int) {
+		quint64 count = historizer.numDataPointsInRange(nodeId, timeStart, QDateTime(), logOut);
+		auto points = historizer.readHistoryData(nodeId, timeStart, 0, count, logOut);
+		Q_UNUSED(points);
+	}, extra);
+	printLog(logOut);
+}
+
+// last hour and all of 2 hours of 1 second data points, from the multi-file sqlite historizer
+// and from the tiered historizer over another one (last hour in memory, older moved to sqlite)
+static void benchTiered(QUaBenchmark& bench, const QString& path, const QString& coldPath, const int& iterations)
+{
+	QQueue<QUaLog> logOut;
+	QUaMultiSqliteHistorizer sqlite;
+	QUaMultiSqliteHistorizer cold;
+	if (!sqlite.setDatabasePath(path, logOut) || !cold.setDatabasePath(coldPath, logOut))
+	{
+		printLog(logOut);
+		return;
+	}
+	// NOTE : cold historizer must outlive the tiered one
+	QUaTieredHistorizer tiered;
+	tiered.setColdHistorizer(cold);
+	QUaNodeId nodeId(1, "tiered");
+	const int numPoints = 2 * 60 * 60;
+	QDateTime timeStart = QDateTime::currentDateTimeUtc().addSecs(-numPoints);
+	QDateTime timeHour  = timeStart.addSecs(numPoints / 2);
+	for (int i = 0; i < numPoints; i++)
+	{
+		QUaHistoryDataPoint dataPoint = { timeStart.addSecs(i), static_cast<double>(i), 0 };
+		sqlite.writeHistoryData(nodeId, dataPoint, logOut);
+		tiered.writeHistoryData(nodeId, dataPoint, logOut);
+	}
+	// move the first hour to the cold tier
+	tiered.age(logOut);
+	printLog(logOut);
+	int reads = qMax(1, iterations / 100);
+	QJsonObject extra({
+		{ "points"   , numPoints                                },
+		{ "hotPoints", static_cast<qint64>(tiered.hotCount()) }
+	});
+	benchRange(bench, "history/tiered/lasthour/multisqlite", sqlite, nodeId, timeHour , reads, extra);
+	benchRange(bench, "history/tiered/lasthour/tiered"     , tiered, nodeId, timeHour , reads, extra);
+	benchRange(bench, "history/tiered/all/multisqlite"     , sqlite, nodeId, timeStart, reads, extra);
+	benchRange(bench, "history/tiered/all/tiered"          , tiered, nodeId, timeStart, reads, extra);
+}
+
+// hourly time averages of a day of 1 second data points, from the 1 hour rollups of the
+// historizer (day aligned range) and from the raw data points (range shifted 1 millisecond)
+static void benchAggregate(QUaBenchmark& bench, const int& iterations)
+{
+	QQueue<QUaLog> logOut;
+	QUaInMemoryHistorizer historizer;
+	QUaHistoryBackend backend;
+	backend.setHistorizer(historizer);
+	QUaNodeId nodeId(1, "aggregated");
+	const qint64 day = 24 * 60 * 60 * 1000;
+	const qint64 hour = 60 * 60 * 1000;
+	QDateTime timeStart = QDateTime::fromMSecsSinceEpoch((QDateTime::currentMSecsSinceEpoch() / day) * day, Qt::UTC);
+	QDateTime timeEnd   = timeStart.addMSecs(day);
+	const int numPoints = 24 * 60 * 60;
+	for (int i = 0; i < numPoints; i++)
+	{
+		historizer.writeHistoryData(nodeId, { timeStart.addSecs(i), qSin(i / 600.0), 0 }, logOut);
+	}
+	int reads = qMax(1, iterations / 100);
+	QJsonObject extra({ { "points", numPoints }, { "intervals", 24 } });
+	bench.run("history/aggregate/inmemory/rollup", reads, [&](int) {
+		auto points = backend.readHistoryAggregate(nodeId, QUaHistoryBackend::Aggregate::TimeAverage,
+			timeStart, timeEnd, hour, logOut);
+		Q_UNUSED(points);
+	}, extra);
+	bench.run("history/aggregate/inmemory/raw", reads, [&](int) {
+		auto points = backend.readHistoryAggregate(nodeId, QUaHistoryBackend::Aggregate::TimeAverage,
+			timeStart.addMSecs(1), timeEnd.addMSecs(1), hour, logOut);
+		Q_UNUSED(points);
+	}, extra);
+	printLog(logOut);
+}
+#endif // UA_ENABLE_HISTORIZING
+
+template<typename T>
+static void benchSerializer(QUaBenchmark& bench, const QString& name, T& serializer, QUaServer& server)
+{
+	QQueue<QUaLog> logOut;
+	QUaFolderObject* objsFolder = server.objectsFolder();
+	int nodes = objsFolder->browseChildren().count();
+	QElapsedTimer timer;
+	timer.start();
+	bool ok = objsFolder->serialize(serializer, logOut);
+	bench.addResult("serialize/" + name, 1, timer.nsecsElapsed(), QJsonObject({ { "ok", ok }, { "top_level_nodes", nodes } }));
+	printLog(logOut);
+	timer.restart();
+	ok = objsFolder->deserialize(serializer, logOut);
+	bench.addResult("deserialize/" + name, 1, timer.nsecsElapsed(), QJsonObject({ { "ok", ok }, { "top_level_nodes", nodes } }));
+	printLog(logOut);
+}
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Benchmarks the QUaServer wrapper's hot paths.");
+	parser.addHelpOption();
+	QCommandLineOption optIterations({ "n", "iterations" }, "Iterations per case.", "count", "1000");
+	QCommandLineOption optMonItems({ "m", "monitored-items" }, "Event monitored items.", "count", "100");
+	QCommandLineOption optPort({ "p", "port" }, "Loopback port for the in-process client.", "port", "48400");
+	QCommandLineOption optOutput({ "o", "output" }, "Output json file (default stdout).", "file");
+	QCommandLineOption optTreeNodes({ "t", "tree-nodes" }, "Nodes of the depth 10 lookup tree (0 to skip).", "count", "100000");
+	QCommandLineOption optInstances({ "i", "instances" }, "Instances of the createInstance/createInstances comparison (0 to skip).", "count", "200000");
+	parser.addOptions({ optIterations, optMonItems, optPort, optOutput, optTreeNodes, optInstances });
+	parser.process(a);
+	int iterations     = qMax(1, parser.value(optIterations).toInt());
+	int monitoredItems = qMax(1, parser.value(optMonItems).toInt());
+	int treeNodes      = qMax(0, parser.value(optTreeNodes).toInt());
+	int instances      = qMax(0, parser.value(optInstances).toInt());
+
+	QTemporaryDir tempDir;
+	QUaBenchmark bench("02_hotpaths");
+	{
+		QUaServer server;
+		server.registerType<BenchFlatType>();
+		server.registerType<BenchLeafType>();
+		server.registerType<BenchMidType>();
+		server.registerType<BenchDeepType>();
+
+		benchCreateInstances(bench, server, iterations);
+		benchSetValue(bench, server, iterations);
+		benchWriteValues(bench, server, 50000);
+		benchLookups(bench, server, iterations);
+
+		QQueue<QUaLog> logOut;
+		QUaXmlSerializer xmlSerializer;
+		if (xmlSerializer.setXmlFileName(tempDir.filePath("config.xml"), logOut))
+		{
+			benchSerializer(bench, "xml", xmlSerializer, server);
+		}
+		printLog(logOut);
+		QUaSqliteSerializer sqliteSerializer;
+		if (sqliteSerializer.setSqliteDbName(tempDir.filePath("config.sqlite"), logOut))
+		{
+			benchSerializer(bench, "sqlite", sqliteSerializer, server);
+		}
+		printLog(logOut);
+
+		// client read latency while this thread is busy, without and with iterate thread
+		server.setPort(static_cast<quint16>(parser.value(optPort).toUInt()));
+		benchReadLatency(bench, server, qMin(iterations, 500), false);
+		benchReadLatency(bench, server, qMin(iterations, 500), true);
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+		server.registerType<MyEvent>();
+		server.setIterateInThread(true);
+		server.start();
+		benchEvents(bench, server, iterations, monitoredItems);
+		server.stop();
+#else
+		Q_UNUSED(monitoredItems);
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	}
+
+	benchNodeIds(bench, iterations);
+
+	if (instances > 0)
+	{
+		benchCreateInstancesLarge(bench, instances);
+	}
+
+	if (treeNodes > 0)
+	{
+		benchTree(bench, iterations, treeNodes, 10);
+		benchDeleteSubtree(bench, treeNodes);
+	}
+
+	benchClone(bench, 500, 1000);
+
+	benchVirtualFolder(bench, iterations);
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// unlimited, and collapsed/split batches
+	benchChangeEvents(bench, iterations, 0);
+	benchChangeEvents(bench, iterations, 100);
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+#ifdef UA_ENABLE_HISTORIZING
+	{
+		QUaInMemoryHistorizer historizer;
+		benchHistorizer(bench, "inmemory", historizer, iterations);
+	}
+	{
+		QUaInMemoryHistorizer historizer;
+		benchHistorizer(bench, "inmemory", historizer, iterations, true);
+	}
+	{
+		QUaCompressedHistorizer historizer;
+		benchHistorizer(bench, "compressed", historizer, iterations);
+	}
+	benchCompressedBytes(bench, iterations);
+	benchWriteValue(bench, iterations);
+	{
+		// full buffer, every write evicts
+		QUaRingHistorizer historizer;
+		historizer.setDefaultRetention({ qMax(1, iterations / 10), 1000, qMax(1, iterations / 100) });
+		benchHistorizer(bench, "ring", historizer, iterations);
+	}
+	benchRingRead(bench, iterations);
+	{
+		QQueue<QUaLog> logOut;
+		QUaMappedHistorizer historizer;
+		if (historizer.setPath(tempDir.filePath("mapped"), logOut))
+		{
+			benchHistorizer(bench, "mapped", historizer, iterations);
+		}
+		printLog(logOut);
+	}
+	benchMapped(bench, tempDir.filePath("mappedappend"), iterations);
+	// 100 points per iteration, read in pages of 1000
+	{
+		QUaInMemoryHistorizer historizer;
+		benchPages(bench, "inmemory", historizer, iterations * 100, 1000);
+	}
+	{
+		QQueue<QUaLog> logOut;
+		QUaMappedHistorizer historizer;
+		if (historizer.setPath(tempDir.filePath("mappedpages"), logOut))
+		{
+			benchPages(bench, "mapped", historizer, iterations * 100, 1000);
+		}
+		printLog(logOut);
+	}
+	benchAggregate(bench, iterations);
+	{
+		QQueue<QUaLog> logOut;
+		QUaSqliteHistorizer historizer;
+		if (historizer.setSqliteDbName(tempDir.filePath("pages.sqlite"), logOut))
+		{
+			benchPages(bench, "sqlite", historizer, iterations * 100, 1000);
+		}
+		printLog(logOut);
+	}
+	{
+		QQueue<QUaLog> logOut;
+		QUaSqliteHistorizer historizer;
+		if (historizer.setSqliteDbName(tempDir.filePath("history.sqlite"), logOut))
+		{
+			benchHistorizer(bench, "sqlite", historizer, iterations);
+		}
+		printLog(logOut);
+	}
+	{
+		QQueue<QUaLog> logOut;
+		QUaSqliteHistorizer historizer;
+		if (historizer.setSqliteDbName(tempDir.filePath("history_async.sqlite"), logOut))
+		{
+			benchHistorizer(bench, "sqlite", historizer, iterations, true);
+		}
+		printLog(logOut);
+	}
+	{
+		QQueue<QUaLog> logOut;
+		QUaMultiSqliteHistorizer historizer;
+		if (historizer.setDatabasePath(tempDir.filePath("multisqlite"), logOut))
+		{
+			benchHistorizer(bench, "multisqlite", historizer, iterations);
+		}
+		printLog(logOut);
+	}
+	{
+		QQueue<QUaLog> logOut;
+		QUaMultiSqliteHistorizer historizer;
+		historizer.setWriteThread(true);
+		if (historizer.setDatabasePath(tempDir.filePath("multisqlite_thread"), logOut))
+		{
+			benchHistorizer(bench, "multisqlite/thread", historizer, iterations);
+			// time until the write thread commits the queued data points
+			QElapsedTimer timer;
+			timer.start();
+			historizer.flushWrites();
+			bench.addResult("history/commit/multisqlite/thread", iterations, timer.nsecsElapsed());
+		}
+		printLog(logOut);
+	}
+	benchTiered(bench, tempDir.filePath("tieredsqlite"), tempDir.filePath("tieredcold"), iterations);
+#endif // UA_ENABLE_HISTORIZING
+
+	if (!bench.write(parser.value(optOutput)))
+	{
+		qCritical() << "[ERROR] : Could not write" << parser.value(optOutput);
+		return 1;
+	}
+	return 0;
+}
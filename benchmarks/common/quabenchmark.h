@@ -0,0 +1,84 @@
+#ifndef QUABENCHMARK_H
+#define QUABENCHMARK_H
+
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QFile>
+#include <QSysInfo>
+#include <QDateTime>
+#include <functional>
+
+// runs benchmark cases and collects their timings in a machine readable (json) format
+class QUaBenchmark
+{
+public:
+	explicit QUaBenchmark(const QString& name)
+		: m_name(name)
+	{
+	};
+	// calls func(i) for i in [0, iterations), returns elapsed nanoseconds
+	qint64 run(
+		const QString& caseName,
+		const int& iterations,
+		const std::function<void(int)>& func,
+		const QJsonObject& extra = QJsonObject())
+	{
+		QElapsedTimer timer;
+		timer.start();
+		for (int i = 0; i < iterations; i++)
+		{
+			func(i);
+		}
+		qint64 nsecs = timer.nsecsElapsed();
+		this->addResult(caseName, iterations, nsecs, extra);
+		return nsecs;
+	};
+	// add an externally measured result
+	void addResult(
+		const QString& caseName,
+		const int& iterations,
+		const qint64& nsecs,
+		const QJsonObject& extra = QJsonObject())
+	{
+		QJsonObject result = extra;
+		result["name"]       = caseName;
+		result["iterations"] = iterations;
+		result["total_ns"]   = static_cast<double>(nsecs);
+		result["ns_per_op"]  = iterations > 0 ? static_cast<double>(nsecs) / iterations : 0.0;
+		m_results.append(result);
+	};
+	QByteArray toJson() const
+	{
+		return QJsonDocument(QJsonObject({
+			{ "benchmark", m_name },
+			{ "timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+			{ "host"     , QSysInfo::prettyProductName() + " " + QSysInfo::currentCpuArchitecture() },
+			{ "results"  , m_results }
+		})).toJson();
+	};
+	// writes json to file, or to stdout if file name is empty
+	bool write(const QString& strFileName = QString()) const
+	{
+		if (strFileName.isEmpty())
+		{
+			QTextStream out(stdout);
+			out << this->toJson();
+			return true;
+		}
+		QFile file(strFileName);
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		{
+			return false;
+		}
+		file.write(this->toJson());
+		return true;
+	};
+private:
+	QString    m_name;
+	QJsonArray m_results;
+};
+
+#endif // QUABENCHMARK_H
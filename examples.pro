@@ -14,7 +14,9 @@ SUBDIRS += \
 08_events \
 09_serialization \
 10_historizing \
-11_alarms_conditions
+11_alarms_conditions \
+bench_01_setvalue \
+bench_02_hotpaths
 # directories
 00_amalgamation.subdir      = $$PWD/src/amalgamation
 01_basics.subdir            = $$PWD/examples/01_basics
@@ -28,6 +30,8 @@ SUBDIRS += \
 09_serialization.subdir     = $$PWD/examples/09_serialization
 10_historizing.subdir       = $$PWD/examples/10_historizing
 11_alarms_conditions.subdir = $$PWD/examples/11_alarms_conditions
+bench_01_setvalue.subdir    = $$PWD/benchmarks/01_setvalue
+bench_02_hotpaths.subdir    = $$PWD/benchmarks/02_hotpaths
 # dependencies
 00_amalgamation.depends      =
 01_basics.depends            = 00_amalgamation
@@ -40,4 +44,6 @@ SUBDIRS += \
 08_events.depends            = 00_amalgamation
 09_serialization.depends     = 00_amalgamation
 10_historizing.depends       = 00_amalgamation
-11_alarms_conditions.depends = 00_amalgamation
\ No newline at end of file
+11_alarms_conditions.depends = 00_amalgamation
+bench_01_setvalue.depends    = 00_amalgamation
+bench_02_hotpaths.depends    = 00_amalgamation
\ No newline at end of file
@@ -14,10 +14,19 @@ INCLUDEPATH += $$PWD/
 SOURCES += \
 main.cpp \
 quainmemoryhistorizer.cpp \
+quacompressedhistorizer.cpp \
+quaringhistorizer.cpp \
+quamappedhistorizer.cpp \
+quatieredhistorizer.cpp \
 quasqlitehistorizer.cpp
 
 HEADERS += \
 quainmemoryhistorizer.h \
+quacompressedhistorizer.h \
+quaringhistorizer.h \
+quamappedhistorizer.h \
+quanumericbits.h \
+quatieredhistorizer.h \
 quasqlitehistorizer.h
 
 ua_events || ua_alarms_conditions {
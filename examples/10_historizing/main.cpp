@@ -6,11 +6,20 @@
 #include <QUaServer>
 
 #ifdef UA_ENABLE_HISTORIZING
-#ifndef SQLITE_HISTORIZER
-#include "quainmemoryhistorizer.h"
-#else
+#if defined(SQLITE_HISTORIZER)
+#include "quasqlitehistorizer.h"
+#elif defined(COMPRESSED_HISTORIZER)
+#include "quacompressedhistorizer.h"
+#elif defined(RING_HISTORIZER)
+#include "quaringhistorizer.h"
+#elif defined(MAPPED_HISTORIZER)
+#include "quamappedhistorizer.h"
+#elif defined(TIERED_HISTORIZER)
+#include "quatieredhistorizer.h"
 #include "quasqlitehistorizer.h"
-#endif // !SQLITE_HISTORIZER
+#else
+#include "quainmemoryhistorizer.h"
+#endif // SQLITE_HISTORIZER
 #endif // UA_ENABLE_HISTORIZING
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
@@ -35,7 +44,39 @@ int main(int argc, char* argv[])
 
 #ifdef UA_ENABLE_HISTORIZING
 	// set historizer (must live at least as long as the server)
-#ifndef SQLITE_HISTORIZER
+#if defined(COMPRESSED_HISTORIZER)
+	QUaCompressedHistorizer historizer;
+#elif defined(RING_HISTORIZER)
+	// keep the last 1000 data points per variable, and 1 minute averages of older ones for a day
+	QUaRingHistorizer historizer;
+	historizer.setDefaultRetention({ 1000, 60 * 1000, 24 * 60 });
+#elif defined(MAPPED_HISTORIZER)
+	QUaMappedHistorizer historizer;
+	QQueue<QUaLog> logOut;
+	if (!historizer.setPath("history", logOut))
+	{
+		for (auto log : logOut)
+		{
+			qDebug() << "[" << log.level << "] :" << log.message;
+		}
+		return -1;
+	}
+#elif defined(TIERED_HISTORIZER)
+	// last hour in memory, older data points moved to sqlite
+	// NOTE : cold historizer must live at least as long as the tiered one
+	QUaSqliteHistorizer coldHistorizer;
+	QQueue<QUaLog> logOut;
+	if (!coldHistorizer.setSqliteDbName("history.sqlite", logOut))
+	{
+		for (auto log : logOut)
+		{
+			qDebug() << "[" << log.level << "] :" << log.message;
+		}
+		return -1;
+	}
+	QUaTieredHistorizer historizer;
+	historizer.setColdHistorizer(coldHistorizer);
+#elif !defined(SQLITE_HISTORIZER)
 	QUaInMemoryHistorizer historizer;
 #else
 	QUaSqliteHistorizer historizer;
@@ -49,7 +90,7 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 	historizer.setTransactionTimeout(2 * 1000); // db transaction every 2 secs
-#endif // !SQLITE_HISTORIZER
+#endif // COMPRESSED_HISTORIZER
 
 	// set the historizer
 	// NOTE : historizer must live at least as long as server
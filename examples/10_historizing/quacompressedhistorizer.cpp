@@ -0,0 +1,772 @@
+#include "quacompressedhistorizer.h"
+#include "quanumericbits.h"
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <QtAlgorithms>
+
+QUaCompressedHistorizer::QUaCompressedHistorizer()
+{
+	m_chunkSize  = 1024;
+	m_cacheChunk = nullptr;
+}
+
+int QUaCompressedHistorizer::chunkSize() const
+{
+	return m_chunkSize;
+}
+
+void QUaCompressedHistorizer::setChunkSize(const int& chunkSize)
+{
+	// NOTE : only applies to new chunks
+	m_chunkSize = (std::max)(2, chunkSize);
+}
+
+quint64 QUaCompressedHistorizer::dataPointCount() const
+{
+	quint64 count = 0;
+	for (const auto& series : m_database)
+	{
+		for (const auto& chunk : series)
+		{
+			count += static_cast<quint64>(chunk.count);
+		}
+	}
+	return count;
+}
+
+quint64 QUaCompressedHistorizer::dataPointBytes() const
+{
+	quint64 bytes = 0;
+	for (const auto& series : m_database)
+	{
+		for (const auto& chunk : series)
+		{
+			bytes += sizeof(Chunk);
+			bytes += static_cast<quint64>(chunk.times.bytes.size());
+			bytes += static_cast<quint64>(chunk.statuses.bytes.size());
+			bytes += static_cast<quint64>(chunk.values.bytes.size());
+			bytes += static_cast<quint64>(chunk.generic.size()) * sizeof(QVariant);
+		}
+	}
+	return bytes;
+}
+
+bool QUaCompressedHistorizer::writeHistoryData(
+	const QUaNodeId &nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	Q_UNUSED(logOut);
+	m_cacheChunk = nullptr;
+	auto& series = m_database[nodeId];
+	Sample sample = {
+		dataPoint.timestamp.toMSecsSinceEpoch(),
+		dataPoint.value,
+		dataPoint.status
+	};
+	// fast path, data points usually arrive in order
+	if (series.isEmpty() || sample.time > series.last().timeLast)
+	{
+		this->appendSample(series, sample);
+		return true;
+	}
+	this->insertSample(series, sample);
+	return true;
+}
+
+bool QUaCompressedHistorizer::writeHistoryDataRaw(
+	const UA_NodeId& nodeId,
+	const UA_DateTime& timestamp,
+	const UA_Variant& value,
+	const UA_StatusCode& status,
+	QQueue<QUaLog>& logOut)
+{
+	int type;
+	quint64 bits;
+	if (QUaNumericBits::valueToBits(value, type, bits))
+	{
+		// same truncation as QUaTypesConverter
+		qint64 time = timestamp / UA_DATETIME_MSEC - UA_DATETIME_UNIX_EPOCH / UA_DATETIME_MSEC;
+		m_cacheChunk = nullptr;
+		auto& series = m_database[nodeId];
+		if (series.isEmpty() || time > series.last().timeLast)
+		{
+			this->appendValue(series, time, status, type, bits, QVariant());
+			return true;
+		}
+	}
+	// other types and out of order data points
+	return this->writeHistoryData(nodeId, {
+		QUaTypesConverter::uaVariantToQVariantScalar<QDateTime, UA_DateTime>(&timestamp),
+		QUaTypesConverter::uaVariantToQVariant(value),
+		status
+	}, logOut);
+}
+
+bool QUaCompressedHistorizer::updateHistoryData(
+	const QUaNodeId &nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	Q_ASSERT(
+		m_database.contains(nodeId) &&
+		this->hasTimestamp(nodeId, dataPoint.timestamp, logOut)
+	);
+	return this->writeHistoryData(nodeId, dataPoint, logOut);
+}
+
+bool QUaCompressedHistorizer::removeHistoryData(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QQueue<QUaLog>& logOut)
+{
+	Q_ASSERT(timeStart <= timeEnd || !timeEnd.isValid());
+	if (!m_database.contains(nodeId))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error removing history data. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return false;
+	}
+	m_cacheChunk = nullptr;
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	qint64 end   = timeEnd.isValid() ? timeEnd.toMSecsSinceEpoch() : (std::numeric_limits<qint64>::max)();
+	const auto& series = m_database[nodeId];
+	ChunkSeries result;
+	for (const auto& chunk : series)
+	{
+		// untouched
+		if (chunk.timeLast < start || chunk.timeFirst > end)
+		{
+			result << chunk;
+			continue;
+		}
+		// removed whole
+		if (chunk.timeFirst >= start && chunk.timeLast <= end)
+		{
+			continue;
+		}
+		// partially removed, re-encode the rest
+		QVector<Sample> samples;
+		const auto decoded = QUaCompressedHistorizer::decodeSamples(chunk);
+		for (const auto& sample : decoded)
+		{
+			if (sample.time < start || sample.time > end)
+			{
+				samples << sample;
+			}
+		}
+		result << this->encodeSamples(samples);
+	}
+	m_database[nodeId] = result;
+	return true;
+}
+
+QDateTime QUaCompressedHistorizer::firstTimestamp(
+	const QUaNodeId &nodeId,
+	QQueue<QUaLog>& logOut) const
+{
+	if (!m_database.contains(nodeId) || m_database[nodeId].isEmpty())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding first history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	return QDateTime::fromMSecsSinceEpoch(m_database[nodeId].first().timeFirst, Qt::UTC);
+}
+
+QDateTime QUaCompressedHistorizer::lastTimestamp(
+	const QUaNodeId &nodeId,
+	QQueue<QUaLog>& logOut) const
+{
+	if (!m_database.contains(nodeId) || m_database[nodeId].isEmpty())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding most recent history timstamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	return QDateTime::fromMSecsSinceEpoch(m_database[nodeId].last().timeLast, Qt::UTC);
+}
+
+bool QUaCompressedHistorizer::hasTimestamp(
+	const QUaNodeId &nodeId,
+	const QDateTime& timestamp,
+	QQueue<QUaLog>& logOut) const
+{
+	if (!m_database.contains(nodeId))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return false;
+	}
+	qint64 time = timestamp.toMSecsSinceEpoch();
+	// NOTE : reference to stored series, its chunks are cached by address
+	const auto& series = *m_database.constFind(nodeId);
+	int index = QUaCompressedHistorizer::chunkAtOrAfter(series, time);
+	if (index >= series.count() || series.at(index).timeFirst > time)
+	{
+		return false;
+	}
+	const auto& times = this->chunkTimes(series.at(index));
+	return std::binary_search(times.begin(), times.end(), time);
+}
+
+QDateTime QUaCompressedHistorizer::findTimestamp(
+	const QUaNodeId &nodeId,
+	const QDateTime& timestamp,
+	const QUaHistoryBackend::TimeMatch& match,
+	QQueue<QUaLog>& logOut) const
+{
+	if (!m_database.contains(nodeId))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	// NOTE : the database might or might not contain the input timestamp
+	qint64 time = timestamp.toMSecsSinceEpoch();
+	const auto& series = *m_database.constFind(nodeId);
+	switch (match)
+	{
+	case QUaHistoryBackend::TimeMatch::ClosestFromAbove:
+	{
+		// first timestamp greater than input, in the first chunk which ends after input
+		int index = QUaCompressedHistorizer::chunkAtOrAfter(series, time + 1);
+		if (index < series.count())
+		{
+			const auto& times = this->chunkTimes(series.at(index));
+			auto iter = std::upper_bound(times.begin(), times.end(), time);
+			Q_ASSERT(iter != times.end());
+			return QDateTime::fromMSecsSinceEpoch(*iter, Qt::UTC);
+		}
+		// if there is none return last
+		return this->lastTimestamp(nodeId, logOut);
+	}
+	break;
+	case QUaHistoryBackend::TimeMatch::ClosestFromBelow:
+	{
+		// last timestamp lower than input, in the last chunk which starts before input
+		auto iterChunk = std::lower_bound(series.begin(), series.end(), time,
+		[](const Chunk& chunk, const qint64& key) {
+			return chunk.timeFirst < key;
+		});
+		if (iterChunk != series.begin())
+		{
+			--iterChunk;
+			const auto& times = this->chunkTimes(*iterChunk);
+			auto iter = std::lower_bound(times.begin(), times.end(), time);
+			Q_ASSERT(iter != times.begin());
+			return QDateTime::fromMSecsSinceEpoch(*(--iter), Qt::UTC);
+		}
+		// if there is none return first
+		return this->firstTimestamp(nodeId, logOut);
+	}
+	break;
+	default:
+		Q_ASSERT(false);
+		break;
+	}
+	return QDateTime();
+}
+
+quint64 QUaCompressedHistorizer::numDataPointsInRange(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QQueue<QUaLog>& logOut) const
+{
+	if (!m_database.contains(nodeId))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history points. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return 0;
+	}
+	// if the end timestamp is invalid, it means the API is requesting up to the most recent timestamp
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	qint64 end   = timeEnd.isValid() ? timeEnd.toMSecsSinceEpoch() : (std::numeric_limits<qint64>::max)();
+	const auto& series = *m_database.constFind(nodeId);
+	quint64 count = 0;
+	for (int i = QUaCompressedHistorizer::chunkAtOrAfter(series, start); i < series.count(); i++)
+	{
+		const auto& chunk = series.at(i);
+		if (chunk.timeFirst > end)
+		{
+			break;
+		}
+		// whole chunk in range, no need to decode
+		if (chunk.timeFirst >= start && chunk.timeLast <= end)
+		{
+			count += static_cast<quint64>(chunk.count);
+			continue;
+		}
+		const auto& times = this->chunkTimes(chunk);
+		auto iterIni = std::lower_bound(times.begin(), times.end(), start);
+		auto iterEnd = std::upper_bound(iterIni  , times.end(), end);
+		count += static_cast<quint64>(std::distance(iterIni, iterEnd));
+	}
+	return count;
+}
+
+QVector<QUaHistoryDataPoint> QUaCompressedHistorizer::readHistoryData(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const quint64& numPointsOffset,
+	const quint64& numPointsToRead,
+	QQueue<QUaLog>& logOut) const
+{
+	auto points = QVector<QUaHistoryDataPoint>();
+	if (!m_database.contains(nodeId))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error reading history data. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return points;
+	}
+	const auto& series = *m_database.constFind(nodeId);
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	// position of start timestamp
+	int i = QUaCompressedHistorizer::chunkAtOrAfter(series, start);
+	quint64 skip = numPointsOffset;
+	if (i < series.count())
+	{
+		const auto& times = this->chunkTimes(series.at(i));
+		skip += static_cast<quint64>(std::distance(
+			times.begin(),
+			std::lower_bound(times.begin(), times.end(), start)
+		));
+	}
+	// apply offset, skipping whole chunks without decoding
+	while (i < series.count() && skip >= static_cast<quint64>(series.at(i).count))
+	{
+		skip -= static_cast<quint64>(series.at(i).count);
+		i++;
+	}
+	// copy return data points
+	points.reserve(static_cast<int>(numPointsToRead));
+	for (; i < series.count() && static_cast<quint64>(points.count()) < numPointsToRead; i++)
+	{
+		const auto samples = QUaCompressedHistorizer::decodeSamples(series.at(i));
+		for (int j = static_cast<int>(skip); j < samples.count() && static_cast<quint64>(points.count()) < numPointsToRead; j++)
+		{
+			const auto& sample = samples.at(j);
+			points.append({
+				QDateTime::fromMSecsSinceEpoch(sample.time, Qt::UTC),
+				sample.value,
+				sample.status
+			});
+		}
+		skip = 0;
+	}
+	// NOTE : return invalid values if API requests more values than available
+	points.resize(static_cast<int>(numPointsToRead));
+	return points;
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+bool QUaCompressedHistorizer::writeHistoryEventsOfType(
+	const QUaNodeId            &eventTypeNodeId,
+	const QList<QUaNodeId>     &emittersNodeIds,
+	const QUaHistoryEventPoint &eventPoint,
+	QQueue<QUaLog>             &logOut
+)
+{
+	return m_events.writeHistoryEventsOfType(eventTypeNodeId, emittersNodeIds, eventPoint, logOut);
+}
+
+QVector<QUaNodeId> QUaCompressedHistorizer::eventTypesOfEmitter(
+	const QUaNodeId &emitterNodeId,
+	QQueue<QUaLog>  &logOut
+)
+{
+	return m_events.eventTypesOfEmitter(emitterNodeId, logOut);
+}
+
+QDateTime QUaCompressedHistorizer::findTimestampEventOfType(
+	const QUaNodeId                    &emitterNodeId,
+	const QUaNodeId                    &eventTypeNodeId,
+	const QDateTime                    &timestamp,
+	const QUaHistoryBackend::TimeMatch &match,
+	QQueue<QUaLog>                     &logOut
+)
+{
+	return m_events.findTimestampEventOfType(emitterNodeId, eventTypeNodeId, timestamp, match, logOut);
+}
+
+quint64 QUaCompressedHistorizer::numEventsOfTypeInRange(
+	const QUaNodeId &emitterNodeId,
+	const QUaNodeId &eventTypeNodeId,
+	const QDateTime &timeStart,
+	const QDateTime &timeEnd,
+	QQueue<QUaLog>  &logOut
+)
+{
+	return m_events.numEventsOfTypeInRange(emitterNodeId, eventTypeNodeId, timeStart, timeEnd, logOut);
+}
+
+QVector<QUaHistoryEventPoint> QUaCompressedHistorizer::readHistoryEventsOfType(
+	const QUaNodeId &emitterNodeId,
+	const QUaNodeId &eventTypeNodeId,
+	const QDateTime &timeStart,
+	const quint64   &numPointsOffset,
+	const quint64   &numPointsToRead,
+	const QList<QUaBrowsePath> &columnsToRead,
+	QQueue<QUaLog>  &logOut
+)
+{
+	return m_events.readHistoryEventsOfType(
+		emitterNodeId,
+		eventTypeNodeId,
+		timeStart,
+		numPointsOffset,
+		numPointsToRead,
+		columnsToRead,
+		logOut
+	);
+}
+
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+const QVector<qint64>& QUaCompressedHistorizer::chunkTimes(const Chunk& chunk) const
+{
+	if (m_cacheChunk != &chunk)
+	{
+		m_cacheTimes = QUaCompressedHistorizer::decodeTimes(chunk);
+		m_cacheChunk = &chunk;
+	}
+	return m_cacheTimes;
+}
+
+void QUaCompressedHistorizer::insertSample(ChunkSeries& series, const Sample& sample)
+{
+	// decode the chunk where it belongs, insert or overwrite, and encode it again
+	int index = QUaCompressedHistorizer::chunkAtOrAfter(series, sample.time);
+	Q_ASSERT(index < series.count());
+	auto samples = QUaCompressedHistorizer::decodeSamples(series.at(index));
+	auto iter = std::lower_bound(samples.begin(), samples.end(), sample.time,
+	[](const Sample& other, const qint64& key) {
+		return other.time < key;
+	});
+	if (iter != samples.end() && iter->time == sample.time)
+	{
+		*iter = sample;
+	}
+	else
+	{
+		samples.insert(iter, sample);
+	}
+	// might be split if full or if the value type differs
+	auto chunks = this->encodeSamples(samples);
+	series.remove(index);
+	for (int i = 0; i < chunks.count(); i++)
+	{
+		series.insert(index + i, chunks.at(i));
+	}
+}
+
+void QUaCompressedHistorizer::appendSample(ChunkSeries& series, const Sample& sample) const
+{
+	int type = sample.value.userType();
+	quint64 bits = QUaNumericBits::isNumericType(type) ?
+		QUaNumericBits::valueToBits(sample.value, type) : 0;
+	this->appendValue(series, sample.time, sample.status, type, bits, sample.value);
+}
+
+void QUaCompressedHistorizer::appendValue(
+	ChunkSeries& series,
+	const qint64& time,
+	const quint32& status,
+	const int& type,
+	const quint64& bits,
+	const QVariant& value) const
+{
+	Q_ASSERT(series.isEmpty() || time > series.last().timeLast);
+	bool numeric = QUaNumericBits::isNumericType(type);
+	// start a new chunk if full or if the value type changes
+	if (series.isEmpty() ||
+		series.last().count >= m_chunkSize ||
+		series.last().type != type)
+	{
+		Chunk chunk;
+		chunk.timeFirst = time;
+		chunk.timeLast  = time;
+		chunk.count     = 1;
+		chunk.type      = type;
+		chunk.times.bitCount    = 0;
+		chunk.statuses.bitCount = 0;
+		chunk.values.bitCount   = 0;
+		chunk.lastDelta    = 0;
+		chunk.lastBits     = 0;
+		chunk.lastStatus   = status;
+		chunk.lastLeading  = -1;
+		chunk.lastTrailing = -1;
+		// first timestamp is timeFirst, first status and value are stored whole
+		QUaCompressedHistorizer::writeBits(chunk.statuses, status, 32);
+		if (numeric)
+		{
+			chunk.lastBits = bits;
+			QUaCompressedHistorizer::writeBits(chunk.values, chunk.lastBits, 64);
+		}
+		else
+		{
+			chunk.generic << value;
+		}
+		series << chunk;
+		return;
+	}
+	Chunk& chunk = series.last();
+	// timestamp, delta of delta
+	qint64 delta = time - chunk.timeLast;
+	qint64 dod   = delta - chunk.lastDelta;
+	if (dod == 0)
+	{
+		QUaCompressedHistorizer::writeBits(chunk.times, 0x0, 1);
+	}
+	else if (dod >= -63 && dod <= 64)
+	{
+		QUaCompressedHistorizer::writeBits(chunk.times, 0x2, 2);
+		QUaCompressedHistorizer::writeBits(chunk.times, static_cast<quint64>(dod + 63), 7);
+	}
+	else if (dod >= -255 && dod <= 256)
+	{
+		QUaCompressedHistorizer::writeBits(chunk.times, 0x6, 3);
+		QUaCompressedHistorizer::writeBits(chunk.times, static_cast<quint64>(dod + 255), 9);
+	}
+	else if (dod >= -2047 && dod <= 2048)
+	{
+		QUaCompressedHistorizer::writeBits(chunk.times, 0xE, 4);
+		QUaCompressedHistorizer::writeBits(chunk.times, static_cast<quint64>(dod + 2047), 12);
+	}
+	else
+	{
+		QUaCompressedHistorizer::writeBits(chunk.times, 0xF, 4);
+		QUaCompressedHistorizer::writeBits(chunk.times, static_cast<quint64>(dod), 64);
+	}
+	chunk.lastDelta = delta;
+	chunk.timeLast  = time;
+	// status, repeated or new
+	if (status == chunk.lastStatus)
+	{
+		QUaCompressedHistorizer::writeBits(chunk.statuses, 0x0, 1);
+	}
+	else
+	{
+		QUaCompressedHistorizer::writeBits(chunk.statuses, 0x1, 1);
+		QUaCompressedHistorizer::writeBits(chunk.statuses, status, 32);
+		chunk.lastStatus = status;
+	}
+	chunk.count++;
+	if (!numeric)
+	{
+		chunk.generic << value;
+		return;
+	}
+	// value, xor with previous
+	quint64 xorBits = bits ^ chunk.lastBits;
+	chunk.lastBits = bits;
+	if (xorBits == 0)
+	{
+		QUaCompressedHistorizer::writeBits(chunk.values, 0x0, 1);
+		return;
+	}
+	QUaCompressedHistorizer::writeBits(chunk.values, 0x1, 1);
+	int leading  = (std::min)(31, static_cast<int>(qCountLeadingZeroBits(xorBits)));
+	int trailing = static_cast<int>(qCountTrailingZeroBits(xorBits));
+	// reuse previous window of meaningful bits if it fits
+	if (chunk.lastLeading >= 0 && leading >= chunk.lastLeading && trailing >= chunk.lastTrailing)
+	{
+		QUaCompressedHistorizer::writeBits(chunk.values, 0x0, 1);
+		int length = 64 - chunk.lastLeading - chunk.lastTrailing;
+		QUaCompressedHistorizer::writeBits(chunk.values, xorBits >> chunk.lastTrailing, length);
+		return;
+	}
+	int length = 64 - leading - trailing;
+	QUaCompressedHistorizer::writeBits(chunk.values, 0x1, 1);
+	QUaCompressedHistorizer::writeBits(chunk.values, static_cast<quint64>(leading), 5);
+	// NOTE : length is in [1, 64], 64 is stored as 0
+	QUaCompressedHistorizer::writeBits(chunk.values, static_cast<quint64>(length & 0x3F), 6);
+	QUaCompressedHistorizer::writeBits(chunk.values, xorBits >> trailing, length);
+	chunk.lastLeading  = leading;
+	chunk.lastTrailing = trailing;
+}
+
+QUaCompressedHistorizer::ChunkSeries QUaCompressedHistorizer::encodeSamples(const QVector<Sample>& samples) const
+{
+	ChunkSeries series;
+	for (const auto& sample : samples)
+	{
+		this->appendSample(series, sample);
+	}
+	return series;
+}
+
+QVector<QUaCompressedHistorizer::Sample> QUaCompressedHistorizer::decodeSamples(const Chunk& chunk)
+{
+	QVector<Sample> samples;
+	samples.reserve(chunk.count);
+	const auto times = QUaCompressedHistorizer::decodeTimes(chunk);
+	bool numeric = QUaNumericBits::isNumericType(chunk.type);
+	quint64 posStatus = 0;
+	quint64 posValue  = 0;
+	quint32 status    = 0;
+	quint64 bits      = 0;
+	int leading  = 0;
+	int trailing = 0;
+	for (int i = 0; i < chunk.count; i++)
+	{
+		// status
+		if (i == 0 || QUaCompressedHistorizer::readBits(chunk.statuses, posStatus, 1) == 0x1)
+		{
+			status = static_cast<quint32>(QUaCompressedHistorizer::readBits(chunk.statuses, posStatus, 32));
+		}
+		if (!numeric)
+		{
+			samples.append({ times.at(i), chunk.generic.at(i), status });
+			continue;
+		}
+		// value
+		if (i == 0)
+		{
+			bits = QUaCompressedHistorizer::readBits(chunk.values, posValue, 64);
+		}
+		else if (QUaCompressedHistorizer::readBits(chunk.values, posValue, 1) == 0x1)
+		{
+			if (QUaCompressedHistorizer::readBits(chunk.values, posValue, 1) == 0x1)
+			{
+				leading    = static_cast<int>(QUaCompressedHistorizer::readBits(chunk.values, posValue, 5));
+				int length = static_cast<int>(QUaCompressedHistorizer::readBits(chunk.values, posValue, 6));
+				length     = length == 0 ? 64 : length;
+				trailing   = 64 - leading - length;
+			}
+			int length = 64 - leading - trailing;
+			bits ^= QUaCompressedHistorizer::readBits(chunk.values, posValue, length) << trailing;
+		}
+		samples.append({ times.at(i), QUaNumericBits::bitsToValue(bits, chunk.type), status });
+	}
+	return samples;
+}
+
+QVector<qint64> QUaCompressedHistorizer::decodeTimes(const Chunk& chunk)
+{
+	QVector<qint64> times;
+	times.reserve(chunk.count);
+	quint64 pos   = 0;
+	qint64  time  = chunk.timeFirst;
+	qint64  delta = 0;
+	times.append(time);
+	for (int i = 1; i < chunk.count; i++)
+	{
+		qint64 dod = 0;
+		if (QUaCompressedHistorizer::readBits(chunk.times, pos, 1) == 0x1)
+		{
+			if (QUaCompressedHistorizer::readBits(chunk.times, pos, 1) == 0x0)
+			{
+				dod = static_cast<qint64>(QUaCompressedHistorizer::readBits(chunk.times, pos, 7)) - 63;
+			}
+			else if (QUaCompressedHistorizer::readBits(chunk.times, pos, 1) == 0x0)
+			{
+				dod = static_cast<qint64>(QUaCompressedHistorizer::readBits(chunk.times, pos, 9)) - 255;
+			}
+			else if (QUaCompressedHistorizer::readBits(chunk.times, pos, 1) == 0x0)
+			{
+				dod = static_cast<qint64>(QUaCompressedHistorizer::readBits(chunk.times, pos, 12)) - 2047;
+			}
+			else
+			{
+				dod = static_cast<qint64>(QUaCompressedHistorizer::readBits(chunk.times, pos, 64));
+			}
+		}
+		delta += dod;
+		time  += delta;
+		times.append(time);
+	}
+	Q_ASSERT(time == chunk.timeLast);
+	return times;
+}
+
+int QUaCompressedHistorizer::chunkAtOrAfter(const ChunkSeries& series, const qint64& time)
+{
+	auto iter = std::lower_bound(series.begin(), series.end(), time,
+	[](const Chunk& chunk, const qint64& key) {
+		return chunk.timeLast < key;
+	});
+	return static_cast<int>(std::distance(series.begin(), iter));
+}
+
+void QUaCompressedHistorizer::writeBits(BitStream& stream, const quint64& value, const int& numBits)
+{
+	// most significant bit first
+	int remaining = numBits;
+	while (remaining > 0)
+	{
+		int bitOffset = static_cast<int>(stream.bitCount & 0x7);
+		if (bitOffset == 0)
+		{
+			stream.bytes.append('\0');
+		}
+		int free  = 8 - bitOffset;
+		int take  = (std::min)(free, remaining);
+		quint8 part = static_cast<quint8>((value >> (remaining - take)) & ((1u << take) - 1));
+		stream.bytes.data()[stream.bitCount >> 3] |= static_cast<char>(part << (free - take));
+		remaining       -= take;
+		stream.bitCount += static_cast<quint64>(take);
+	}
+}
+
+quint64 QUaCompressedHistorizer::readBits(const BitStream& stream, quint64& pos, const int& numBits)
+{
+	Q_ASSERT(pos + static_cast<quint64>(numBits) <= stream.bitCount);
+	quint64 value = 0;
+	int remaining = numBits;
+	while (remaining > 0)
+	{
+		int bitOffset = static_cast<int>(pos & 0x7);
+		int avail = 8 - bitOffset;
+		int take  = (std::min)(avail, remaining);
+		quint8 byte = static_cast<quint8>(stream.bytes.constData()[pos >> 3]);
+		value = (value << take) | ((byte >> (avail - take)) & ((1u << take) - 1));
+		remaining -= take;
+		pos       += static_cast<quint64>(take);
+	}
+	return value;
+}
+
+#endif // UA_ENABLE_HISTORIZING
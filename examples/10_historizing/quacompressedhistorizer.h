@@ -0,0 +1,221 @@
+#ifndef QUACOMPRESSEDHISTORIZER_H
+#define QUACOMPRESSEDHISTORIZER_H
+
+#include <QUaHistoryBackend>
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include "quainmemoryhistorizer.h"
+
+// in-memory historizer which stores the data points of each node in compressed chunks,
+// timestamps (ms) with delta-of-delta encoding, numeric values with XOR (Gorilla) encoding
+// and statuses as repeated or new, values of other types are kept as they are
+// NOTE : events are stored uncompressed, as in QUaInMemoryHistorizer
+class QUaCompressedHistorizer
+{
+public:
+	QUaCompressedHistorizer();
+
+	// maximum number of data points per chunk, reads and out of order writes
+	// decode a whole chunk (default 1024)
+	int  chunkSize() const;
+	void setChunkSize(const int& chunkSize);
+
+	// number of stored data points, of all nodes
+	quint64 dataPointCount() const;
+	// approximate memory used by the stored data points, of all nodes
+	quint64 dataPointBytes() const;
+
+	// required API for QUaServer::setHistorizer
+	// write data point to backend, return true on success
+	bool writeHistoryData(
+		const QUaNodeId &nodeId,
+		const QUaHistoryDataPoint& dataPoint,
+		QQueue<QUaLog>& logOut
+	);
+	// optional API for QUaServer::setHistorizer
+	// write a data value as received by the server, numeric scalars written in order are
+	// encoded without converting them to QDateTime and QVariant
+	bool writeHistoryDataRaw(
+		const UA_NodeId     &nodeId,
+		const UA_DateTime   &timestamp,
+		const UA_Variant    &value,
+		const UA_StatusCode &status,
+		QQueue<QUaLog>      &logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// update an existing node's data point in backend, return true on success
+	bool updateHistoryData(
+		const QUaNodeId &nodeId,
+		const QUaHistoryDataPoint& dataPoint,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// remove an existing node's data points within a range, return true on success
+	bool removeHistoryData(
+		const QUaNodeId &nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// return the timestamp of the first sample available for the given node
+	QDateTime firstTimestamp(
+		const QUaNodeId &nodeId,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the timestamp of the latest sample available for the given node
+	QDateTime lastTimestamp(
+		const QUaNodeId &nodeId,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return true if given timestamp is available for the given node
+	bool hasTimestamp(
+		const QUaNodeId &nodeId,
+		const QDateTime& timestamp,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return a timestamp matching the criteria for the given node
+	QDateTime findTimestamp(
+		const QUaNodeId &nodeId,
+		const QDateTime& timestamp,
+		const QUaHistoryBackend::TimeMatch& match,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the number for data points within a time range for the given node
+	quint64 numDataPointsInRange(
+		const QUaNodeId &nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the numPointsToRead data points for the given node from the given start time
+	QVector<QUaHistoryDataPoint> readHistoryData(
+		const QUaNodeId & nodeId,
+		const QDateTime &timeStart,
+		const quint64   &numPointsOffset,
+		const quint64   &numPointsToRead,
+		QQueue<QUaLog>  &logOut
+	) const;
+
+	// event history support
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// write a event's data to backend
+	bool writeHistoryEventsOfType(
+		const QUaNodeId            &eventTypeNodeId,
+		const QList<QUaNodeId>     &emittersNodeIds,
+		const QUaHistoryEventPoint &eventPoint,
+		QQueue<QUaLog>             &logOut
+	);
+	// get event types (node ids) for which there are events stored for the
+	// given emitter
+	QVector<QUaNodeId> eventTypesOfEmitter(
+		const QUaNodeId &emitterNodeId,
+		QQueue<QUaLog>  &logOut
+	);
+	// find a timestamp matching the criteria for the emitter and event type
+	QDateTime findTimestampEventOfType(
+		const QUaNodeId                    &emitterNodeId,
+		const QUaNodeId                    &eventTypeNodeId,
+		const QDateTime                    &timestamp,
+		const QUaHistoryBackend::TimeMatch &match,
+		QQueue<QUaLog>                     &logOut
+	);
+	// get the number for events within a time range for the given emitter and event type
+	quint64 numEventsOfTypeInRange(
+		const QUaNodeId &emitterNodeId,
+		const QUaNodeId &eventTypeNodeId,
+		const QDateTime &timeStart,
+		const QDateTime &timeEnd,
+		QQueue<QUaLog>  &logOut
+	);
+	// return the numPointsToRead events for the given emitter and event type,
+	// starting from the numPointsOffset offset after given start time (pagination)
+	QVector<QUaHistoryEventPoint> readHistoryEventsOfType(
+		const QUaNodeId &emitterNodeId,
+		const QUaNodeId &eventTypeNodeId,
+		const QDateTime &timeStart,
+		const quint64   &numPointsOffset,
+		const quint64   &numPointsToRead,
+		const QList<QUaBrowsePath> &columnsToRead,
+		QQueue<QUaLog>  &logOut
+	);
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+private:
+	// append only bit stream
+	struct BitStream
+	{
+		QByteArray bytes;
+		quint64    bitCount;
+	};
+	// consecutive data points of a node, all values of the same type,
+	// each column is compressed in its own stream
+	struct Chunk
+	{
+		qint64    timeFirst;
+		qint64    timeLast;
+		int       count;
+		int       type;
+		BitStream times;
+		BitStream statuses;
+		BitStream values;          // numeric types
+		QVector<QVariant> generic; // other types
+		// encoder state, so data points are appended without decoding
+		qint64  lastDelta;
+		quint64 lastBits;
+		quint32 lastStatus;
+		int     lastLeading;
+		int     lastTrailing;
+	};
+	struct Sample
+	{
+		qint64   time;
+		QVariant value;
+		quint32  status;
+	};
+	// NOTE : chunks of a node are ordered by time and do not overlap
+	typedef QVector<Chunk> ChunkSeries;
+	QHash<QUaNodeId, ChunkSeries> m_database;
+	int m_chunkSize;
+
+	// decoded timestamps of the last chunk searched, reused by consecutive calls of a history read
+	// NOTE : invalidated by any write
+	mutable const Chunk*    m_cacheChunk;
+	mutable QVector<qint64> m_cacheTimes;
+	const QVector<qint64>& chunkTimes(const Chunk& chunk) const;
+
+	void insertSample(ChunkSeries& series, const Sample& sample);
+	void appendSample(ChunkSeries& series, const Sample& sample) const;
+	// value is only used for non numeric types, else bits
+	void appendValue(
+		ChunkSeries& series,
+		const qint64& time,
+		const quint32& status,
+		const int& type,
+		const quint64& bits,
+		const QVariant& value
+	) const;
+	ChunkSeries encodeSamples(const QVector<Sample>& samples) const;
+	static QVector<Sample> decodeSamples(const Chunk& chunk);
+	static QVector<qint64> decodeTimes(const Chunk& chunk);
+	// first chunk which ends at or after time (series.count() if none)
+	static int chunkAtOrAfter(const ChunkSeries& series, const qint64& time);
+
+	static void    writeBits(BitStream& stream, const quint64& value, const int& numBits);
+	static quint64 readBits(const BitStream& stream, quint64& pos, const int& numBits);
+
+	// event history support
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	QUaInMemoryHistorizer m_events;
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+};
+
+#endif // UA_ENABLE_HISTORIZING
+
+#endif // QUACOMPRESSEDHISTORIZER_H
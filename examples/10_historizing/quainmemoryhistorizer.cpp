@@ -12,6 +12,38 @@ bool QUaInMemoryHistorizer::writeHistoryData(
 		dataPoint.value,
 		dataPoint.status
 	};
+	// out of order or overwritten data point
+	if (!m_rollups.add(nodeId, dataPoint))
+	{
+		this->rebuildRollups(nodeId, dataPoint.timestamp, dataPoint.timestamp);
+	}
+	return true;
+}
+
+bool QUaInMemoryHistorizer::writeHistoryDataBatch(
+	const QVector<QUaHistoryNodeDataPoint>& points,
+	QQueue<QUaLog>& logOut)
+{
+	Q_UNUSED(logOut);
+	// consecutive points of the same node look up its table once
+	const QUaNodeId* lastNodeId = nullptr;
+	DataPointTable* table = nullptr;
+	for (const auto& point : points)
+	{
+		if (!lastNodeId || !(*lastNodeId == point.nodeId))
+		{
+			lastNodeId = &point.nodeId;
+			table = &m_database[point.nodeId];
+		}
+		(*table)[point.dataPoint.timestamp] = {
+			point.dataPoint.value,
+			point.dataPoint.status
+		};
+		if (!m_rollups.add(point.nodeId, point.dataPoint))
+		{
+			this->rebuildRollups(point.nodeId, point.dataPoint.timestamp, point.dataPoint.timestamp);
+		}
+	}
 	return true;
 }
 
@@ -57,6 +89,7 @@ bool QUaInMemoryHistorizer::removeHistoryData(
 	{
 		table.erase(it);
 	}
+	this->rebuildRollups(nodeId, timeStart, timeEnd);
 	return true;
 }
 
@@ -281,6 +314,41 @@ QVector<QUaHistoryDataPoint> QUaInMemoryHistorizer::readHistoryData(
 	return points;
 }
 
+
+bool QUaInMemoryHistorizer::readHistoryRollups(
+	const QUaNodeId &nodeId,
+	const QDateTime &timeStart,
+	const QDateTime &timeEnd,
+	const qint64    &interval,
+	QVector<QUaHistoryRollup> &rollups,
+	QQueue<QUaLog>  &logOut) const
+{
+	Q_UNUSED(logOut);
+	return m_rollups.read(nodeId, timeStart, timeEnd, interval, rollups);
+}
+
+void QUaInMemoryHistorizer::rebuildRollups(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd)
+{
+	QDateTime rangeStart, rangeEnd;
+	m_rollups.rebuildRange(timeStart, timeEnd, rangeStart, rangeEnd);
+	auto& table = m_database[nodeId];
+	auto iterIni = table.lowerBound(rangeStart);
+	auto iterEnd = rangeEnd.isValid() ? table.lowerBound(rangeEnd) : table.end();
+	QVector<QUaHistoryDataPoint> points;
+	for (auto it = iterIni; it != iterEnd; it++)
+	{
+		points << QUaHistoryDataPoint({
+			it.key(),
+			it.value().value,
+			it.value().status
+		});
+	}
+	m_rollups.rebuild(nodeId, rangeStart, rangeEnd, points);
+}
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 
 bool QUaInMemoryHistorizer::writeHistoryEventsOfType(
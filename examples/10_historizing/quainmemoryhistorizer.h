@@ -16,6 +16,12 @@ public:
 		const QUaHistoryDataPoint& dataPoint,
 		QQueue<QUaLog>& logOut
 	);
+	// optional API for QUaServer::setHistorizer
+	// write a batch of data points to backend, used with QUaServer::setHistoryWriteAsync
+	bool writeHistoryDataBatch(
+		const QVector<QUaHistoryNodeDataPoint>& points,
+		QQueue<QUaLog>& logOut
+	);
 	// required API for QUaServer::setHistorizer
 	// update an existing node's data point in backend, return true on success
 	bool updateHistoryData(
@@ -75,6 +81,16 @@ public:
 		const quint64   &numPointsToRead,
 		QQueue<QUaLog>  &logOut
 	) const;
+	// optional API for QUaServer::setHistorizer
+	// return the rollups used to answer aggregate history reads (see QUaHistoryRollupTiers::read)
+	bool readHistoryRollups(
+		const QUaNodeId &nodeId,
+		const QDateTime &timeStart,
+		const QDateTime &timeEnd,
+		const qint64    &interval,
+		QVector<QUaHistoryRollup> &rollups,
+		QQueue<QUaLog>  &logOut
+	) const;
 
 	// event history support
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
@@ -129,6 +145,10 @@ private:
 	// NOTE : use a map to store the data points of a single node, ordered by time
 	typedef QMap<QDateTime, DataPoint> DataPointTable;
 	QHash<QUaNodeId, DataPointTable> m_database;
+	// 1 minute, 1 hour and 1 day rollups of numeric data points, updated on write
+	QUaHistoryRollupTiers m_rollups;
+	// recompute the rollups affected by changing the data points within a range
+	void rebuildRollups(const QUaNodeId &nodeId, const QDateTime& timeStart, const QDateTime& timeEnd);
 
 	// event history support
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
@@ -0,0 +1,1559 @@
+#include "quamappedhistorizer.h"
+#include "quanumericbits.h"
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <QDir>
+#include <QSaveFile>
+#include <QDataStream>
+
+// sparse index entry every IndexStride records of a segment
+static const int IndexStride = 64;
+// number of closed segments kept mapped for reads
+static const int MaxMapped   = 64;
+// records mapped past the last one of an open segment
+static const int GrowStep    = 4096;
+
+static const QString DataDir      = QStringLiteral("data");
+static const QString EventsDir    = QStringLiteral("events");
+static const QString NodeIdFile   = QStringLiteral("nodeid");
+static const QString RecordSuffix = QStringLiteral(".rec");
+static const QString BlobSuffix   = QStringLiteral(".blob");
+
+QUaMappedHistorizer::QUaMappedHistorizer()
+{
+	Q_STATIC_ASSERT(sizeof(Record) == 32);
+	m_segmentSize     = 1048576;
+	m_segmentInterval = 86400000;
+	m_nextDir         = 0;
+	m_maxOpenSegments = 256;
+	m_activeStamp     = 0;
+}
+
+QUaMappedHistorizer::~QUaMappedHistorizer()
+{
+	this->close();
+}
+
+QString QUaMappedHistorizer::path() const
+{
+	return m_path;
+}
+
+bool QUaMappedHistorizer::setPath(const QString& path, QQueue<QUaLog>& logOut)
+{
+	this->close();
+	m_database.clear();
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	m_events.clear();
+	m_eventDirs.clear();
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	m_nextDir = 0;
+	m_path    = path;
+	QDir dir(path);
+	if (!dir.mkpath(DataDir) || !dir.mkpath(EventsDir))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error opening history path %1. Could not create directory.")
+				.arg(path),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	bool ok = true;
+	// one directory per node, named by creation order
+	QDir dataDir(dir.filePath(DataDir));
+	for (const auto& dirName : dataDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+	{
+		m_nextDir = (std::max)(m_nextDir, dirName.toInt() + 1);
+		QString dirPath  = dataDir.filePath(dirName);
+		QUaNodeId nodeId = QUaMappedHistorizer::readNodeId(dirPath);
+		if (nodeId.isNull())
+		{
+			logOut << QUaLog({
+				QObject::tr("Ignoring history directory %1. Missing node id.")
+					.arg(dirPath),
+				QUaLogLevel::Warning,
+				QUaLogCategory::History
+			});
+			continue;
+		}
+		Series series;
+		ok = this->openSeries(series, dirPath, logOut) && ok;
+		m_database.insert(nodeId, series);
+	}
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// one directory per emitter, containing one directory per event type
+	QDir eventsDir(dir.filePath(EventsDir));
+	for (const auto& emitterName : eventsDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+	{
+		m_nextDir = (std::max)(m_nextDir, emitterName.toInt() + 1);
+		QString emitterPath     = eventsDir.filePath(emitterName);
+		QUaNodeId emitterNodeId = QUaMappedHistorizer::readNodeId(emitterPath);
+		if (emitterNodeId.isNull())
+		{
+			logOut << QUaLog({
+				QObject::tr("Ignoring history directory %1. Missing node id.")
+					.arg(emitterPath),
+				QUaLogLevel::Warning,
+				QUaLogCategory::History
+			});
+			continue;
+		}
+		m_eventDirs.insert(emitterNodeId, emitterPath);
+		auto& eventTypes = m_events[emitterNodeId];
+		QDir emitterDir(emitterPath);
+		for (const auto& typeName : emitterDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+		{
+			m_nextDir = (std::max)(m_nextDir, typeName.toInt() + 1);
+			QString dirPath           = emitterDir.filePath(typeName);
+			QUaNodeId eventTypeNodeId = QUaMappedHistorizer::readNodeId(dirPath);
+			if (eventTypeNodeId.isNull())
+			{
+				logOut << QUaLog({
+					QObject::tr("Ignoring history directory %1. Missing node id.")
+						.arg(dirPath),
+					QUaLogLevel::Warning,
+					QUaLogCategory::History
+				});
+				continue;
+			}
+			Series series;
+			ok = this->openSeries(series, dirPath, logOut) && ok;
+			eventTypes.insert(eventTypeNodeId, series);
+		}
+	}
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	return ok;
+}
+
+void QUaMappedHistorizer::close()
+{
+	m_mapped.clear();
+	m_mappedOrder.clear();
+	for (const auto& dirPath : m_active.keys())
+	{
+		this->closeActive(dirPath);
+	}
+}
+
+int QUaMappedHistorizer::segmentSize() const
+{
+	return m_segmentSize;
+}
+
+void QUaMappedHistorizer::setSegmentSize(const int& segmentSize)
+{
+	m_segmentSize = (std::max)(IndexStride, segmentSize);
+}
+
+int QUaMappedHistorizer::maxOpenSegments() const
+{
+	return m_maxOpenSegments;
+}
+
+void QUaMappedHistorizer::setMaxOpenSegments(const int& maxOpenSegments)
+{
+	m_maxOpenSegments = (std::max)(1, maxOpenSegments);
+	while (m_active.count() > m_maxOpenSegments)
+	{
+		this->closeOldestActive();
+	}
+}
+
+qint64 QUaMappedHistorizer::segmentInterval() const
+{
+	return m_segmentInterval;
+}
+
+void QUaMappedHistorizer::setSegmentInterval(const qint64& segmentInterval)
+{
+	m_segmentInterval = (std::max)(Q_INT64_C(1), segmentInterval);
+}
+
+bool QUaMappedHistorizer::writeHistoryData(
+	const QUaNodeId &nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	Series* series = this->dataSeries(nodeId, logOut);
+	if (!series)
+	{
+		return false;
+	}
+	Record record;
+	QByteArray blob;
+	QUaMappedHistorizer::encodeValue(dataPoint.value, record, blob);
+	record.time   = dataPoint.timestamp.toMSecsSinceEpoch();
+	record.status = dataPoint.status;
+	return this->write(*series, record, blob, true, logOut);
+}
+
+bool QUaMappedHistorizer::writeHistoryDataRaw(
+	const UA_NodeId& nodeId,
+	const UA_DateTime& timestamp,
+	const UA_Variant& value,
+	const UA_StatusCode& status,
+	QQueue<QUaLog>& logOut)
+{
+	int type;
+	quint64 bits;
+	if (QUaNumericBits::valueToBits(value, type, bits))
+	{
+		// same truncation as QUaTypesConverter
+		qint64 time = timestamp / UA_DATETIME_MSEC - UA_DATETIME_UNIX_EPOCH / UA_DATETIME_MSEC;
+		Series* series = this->dataSeries(nodeId, logOut);
+		if (series && (series->segments.isEmpty() || time > series->segments.last().timeLast))
+		{
+			Record record = { time, bits, status, type, 0, 0 };
+			return this->append(*series, record, QByteArray(), logOut);
+		}
+	}
+	// other types and out of order data points
+	return this->writeHistoryData(nodeId, {
+		QUaTypesConverter::uaVariantToQVariantScalar<QDateTime, UA_DateTime>(&timestamp),
+		QUaTypesConverter::uaVariantToQVariant(value),
+		status
+	}, logOut);
+}
+
+bool QUaMappedHistorizer::updateHistoryData(
+	const QUaNodeId &nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	Q_ASSERT(
+		m_database.contains(nodeId) &&
+		this->hasTimestamp(nodeId, dataPoint.timestamp, logOut)
+	);
+	return this->writeHistoryData(nodeId, dataPoint, logOut);
+}
+
+bool QUaMappedHistorizer::removeHistoryData(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QQueue<QUaLog>& logOut)
+{
+	Q_ASSERT(timeStart <= timeEnd || !timeEnd.isValid());
+	auto iter = m_database.find(nodeId);
+	if (iter == m_database.end())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error removing history data. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return false;
+	}
+	return this->remove(
+		*iter,
+		timeStart.toMSecsSinceEpoch(),
+		timeEnd.isValid() ? timeEnd.toMSecsSinceEpoch() : (std::numeric_limits<qint64>::max)(),
+		logOut
+	);
+}
+
+QDateTime QUaMappedHistorizer::firstTimestamp(
+	const QUaNodeId &nodeId,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd() || iter->segments.isEmpty())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding first history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	return QDateTime::fromMSecsSinceEpoch(iter->segments.first().timeFirst, Qt::UTC);
+}
+
+QDateTime QUaMappedHistorizer::lastTimestamp(
+	const QUaNodeId &nodeId,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd() || iter->segments.isEmpty())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding most recent history timstamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	return QDateTime::fromMSecsSinceEpoch(iter->segments.last().timeLast, Qt::UTC);
+}
+
+bool QUaMappedHistorizer::hasTimestamp(
+	const QUaNodeId &nodeId,
+	const QDateTime& timestamp,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return false;
+	}
+	qint64 time = timestamp.toMSecsSinceEpoch();
+	const Record* record = this->recordAt(*iter, this->lowerBound(*iter, time));
+	return record && record->time == time;
+}
+
+QDateTime QUaMappedHistorizer::findTimestamp(
+	const QUaNodeId &nodeId,
+	const QDateTime& timestamp,
+	const QUaHistoryBackend::TimeMatch& match,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd() || iter->segments.isEmpty())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	// NOTE : the database might or might not contain the input timestamp
+	const Series& series = *iter;
+	qint64 time = timestamp.toMSecsSinceEpoch();
+	switch (match)
+	{
+	case QUaHistoryBackend::TimeMatch::ClosestFromAbove:
+	{
+		const Record* record = this->recordAt(series, this->upperBound(series, time));
+		// if there is none return last
+		return QDateTime::fromMSecsSinceEpoch(
+			record ? record->time : series.segments.last().timeLast,
+			Qt::UTC
+		);
+	}
+	break;
+	case QUaHistoryBackend::TimeMatch::ClosestFromBelow:
+	{
+		Position position = this->lowerBound(series, time);
+		const Record* record = this->previous(series, position) ?
+			this->recordAt(series, position) : nullptr;
+		// if there is none return first
+		return QDateTime::fromMSecsSinceEpoch(
+			record ? record->time : series.segments.first().timeFirst,
+			Qt::UTC
+		);
+	}
+	break;
+	default:
+		Q_ASSERT(false);
+		break;
+	}
+	return QDateTime();
+}
+
+quint64 QUaMappedHistorizer::numDataPointsInRange(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history points. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return 0;
+	}
+	return this->rangeCount(*iter, timeStart, timeEnd);
+}
+
+QVector<QUaHistoryDataPoint> QUaMappedHistorizer::readHistoryData(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const quint64& numPointsOffset,
+	const quint64& numPointsToRead,
+	QQueue<QUaLog>& logOut) const
+{
+	auto points = QVector<QUaHistoryDataPoint>();
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error reading history data. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return points;
+	}
+	const Series& series = *iter;
+	// position of start timestamp plus offset
+	Position position = this->lowerBound(series, timeStart.toMSecsSinceEpoch());
+	this->advance(series, position, numPointsOffset);
+	points.reserve(static_cast<int>(numPointsToRead));
+	while (position.segment < series.segments.count() &&
+		static_cast<quint64>(points.count()) < numPointsToRead)
+	{
+		const Record* records = this->segmentRecords(series, position.segment);
+		int count = records ? series.segments.at(position.segment).count : 0;
+		for (; position.index < count && static_cast<quint64>(points.count()) < numPointsToRead; position.index++)
+		{
+			const Record& record = records[position.index];
+			points.append({
+				QDateTime::fromMSecsSinceEpoch(record.time, Qt::UTC),
+				this->decodeValue(series, position.segment, record),
+				record.status
+			});
+		}
+		if (position.index >= count)
+		{
+			position.segment++;
+			position.index = 0;
+		}
+	}
+	// NOTE : return invalid values if API requests more values than available
+	points.resize(static_cast<int>(numPointsToRead));
+	return points;
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+bool QUaMappedHistorizer::writeHistoryEventsOfType(
+	const QUaNodeId            &eventTypeNodeId,
+	const QList<QUaNodeId>     &emittersNodeIds,
+	const QUaHistoryEventPoint &eventPoint,
+	QQueue<QUaLog>             &logOut
+)
+{
+	// same fields stored once per emitter, so each series is read on its own
+	QByteArray blob = QUaMappedHistorizer::encodeEvent(eventPoint);
+	qint64 time = eventPoint.timestamp.toMSecsSinceEpoch();
+	bool ok = true;
+	for (const auto& emitterNodeId : emittersNodeIds)
+	{
+		Series* series = this->eventSeries(emitterNodeId, eventTypeNodeId, true, logOut);
+		if (!series)
+		{
+			ok = false;
+			continue;
+		}
+		Record record = { time, 0, 0, 0, 0, 0 };
+		ok = this->write(*series, record, blob, false, logOut) && ok;
+	}
+	return ok;
+}
+
+QVector<QUaNodeId> QUaMappedHistorizer::eventTypesOfEmitter(
+	const QUaNodeId &emitterNodeId,
+	QQueue<QUaLog>  &logOut
+)
+{
+	if (!m_events.contains(emitterNodeId))
+	{
+		logOut << QUaLog({
+			QObject::tr("No event types stored for emitter %1.")
+				.arg(emitterNodeId),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+	}
+	return m_events.value(emitterNodeId).keys().toVector();
+}
+
+QDateTime QUaMappedHistorizer::findTimestampEventOfType(
+	const QUaNodeId                    &emitterNodeId,
+	const QUaNodeId                    &eventTypeNodeId,
+	const QDateTime                    &timestamp,
+	const QUaHistoryBackend::TimeMatch &match,
+	QQueue<QUaLog>                     &logOut
+)
+{
+	Series* series = this->eventSeries(emitterNodeId, eventTypeNodeId, false, logOut);
+	if (!series)
+	{
+		logOut << QUaLog({
+			QObject::tr("No events of type %1 stored for emitter %2.")
+				.arg(eventTypeNodeId)
+				.arg(emitterNodeId),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+		return QDateTime();
+	}
+	// NOTE : the database might or might not contain the input timestamp
+	Position position = this->lowerBound(*series, timestamp.toMSecsSinceEpoch());
+	const Record* record = nullptr;
+	switch (match)
+	{
+	case QUaHistoryBackend::TimeMatch::ClosestFromAbove:
+		record = this->recordAt(*series, position);
+		break;
+	case QUaHistoryBackend::TimeMatch::ClosestFromBelow:
+		record = this->previous(*series, position) ?
+			this->recordAt(*series, position) : nullptr;
+		break;
+	default:
+		Q_ASSERT(false);
+		break;
+	}
+	if (!record)
+	{
+		logOut << QUaLog({
+			QObject::tr("No events of type %1 stored for emitter %2 around timestamp %3.")
+				.arg(eventTypeNodeId)
+				.arg(emitterNodeId)
+				.arg(timestamp.toString()),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+		return QDateTime();
+	}
+	return QDateTime::fromMSecsSinceEpoch(record->time, Qt::UTC);
+}
+
+quint64 QUaMappedHistorizer::numEventsOfTypeInRange(
+	const QUaNodeId &emitterNodeId,
+	const QUaNodeId &eventTypeNodeId,
+	const QDateTime &timeStart,
+	const QDateTime &timeEnd,
+	QQueue<QUaLog>  &logOut
+)
+{
+	Series* series = this->eventSeries(emitterNodeId, eventTypeNodeId, false, logOut);
+	if (!series)
+	{
+		logOut << QUaLog({
+			QObject::tr("No events of type %1 stored for emitter %2.")
+				.arg(eventTypeNodeId)
+				.arg(emitterNodeId),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+		return 0;
+	}
+	return this->rangeCount(*series, timeStart, timeEnd);
+}
+
+QVector<QUaHistoryEventPoint> QUaMappedHistorizer::readHistoryEventsOfType(
+	const QUaNodeId &emitterNodeId,
+	const QUaNodeId &eventTypeNodeId,
+	const QDateTime &timeStart,
+	const quint64   &numPointsOffset,
+	const quint64   &numPointsToRead,
+	const QList<QUaBrowsePath> &columnsToRead,
+	QQueue<QUaLog>  &logOut
+)
+{
+	auto points = QVector<QUaHistoryEventPoint>();
+	Series* series = this->eventSeries(emitterNodeId, eventTypeNodeId, false, logOut);
+	if (!series)
+	{
+		logOut << QUaLog({
+			QObject::tr("No events of type %1 stored for emitter %2.")
+				.arg(eventTypeNodeId)
+				.arg(emitterNodeId),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+		return points;
+	}
+	// position of start timestamp plus offset
+	Position position = this->lowerBound(*series, timeStart.toMSecsSinceEpoch());
+	this->advance(*series, position, numPointsOffset);
+	points.reserve(static_cast<int>(numPointsToRead));
+	while (position.segment < series->segments.count() &&
+		static_cast<quint64>(points.count()) < numPointsToRead)
+	{
+		const Record* records = this->segmentRecords(*series, position.segment);
+		int count = records ? series->segments.at(position.segment).count : 0;
+		for (; position.index < count && static_cast<quint64>(points.count()) < numPointsToRead; position.index++)
+		{
+			const Record& record = records[position.index];
+			points.append({
+				QDateTime::fromMSecsSinceEpoch(record.time, Qt::UTC),
+				QUaMappedHistorizer::decodeEvent(
+					this->readBlob(*series, position.segment, record),
+					columnsToRead
+				)
+			});
+		}
+		if (position.index >= count)
+		{
+			position.segment++;
+			position.index = 0;
+		}
+	}
+	// NOTE : return invalid values if API requests more values than available
+	points.resize(static_cast<int>(numPointsToRead));
+	return points;
+}
+
+QUaMappedHistorizer::Series* QUaMappedHistorizer::eventSeries(
+	const QUaNodeId& emitterNodeId,
+	const QUaNodeId& eventTypeNodeId,
+	const bool& create,
+	QQueue<QUaLog>& logOut)
+{
+	auto emitter = m_events.find(emitterNodeId);
+	if (emitter != m_events.end())
+	{
+		auto iter = emitter->find(eventTypeNodeId);
+		if (iter != emitter->end())
+		{
+			return &*iter;
+		}
+	}
+	if (!create)
+	{
+		return nullptr;
+	}
+	QString emitterPath = m_eventDirs.value(emitterNodeId);
+	if (emitterPath.isEmpty())
+	{
+		emitterPath = this->createDir(EventsDir, emitterNodeId, logOut);
+		if (emitterPath.isEmpty())
+		{
+			return nullptr;
+		}
+		m_eventDirs.insert(emitterNodeId, emitterPath);
+	}
+	QString dirPath = this->createDir(emitterPath, eventTypeNodeId, logOut);
+	if (dirPath.isEmpty())
+	{
+		return nullptr;
+	}
+	Series series;
+	this->openSeries(series, dirPath, logOut);
+	return &*m_events[emitterNodeId].insert(eventTypeNodeId, series);
+}
+
+QByteArray QUaMappedHistorizer::encodeEvent(const QUaHistoryEventPoint& eventPoint)
+{
+	QByteArray bytes;
+	QDataStream stream(&bytes, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_9);
+	stream << static_cast<quint32>(eventPoint.fields.count());
+	for (auto iter = eventPoint.fields.begin(); iter != eventPoint.fields.end(); ++iter)
+	{
+		stream << static_cast<quint32>(iter.key().count());
+		for (const auto& name : iter.key())
+		{
+			stream << name.namespaceIndex() << name.name();
+		}
+		stream << QUaMappedHistorizer::storableValue(iter.value());
+	}
+	return bytes;
+}
+
+QHash<QUaBrowsePath, QVariant> QUaMappedHistorizer::decodeEvent(
+	const QByteArray& bytes,
+	const QList<QUaBrowsePath>& columnsToRead)
+{
+	QHash<QUaBrowsePath, QVariant> fields;
+	QDataStream stream(bytes);
+	stream.setVersion(QDataStream::Qt_5_9);
+	quint32 count = 0;
+	stream >> count;
+	for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++)
+	{
+		quint32 length = 0;
+		stream >> length;
+		QUaBrowsePath browsePath;
+		for (quint32 j = 0; j < length && stream.status() == QDataStream::Ok; j++)
+		{
+			quint16 namespaceIndex = 0;
+			QString name;
+			stream >> namespaceIndex >> name;
+			browsePath << QUaQualifiedName(namespaceIndex, name);
+		}
+		QVariant value;
+		stream >> value;
+		// empty means all columns
+		if (!columnsToRead.isEmpty() && !columnsToRead.contains(browsePath))
+		{
+			continue;
+		}
+		fields.insert(browsePath, value);
+	}
+	return fields;
+}
+
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+QUaMappedHistorizer::Series* QUaMappedHistorizer::dataSeries(
+	const QUaNodeId& nodeId,
+	QQueue<QUaLog>& logOut)
+{
+	auto iter = m_database.find(nodeId);
+	if (iter != m_database.end())
+	{
+		return &*iter;
+	}
+	QString dirPath = this->createDir(DataDir, nodeId, logOut);
+	if (dirPath.isEmpty())
+	{
+		return nullptr;
+	}
+	Series series;
+	this->openSeries(series, dirPath, logOut);
+	return &*m_database.insert(nodeId, series);
+}
+
+QString QUaMappedHistorizer::createDir(
+	const QString& parentPath,
+	const QUaNodeId& nodeId,
+	QQueue<QUaLog>& logOut)
+{
+	if (m_path.isEmpty())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error writing history. History path not set."),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return QString();
+	}
+	// node ids can be too long or contain invalid characters for a file name,
+	// so directories are numbered and the node id is stored inside
+	QDir parentDir(QDir(m_path).filePath(parentPath));
+	QString dirPath = parentDir.filePath(QString("%1").arg(m_nextDir++, 8, 10, QChar('0')));
+	QFile file(QDir(dirPath).filePath(NodeIdFile));
+	if (!parentDir.mkpath(dirPath) ||
+		!file.open(QIODevice::WriteOnly) ||
+		file.write(nodeId.toXmlString().toUtf8()) < 0)
+	{
+		logOut << QUaLog({
+			QObject::tr("Error creating history directory %1 for node id %2. %3")
+				.arg(dirPath)
+				.arg(nodeId)
+				.arg(file.errorString()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return QString();
+	}
+	return dirPath;
+}
+
+QUaNodeId QUaMappedHistorizer::readNodeId(const QString& dirPath)
+{
+	QFile file(QDir(dirPath).filePath(NodeIdFile));
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return QUaNodeId();
+	}
+	return QUaNodeId(QString::fromUtf8(file.readAll()));
+}
+
+bool QUaMappedHistorizer::openSeries(Series& series, const QString& dirPath, QQueue<QUaLog>& logOut)
+{
+	series.dirPath  = dirPath;
+	series.nextFile = 0;
+	series.segments.clear();
+	bool ok = true;
+	QDir dir(dirPath);
+	QStringList fileNames = dir.entryList({ QStringLiteral("*") + RecordSuffix }, QDir::Files, QDir::Name);
+	for (int i = 0; i < fileNames.count(); i++)
+	{
+		QString fileName = fileNames.at(i).left(fileNames.at(i).length() - RecordSuffix.length());
+		series.nextFile  = (std::max)(series.nextFile, fileName.toInt() + 1);
+		QString basePath = dir.filePath(fileName);
+		QFile file(basePath + RecordSuffix);
+		QFile blob(basePath + BlobSuffix);
+		qint64 blobSize = blob.exists() ? blob.size() : 0;
+		int count = static_cast<int>(file.size() / static_cast<qint64>(sizeof(Record)));
+		const Record* records = nullptr;
+		if (!file.open(QIODevice::ReadWrite) ||
+			(count > 0 && !(records = reinterpret_cast<const Record*>(
+				file.map(0, static_cast<qint64>(count) * static_cast<qint64>(sizeof(Record)))))))
+		{
+			logOut << QUaLog({
+				QObject::tr("Error opening history segment %1. %2")
+					.arg(file.fileName())
+					.arg(file.errorString()),
+				QUaLogLevel::Error,
+				QUaLogCategory::History
+			});
+			ok = false;
+			continue;
+		}
+		// closed segments were truncated to their records, the last one (and any segment
+		// with a damaged tail) is scanned up to the first record which is not valid
+		int valid = 0;
+		qint64 blobEnd = blobSize;
+		if (i == fileNames.count() - 1 || count == 0 ||
+			!QUaMappedHistorizer::isValid(records[count - 1], blobSize))
+		{
+			blobEnd = 0;
+			qint64 time = (std::numeric_limits<qint64>::min)();
+			for (; valid < count; valid++)
+			{
+				const Record& record = records[valid];
+				if (!QUaMappedHistorizer::isValid(record, blobSize) || record.time < time)
+				{
+					break;
+				}
+				time = record.time;
+				if (record.size > 0)
+				{
+					blobEnd = (std::max)(blobEnd, static_cast<qint64>(record.value + record.size));
+				}
+			}
+		}
+		else
+		{
+			valid = count;
+		}
+		// a zero filled tail is unused capacity, anything else was damaged by a crash
+		static const Record zero = { 0, 0, 0, 0, 0, 0 };
+		if (valid < count && std::memcmp(&records[valid], &zero, sizeof(Record)) != 0)
+		{
+			logOut << QUaLog({
+				QObject::tr("Recovered history segment %1. Truncated to %2 valid records.")
+					.arg(file.fileName())
+					.arg(valid),
+				QUaLogLevel::Warning,
+				QUaLogCategory::History
+			});
+		}
+		Segment segment = {
+			fileName,
+			valid > 0 ? records[0].time : 0,
+			valid > 0 ? records[valid - 1].time : 0,
+			valid,
+			QVector<qint64>()
+		};
+		if (records)
+		{
+			file.unmap(reinterpret_cast<uchar*>(const_cast<Record*>(records)));
+		}
+		qint64 bytes = static_cast<qint64>(valid) * static_cast<qint64>(sizeof(Record));
+		if (file.size() != bytes)
+		{
+			file.resize(bytes);
+		}
+		file.close();
+		if (blobEnd < blobSize && blob.open(QIODevice::ReadWrite))
+		{
+			blob.resize(blobEnd);
+			blob.close();
+		}
+		if (valid == 0)
+		{
+			QFile::remove(basePath + RecordSuffix);
+			QFile::remove(basePath + BlobSuffix);
+			continue;
+		}
+		series.segments.append(segment);
+	}
+	return ok;
+}
+
+QUaMappedHistorizer::Active* QUaMappedHistorizer::openActive(Series& series, QQueue<QUaLog>& logOut)
+{
+	Q_ASSERT(!m_active.contains(series.dirPath) && !series.segments.isEmpty());
+	// bound the open files and mappings
+	if (m_active.count() >= m_maxOpenSegments)
+	{
+		this->closeOldestActive();
+	}
+	int segment = series.segments.count() - 1;
+	QString filePath = this->segmentPath(series, segment) + RecordSuffix;
+	this->unmapSegment(filePath);
+	// room for GrowStep more records, appends only write to memory until it is used up
+	const Segment& last = series.segments.at(segment);
+	int capacity = (std::max)(last.count, (std::min)(m_segmentSize, last.count + GrowStep));
+	qint64 bytes = static_cast<qint64>(capacity) * static_cast<qint64>(sizeof(Record));
+	QSharedPointer<QFile> file(new QFile(filePath));
+	uchar* data = nullptr;
+	if (!file->open(QIODevice::ReadWrite) ||
+		!file->resize(bytes) ||
+		!(data = file->map(0, bytes)))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error opening history segment %1. %2")
+				.arg(filePath)
+				.arg(file->errorString()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return nullptr;
+	}
+	Record* records = reinterpret_cast<Record*>(data);
+	if (last.index.isEmpty())
+	{
+		QUaMappedHistorizer::buildIndex(last, records);
+	}
+	return &*m_active.insert(series.dirPath, {
+		file,
+		records,
+		capacity,
+		last.count,
+		++m_activeStamp,
+		QSharedPointer<QFile>()
+	});
+}
+
+void QUaMappedHistorizer::closeActive(const QString& dirPath)
+{
+	auto iter = m_active.find(dirPath);
+	if (iter == m_active.end())
+	{
+		return;
+	}
+	iter->file->unmap(reinterpret_cast<uchar*>(iter->records));
+	// drop unused capacity, closed segments only hold records
+	iter->file->resize(
+		static_cast<qint64>(iter->count) * static_cast<qint64>(sizeof(Record))
+	);
+	m_active.erase(iter);
+}
+
+void QUaMappedHistorizer::closeOldestActive()
+{
+	auto oldest = std::min_element(m_active.cbegin(), m_active.cend(),
+	[](const Active& a, const Active& b) {
+		return a.used < b.used;
+	});
+	if (oldest == m_active.cend())
+	{
+		return;
+	}
+	// copy, the key is erased on close
+	QString dirPath = oldest.key();
+	this->closeActive(dirPath);
+}
+
+bool QUaMappedHistorizer::write(
+	Series& series,
+	Record& record,
+	const QByteArray& blob,
+	const bool& unique,
+	QQueue<QUaLog>& logOut)
+{
+	// fast path, data points usually arrive in order
+	if (series.segments.isEmpty() ||
+		record.time > series.segments.last().timeLast ||
+		(!unique && record.time == series.segments.last().timeLast))
+	{
+		return this->append(series, record, blob, logOut);
+	}
+	return this->insert(series, record, blob, unique, logOut);
+}
+
+bool QUaMappedHistorizer::append(
+	Series& series,
+	Record& record,
+	const QByteArray& blob,
+	QQueue<QUaLog>& logOut)
+{
+	Active* active = nullptr;
+	// roll over when the last segment is full or spans too long
+	if (series.segments.isEmpty() ||
+		series.segments.last().count >= m_segmentSize ||
+		record.time - series.segments.last().timeFirst >= m_segmentInterval)
+	{
+		this->closeActive(series.dirPath);
+		series.segments.append({
+			QString("%1").arg(series.nextFile++, 10, 10, QChar('0')),
+			record.time,
+			record.time,
+			0,
+			QVector<qint64>()
+		});
+		active = this->openActive(series, logOut);
+		if (!active)
+		{
+			series.segments.removeLast();
+			return false;
+		}
+	}
+	else
+	{
+		active = this->activeSegment(series, series.segments.count() - 1);
+		// reopen a closed last segment, or remap it with more room keeping the blob file
+		if (!active || active->count >= active->capacity)
+		{
+			QSharedPointer<QFile> blob = active ? active->blob : QSharedPointer<QFile>();
+			this->closeActive(series.dirPath);
+			active = this->openActive(series, logOut);
+			if (!active)
+			{
+				return false;
+			}
+			active->blob = blob;
+		}
+	}
+	active->used = ++m_activeStamp;
+	int segment = series.segments.count() - 1;
+	// value goes first, so a record never points past the end of the blob file
+	if (!blob.isEmpty() && !this->appendBlob(series, segment, record, blob, logOut))
+	{
+		return false;
+	}
+	record.check = QUaMappedHistorizer::recordCheck(record);
+	Segment& last = series.segments[segment];
+	active->records[last.count] = record;
+	if (last.count % IndexStride == 0)
+	{
+		last.index.append(record.time);
+	}
+	if (last.count == 0)
+	{
+		last.timeFirst = record.time;
+	}
+	last.timeLast = record.time;
+	last.count++;
+	active->count = last.count;
+	return true;
+}
+
+bool QUaMappedHistorizer::insert(
+	Series& series,
+	Record& record,
+	const QByteArray& blob,
+	const bool& unique,
+	QQueue<QUaLog>& logOut)
+{
+	// first segment ending at or after the time, the last one otherwise
+	auto iter = std::lower_bound(series.segments.cbegin(), series.segments.cend(), record.time,
+	[](const Segment& segment, const qint64& time) {
+		return segment.timeLast < time;
+	});
+	int segment = (std::min)(
+		static_cast<int>(std::distance(series.segments.cbegin(), iter)),
+		series.segments.count() - 1
+	);
+	const Record* records = this->segmentRecords(series, segment);
+	if (!records)
+	{
+		logOut << QUaLog({
+			QObject::tr("Error writing history. Could not map segment %1.")
+				.arg(this->segmentPath(series, segment)),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	int count = series.segments.at(segment).count;
+	QVector<Record> copy(count);
+	std::memcpy(copy.data(), records, static_cast<size_t>(count) * sizeof(Record));
+	if (!blob.isEmpty() && !this->appendBlob(series, segment, record, blob, logOut))
+	{
+		return false;
+	}
+	// data points replace the one with the same time, events go after it
+	auto pos = unique ?
+		std::lower_bound(copy.begin(), copy.end(), record.time,
+		[](const Record& item, const qint64& time) {
+			return item.time < time;
+		}) :
+		std::upper_bound(copy.begin(), copy.end(), record.time,
+		[](const qint64& time, const Record& item) {
+			return time < item.time;
+		});
+	if (unique && pos != copy.end() && pos->time == record.time)
+	{
+		*pos = record;
+	}
+	else
+	{
+		copy.insert(pos, record);
+	}
+	return this->rewriteSegment(series, segment, copy, logOut);
+}
+
+bool QUaMappedHistorizer::remove(
+	Series& series,
+	const qint64& timeStart,
+	const qint64& timeEnd,
+	QQueue<QUaLog>& logOut)
+{
+	bool ok = true;
+	// backwards, emptied segments are removed
+	for (int segment = series.segments.count() - 1; segment >= 0; segment--)
+	{
+		const Segment& item = series.segments.at(segment);
+		if (item.timeLast < timeStart || item.timeFirst > timeEnd)
+		{
+			continue;
+		}
+		const Record* records = this->segmentRecords(series, segment);
+		if (!records)
+		{
+			ok = false;
+			continue;
+		}
+		QVector<Record> kept;
+		kept.reserve(item.count);
+		for (int i = 0; i < item.count; i++)
+		{
+			if (records[i].time < timeStart || records[i].time > timeEnd)
+			{
+				kept.append(records[i]);
+			}
+		}
+		if (kept.count() == item.count)
+		{
+			continue;
+		}
+		// NOTE : blob files are not compacted
+		ok = this->rewriteSegment(series, segment, kept, logOut) && ok;
+	}
+	return ok;
+}
+
+bool QUaMappedHistorizer::rewriteSegment(
+	Series& series,
+	const int& segment,
+	QVector<Record>& records,
+	QQueue<QUaLog>& logOut)
+{
+	QString basePath = this->segmentPath(series, segment);
+	QString filePath = basePath + RecordSuffix;
+	this->unmapSegment(filePath);
+	// the file is replaced, so its unused capacity is not dropped, the new
+	// one is mapped again on the next append
+	Active* active = this->activeSegment(series, segment);
+	if (active)
+	{
+		active->file->unmap(reinterpret_cast<uchar*>(active->records));
+		m_active.remove(series.dirPath);
+	}
+	if (records.isEmpty())
+	{
+		QFile::remove(filePath);
+		QFile::remove(basePath + BlobSuffix);
+		series.segments.remove(segment);
+		return true;
+	}
+	for (auto& record : records)
+	{
+		record.check = QUaMappedHistorizer::recordCheck(record);
+	}
+	// replaced atomically, a crash leaves either the old or the new segment
+	qint64 bytes = static_cast<qint64>(records.count()) * static_cast<qint64>(sizeof(Record));
+	QSaveFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly) ||
+		file.write(reinterpret_cast<const char*>(records.constData()), bytes) != bytes ||
+		!file.commit())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error rewriting history segment %1. %2")
+				.arg(filePath)
+				.arg(file.errorString()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	Segment& item  = series.segments[segment];
+	item.count     = records.count();
+	item.timeFirst = records.first().time;
+	item.timeLast  = records.last().time;
+	QUaMappedHistorizer::buildIndex(item, records.constData());
+	return true;
+}
+
+bool QUaMappedHistorizer::appendBlob(
+	Series& series,
+	const int& segment,
+	Record& record,
+	const QByteArray& blob,
+	QQueue<QUaLog>& logOut)
+{
+	Active* active = this->activeSegment(series, segment);
+	QSharedPointer<QFile> file = active ? active->blob : QSharedPointer<QFile>();
+	if (file.isNull())
+	{
+		file.reset(new QFile(this->segmentPath(series, segment) + BlobSuffix));
+		if (!file->open(QIODevice::ReadWrite))
+		{
+			logOut << QUaLog({
+				QObject::tr("Error opening history blob %1. %2")
+					.arg(file->fileName())
+					.arg(file->errorString()),
+				QUaLogLevel::Error,
+				QUaLogCategory::History
+			});
+			return false;
+		}
+		if (active)
+		{
+			active->blob = file;
+		}
+	}
+	qint64 offset = file->size();
+	if (!file->seek(offset) || file->write(blob) != blob.size() || !file->flush())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error writing history blob %1. %2")
+				.arg(file->fileName())
+				.arg(file->errorString()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	record.value = static_cast<quint64>(offset);
+	record.size  = static_cast<quint32>(blob.size());
+	return true;
+}
+
+QUaMappedHistorizer::Active* QUaMappedHistorizer::activeSegment(
+	const Series& series,
+	const int& segment) const
+{
+	if (segment != series.segments.count() - 1)
+	{
+		return nullptr;
+	}
+	auto iter = m_active.find(series.dirPath);
+	return iter != m_active.end() ? &*iter : nullptr;
+}
+
+const QUaMappedHistorizer::Record* QUaMappedHistorizer::segmentRecords(
+	const Series& series,
+	const int& segment) const
+{
+	const Active* active = this->activeSegment(series, segment);
+	if (active)
+	{
+		return active->records;
+	}
+	QString filePath = this->segmentPath(series, segment) + RecordSuffix;
+	auto iter = m_mapped.find(filePath);
+	if (iter != m_mapped.end())
+	{
+		// most recently used last
+		if (m_mappedOrder.last() != filePath)
+		{
+			m_mappedOrder.removeOne(filePath);
+			m_mappedOrder.append(filePath);
+		}
+		return iter->records;
+	}
+	const Segment& item = series.segments.at(segment);
+	qint64 bytes = static_cast<qint64>(item.count) * static_cast<qint64>(sizeof(Record));
+	QSharedPointer<QFile> file(new QFile(filePath));
+	const Record* records = nullptr;
+	if (!file->open(QIODevice::ReadOnly) ||
+		file->size() < bytes ||
+		!(records = reinterpret_cast<const Record*>(file->map(0, bytes))))
+	{
+		return nullptr;
+	}
+	if (item.index.isEmpty())
+	{
+		QUaMappedHistorizer::buildIndex(item, records);
+	}
+	if (m_mappedOrder.count() >= MaxMapped)
+	{
+		m_mapped.remove(m_mappedOrder.takeFirst());
+	}
+	m_mapped.insert(filePath, { file, records, QSharedPointer<QFile>() });
+	m_mappedOrder.append(filePath);
+	return records;
+}
+
+QByteArray QUaMappedHistorizer::readBlob(
+	const Series& series,
+	const int& segment,
+	const Record& record) const
+{
+	QSharedPointer<QFile>* blob = nullptr;
+	Active* active = this->activeSegment(series, segment);
+	if (active)
+	{
+		blob = &active->blob;
+	}
+	else
+	{
+		// also maps the segment if it was evicted
+		if (!this->segmentRecords(series, segment))
+		{
+			return QByteArray();
+		}
+		blob = &m_mapped[this->segmentPath(series, segment) + RecordSuffix].blob;
+	}
+	if (blob->isNull())
+	{
+		QSharedPointer<QFile> file(new QFile(this->segmentPath(series, segment) + BlobSuffix));
+		if (!file->open(QIODevice::ReadWrite))
+		{
+			return QByteArray();
+		}
+		*blob = file;
+	}
+	if (!(*blob)->seek(static_cast<qint64>(record.value)))
+	{
+		return QByteArray();
+	}
+	return (*blob)->read(record.size);
+}
+
+void QUaMappedHistorizer::unmapSegment(const QString& filePath) const
+{
+	if (m_mapped.remove(filePath) > 0)
+	{
+		m_mappedOrder.removeOne(filePath);
+	}
+}
+
+QString QUaMappedHistorizer::segmentPath(const Series& series, const int& segment) const
+{
+	return QDir(series.dirPath).filePath(series.segments.at(segment).fileName);
+}
+
+QUaMappedHistorizer::Position QUaMappedHistorizer::lowerBound(const Series& series, const qint64& time) const
+{
+	// first segment ending at or after the time
+	auto iter = std::lower_bound(series.segments.cbegin(), series.segments.cend(), time,
+	[](const Segment& segment, const qint64& time) {
+		return segment.timeLast < time;
+	});
+	int segment = static_cast<int>(std::distance(series.segments.cbegin(), iter));
+	if (segment >= series.segments.count())
+	{
+		return { segment, 0 };
+	}
+	return { segment, this->segmentBound(series, segment, time, false) };
+}
+
+QUaMappedHistorizer::Position QUaMappedHistorizer::upperBound(const Series& series, const qint64& time) const
+{
+	// first segment ending after the time
+	auto iter = std::upper_bound(series.segments.cbegin(), series.segments.cend(), time,
+	[](const qint64& time, const Segment& segment) {
+		return time < segment.timeLast;
+	});
+	int segment = static_cast<int>(std::distance(series.segments.cbegin(), iter));
+	if (segment >= series.segments.count())
+	{
+		return { segment, 0 };
+	}
+	return { segment, this->segmentBound(series, segment, time, true) };
+}
+
+int QUaMappedHistorizer::segmentBound(
+	const Series& series,
+	const int& segment,
+	const qint64& time,
+	const bool& upper) const
+{
+	const Segment& item = series.segments.at(segment);
+	const Record* records = this->segmentRecords(series, segment);
+	if (!records)
+	{
+		return item.count;
+	}
+	// sparse index narrows the search down to IndexStride records
+	const auto& index = item.index;
+	auto iter = upper ?
+		std::upper_bound(index.cbegin(), index.cend(), time) :
+		std::lower_bound(index.cbegin(), index.cend(), time);
+	int block = static_cast<int>(std::distance(index.cbegin(), iter));
+	int first = block > 0 ? (block - 1) * IndexStride : 0;
+	int last  = block < index.count() ? block * IndexStride : item.count;
+	const Record* result = upper ?
+		std::upper_bound(records + first, records + last, time,
+		[](const qint64& time, const Record& record) {
+			return time < record.time;
+		}) :
+		std::lower_bound(records + first, records + last, time,
+		[](const Record& record, const qint64& time) {
+			return record.time < time;
+		});
+	return static_cast<int>(result - records);
+}
+
+void QUaMappedHistorizer::advance(const Series& series, Position& position, quint64 count) const
+{
+	while (count > 0 && position.segment < series.segments.count())
+	{
+		quint64 left = static_cast<quint64>(series.segments.at(position.segment).count - position.index);
+		if (count < left)
+		{
+			position.index += static_cast<int>(count);
+			return;
+		}
+		count -= left;
+		position.segment++;
+		position.index = 0;
+	}
+}
+
+bool QUaMappedHistorizer::previous(const Series& series, Position& position) const
+{
+	if (position.index > 0)
+	{
+		position.index--;
+		return true;
+	}
+	if (position.segment > 0)
+	{
+		position.segment--;
+		position.index = series.segments.at(position.segment).count - 1;
+		return true;
+	}
+	return false;
+}
+
+const QUaMappedHistorizer::Record* QUaMappedHistorizer::recordAt(
+	const Series& series,
+	const Position& position) const
+{
+	if (position.segment >= series.segments.count() ||
+		position.index >= series.segments.at(position.segment).count)
+	{
+		return nullptr;
+	}
+	const Record* records = this->segmentRecords(series, position.segment);
+	return records ? &records[position.index] : nullptr;
+}
+
+quint64 QUaMappedHistorizer::rangeCount(
+	const Series& series,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd) const
+{
+	Position first = this->lowerBound(series, timeStart.toMSecsSinceEpoch());
+	// if the end timestamp is invalid, it means the API is requesting up to the most recent timestamp
+	Position last = timeEnd.isValid() ?
+		this->upperBound(series, timeEnd.toMSecsSinceEpoch()) :
+		Position({ series.segments.count(), 0 });
+	if (first.segment > last.segment ||
+		(first.segment == last.segment && first.index >= last.index))
+	{
+		return 0;
+	}
+	if (first.segment == last.segment)
+	{
+		return static_cast<quint64>(last.index - first.index);
+	}
+	quint64 count = static_cast<quint64>(series.segments.at(first.segment).count - first.index);
+	for (int segment = first.segment + 1; segment < last.segment; segment++)
+	{
+		count += static_cast<quint64>(series.segments.at(segment).count);
+	}
+	return count + static_cast<quint64>(last.index);
+}
+
+QVariant QUaMappedHistorizer::decodeValue(
+	const Series& series,
+	const int& segment,
+	const Record& record) const
+{
+	if (record.size == 0)
+	{
+		return QUaNumericBits::isNumericType(record.type) ?
+			QUaNumericBits::bitsToValue(record.value, record.type) : QVariant();
+	}
+	QByteArray bytes = this->readBlob(series, segment, record);
+	QDataStream stream(bytes);
+	stream.setVersion(QDataStream::Qt_5_9);
+	QVariant value;
+	stream >> value;
+	return value;
+}
+
+void QUaMappedHistorizer::encodeValue(const QVariant& value, Record& record, QByteArray& blob)
+{
+	int type = value.userType();
+	if (QUaNumericBits::isNumericType(type))
+	{
+		record.value = QUaNumericBits::valueToBits(value, type);
+		record.type  = type;
+		record.size  = 0;
+		return;
+	}
+	record.value = 0;
+	record.type  = QMetaType::UnknownType;
+	record.size  = 0;
+	if (!value.isValid())
+	{
+		return;
+	}
+	QDataStream stream(&blob, QIODevice::WriteOnly);
+	stream.setVersion(QDataStream::Qt_5_9);
+	stream << QUaMappedHistorizer::storableValue(value);
+}
+
+QVariant QUaMappedHistorizer::storableValue(const QVariant& value)
+{
+	// custom types can not be streamed, lists are stored item by item and other values as
+	// string, the backend converts them back to the type of the node on read
+	if (value.userType() < QMetaType::User)
+	{
+		return value;
+	}
+	if (value.canConvert<QVariantList>())
+	{
+		QVariantList list;
+		for (const auto& item : value.value<QVariantList>())
+		{
+			list << QUaMappedHistorizer::storableValue(item);
+		}
+		return list;
+	}
+	return value.toString();
+}
+
+void QUaMappedHistorizer::buildIndex(const Segment& segment, const Record* records)
+{
+	segment.index.clear();
+	segment.index.reserve(segment.count / IndexStride + 1);
+	for (int i = 0; i < segment.count; i += IndexStride)
+	{
+		segment.index.append(records[i].time);
+	}
+}
+
+bool QUaMappedHistorizer::isValid(const Record& record, const qint64& blobSize)
+{
+	return record.check == QUaMappedHistorizer::recordCheck(record) &&
+		(record.size == 0 || record.value + record.size <= static_cast<quint64>(blobSize));
+}
+
+quint32 QUaMappedHistorizer::recordCheck(const Record& record)
+{
+	// FNV-1a over the 32 bit words before the checksum
+	quint32 words[sizeof(Record) / sizeof(quint32)];
+	std::memcpy(words, &record, sizeof(Record));
+	quint32 hash = 2166136261u;
+	for (size_t i = 0; i < sizeof(Record) / sizeof(quint32) - 1; i++)
+	{
+		hash ^= words[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+#endif // UA_ENABLE_HISTORIZING
@@ -0,0 +1,286 @@
+#ifndef QUAMAPPEDHISTORIZER_H
+#define QUAMAPPEDHISTORIZER_H
+
+#include <QUaHistoryBackend>
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include <QFile>
+#include <QSharedPointer>
+
+// historizer which appends fixed width records to memory mapped segment files, one series of
+// segments per node (and per event type of each emitter), rolled over by size or time span
+// numeric values are stored in the record, other values and events in a blob file next to it
+// on setPath the last segment of each series is scanned and truncated to its last valid record
+// NOTE : records reach the file when the operating system writes back the mapped pages, so all
+//        data survives a crash of the process, and a power loss loses at most the unwritten tail
+// NOTE : out of order writes, updates and removals rewrite the whole affected segment
+class QUaMappedHistorizer
+{
+public:
+	QUaMappedHistorizer();
+	~QUaMappedHistorizer();
+
+	// directory of the segment files, created if it does not exist, and existing
+	// segments are recovered, return false on error
+	QString path() const;
+	bool    setPath(const QString& path, QQueue<QUaLog>& logOut);
+	// unmap all segments and truncate them to their records, also done on destruction
+	void close();
+
+	// maximum number of records per segment (default 1048576, 32 MB segment files)
+	// NOTE : applies to segments created from then on, the last segment of a series is
+	//        mapped with room for 4096 more records and remapped as it grows
+	int  segmentSize() const;
+	void setSegmentSize(const int& segmentSize);
+	// maximum number of series which keep their last segment open and mapped for appends
+	// (default 256), the least recently written one is closed to open another
+	int  maxOpenSegments() const;
+	void setMaxOpenSegments(const int& maxOpenSegments);
+	// maximum time span of a segment in milliseconds (default 1 day)
+	qint64 segmentInterval() const;
+	void   setSegmentInterval(const qint64& segmentInterval);
+
+	// required API for QUaServer::setHistorizer
+	// write data point to backend, return true on success
+	bool writeHistoryData(
+		const QUaNodeId &nodeId,
+		const QUaHistoryDataPoint& dataPoint,
+		QQueue<QUaLog>& logOut
+	);
+	// optional API for QUaServer::setHistorizer
+	// write a data value as received by the server, numeric scalars written in order are
+	// appended without converting them to QDateTime and QVariant
+	bool writeHistoryDataRaw(
+		const UA_NodeId     &nodeId,
+		const UA_DateTime   &timestamp,
+		const UA_Variant    &value,
+		const UA_StatusCode &status,
+		QQueue<QUaLog>      &logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// update an existing node's data point in backend, return true on success
+	bool updateHistoryData(
+		const QUaNodeId &nodeId,
+		const QUaHistoryDataPoint& dataPoint,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// remove an existing node's data points within a range, return true on success
+	bool removeHistoryData(
+		const QUaNodeId &nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// return the timestamp of the first sample available for the given node
+	QDateTime firstTimestamp(
+		const QUaNodeId &nodeId,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the timestamp of the latest sample available for the given node
+	QDateTime lastTimestamp(
+		const QUaNodeId &nodeId,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return true if given timestamp is available for the given node
+	bool hasTimestamp(
+		const QUaNodeId &nodeId,
+		const QDateTime& timestamp,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return a timestamp matching the criteria for the given node
+	QDateTime findTimestamp(
+		const QUaNodeId &nodeId,
+		const QDateTime& timestamp,
+		const QUaHistoryBackend::TimeMatch& match,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the number for data points within a time range for the given node
+	quint64 numDataPointsInRange(
+		const QUaNodeId &nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the numPointsToRead data points for the given node from the given start time
+	QVector<QUaHistoryDataPoint> readHistoryData(
+		const QUaNodeId & nodeId,
+		const QDateTime &timeStart,
+		const quint64   &numPointsOffset,
+		const quint64   &numPointsToRead,
+		QQueue<QUaLog>  &logOut
+	) const;
+
+	// event history support
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// write a event's data to backend
+	bool writeHistoryEventsOfType(
+		const QUaNodeId            &eventTypeNodeId,
+		const QList<QUaNodeId>     &emittersNodeIds,
+		const QUaHistoryEventPoint &eventPoint,
+		QQueue<QUaLog>             &logOut
+	);
+	// get event types (node ids) for which there are events stored for the
+	// given emitter
+	QVector<QUaNodeId> eventTypesOfEmitter(
+		const QUaNodeId &emitterNodeId,
+		QQueue<QUaLog>  &logOut
+	);
+	// find a timestamp matching the criteria for the emitter and event type
+	QDateTime findTimestampEventOfType(
+		const QUaNodeId                    &emitterNodeId,
+		const QUaNodeId                    &eventTypeNodeId,
+		const QDateTime                    &timestamp,
+		const QUaHistoryBackend::TimeMatch &match,
+		QQueue<QUaLog>                     &logOut
+	);
+	// get the number for events within a time range for the given emitter and event type
+	quint64 numEventsOfTypeInRange(
+		const QUaNodeId &emitterNodeId,
+		const QUaNodeId &eventTypeNodeId,
+		const QDateTime &timeStart,
+		const QDateTime &timeEnd,
+		QQueue<QUaLog>  &logOut
+	);
+	// return the numPointsToRead events for the given emitter and event type,
+	// starting from the numPointsOffset offset after given start time (pagination)
+	QVector<QUaHistoryEventPoint> readHistoryEventsOfType(
+		const QUaNodeId &emitterNodeId,
+		const QUaNodeId &eventTypeNodeId,
+		const QDateTime &timeStart,
+		const quint64   &numPointsOffset,
+		const quint64   &numPointsToRead,
+		const QList<QUaBrowsePath> &columnsToRead,
+		QQueue<QUaLog>  &logOut
+	);
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+private:
+	// fixed width record, 32 bytes
+	struct Record
+	{
+		qint64  time;   // milliseconds since epoch (UTC)
+		quint64 value;  // numeric value bits, or offset of the value in the blob file
+		quint32 status;
+		qint32  type;   // meta type of a numeric value
+		quint32 size;   // bytes of the value in the blob file, zero for numeric values
+		quint32 check;  // checksum of the fields above, zero filled records are invalid
+	};
+	// segment files <fileName>.rec and <fileName>.blob, named by creation order
+	struct Segment
+	{
+		QString fileName;
+		qint64  timeFirst;
+		qint64  timeLast;
+		int     count;
+		// time of every IndexStride-th record, built when the segment is mapped
+		mutable QVector<qint64> index;
+	};
+	// records of a node, or of an event type of an emitter, ordered by time
+	struct Series
+	{
+		QString dirPath;
+		int     nextFile;
+		QVector<Segment> segments;
+	};
+	// last segment of a series, mapped with room for appends
+	struct Active
+	{
+		QSharedPointer<QFile> file;
+		Record* records;
+		int     capacity;
+		int     count;   // records in use, the rest is dropped on close
+		quint64 used;    // stamp of the last append, least recently used is closed first
+		QSharedPointer<QFile> blob; // opened on first use
+	};
+	// closed segment, mapped for reads
+	struct Mapped
+	{
+		QSharedPointer<QFile> file;
+		const Record*         records;
+		QSharedPointer<QFile> blob; // opened on first use
+	};
+	// position of a record in a series
+	struct Position
+	{
+		int segment;
+		int index;
+	};
+
+	QString m_path;
+	int     m_segmentSize;
+	qint64  m_segmentInterval;
+	int     m_nextDir;
+	int     m_maxOpenSegments;
+	QHash<QUaNodeId, Series> m_database;
+	// last segments open for appends, by series directory
+	mutable QHash<QString, Active> m_active;
+	quint64 m_activeStamp;
+	// least recently used closed segments stay mapped, by file path
+	mutable QHash<QString, Mapped> m_mapped;
+	mutable QList<QString>         m_mappedOrder;
+
+	Series* dataSeries(const QUaNodeId& nodeId, QQueue<QUaLog>& logOut);
+	QString createDir(const QString& parentPath, const QUaNodeId& nodeId, QQueue<QUaLog>& logOut);
+	static QUaNodeId readNodeId(const QString& dirPath);
+	// recover the segments of a series directory, the last one is mapped on the next append
+	bool openSeries(Series& series, const QString& dirPath, QQueue<QUaLog>& logOut);
+	// map the last segment with room for more records, closing the least recently used
+	// one if there are too many open
+	Active* openActive(Series& series, QQueue<QUaLog>& logOut);
+	void    closeActive(const QString& dirPath);
+	void    closeOldestActive();
+
+	// append if newer than the last record (or as new as, if not unique), else rewrite the segment
+	bool write(Series& series, Record& record, const QByteArray& blob, const bool& unique, QQueue<QUaLog>& logOut);
+	bool append(Series& series, Record& record, const QByteArray& blob, QQueue<QUaLog>& logOut);
+	bool insert(Series& series, Record& record, const QByteArray& blob, const bool& unique, QQueue<QUaLog>& logOut);
+	bool remove(Series& series, const qint64& timeStart, const qint64& timeEnd, QQueue<QUaLog>& logOut);
+	bool rewriteSegment(Series& series, const int& segment, QVector<Record>& records, QQueue<QUaLog>& logOut);
+	bool appendBlob(Series& series, const int& segment, Record& record, const QByteArray& blob, QQueue<QUaLog>& logOut);
+
+	// open last segment, null if the segment is not the last one or it is closed
+	Active* activeSegment(const Series& series, const int& segment) const;
+	const Record* segmentRecords(const Series& series, const int& segment) const;
+	QByteArray readBlob(const Series& series, const int& segment, const Record& record) const;
+	void unmapSegment(const QString& filePath) const;
+	QString segmentPath(const Series& series, const int& segment) const;
+
+	// first position with time >= (lower) or > (upper) than given time
+	Position lowerBound(const Series& series, const qint64& time) const;
+	Position upperBound(const Series& series, const qint64& time) const;
+	int  segmentBound(const Series& series, const int& segment, const qint64& time, const bool& upper) const;
+	void advance(const Series& series, Position& position, quint64 count) const;
+	bool previous(const Series& series, Position& position) const;
+	const Record* recordAt(const Series& series, const Position& position) const;
+	// number of records within [timeStart, timeEnd], up to the last one if timeEnd is invalid
+	quint64 rangeCount(const Series& series, const QDateTime& timeStart, const QDateTime& timeEnd) const;
+
+	QVariant decodeValue(const Series& series, const int& segment, const Record& record) const;
+	static void     encodeValue(const QVariant& value, Record& record, QByteArray& blob);
+	static QVariant storableValue(const QVariant& value);
+	static void     buildIndex(const Segment& segment, const Record* records);
+	static bool     isValid(const Record& record, const qint64& blobSize);
+	static quint32  recordCheck(const Record& record);
+
+	// event history support
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// emitter node id, event type node id
+	QHash<QUaNodeId, QHash<QUaNodeId, Series>> m_events;
+	QHash<QUaNodeId, QString> m_eventDirs;
+	Series* eventSeries(const QUaNodeId& emitterNodeId, const QUaNodeId& eventTypeNodeId, const bool& create, QQueue<QUaLog>& logOut);
+	static QByteArray encodeEvent(const QUaHistoryEventPoint& eventPoint);
+	static QHash<QUaBrowsePath, QVariant> decodeEvent(const QByteArray& bytes, const QList<QUaBrowsePath>& columnsToRead);
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+};
+
+#endif // UA_ENABLE_HISTORIZING
+
+#endif // QUAMAPPEDHISTORIZER_H
@@ -7,6 +7,38 @@
 
 #include <QFileInfo>
 #include <QDir>
+#include <QThread>
+#include <functional>
+
+// runs the write loop of the historizer, which owns its own database connections
+class QUaMultiSqliteWriteThread : public QThread
+{
+public:
+	QUaMultiSqliteWriteThread(const std::function<void()>& loop) : m_loop(loop) {}
+protected:
+	void run() override
+	{
+		m_loop();
+	}
+private:
+	std::function<void()> m_loop;
+};
+
+// scoped pause of the write thread (see QUaMultiSqliteHistorizer::pauseWrites)
+class QUaMultiSqliteWritePause
+{
+public:
+	explicit QUaMultiSqliteWritePause(QUaMultiSqliteHistorizer* historizer) : m_historizer(historizer)
+	{
+		m_historizer->pauseWrites();
+	}
+	~QUaMultiSqliteWritePause()
+	{
+		m_historizer->resumeWrites();
+	}
+private:
+	QUaMultiSqliteHistorizer* m_historizer;
+};
 
 // map supported types
 QHash<int, QString> QUaMultiSqliteHistorizer::m_hashTypes = {
@@ -56,6 +88,13 @@ QUaMultiSqliteHistorizer::QUaMultiSqliteHistorizer()
 	m_strBaseName        = "uahist";
 	m_strSuffix          = "sqlite";
 	m_deferTotalSizeCheck = false;	
+	m_writeThread        = nullptr;
+	m_writeStop          = false;
+	m_writeFlush         = false;
+	m_writePause         = 0;
+	m_writePaused        = false;
+	m_writeQueueSize     = 100000;
+	m_commitRowsLimit    = 10000;
 	// handle transation
 	QObject::connect(&m_timerTransaction, &QTimer::timeout, &m_timerTransaction,
 	[this]() {
@@ -134,6 +173,8 @@ QUaMultiSqliteHistorizer::QUaMultiSqliteHistorizer()
 
 QUaMultiSqliteHistorizer::~QUaMultiSqliteHistorizer()
 {
+	// commit queued data points first
+	this->stopWriteThread();
 	// close all db files
 	while (!m_dbFiles.isEmpty())
 	{
@@ -349,6 +390,7 @@ int QUaMultiSqliteHistorizer::transactionTimeout() const
 
 void QUaMultiSqliteHistorizer::setTransactionTimeout(const int& timeoutMs)
 {
+	QMutexLocker locker(&m_writeMutex);
 	m_timeoutTransaction = (std::max)(0, timeoutMs);
 	if (m_timeoutTransaction <= 0)
 	{
@@ -367,44 +409,88 @@ void QUaMultiSqliteHistorizer::setMultiRowInsertSize(const int& rows)
 	{
 		return;
 	}
-	// update multirow queries
+	// NOTE : multirow queries are prepared for each block size on first use
+	QMutexLocker locker(&m_writeMutex);
 	m_multiRowInsertSize = (std::max)(rows, 1);
-	// get most recent db file, creates one of not exist
-	bool ok = false;
-	auto& dbInfo = this->getMostRecentDbInfo(QDateTime::currentDateTimeUtc(), ok, m_deferedLogOut);
-	if (!ok)
+}
+
+bool QUaMultiSqliteHistorizer::writeThread() const
+{
+	return m_writeThread;
+}
+
+void QUaMultiSqliteHistorizer::setWriteThread(const bool& writeThread)
+{
+	if (writeThread == this->writeThread())
 	{
 		return;
 	}
-	// get database handle
-	QSqlDatabase db;
-	if (!this->getOpenedDatabase(dbInfo, db, m_deferedLogOut))
+	if (!writeThread)
 	{
+		this->stopWriteThread();
 		return;
-	}	
-	QString strStmt;
-	for (auto& nodeId : dbInfo.dataPrepStmts.keys())
+	}
+	// commit data of calling thread before writing from the write thread
+	if (!m_dbFiles.isEmpty())
 	{
-		QSqlQuery query(db);
-		// prepared statement for multirow insert
-		strStmt = QString(
-			"INSERT INTO \"%1\" (Time, Value, Status) VALUES "
-		).arg(nodeId);
-		for (int i = 0; i < m_multiRowInsertSize; i++)
+		m_timerTransaction.stop();
+		auto& dbInfo = m_dbFiles.last();
+		if (m_multiRowInsertSize > 1)
 		{
-			if (i == m_multiRowInsertSize - 1)
-			{
-				// last one
-				strStmt += QString("(:t%1, :v%1, :s%1);").arg(i);
-				break;
-			}
-			strStmt += QString("(:t%1, :v%1, :s%1), ").arg(i);
+			this->flushOutstandingRowBlocks(dbInfo, m_deferedLogOut);
 		}
-		if (!this->prepareStmt(dbInfo, query, strStmt, m_deferedLogOut))
+		QSqlDatabase db;
+		if (dbInfo.openedTransaction && this->getOpenedDatabase(dbInfo, db, m_deferedLogOut))
 		{
-			continue;
+			db.commit();
 		}
-		dbInfo.dataPrepStmts[nodeId].writeHistoryDataMultiRow = query;
+		dbInfo.openedTransaction = false;
+	}
+	// database size is then checked on writes (see writeHistoryData)
+	m_checkingTimer.restart();
+	m_writeStop  = false;
+	m_writeFlush = false;
+	m_writeThread = new QUaMultiSqliteWriteThread([this]() {
+		this->writeLoop();
+	});
+	m_writeThread->start();
+}
+
+int QUaMultiSqliteHistorizer::commitRowsLimit() const
+{
+	return m_commitRowsLimit;
+}
+
+void QUaMultiSqliteHistorizer::setCommitRowsLimit(const int& rows)
+{
+	QMutexLocker locker(&m_writeMutex);
+	m_commitRowsLimit = (std::max)(rows, 1);
+}
+
+int QUaMultiSqliteHistorizer::writeQueueSize() const
+{
+	return m_writeQueueSize;
+}
+
+void QUaMultiSqliteHistorizer::setWriteQueueSize(const int& size)
+{
+	QMutexLocker locker(&m_writeMutex);
+	m_writeQueueSize = (std::max)(size, 1);
+	m_writeNotFull.wakeAll();
+}
+
+void QUaMultiSqliteHistorizer::flushWrites()
+{
+	QMutexLocker locker(&m_writeMutex);
+	if (!m_writeThread)
+	{
+		return;
+	}
+	m_writeFlush = true;
+	m_writeNotEmpty.wakeOne();
+	while (m_writeFlush)
+	{
+		m_writeFlushed.wait(&m_writeMutex);
 	}
 }
 
@@ -420,6 +506,12 @@ bool QUaMultiSqliteHistorizer::writeHistoryData(
 		logOut << m_deferedLogOut;
 		m_deferedLogOut.clear();
 	}
+	if (m_writeThread)
+	{
+		QMutexLocker locker(&m_writeMutex);
+		logOut << m_writeLogOut;
+		m_writeLogOut.clear();
+	}
 	// get most recent db file, creates one of not exist
 	bool ok = false;
 	auto& dbInfo = this->getMostRecentDbInfo(dataPoint.timestamp, ok, logOut);
@@ -427,9 +519,9 @@ bool QUaMultiSqliteHistorizer::writeHistoryData(
 	{
 		return false;
 	}
-	// if transactions disabled, check if need to change database here
+	// if transactions disabled or handled by the write thread, check if need to change database here
 	// NOTE : if transactions enabled, this check if performed in transation timeout
-	if (m_timeoutTransaction <= 0 && m_checkingTimer.elapsed() > 5000)
+	if ((m_timeoutTransaction <= 0 || m_writeThread) && m_checkingTimer.elapsed() > 5000)
 	{
 		m_checkingTimer.restart();
 		bool ok = this->checkDatabase(dataPoint.timestamp, logOut);
@@ -457,6 +549,8 @@ bool QUaMultiSqliteHistorizer::writeHistoryData(
 	}
 	if (!dataTableExists)
 	{
+		// wait for the write thread to commit, else this thread waits on its lock
+		QUaMultiSqliteWritePause pause(this);
 		// get sql data type to store
 		auto dataType = QUaMultiSqliteHistorizer::QVariantToQtType(dataPoint.value);
 		if (!this->createDataNodeTable(dbInfo, db, nodeId, dataType, logOut))
@@ -464,6 +558,19 @@ bool QUaMultiSqliteHistorizer::writeHistoryData(
 			return false;
 		}
 	}
+	// queue for the write thread
+	if (m_writeThread)
+	{
+		QMutexLocker locker(&m_writeMutex);
+		// backpressure, wait for the write thread to take the queue
+		while (m_writeQueue.count() >= m_writeQueueSize)
+		{
+			m_writeNotFull.wait(&m_writeMutex);
+		}
+		m_writeQueue.enqueue({ dbInfo.strFileName, nodeId, dataPoint });
+		m_writeNotEmpty.wakeOne();
+		return true;
+	}
 	// insert new data point
 	return this->insertDataPoint(
 		dbInfo,
@@ -1191,8 +1298,10 @@ QVector<QUaHistoryDataPoint> QUaMultiSqliteHistorizer::readHistoryData(
 			continue;
 		}
 		Q_ASSERT(db.isValid() && db.isOpen());
-		QSqlQuery query = dbInfo.dataPrepStmts[nodeId].numDataPointsInRangeEndInvalid;
+		// NOTE : count at most up to the offset, so a small offset does not scan the whole file
+		QSqlQuery query = dbInfo.dataPrepStmts[nodeId].numDataPointsInRangeBounded;
 		query.bindValue(0, timeStart.toMSecsSinceEpoch());
+		query.bindValue(1, trueOffset + 1);
 		if (!query.exec())
 		{
 			logOut << QUaLog({
@@ -1363,9 +1472,9 @@ bool QUaMultiSqliteHistorizer::writeHistoryEventsOfType(
 	{
 		return false;
 	}
-	// if transactions disabled, check if need to change database here
+	// if transactions disabled or handled by the write thread, check if need to change database here
 	// NOTE : if transactions enabled, this check if performed in transation timeout
-	if (m_timeoutTransaction <= 0 && m_checkingTimer.elapsed() > 5000)
+	if ((m_timeoutTransaction <= 0 || m_writeThread) && m_checkingTimer.elapsed() > 5000)
 	{
 		m_checkingTimer.restart();
 		bool ok = this->checkDatabase(eventPoint.timestamp, logOut);
@@ -1374,6 +1483,8 @@ bool QUaMultiSqliteHistorizer::writeHistoryEventsOfType(
 			return ok;
 		}
 	}
+	// wait for the write thread to commit, else this thread waits on its lock
+	QUaMultiSqliteWritePause pause(this);
 	// get database handle
 	QSqlDatabase db;
 	if (!this->getOpenedDatabase(dbInfo, db, logOut))
@@ -2151,7 +2262,12 @@ bool QUaMultiSqliteHistorizer::getOpenedDatabase(
 		db = QSqlDatabase::addDatabase("QSQLITE", strDbName);
 		// the database name is not the connection name
 		db.setDatabaseName(strDbName);
-		db.open();
+		// wait instead of failing while the write thread holds the write lock
+		db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+		if (db.open())
+		{
+			QUaMultiSqliteHistorizer::configureDatabase(db, logOut);
+		}
 	}
 	// check if opened correctly
 	if (!db.isOpen())
@@ -2177,6 +2293,8 @@ bool QUaMultiSqliteHistorizer::closeDatabase(
 )
 {
 	const QString& strDbName = dbInfo.strFileName;
+	// write thread commits and closes its connections
+	this->flushWrites();
 	// check if there are any outstanding row blocks
 	// NOTE : we must flush the blocks because they "live" in the dbInfo.dataPrepStmts
 	//        in the DataPreparedStatements struct, so we gotta flush before we clear
@@ -2246,24 +2364,9 @@ bool QUaMultiSqliteHistorizer::flushOutstandingRowBlocks(
 		{
 			continue;
 		}
-		// create flush query
-		QString strStmt;	
-		QSqlQuery query(db);	
-		// prepared statement for multirow insert
-		strStmt = QString(
-			"INSERT INTO \"%1\" (Time, Value, Status) VALUES "
-		).arg(nodeId);
-		for (int i = 0; i < blockSize; i++)
-		{
-			if (i == blockSize - 1)
-			{
-				// last one
-				strStmt += QString("(:t%1, :v%1, :s%1);").arg(i);
-				break;
-			}
-			strStmt += QString("(:t%1, :v%1, :s%1), ").arg(i);
-		}
-		if (!this->prepareStmt(dbInfo, query, strStmt, logOut))
+		// flush query, prepared once per block size
+		QSqlQuery* query = this->multiRowInsertStmt(dbInfo, db, nodeId, blockSize, logOut);
+		if (!query)
 		{
 			ok = false;
 			continue;
@@ -2273,17 +2376,17 @@ bool QUaMultiSqliteHistorizer::flushOutstandingRowBlocks(
 		{
 			auto currTime = block.firstKey();
 			auto currPoint = block.take(currTime);
-			query.bindValue(3 * i, currTime.toMSecsSinceEpoch());
-			query.bindValue(3 * i + 1, currPoint.value);
-			query.bindValue(3 * i + 2, currPoint.status);
+			query->bindValue(3 * i, currTime.toMSecsSinceEpoch());
+			query->bindValue(3 * i + 1, currPoint.value);
+			query->bindValue(3 * i + 2, currPoint.status);
 		}
-		if (!query.exec())
+		if (!query->exec())
 		{
 			logOut << QUaLog({
 				QObject::tr("Could not flush row block in %1 table in %2 database. Sql : %3.")
 					.arg(nodeId)
 					.arg(dbInfo.strFileName)
-					.arg(query.lastError().text()),
+					.arg(query->lastError().text()),
 				QUaLogLevel::Error,
 				QUaLogCategory::History
 			});
@@ -2307,6 +2410,400 @@ bool QUaMultiSqliteHistorizer::flushOutstandingRowBlocks(
 	return ok;
 }
 
+QSqlQuery* QUaMultiSqliteHistorizer::multiRowInsertStmt(
+	DatabaseInfo& dbInfo,
+	QSqlDatabase& db,
+	const QUaNodeId& nodeId,
+	const int& rows,
+	QQueue<QUaLog>& logOut
+)
+{
+	auto& stmts = dbInfo.dataPrepStmts[nodeId].writeHistoryDataRows;
+	auto iter = stmts.find(rows);
+	if (iter != stmts.end())
+	{
+		return &iter.value();
+	}
+	QSqlQuery query(db);
+	if (!this->prepareStmt(dbInfo, query, QUaMultiSqliteHistorizer::multiRowInsertSql(nodeId, rows), logOut))
+	{
+		return nullptr;
+	}
+	return &stmts.insert(rows, query).value();
+}
+
+QString QUaMultiSqliteHistorizer::multiRowInsertSql(
+	const QUaNodeId& nodeId,
+	const int& rows
+)
+{
+	Q_ASSERT(rows > 0);
+	QString strStmt = QString(
+		"INSERT INTO \"%1\" (Time, Value, Status) VALUES "
+	).arg(nodeId);
+	strStmt.reserve(strStmt.size() + rows * 11);
+	for (int i = 0; i < rows; i++)
+	{
+		strStmt += i == 0 ? "(?, ?, ?)" : ", (?, ?, ?)";
+	}
+	strStmt += ";";
+	return strStmt;
+}
+
+bool QUaMultiSqliteHistorizer::configureDatabase(
+	QSqlDatabase& db,
+	QQueue<QUaLog>& logOut
+)
+{
+	// page size only applies to new files, WAL lets reads run while a transaction is open
+	// and with WAL, NORMAL synchronous only syncs on checkpoints (a power loss can only lose
+	// the last commits, never corrupt the file)
+	bool ok = true;
+	QSqlQuery query(db);
+	for (const char* strStmt : {
+		"PRAGMA page_size = 8192;",
+		"PRAGMA journal_mode = WAL;",
+		"PRAGMA synchronous = NORMAL;",
+		"PRAGMA temp_store = MEMORY;",
+		"PRAGMA cache_size = -8192;"
+		})
+	{
+		if (query.exec(strStmt))
+		{
+			continue;
+		}
+		logOut << QUaLog({
+			QObject::tr("Could not configure %1 database with %2. Sql : %3.")
+				.arg(db.databaseName())
+				.arg(strStmt)
+				.arg(query.lastError().text()),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+		ok = false;
+	}
+	return ok;
+}
+
+void QUaMultiSqliteHistorizer::stopWriteThread()
+{
+	{
+		QMutexLocker locker(&m_writeMutex);
+		if (!m_writeThread)
+		{
+			return;
+		}
+		m_writeStop = true;
+		m_writeNotEmpty.wakeOne();
+	}
+	// write thread commits queued data points before it returns
+	m_writeThread->wait();
+	delete m_writeThread;
+	QMutexLocker locker(&m_writeMutex);
+	m_writeThread = nullptr;
+	m_writeStop   = false;
+	m_deferedLogOut << m_writeLogOut;
+	m_writeLogOut.clear();
+}
+
+void QUaMultiSqliteHistorizer::writeLoop()
+{
+	// connections of this thread by database file name
+	QHash<QString, WriteDatabase> writeDbs;
+	QElapsedTimer transactionTimer;
+	int uncommitted = 0;
+	QQueue<WriteRow> rows;
+	while (true)
+	{
+		int  multiRowInsertSize;
+		int  timeoutTransaction;
+		int  commitRowsLimit;
+		bool stop;
+		bool flush;
+		bool pause;
+		{
+			QMutexLocker locker(&m_writeMutex);
+			// wait for rows, a flush, pause or stop request, or until the open transaction is due
+			while (m_writeQueue.isEmpty() && !m_writeStop && !m_writeFlush && m_writePause == 0)
+			{
+				if (uncommitted == 0)
+				{
+					m_writeNotEmpty.wait(&m_writeMutex);
+					continue;
+				}
+				qint64 remaining = m_timeoutTransaction - transactionTimer.elapsed();
+				if (remaining <= 0 ||
+					!m_writeNotEmpty.wait(&m_writeMutex, static_cast<unsigned long>(remaining)))
+				{
+					break;
+				}
+			}
+			pause = m_writePause > 0;
+			if (!pause)
+			{
+				rows.swap(m_writeQueue);
+				m_writeNotFull.wakeAll();
+			}
+			multiRowInsertSize = m_multiRowInsertSize;
+			timeoutTransaction = m_timeoutTransaction;
+			commitRowsLimit    = m_commitRowsLimit;
+			stop  = m_writeStop;
+			flush = m_writeFlush;
+		}
+		// commit and wait while the calling thread writes, rows queued meanwhile are kept
+		if (pause)
+		{
+			QQueue<QUaLog> logOut;
+			if (uncommitted > 0)
+			{
+				this->writeCommit(writeDbs, logOut);
+				uncommitted = 0;
+			}
+			QMutexLocker locker(&m_writeMutex);
+			m_writeLogOut << logOut;
+			m_writePaused = true;
+			m_writePausedChanged.wakeAll();
+			while (m_writePause > 0)
+			{
+				m_writePausedChanged.wait(&m_writeMutex);
+			}
+			m_writePaused = false;
+			continue;
+		}
+		// insert out of the lock, so the calling thread keeps queueing
+		QQueue<QUaLog> logOut;
+		for (const auto& row : rows)
+		{
+			auto& writeDb = writeDbs[row.strFileName];
+			if (!this->getWriteDatabase(row.strFileName, writeDb, logOut))
+			{
+				continue;
+			}
+			if (uncommitted++ == 0)
+			{
+				transactionTimer.start();
+			}
+			auto& block = writeDb.blocks[row.nodeId];
+			block.append(row.dataPoint);
+			if (block.count() >= multiRowInsertSize)
+			{
+				this->writeBlock(row.strFileName, writeDb, row.nodeId, logOut);
+			}
+		}
+		rows.clear();
+		// commit on time or size, and on flush or stop
+		if (uncommitted > 0 && (
+			stop || flush ||
+			timeoutTransaction <= 0 ||
+			uncommitted >= commitRowsLimit ||
+			transactionTimer.elapsed() >= timeoutTransaction))
+		{
+			this->writeCommit(writeDbs, logOut);
+			uncommitted = 0;
+		}
+		// close connections on flush, so the calling thread can close or delete the files
+		if (stop || flush)
+		{
+			for (auto iter = writeDbs.begin(); iter != writeDbs.end(); iter++)
+			{
+				auto& writeDb = iter.value();
+				QString strConnName = writeDb.db.connectionName();
+				writeDb.insertStmts.clear();
+				writeDb.db.close();
+				writeDb.db = QSqlDatabase();
+				QSqlDatabase::removeDatabase(strConnName);
+			}
+			writeDbs.clear();
+		}
+		QMutexLocker locker(&m_writeMutex);
+		m_writeLogOut << logOut;
+		// rows queued meanwhile are written before completing the flush
+		if (!m_writeQueue.isEmpty())
+		{
+			continue;
+		}
+		if (flush)
+		{
+			m_writeFlush = false;
+			m_writeFlushed.wakeAll();
+		}
+		if (stop)
+		{
+			return;
+		}
+	}
+}
+
+void QUaMultiSqliteHistorizer::pauseWrites()
+{
+	QMutexLocker locker(&m_writeMutex);
+	if (!m_writeThread)
+	{
+		return;
+	}
+	// nested pauses only wait once
+	if (m_writePause++ > 0)
+	{
+		return;
+	}
+	m_writeNotEmpty.wakeOne();
+	while (!m_writePaused)
+	{
+		m_writePausedChanged.wait(&m_writeMutex);
+	}
+}
+
+void QUaMultiSqliteHistorizer::resumeWrites()
+{
+	QMutexLocker locker(&m_writeMutex);
+	if (m_writePause == 0)
+	{
+		return;
+	}
+	m_writePause--;
+	if (m_writePause == 0)
+	{
+		m_writePausedChanged.wakeAll();
+	}
+}
+
+bool QUaMultiSqliteHistorizer::getWriteDatabase(
+	const QString& strFileName,
+	WriteDatabase& writeDb,
+	QQueue<QUaLog>& logOut
+)
+{
+	if (!writeDb.db.isValid())
+	{
+		writeDb.openedTransaction = false;
+		// connection names are global, so use a different name than the calling thread
+		writeDb.db = QSqlDatabase::addDatabase("QSQLITE", strFileName + ".writer");
+		writeDb.db.setDatabaseName(strFileName);
+		writeDb.db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+		if (writeDb.db.open())
+		{
+			QUaMultiSqliteHistorizer::configureDatabase(writeDb.db, logOut);
+		}
+	}
+	if (!writeDb.db.isOpen())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error opening %1 from write thread. Sql : %2")
+				.arg(strFileName)
+				.arg(writeDb.db.lastError().text()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	if (writeDb.openedTransaction)
+	{
+		return true;
+	}
+	writeDb.openedTransaction = writeDb.db.transaction();
+	if (!writeDb.openedTransaction)
+	{
+		logOut << QUaLog({
+			QObject::tr("Failed to begin transaction in %1 database from write thread. Sql : %2.")
+				.arg(strFileName)
+				.arg(writeDb.db.lastError().text()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	return true;
+}
+
+bool QUaMultiSqliteHistorizer::writeBlock(
+	const QString& strFileName,
+	WriteDatabase& writeDb,
+	const QUaNodeId& nodeId,
+	QQueue<QUaLog>& logOut
+)
+{
+	auto& block = writeDb.blocks[nodeId];
+	int blockSize = block.count();
+	if (blockSize <= 0)
+	{
+		return true;
+	}
+	// prepared once per table and block size
+	auto& stmts = writeDb.insertStmts[nodeId];
+	auto iter = stmts.find(blockSize);
+	if (iter == stmts.end())
+	{
+		QSqlQuery query(writeDb.db);
+		QString strStmt = QUaMultiSqliteHistorizer::multiRowInsertSql(nodeId, blockSize);
+		if (!query.prepare(strStmt))
+		{
+			logOut << QUaLog({
+				QObject::tr("Error preparing statement %1 for %2 database. Sql : %3.")
+					.arg(strStmt)
+					.arg(strFileName)
+					.arg(query.lastError().text()),
+				QUaLogLevel::Error,
+				QUaLogCategory::History
+			});
+			block.clear();
+			return false;
+		}
+		iter = stmts.insert(blockSize, query);
+	}
+	QSqlQuery& query = iter.value();
+	for (int i = 0; i < blockSize; i++)
+	{
+		const auto& dataPoint = block.at(i);
+		query.bindValue(3 * i    , dataPoint.timestamp.toMSecsSinceEpoch());
+		query.bindValue(3 * i + 1, dataPoint.value);
+		query.bindValue(3 * i + 2, dataPoint.status);
+	}
+	block.clear();
+	if (!query.exec())
+	{
+		logOut << QUaLog({
+			QObject::tr("Could not insert new row block in %1 table in %2 database. Sql : %3.")
+				.arg(nodeId)
+				.arg(strFileName)
+				.arg(query.lastError().text()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	return true;
+}
+
+void QUaMultiSqliteHistorizer::writeCommit(
+	QHash<QString, WriteDatabase>& writeDbs,
+	QQueue<QUaLog>& logOut
+)
+{
+	for (auto iter = writeDbs.begin(); iter != writeDbs.end(); iter++)
+	{
+		auto& writeDb = iter.value();
+		for (auto block = writeDb.blocks.begin(); block != writeDb.blocks.end(); block++)
+		{
+			this->writeBlock(iter.key(), writeDb, block.key(), logOut);
+		}
+		if (!writeDb.openedTransaction)
+		{
+			continue;
+		}
+		if (!writeDb.db.commit())
+		{
+			logOut << QUaLog({
+				QObject::tr("Failed to commit transaction in %1 database from write thread. Sql : %2.")
+					.arg(iter.key())
+					.arg(writeDb.db.lastError().text()),
+				QUaLogLevel::Error,
+				QUaLogCategory::History
+			});
+		}
+		writeDb.openedTransaction = false;
+	}
+}
+
 bool QUaMultiSqliteHistorizer::checkDatabase(
 	const QDateTime& startTime,
 	QQueue<QUaLog>& logOut
@@ -2339,8 +2836,8 @@ bool QUaMultiSqliteHistorizer::checkDatabase(
 			});
 		return false;
 	}
-	// convert bytes to Mb
-	fileSizeMb = fileInfo.size() / 1024.0 / 1024.0;
+	// convert bytes to Mb, including the write ahead log
+	fileSizeMb = (fileInfo.size() + QFileInfo(strDbName + "-wal").size()) / 1024.0 / 1024.0;
 	// return ok if size is below limit
 	bool totalSizeCheck = false;
 	if (fileSizeMb >= m_fileSizeLimMb)
@@ -2368,7 +2865,7 @@ bool QUaMultiSqliteHistorizer::checkDatabase(
 	for (auto & dbInfo : m_dbFiles)
 	{
 		auto fInfo = QFileInfo(dbInfo.strFileName);
-		totalSizeMb += fInfo.size() / 1024.0 / 1024.0;
+		totalSizeMb += (fInfo.size() + QFileInfo(dbInfo.strFileName + "-wal").size()) / 1024.0 / 1024.0;
 	}
 	// remove oldest files until total size is ok
 	m_deferTotalSizeCheck = false;
@@ -2406,8 +2903,10 @@ bool QUaMultiSqliteHistorizer::checkDatabase(
 		}
 		// substract size
 		auto fInfo = QFileInfo(dbInfo.strFileName);		
-		totalSizeMb -= fInfo.size() / 1024.0 / 1024.0;
-		// remove file
+		totalSizeMb -= (fInfo.size() + QFileInfo(dbInfo.strFileName + "-wal").size()) / 1024.0 / 1024.0;
+		// remove file, the write ahead log files are left if not checkpointed on close
+		QFile::remove(dbInfo.strFileName + "-wal");
+		QFile::remove(dbInfo.strFileName + "-shm");
 		QFile file(dbInfo.strFileName);
 		ok = file.remove();
 		if (!ok)
@@ -2691,31 +3190,35 @@ bool QUaMultiSqliteHistorizer::insertDataPoint(
 		dataPoint.value,
 		dataPoint.status
 	};
-	Q_ASSERT(block.size() <= m_multiRowInsertSize);
 	// return if block not full
+	// NOTE : block can be larger if multiRowInsertSize was reduced
 	if (block.size() < m_multiRowInsertSize)
 	{
 		return true;
 	}
-	Q_ASSERT(block.size() == m_multiRowInsertSize);
 	// multirow insert if block full
-	QSqlQuery& query = dbInfo.dataPrepStmts[nodeId].writeHistoryDataMultiRow;
+	int blockSize = block.size();
+	QSqlQuery* query = this->multiRowInsertStmt(dbInfo, db, nodeId, blockSize, logOut);
+	if (!query)
+	{
+		return false;
+	}
 	// insert block
-	for (int i = 0; i < m_multiRowInsertSize; i++)
+	for (int i = 0; i < blockSize; i++)
 	{
 		auto currTime  = block.firstKey();
 		auto currPoint = block.take(currTime);
-		query.bindValue(3 * i    , currTime.toMSecsSinceEpoch());
-		query.bindValue(3 * i + 1, currPoint.value);
-		query.bindValue(3 * i + 2, currPoint.status);
+		query->bindValue(3 * i    , currTime.toMSecsSinceEpoch());
+		query->bindValue(3 * i + 1, currPoint.value);
+		query->bindValue(3 * i + 2, currPoint.status);
 	}
-	if (!query.exec())
+	if (!query->exec())
 	{
 		logOut << QUaLog({
 			QObject::tr("Could not insert new row block in %1 table in %2 database. Sql : %3.")
 				.arg(nodeId)
 				.arg(strDbName)
-				.arg(query.lastError().text()),
+				.arg(query->lastError().text()),
 			QUaLogLevel::Error,
 			QUaLogCategory::History
 		});
@@ -2755,25 +3258,7 @@ bool QUaMultiSqliteHistorizer::dataPrepareAllStmts(
 		return false;
 	}
 	dbInfo.dataPrepStmts[nodeId].writeHistoryData = query;
-	// prepared statement for multirow insert
-	strStmt = QString(
-		"INSERT INTO \"%1\" (Time, Value, Status) VALUES "
-	).arg(nodeId);
-	for (int i = 0; i < m_multiRowInsertSize; i++)
-	{
-		if (i == m_multiRowInsertSize - 1)
-		{
-			// last one
-			strStmt += QString("(:t%1, :v%1, :s%1);").arg(i);
-			break;
-		}
-		strStmt += QString("(:t%1, :v%1, :s%1), ").arg(i);
-	}
-	if (!this->prepareStmt(dbInfo, query, strStmt, logOut))
-	{
-		return false;
-	}
-	dbInfo.dataPrepStmts[nodeId].writeHistoryDataMultiRow = query;
+	// NOTE : multirow insert statements are prepared on first use (see multiRowInsertStmt)
 	// prepared statement for first timestamp
 	strStmt = QString(
 		"SELECT "
@@ -2897,6 +3382,30 @@ bool QUaMultiSqliteHistorizer::dataPrepareAllStmts(
 	}
 	query.setForwardOnly(true);
 	dbInfo.dataPrepStmts[nodeId].numDataPointsInRangeEndInvalid = query;
+	// prepared statement for num points in range when end time is invalid, up to a limit
+	strStmt = QString(
+		"SELECT "
+		"COUNT(*) "
+		"FROM "
+		"("
+		"SELECT "
+		"1 "
+		"FROM "
+		"\"%1\" p "
+		"WHERE "
+		"p.Time >= :TimeStart "
+		"ORDER BY "
+		"p.Time ASC "
+		"LIMIT "
+		":Limit"
+		");"
+	).arg(nodeId);
+	if (!this->prepareStmt(dbInfo, query, strStmt, logOut))
+	{
+		return false;
+	}
+	query.setForwardOnly(true);
+	dbInfo.dataPrepStmts[nodeId].numDataPointsInRangeBounded = query;
 	// prepared statement for reading data points
 	strStmt = QString(
 		"SELECT "
@@ -2949,7 +3458,9 @@ bool QUaMultiSqliteHistorizer::handleTransactions(
 	QQueue<QUaLog>& logOut)
 {
 	// return success if transactions disabled
-	if (m_timeoutTransaction == 0)
+	// NOTE : with write thread, writes of the calling thread (tables, events) autocommit
+	//        so the calling connection never holds the write lock
+	if (m_timeoutTransaction == 0 || m_writeThread)
 	{
 		return true;
 	}
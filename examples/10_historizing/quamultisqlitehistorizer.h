@@ -11,6 +11,10 @@
 #include <QTimer>
 #include <QFileSystemWatcher>
 #include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+
+class QThread;
 
 class QUaMultiSqliteHistorizer
 {
@@ -55,6 +59,30 @@ public:
 	int multiRowInsertSize() const;
 	void setMultiRowInsertSize(const int& rows);
 
+	// write data points from a dedicated thread with its own connection to each database file
+	// the connections of the calling thread are then only used for reads, event writes and
+	// creating tables, and in WAL mode reads never wait on the data writes
+	// NOTE : event writes and creating tables wait until the write thread commits, instead
+	//        of waiting up to transactionTimeout on its write lock
+	// NOTE : queued data points are returned by reads once committed (see flushWrites)
+	// default is false
+	bool writeThread() const;
+	void setWriteThread(const bool& writeThread);
+
+	// number of rows after which the write thread commits, before transactionTimeout elapses
+	// default is 10000 rows
+	int commitRowsLimit() const;
+	void setCommitRowsLimit(const int& rows);
+
+	// maximum number of data points queued for the write thread, writes of the calling thread
+	// block while the queue is full
+	// default is 100000 data points
+	int writeQueueSize() const;
+	void setWriteQueueSize(const int& size);
+
+	// block until the write thread has committed all queued data points
+	void flushWrites();
+
 	// required API for QUaServer::setHistorizer
 	// write data point to backend, return true on success
 	bool writeHistoryData(
@@ -202,9 +230,10 @@ private:
 		QSqlQuery findTimestampBelow;
 		QSqlQuery numDataPointsInRangeEndValid;
 		QSqlQuery numDataPointsInRangeEndInvalid;
+		QSqlQuery numDataPointsInRangeBounded;
 		QSqlQuery readHistoryData;
 		DataPointBlock multiRowBlock; // map to query on time
-		QSqlQuery writeHistoryDataMultiRow;
+		QHash<int, QSqlQuery> writeHistoryDataRows; // multirow insert by number of rows
 	};	
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	// event type name prepared statement cache
@@ -228,6 +257,34 @@ private:
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	};
 	QMap<QDateTime, DatabaseInfo> m_dbFiles;
+	// data point queued for the write thread
+	struct WriteRow {
+		QString strFileName;
+		QUaNodeId nodeId;
+		QUaHistoryDataPoint dataPoint;
+	};
+	// write thread connection to a database file
+	struct WriteDatabase {
+		QSqlDatabase db;
+		bool openedTransaction;
+		QHash<QUaNodeId, QVector<QUaHistoryDataPoint>> blocks;
+		QHash<QUaNodeId, QHash<int, QSqlQuery>> insertStmts; // by table and number of rows
+	};
+	QThread *        m_writeThread;
+	QMutex           m_writeMutex;
+	QWaitCondition   m_writeNotEmpty;
+	QWaitCondition   m_writeFlushed;
+	QWaitCondition   m_writeNotFull;
+	QWaitCondition   m_writePausedChanged;
+	QQueue<WriteRow> m_writeQueue;
+	QQueue<QUaLog>   m_writeLogOut;
+	bool             m_writeStop;
+	bool             m_writeFlush;
+	int              m_writePause;  // pause requests of the calling thread
+	bool             m_writePaused; // write thread committed and waiting
+	int              m_writeQueueSize;
+	int              m_commitRowsLimit;
+	friend class QUaMultiSqliteWritePause;
 	// return SQL type in string form, for given Qt type (only QUaServer supported types)
 	static QHash<int, QString> m_hashTypes;
 	static QMetaType::Type QVariantToQtType(const QVariant& value);
@@ -266,6 +323,48 @@ private:
 		DatabaseInfo& dbInfo,
 		QQueue<QUaLog>& logOut
 	);
+	// get the multirow insert statement of a table for the given number of rows, prepared on first use
+	QSqlQuery* multiRowInsertStmt(
+		DatabaseInfo& dbInfo,
+		QSqlDatabase& db,
+		const QUaNodeId& nodeId,
+		const int& rows,
+		QQueue<QUaLog>& logOut
+	);
+	static QString multiRowInsertSql(
+		const QUaNodeId& nodeId,
+		const int& rows
+	);
+	// set journal (WAL), synchronous and page pragmas of a new connection
+	static bool configureDatabase(
+		QSqlDatabase& db,
+		QQueue<QUaLog>& logOut
+	);
+	// write thread
+	void stopWriteThread();
+	void writeLoop();
+	// make the write thread commit and wait, so the calling thread can write without waiting
+	// on the write thread's lock, no-op without write thread
+	void pauseWrites();
+	void resumeWrites();
+	// get write thread connection, opened with a transaction
+	bool getWriteDatabase(
+		const QString& strFileName,
+		WriteDatabase& writeDb,
+		QQueue<QUaLog>& logOut
+	);
+	// insert the queued rows of a table in a single statement
+	bool writeBlock(
+		const QString& strFileName,
+		WriteDatabase& writeDb,
+		const QUaNodeId& nodeId,
+		QQueue<QUaLog>& logOut
+	);
+	// insert the remaining rows and commit all write thread transactions
+	void writeCommit(
+		QHash<QString, WriteDatabase>& writeDbs,
+		QQueue<QUaLog>& logOut
+	);
 	// checks current database size and creates a new one if necessary
 	bool checkDatabase(
 		const QDateTime& startTime,
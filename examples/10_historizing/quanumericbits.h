@@ -0,0 +1,175 @@
+#ifndef QUANUMERICBITS_H
+#define QUANUMERICBITS_H
+
+#include <QUaHistoryBackend>
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include <cstring>
+
+// numeric values as 64 bits, shared by the historizers which store them packed
+namespace QUaNumericBits {
+
+// true for the meta types stored as 64 bits
+inline bool isNumericType(const int& type)
+{
+	switch (type)
+	{
+	case QMetaType::Bool:
+	case QMetaType::Char:
+	case QMetaType::SChar:
+	case QMetaType::UChar:
+	case QMetaType::Short:
+	case QMetaType::UShort:
+	case QMetaType::Int:
+	case QMetaType::UInt:
+	case QMetaType::Long:
+	case QMetaType::ULong:
+	case QMetaType::LongLong:
+	case QMetaType::ULongLong:
+	case QMetaType::Float:
+	case QMetaType::Double:
+		return true;
+	default:
+		break;
+	}
+	return false;
+}
+
+// bits of a numeric value, the bits of a double for floating point types
+inline quint64 valueToBits(const QVariant& value, const int& type)
+{
+	switch (type)
+	{
+	case QMetaType::Float:
+	case QMetaType::Double:
+	{
+		double dblVal = value.toDouble();
+		quint64 bits;
+		std::memcpy(&bits, &dblVal, sizeof(bits));
+		return bits;
+	}
+	case QMetaType::UChar:
+	case QMetaType::UShort:
+	case QMetaType::UInt:
+	case QMetaType::ULong:
+	case QMetaType::ULongLong:
+		return value.toULongLong();
+	default:
+		break;
+	}
+	return static_cast<quint64>(value.toLongLong());
+}
+
+// same type and bits as the converted QVariant, false if not a numeric scalar
+inline bool valueToBits(const UA_Variant& value, int& type, quint64& bits)
+{
+	if (!value.type || !UA_Variant_isScalar(&value))
+	{
+		return false;
+	}
+	switch (value.type->typeIndex)
+	{
+	case UA_TYPES_BOOLEAN:
+		type = QMetaType::Bool;
+		bits = *static_cast<const UA_Boolean*>(value.data) ? 1 : 0;
+		return true;
+	case UA_TYPES_SBYTE:
+		type = QMetaType::SChar;
+		bits = static_cast<quint64>(static_cast<qint64>(*static_cast<const UA_SByte*>(value.data)));
+		return true;
+	case UA_TYPES_BYTE:
+		type = QMetaType::UChar;
+		bits = *static_cast<const UA_Byte*>(value.data);
+		return true;
+	case UA_TYPES_INT16:
+		type = QMetaType::Short;
+		bits = static_cast<quint64>(static_cast<qint64>(*static_cast<const UA_Int16*>(value.data)));
+		return true;
+	case UA_TYPES_UINT16:
+		type = QMetaType::UShort;
+		bits = *static_cast<const UA_UInt16*>(value.data);
+		return true;
+	case UA_TYPES_INT32:
+		type = QMetaType::Int;
+		bits = static_cast<quint64>(static_cast<qint64>(*static_cast<const UA_Int32*>(value.data)));
+		return true;
+	case UA_TYPES_UINT32:
+		type = QMetaType::UInt;
+		bits = *static_cast<const UA_UInt32*>(value.data);
+		return true;
+	case UA_TYPES_INT64:
+		type = QMetaType::LongLong;
+		bits = static_cast<quint64>(*static_cast<const UA_Int64*>(value.data));
+		return true;
+	case UA_TYPES_UINT64:
+		type = QMetaType::ULongLong;
+		bits = *static_cast<const UA_UInt64*>(value.data);
+		return true;
+	case UA_TYPES_FLOAT:
+	case UA_TYPES_DOUBLE:
+	{
+		type = value.type->typeIndex == UA_TYPES_FLOAT ? QMetaType::Float : QMetaType::Double;
+		double dblVal = value.type->typeIndex == UA_TYPES_FLOAT ?
+			static_cast<double>(*static_cast<const UA_Float*>(value.data)) :
+			*static_cast<const UA_Double*>(value.data);
+		std::memcpy(&bits, &dblVal, sizeof(bits));
+		return true;
+	}
+	default:
+		break;
+	}
+	return false;
+}
+
+// numeric value of the given meta type from its bits
+inline QVariant bitsToValue(const quint64& bits, const int& type)
+{
+	qint64 intVal = static_cast<qint64>(bits);
+	switch (type)
+	{
+	case QMetaType::Bool:
+		return QVariant::fromValue(bits != 0);
+	case QMetaType::Char:
+		return QVariant::fromValue(static_cast<char>(intVal));
+	case QMetaType::SChar:
+		return QVariant::fromValue(static_cast<signed char>(intVal));
+	case QMetaType::UChar:
+		return QVariant::fromValue(static_cast<uchar>(bits));
+	case QMetaType::Short:
+		return QVariant::fromValue(static_cast<short>(intVal));
+	case QMetaType::UShort:
+		return QVariant::fromValue(static_cast<ushort>(bits));
+	case QMetaType::Int:
+		return QVariant::fromValue(static_cast<int>(intVal));
+	case QMetaType::UInt:
+		return QVariant::fromValue(static_cast<uint>(bits));
+	case QMetaType::Long:
+		return QVariant::fromValue(static_cast<long>(intVal));
+	case QMetaType::ULong:
+		return QVariant::fromValue(static_cast<ulong>(bits));
+	case QMetaType::LongLong:
+		return QVariant::fromValue(intVal);
+	case QMetaType::ULongLong:
+		return QVariant::fromValue(bits);
+	case QMetaType::Float:
+	case QMetaType::Double:
+	{
+		double dblVal;
+		std::memcpy(&dblVal, &bits, sizeof(dblVal));
+		return type == QMetaType::Float ?
+			QVariant::fromValue(static_cast<float>(dblVal)) :
+			QVariant::fromValue(dblVal);
+	}
+	default:
+		break;
+	}
+	Q_ASSERT(false);
+	return QVariant();
+}
+
+} // namespace QUaNumericBits
+
+#endif // UA_ENABLE_HISTORIZING
+
+#endif // QUANUMERICBITS_H
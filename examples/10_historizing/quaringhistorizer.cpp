@@ -0,0 +1,634 @@
+#include "quaringhistorizer.h"
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include <limits>
+#include <algorithm>
+
+QUaRingHistorizer::QUaRingHistorizer()
+{
+	m_defaultRetention = { 10000, 0, 0 };
+}
+
+QUaRingHistorizer::Retention QUaRingHistorizer::defaultRetention() const
+{
+	return m_defaultRetention;
+}
+
+void QUaRingHistorizer::setDefaultRetention(const Retention& retention)
+{
+	m_defaultRetention = {
+		(std::max)(1, retention.capacity),
+		(std::max)(Q_INT64_C(0), retention.downsampleInterval),
+		(std::max)(0, retention.downsampleCapacity)
+	};
+}
+
+QUaRingHistorizer::Retention QUaRingHistorizer::retention(const QUaNodeId& nodeId) const
+{
+	auto iter = m_database.constFind(nodeId);
+	return iter != m_database.constEnd() ? iter->retention : m_defaultRetention;
+}
+
+void QUaRingHistorizer::setRetention(const QUaNodeId& nodeId, const Retention& retention)
+{
+	Retention newRetention = {
+		(std::max)(1, retention.capacity),
+		(std::max)(Q_INT64_C(0), retention.downsampleInterval),
+		(std::max)(0, retention.downsampleCapacity)
+	};
+	auto& history = this->nodeHistory(nodeId);
+	// keep the most recent entries that fit the new capacities
+	const auto& oldRetention = history.retention;
+	if (newRetention.capacity           == oldRetention.capacity &&
+		newRetention.downsampleCapacity == oldRetention.downsampleCapacity)
+	{
+		history.retention = newRetention;
+		return;
+	}
+	Ring points  = history.points;
+	Ring buckets = history.buckets;
+	history.retention = newRetention;
+	QUaRingHistorizer::ringReset(history.points , newRetention.capacity);
+	QUaRingHistorizer::ringReset(history.buckets, newRetention.downsampleCapacity);
+	Entry evicted;
+	for (int i = 0; i < buckets.count; i++)
+	{
+		QUaRingHistorizer::ringAppend(history.buckets, QUaRingHistorizer::ringAt(buckets, i), evicted);
+	}
+	// data points which no longer fit are evicted as if the buffer had filled up
+	for (int i = 0; i < points.count; i++)
+	{
+		if (QUaRingHistorizer::ringAppend(history.points, QUaRingHistorizer::ringAt(points, i), evicted))
+		{
+			this->evict(history, evicted);
+		}
+	}
+}
+
+QList<QUaNodeId> QUaRingHistorizer::nodeIds() const
+{
+	return m_database.keys();
+}
+
+QUaRingHistorizer::NodeStats QUaRingHistorizer::nodeStats(const QUaNodeId& nodeId) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd())
+	{
+		return { m_defaultRetention.capacity, 0, m_defaultRetention.downsampleCapacity, 0, 0, 0, 0 };
+	}
+	return {
+		iter->retention.capacity,
+		iter->points.count,
+		iter->retention.downsampleCapacity,
+		iter->buckets.count,
+		iter->evicted,
+		iter->downsampled,
+		iter->rejected
+	};
+}
+
+bool QUaRingHistorizer::writeHistoryData(
+	const QUaNodeId &nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	Q_UNUSED(logOut);
+	auto& history = this->nodeHistory(nodeId);
+	auto& points  = history.points;
+	Entry entry = {
+		dataPoint.timestamp.toMSecsSinceEpoch(),
+		dataPoint.value,
+		dataPoint.status
+	};
+	Entry evicted;
+	// fast path, data points usually arrive in order
+	if (points.count == 0 || entry.time > QUaRingHistorizer::ringAt(points, points.count - 1).time)
+	{
+		// NOTE : buckets are older than any data point, so an empty buffer must not go behind them
+		if (points.count == 0 && history.buckets.count > 0 &&
+			entry.time <= QUaRingHistorizer::ringAt(history.buckets, history.buckets.count - 1).time)
+		{
+			history.rejected++;
+			return true;
+		}
+		if (QUaRingHistorizer::ringAppend(points, entry, evicted))
+		{
+			this->evict(history, evicted);
+		}
+		return true;
+	}
+	// overwrite existing
+	int total = QUaRingHistorizer::count(history);
+	int index = QUaRingHistorizer::lowerBound(history, entry.time);
+	if (index < total && QUaRingHistorizer::entryAt(history, index).time == entry.time)
+	{
+		if (index < history.buckets.count)
+		{
+			QUaRingHistorizer::ringAt(history.buckets, index) = entry;
+			return true;
+		}
+		QUaRingHistorizer::ringAt(points, index - history.buckets.count) = entry;
+		return true;
+	}
+	// out of order, older than anything kept in buffer, cannot be inserted without evicting newer
+	int pos = index - history.buckets.count;
+	bool full = points.count == points.buffer.count();
+	if (pos < 0 || (pos == 0 && full))
+	{
+		history.rejected++;
+		return true;
+	}
+	// out of order, append and move it back to where it belongs
+	if (QUaRingHistorizer::ringAppend(points, entry, evicted))
+	{
+		this->evict(history, evicted);
+		pos--;
+	}
+	for (int i = points.count - 1; i > pos; i--)
+	{
+		std::swap(
+			QUaRingHistorizer::ringAt(points, i),
+			QUaRingHistorizer::ringAt(points, i - 1)
+		);
+	}
+	return true;
+}
+
+bool QUaRingHistorizer::updateHistoryData(
+	const QUaNodeId &nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	Q_ASSERT(
+		m_database.contains(nodeId) &&
+		this->hasTimestamp(nodeId, dataPoint.timestamp, logOut)
+	);
+	return this->writeHistoryData(nodeId, dataPoint, logOut);
+}
+
+bool QUaRingHistorizer::removeHistoryData(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QQueue<QUaLog>& logOut)
+{
+	Q_ASSERT(timeStart <= timeEnd || !timeEnd.isValid());
+	if (!m_database.contains(nodeId))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error removing history data. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return false;
+	}
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	qint64 end   = timeEnd.isValid() ? timeEnd.toMSecsSinceEpoch() : (std::numeric_limits<qint64>::max)();
+	auto& history = m_database[nodeId];
+	// compact both rings in place, keeping the order
+	for (Ring* ring : { &history.buckets, &history.points })
+	{
+		int kept = 0;
+		for (int i = 0; i < ring->count; i++)
+		{
+			const auto& entry = QUaRingHistorizer::ringAt(*ring, i);
+			if (entry.time >= start && entry.time <= end)
+			{
+				continue;
+			}
+			if (kept != i)
+			{
+				QUaRingHistorizer::ringAt(*ring, kept) = entry;
+			}
+			kept++;
+		}
+		// release values of removed entries
+		for (int i = kept; i < ring->count; i++)
+		{
+			QUaRingHistorizer::ringAt(*ring, i).value = QVariant();
+		}
+		ring->count = kept;
+	}
+	// last bucket might have been removed, start a new one
+	history.bucketCount = 0;
+	return true;
+}
+
+QDateTime QUaRingHistorizer::firstTimestamp(
+	const QUaNodeId &nodeId,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd() || QUaRingHistorizer::count(*iter) == 0)
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding first history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	return QDateTime::fromMSecsSinceEpoch(QUaRingHistorizer::entryAt(*iter, 0).time, Qt::UTC);
+}
+
+QDateTime QUaRingHistorizer::lastTimestamp(
+	const QUaNodeId &nodeId,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd() || QUaRingHistorizer::count(*iter) == 0)
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding most recent history timstamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	return QDateTime::fromMSecsSinceEpoch(
+		QUaRingHistorizer::entryAt(*iter, QUaRingHistorizer::count(*iter) - 1).time,
+		Qt::UTC
+	);
+}
+
+bool QUaRingHistorizer::hasTimestamp(
+	const QUaNodeId &nodeId,
+	const QDateTime& timestamp,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return false;
+	}
+	qint64 time = timestamp.toMSecsSinceEpoch();
+	int index = QUaRingHistorizer::lowerBound(*iter, time);
+	return index < QUaRingHistorizer::count(*iter) &&
+		QUaRingHistorizer::entryAt(*iter, index).time == time;
+}
+
+QDateTime QUaRingHistorizer::findTimestamp(
+	const QUaNodeId &nodeId,
+	const QDateTime& timestamp,
+	const QUaHistoryBackend::TimeMatch& match,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	// NOTE : the database might or might not contain the input timestamp
+	qint64 time = timestamp.toMSecsSinceEpoch();
+	switch (match)
+	{
+	case QUaHistoryBackend::TimeMatch::ClosestFromAbove:
+	{
+		int index = QUaRingHistorizer::upperBound(*iter, time);
+		if (index < QUaRingHistorizer::count(*iter))
+		{
+			return QDateTime::fromMSecsSinceEpoch(QUaRingHistorizer::entryAt(*iter, index).time, Qt::UTC);
+		}
+		// if there is none return last
+		return this->lastTimestamp(nodeId, logOut);
+	}
+	break;
+	case QUaHistoryBackend::TimeMatch::ClosestFromBelow:
+	{
+		int index = QUaRingHistorizer::lowerBound(*iter, time);
+		if (index > 0)
+		{
+			return QDateTime::fromMSecsSinceEpoch(QUaRingHistorizer::entryAt(*iter, index - 1).time, Qt::UTC);
+		}
+		// if there is none return first
+		return this->firstTimestamp(nodeId, logOut);
+	}
+	break;
+	default:
+		Q_ASSERT(false);
+		break;
+	}
+	return QDateTime();
+}
+
+quint64 QUaRingHistorizer::numDataPointsInRange(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QQueue<QUaLog>& logOut) const
+{
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding history points. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return 0;
+	}
+	int indexIni = QUaRingHistorizer::lowerBound(*iter, timeStart.toMSecsSinceEpoch());
+	// if the end timestamp is invalid, it means the API is requesting up to the most recent timestamp
+	int indexEnd = timeEnd.isValid() ?
+		QUaRingHistorizer::upperBound(*iter, timeEnd.toMSecsSinceEpoch()) :
+		QUaRingHistorizer::count(*iter);
+	return static_cast<quint64>((std::max)(0, indexEnd - indexIni));
+}
+
+QVector<QUaHistoryDataPoint> QUaRingHistorizer::readHistoryData(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const quint64& numPointsOffset,
+	const quint64& numPointsToRead,
+	QQueue<QUaLog>& logOut) const
+{
+	auto points = QVector<QUaHistoryDataPoint>();
+	auto iter = m_database.constFind(nodeId);
+	if (iter == m_database.constEnd())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error reading history data. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return points;
+	}
+	// position of start timestamp plus offset
+	quint64 index = static_cast<quint64>(QUaRingHistorizer::lowerBound(*iter, timeStart.toMSecsSinceEpoch()));
+	index += numPointsOffset;
+	// copy return data points
+	quint64 total = static_cast<quint64>(QUaRingHistorizer::count(*iter));
+	points.reserve(static_cast<int>(numPointsToRead));
+	for (; index < total && static_cast<quint64>(points.count()) < numPointsToRead; index++)
+	{
+		const auto& entry = QUaRingHistorizer::entryAt(*iter, static_cast<int>(index));
+		points.append({
+			QDateTime::fromMSecsSinceEpoch(entry.time, Qt::UTC),
+			entry.value,
+			entry.status
+		});
+	}
+	// NOTE : return invalid values if API requests more values than available
+	points.resize(static_cast<int>(numPointsToRead));
+	return points;
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+bool QUaRingHistorizer::writeHistoryEventsOfType(
+	const QUaNodeId            &eventTypeNodeId,
+	const QList<QUaNodeId>     &emittersNodeIds,
+	const QUaHistoryEventPoint &eventPoint,
+	QQueue<QUaLog>             &logOut
+)
+{
+	return m_events.writeHistoryEventsOfType(eventTypeNodeId, emittersNodeIds, eventPoint, logOut);
+}
+
+QVector<QUaNodeId> QUaRingHistorizer::eventTypesOfEmitter(
+	const QUaNodeId &emitterNodeId,
+	QQueue<QUaLog>  &logOut
+)
+{
+	return m_events.eventTypesOfEmitter(emitterNodeId, logOut);
+}
+
+QDateTime QUaRingHistorizer::findTimestampEventOfType(
+	const QUaNodeId                    &emitterNodeId,
+	const QUaNodeId                    &eventTypeNodeId,
+	const QDateTime                    &timestamp,
+	const QUaHistoryBackend::TimeMatch &match,
+	QQueue<QUaLog>                     &logOut
+)
+{
+	return m_events.findTimestampEventOfType(emitterNodeId, eventTypeNodeId, timestamp, match, logOut);
+}
+
+quint64 QUaRingHistorizer::numEventsOfTypeInRange(
+	const QUaNodeId &emitterNodeId,
+	const QUaNodeId &eventTypeNodeId,
+	const QDateTime &timeStart,
+	const QDateTime &timeEnd,
+	QQueue<QUaLog>  &logOut
+)
+{
+	return m_events.numEventsOfTypeInRange(emitterNodeId, eventTypeNodeId, timeStart, timeEnd, logOut);
+}
+
+QVector<QUaHistoryEventPoint> QUaRingHistorizer::readHistoryEventsOfType(
+	const QUaNodeId &emitterNodeId,
+	const QUaNodeId &eventTypeNodeId,
+	const QDateTime &timeStart,
+	const quint64   &numPointsOffset,
+	const quint64   &numPointsToRead,
+	const QList<QUaBrowsePath> &columnsToRead,
+	QQueue<QUaLog>  &logOut
+)
+{
+	return m_events.readHistoryEventsOfType(
+		emitterNodeId,
+		eventTypeNodeId,
+		timeStart,
+		numPointsOffset,
+		numPointsToRead,
+		columnsToRead,
+		logOut
+	);
+}
+
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+QUaRingHistorizer::NodeHistory& QUaRingHistorizer::nodeHistory(const QUaNodeId& nodeId)
+{
+	auto iter = m_database.find(nodeId);
+	if (iter != m_database.end())
+	{
+		return *iter;
+	}
+	// allocate the whole buffers upfront, memory does not grow afterwards
+	NodeHistory history;
+	history.retention   = m_defaultRetention;
+	history.bucketSum   = 0.0;
+	history.bucketCount = 0;
+	history.evicted     = 0;
+	history.downsampled = 0;
+	history.rejected    = 0;
+	QUaRingHistorizer::ringReset(history.points , history.retention.capacity);
+	QUaRingHistorizer::ringReset(history.buckets, history.retention.downsampleCapacity);
+	return *m_database.insert(nodeId, history);
+}
+
+void QUaRingHistorizer::evict(NodeHistory& history, const Entry& entry)
+{
+	history.evicted++;
+	const auto& retention = history.retention;
+	if (retention.downsampleInterval <= 0 || retention.downsampleCapacity <= 0)
+	{
+		return;
+	}
+	history.downsampled++;
+	// bucket start, rounded down also for negative times
+	qint64 interval = retention.downsampleInterval;
+	qint64 time     = entry.time - (((entry.time % interval) + interval) % interval);
+	auto&  buckets  = history.buckets;
+	bool   numeric  = entry.value.canConvert<double>() &&
+		entry.value.userType() != QMetaType::QString &&
+		entry.value.userType() != QMetaType::QByteArray;
+	// NOTE : evicted data points arrive in order, so only the last bucket can still grow
+	if (buckets.count > 0 &&
+		QUaRingHistorizer::ringAt(buckets, buckets.count - 1).time == time)
+	{
+		auto& bucket = QUaRingHistorizer::ringAt(buckets, buckets.count - 1);
+		// running mean lost (data removed), continue from the bucket's value
+		if (history.bucketCount == 0)
+		{
+			history.bucketSum   = bucket.value.toDouble();
+			history.bucketCount = 1;
+		}
+		history.bucketCount++;
+		if (numeric)
+		{
+			history.bucketSum += entry.value.toDouble();
+			bucket.value = history.bucketSum / history.bucketCount;
+		}
+		else
+		{
+			bucket.value = entry.value;
+		}
+		// keep the worst severity (two most significant bits of the status code)
+		if ((entry.status >> 30) > (bucket.status >> 30))
+		{
+			bucket.status = entry.status;
+		}
+		return;
+	}
+	history.bucketSum   = numeric ? entry.value.toDouble() : 0.0;
+	history.bucketCount = 1;
+	Entry bucket = {
+		time,
+		numeric ? QVariant(history.bucketSum) : entry.value,
+		entry.status
+	};
+	// oldest bucket is dropped when full
+	Entry dropped;
+	QUaRingHistorizer::ringAppend(buckets, bucket, dropped);
+}
+
+void QUaRingHistorizer::ringReset(Ring& ring, const int& capacity)
+{
+	ring.buffer = QVector<Entry>(capacity);
+	ring.head   = 0;
+	ring.count  = 0;
+}
+
+const QUaRingHistorizer::Entry& QUaRingHistorizer::ringAt(const Ring& ring, const int& index)
+{
+	Q_ASSERT(index >= 0 && index < ring.count);
+	int pos = ring.head + index;
+	return ring.buffer.at(pos < ring.buffer.count() ? pos : pos - ring.buffer.count());
+}
+
+QUaRingHistorizer::Entry& QUaRingHistorizer::ringAt(Ring& ring, const int& index)
+{
+	Q_ASSERT(index >= 0 && index < ring.count);
+	int pos = ring.head + index;
+	return ring.buffer[pos < ring.buffer.count() ? pos : pos - ring.buffer.count()];
+}
+
+bool QUaRingHistorizer::ringAppend(Ring& ring, const Entry& entry, Entry& evicted)
+{
+	int capacity = ring.buffer.count();
+	if (capacity == 0)
+	{
+		evicted = entry;
+		return true;
+	}
+	if (ring.count < capacity)
+	{
+		ring.count++;
+		QUaRingHistorizer::ringAt(ring, ring.count - 1) = entry;
+		return false;
+	}
+	// full, overwrite oldest
+	auto& oldest = ring.buffer[ring.head];
+	evicted = oldest;
+	oldest  = entry;
+	ring.head = ring.head + 1 < capacity ? ring.head + 1 : 0;
+	return true;
+}
+
+int QUaRingHistorizer::count(const NodeHistory& history)
+{
+	return history.buckets.count + history.points.count;
+}
+
+const QUaRingHistorizer::Entry& QUaRingHistorizer::entryAt(const NodeHistory& history, const int& index)
+{
+	return index < history.buckets.count ?
+		QUaRingHistorizer::ringAt(history.buckets, index) :
+		QUaRingHistorizer::ringAt(history.points , index - history.buckets.count);
+}
+
+int QUaRingHistorizer::lowerBound(const NodeHistory& history, const qint64& time)
+{
+	int first = 0;
+	int len   = QUaRingHistorizer::count(history);
+	while (len > 0)
+	{
+		int half = len / 2;
+		if (QUaRingHistorizer::entryAt(history, first + half).time < time)
+		{
+			first += half + 1;
+			len   -= half + 1;
+			continue;
+		}
+		len = half;
+	}
+	return first;
+}
+
+int QUaRingHistorizer::upperBound(const NodeHistory& history, const qint64& time)
+{
+	int first = 0;
+	int len   = QUaRingHistorizer::count(history);
+	while (len > 0)
+	{
+		int half = len / 2;
+		if (!(time < QUaRingHistorizer::entryAt(history, first + half).time))
+		{
+			first += half + 1;
+			len   -= half + 1;
+			continue;
+		}
+		len = half;
+	}
+	return first;
+}
+
+#endif // UA_ENABLE_HISTORIZING
@@ -0,0 +1,211 @@
+#ifndef QUARINGHISTORIZER_H
+#define QUARINGHISTORIZER_H
+
+#include <QUaHistoryBackend>
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include "quainmemoryhistorizer.h"
+
+// in-memory historizer with a fixed number of data points per node, stored in ring buffers
+// allocated upfront, when a node's buffer is full the oldest data point is evicted and optionally
+// merged into a coarser ring of buckets (mean for numeric values, last for others, worst status)
+// NOTE : events are stored as in QUaInMemoryHistorizer (not bounded)
+class QUaRingHistorizer
+{
+public:
+	QUaRingHistorizer();
+
+	struct Retention
+	{
+		int    capacity;           // data points kept per node
+		qint64 downsampleInterval; // milliseconds per bucket of evicted data points, 0 disables downsampling
+		int    downsampleCapacity; // buckets kept per node
+	};
+	// retention of nodes without their own retention (default 10000 data points, no downsampling)
+	// NOTE : applies to nodes historized from then on
+	Retention defaultRetention() const;
+	void      setDefaultRetention(const Retention& retention);
+	// retention of a single node, keeps the most recent data points that fit
+	Retention retention(const QUaNodeId& nodeId) const;
+	void      setRetention(const QUaNodeId& nodeId, const Retention& retention);
+
+	struct NodeStats
+	{
+		int     capacity;
+		int     count;
+		int     downsampleCapacity;
+		int     downsampleCount;
+		quint64 evicted;     // data points evicted from the full buffer
+		quint64 downsampled; // evicted data points merged into buckets
+		quint64 rejected;    // out of order data points older than the buffer
+	};
+	// node ids with history and their occupancy
+	QList<QUaNodeId> nodeIds() const;
+	NodeStats nodeStats(const QUaNodeId& nodeId) const;
+
+	// required API for QUaServer::setHistorizer
+	// write data point to backend, return true on success
+	bool writeHistoryData(
+		const QUaNodeId &nodeId,
+		const QUaHistoryDataPoint& dataPoint,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// update an existing node's data point in backend, return true on success
+	bool updateHistoryData(
+		const QUaNodeId &nodeId,
+		const QUaHistoryDataPoint& dataPoint,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// remove an existing node's data points within a range, return true on success
+	bool removeHistoryData(
+		const QUaNodeId &nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// return the timestamp of the first sample available for the given node
+	QDateTime firstTimestamp(
+		const QUaNodeId &nodeId,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the timestamp of the latest sample available for the given node
+	QDateTime lastTimestamp(
+		const QUaNodeId &nodeId,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return true if given timestamp is available for the given node
+	bool hasTimestamp(
+		const QUaNodeId &nodeId,
+		const QDateTime& timestamp,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return a timestamp matching the criteria for the given node
+	QDateTime findTimestamp(
+		const QUaNodeId &nodeId,
+		const QDateTime& timestamp,
+		const QUaHistoryBackend::TimeMatch& match,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the number for data points within a time range for the given node
+	quint64 numDataPointsInRange(
+		const QUaNodeId &nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the numPointsToRead data points for the given node from the given start time
+	QVector<QUaHistoryDataPoint> readHistoryData(
+		const QUaNodeId & nodeId,
+		const QDateTime &timeStart,
+		const quint64   &numPointsOffset,
+		const quint64   &numPointsToRead,
+		QQueue<QUaLog>  &logOut
+	) const;
+
+	// event history support
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// write a event's data to backend
+	bool writeHistoryEventsOfType(
+		const QUaNodeId            &eventTypeNodeId,
+		const QList<QUaNodeId>     &emittersNodeIds,
+		const QUaHistoryEventPoint &eventPoint,
+		QQueue<QUaLog>             &logOut
+	);
+	// get event types (node ids) for which there are events stored for the
+	// given emitter
+	QVector<QUaNodeId> eventTypesOfEmitter(
+		const QUaNodeId &emitterNodeId,
+		QQueue<QUaLog>  &logOut
+	);
+	// find a timestamp matching the criteria for the emitter and event type
+	QDateTime findTimestampEventOfType(
+		const QUaNodeId                    &emitterNodeId,
+		const QUaNodeId                    &eventTypeNodeId,
+		const QDateTime                    &timestamp,
+		const QUaHistoryBackend::TimeMatch &match,
+		QQueue<QUaLog>                     &logOut
+	);
+	// get the number for events within a time range for the given emitter and event type
+	quint64 numEventsOfTypeInRange(
+		const QUaNodeId &emitterNodeId,
+		const QUaNodeId &eventTypeNodeId,
+		const QDateTime &timeStart,
+		const QDateTime &timeEnd,
+		QQueue<QUaLog>  &logOut
+	);
+	// return the numPointsToRead events for the given emitter and event type,
+	// starting from the numPointsOffset offset after given start time (pagination)
+	QVector<QUaHistoryEventPoint> readHistoryEventsOfType(
+		const QUaNodeId &emitterNodeId,
+		const QUaNodeId &eventTypeNodeId,
+		const QDateTime &timeStart,
+		const quint64   &numPointsOffset,
+		const quint64   &numPointsToRead,
+		const QList<QUaBrowsePath> &columnsToRead,
+		QQueue<QUaLog>  &logOut
+	);
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+private:
+	struct Entry
+	{
+		qint64   time;
+		QVariant value;
+		quint32  status;
+	};
+	// fixed capacity buffer, when full appending overwrites the oldest entry
+	struct Ring
+	{
+		QVector<Entry> buffer;
+		int head;  // index of oldest entry
+		int count;
+	};
+	// a node's history is its buckets (oldest) followed by its data points (newest)
+	struct NodeHistory
+	{
+		Retention retention;
+		Ring      points;
+		Ring      buckets;
+		// running mean of last bucket
+		double    bucketSum;
+		int       bucketCount;
+		quint64   evicted;
+		quint64   downsampled;
+		quint64   rejected;
+	};
+	QHash<QUaNodeId, NodeHistory> m_database;
+	Retention m_defaultRetention;
+
+	NodeHistory& nodeHistory(const QUaNodeId& nodeId);
+	void evict(NodeHistory& history, const Entry& entry);
+
+	static void ringReset(Ring& ring, const int& capacity);
+	static const Entry& ringAt(const Ring& ring, const int& index);
+	static Entry& ringAt(Ring& ring, const int& index);
+	// returns true and the overwritten entry if ring was full
+	static bool ringAppend(Ring& ring, const Entry& entry, Entry& evicted);
+	// logical access to buckets followed by points, all ordered by time
+	static int count(const NodeHistory& history);
+	static const Entry& entryAt(const NodeHistory& history, const int& index);
+	// first index with time >= (lower) or > (upper) than given time
+	static int lowerBound(const NodeHistory& history, const qint64& time);
+	static int upperBound(const NodeHistory& history, const qint64& time);
+
+	// event history support
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	QUaInMemoryHistorizer m_events;
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+};
+
+#endif // UA_ENABLE_HISTORIZING
+
+#endif // QUARINGHISTORIZER_H
@@ -50,6 +50,7 @@ QHash<int, QString> QUaSqliteHistorizer::m_hashTypes = {
 QUaSqliteHistorizer::QUaSqliteHistorizer()
 {
 	m_timeoutTransaction = 1000;
+	m_batchThread = nullptr;
 	QObject::connect(&m_timerTransaction, &QTimer::timeout, &m_timerTransaction,
 	[this]() {
 		// stop timer until next write request
@@ -75,6 +76,9 @@ QUaSqliteHistorizer::QUaSqliteHistorizer()
 
 QUaSqliteHistorizer::~QUaSqliteHistorizer()
 {
+	// NOTE : batch connection is closed by the writer thread when it finishes
+	Q_ASSERT_X(!m_batchThread.loadAcquire(), "QUaSqliteHistorizer::~QUaSqliteHistorizer",
+		"Asynchronous history writes must be stopped before destroying the historizer.");
 	if (!QSqlDatabase::contains(m_strSqliteDbName))
 	{
 		return;
@@ -152,6 +156,11 @@ bool QUaSqliteHistorizer::writeHistoryData(
 		{
 			return false;
 		}
+		// cache prepared statements
+		if (!this->dataPrepareAllStmts(db, nodeId, logOut))
+		{
+			return false;
+		}
 	}
 	// insert new data point
 	return this->insertDataPoint(
@@ -162,6 +171,95 @@ bool QUaSqliteHistorizer::writeHistoryData(
 	);
 }
 
+bool QUaSqliteHistorizer::writeHistoryDataBatch(
+	const QVector<QUaHistoryNodeDataPoint>& points,
+	QQueue<QUaLog>& logOut
+)
+{
+	// get database handle of the calling thread
+	QSqlDatabase db;
+	if (!this->getOpenedBatchDatabase(db, logOut))
+	{
+		return false;
+	}
+	// one transaction per batch
+	if (!db.transaction())
+	{
+		logOut << QUaLog({
+			QObject::tr("Failed to begin transaction in %1 database. Sql : %2.")
+				.arg(m_strSqliteDbName)
+				.arg(db.lastError().text()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	bool ok = true;
+	for (const auto& point : points)
+	{
+		auto iter = m_batchInsertStmts.find(point.nodeId);
+		if (iter == m_batchInsertStmts.end())
+		{
+			// check data table exists
+			// NOTE : do not use the statements cache, it belongs to the historizer's thread
+			bool dataTableExists;
+			if (!this->tableExists(db, point.nodeId, dataTableExists, logOut))
+			{
+				ok = false;
+				continue;
+			}
+			if (!dataTableExists)
+			{
+				auto dataType = QUaSqliteHistorizer::QVariantToQtType(point.dataPoint.value);
+				if (!this->createDataNodeTable(db, point.nodeId, dataType, logOut))
+				{
+					ok = false;
+					continue;
+				}
+			}
+			QSqlQuery query(db);
+			QString strStmt = QString(
+				"INSERT INTO \"%1\" (Time, Value, Status) VALUES (:Time, :Value, :Status);"
+			).arg(point.nodeId);
+			if (!this->prepareStmt(query, strStmt, logOut))
+			{
+				ok = false;
+				continue;
+			}
+			iter = m_batchInsertStmts.insert(point.nodeId, query);
+		}
+		QSqlQuery& query = iter.value();
+		query.bindValue(0, point.dataPoint.timestamp.toMSecsSinceEpoch());
+		query.bindValue(1, point.dataPoint.value);
+		query.bindValue(2, point.dataPoint.status);
+		if (!query.exec())
+		{
+			logOut << QUaLog({
+				QObject::tr("Could not insert new row in %1 table in %2 database. Sql : %3.")
+					.arg(point.nodeId)
+					.arg(m_strSqliteDbName)
+					.arg(query.lastError().text()),
+				QUaLogLevel::Error,
+				QUaLogCategory::History
+			});
+			ok = false;
+		}
+	}
+	if (!db.commit())
+	{
+		logOut << QUaLog({
+			QObject::tr("Failed to commit transaction in %1 database. Sql : %2.")
+				.arg(m_strSqliteDbName)
+				.arg(db.lastError().text()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		db.rollback();
+		return false;
+	}
+	return ok;
+}
+
 bool QUaSqliteHistorizer::updateHistoryData(
 	const QUaNodeId &nodeId,
 	const QUaHistoryDataPoint& dataPoint,
@@ -1304,6 +1402,8 @@ bool QUaSqliteHistorizer::getOpenedDatabase(
 		db = QSqlDatabase::addDatabase("QSQLITE", m_strSqliteDbName);
 		// the database name is not the connection name
 		db.setDatabaseName(m_strSqliteDbName);
+		// wait instead of failing while the writer thread commits (see writeHistoryDataBatch)
+		db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
 		db.open();
 	}
 	// check if opened correctly
@@ -1432,9 +1532,7 @@ bool QUaSqliteHistorizer::createDataNodeTable(
 			});
 		return false;
 	}
-	// cache prepared statement
-	bool ok = this->dataPrepareAllStmts(db, nodeId, logOut);
-	return ok;
+	return true;
 }
 
 bool QUaSqliteHistorizer::insertDataPoint(
@@ -1650,6 +1748,16 @@ bool QUaSqliteHistorizer::handleTransactions(
 	{
 		return true;
 	}
+	// no transaction kept open while a writer thread commits batches, else it would wait on it
+	if (m_batchThread.loadAcquire())
+	{
+		if (m_timerTransaction.isActive())
+		{
+			m_timerTransaction.stop();
+			db.commit();
+		}
+		return true;
+	}
 	// return success if transaction currently opened
 	if (m_timerTransaction.isActive())
 	{
@@ -1672,6 +1780,77 @@ bool QUaSqliteHistorizer::handleTransactions(
 	return true;
 }
 
+bool QUaSqliteHistorizer::getOpenedBatchDatabase(
+	QSqlDatabase& db,
+	QQueue<QUaLog>& logOut)
+{
+	// NOTE : a connection can only be used from the thread that created it
+	QString strConnection = m_strSqliteDbName + ".writer";
+	if (m_batchThread.loadAcquire())
+	{
+		Q_ASSERT(m_batchThread.loadAcquire() == QThread::currentThread());
+		db = QSqlDatabase::database(strConnection, false);
+		return true;
+	}
+	db = QSqlDatabase::addDatabase("QSQLITE", strConnection);
+	db.setDatabaseName(m_strSqliteDbName);
+	db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+	if (!db.open())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error opening %1 for the writer thread. Sql : %2")
+				.arg(m_strSqliteDbName)
+				.arg(db.lastError().text()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		db = QSqlDatabase();
+		QSqlDatabase::removeDatabase(strConnection);
+		return false;
+	}
+	// WAL lets the reads of the historizer's thread run while a batch is committed, and
+	// NORMAL synchronous only syncs on checkpoints
+	QSqlQuery query(db);
+	for (const char* strStmt : {
+		"PRAGMA journal_mode = WAL;",
+		"PRAGMA synchronous = NORMAL;"
+		})
+	{
+		if (query.exec(strStmt))
+		{
+			continue;
+		}
+		logOut << QUaLog({
+			QObject::tr("Could not configure %1 database with %2. Sql : %3.")
+				.arg(m_strSqliteDbName)
+				.arg(strStmt)
+				.arg(query.lastError().text()),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+	}
+	// close from the writer thread itself, finished is emitted from the finishing thread
+	m_batchThread.storeRelease(QThread::currentThread());
+	QObject::connect(QThread::currentThread(), &QThread::finished, &m_timerTransaction,
+	[this]() {
+		this->closeBatchDatabase();
+	}, Qt::DirectConnection);
+	return true;
+}
+
+void QUaSqliteHistorizer::closeBatchDatabase()
+{
+	QString strConnection = m_strSqliteDbName + ".writer";
+	// statements must be released before removing the connection
+	m_batchInsertStmts.clear();
+	{
+		QSqlDatabase db = QSqlDatabase::database(strConnection, false);
+		db.close();
+	}
+	QSqlDatabase::removeDatabase(strConnection);
+	m_batchThread.storeRelease(nullptr);
+}
+
 QMetaType::Type QUaSqliteHistorizer::QVariantToQtType(const QVariant& value)
 {
 	return static_cast<QMetaType::Type>(
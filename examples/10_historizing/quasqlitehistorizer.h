@@ -7,6 +7,7 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QTimer>
+#include <QThread>
 
 class QUaSqliteHistorizer
 {
@@ -34,6 +35,14 @@ public:
 		const QUaHistoryDataPoint& dataPoint,
 		QQueue<QUaLog>& logOut
 	);
+	// optional API for QUaServer::setHistorizer
+	// write a batch of data points in a single transaction, used with QUaServer::setHistoryWriteAsync
+	// NOTE : uses its own connection in WAL mode, owned by the calling (writer) thread and closed when
+	//        that thread finishes, so the other methods can still be called from the historizer's thread
+	bool writeHistoryDataBatch(
+		const QVector<QUaHistoryNodeDataPoint>& points,
+		QQueue<QUaLog>& logOut
+	);
 	// required API for QUaServer::setHistorizer
 	// update an existing node's data point in backend, return true on success
 	bool updateHistoryData(
@@ -143,6 +152,14 @@ private:
 	QTimer  m_timerTransaction;
 	int     m_timeoutTransaction;
 	QQueue<QUaLog> m_deferedLogOut;
+	// connection of the thread calling writeHistoryDataBatch, with its insert statements
+	QAtomicPointer<QThread>     m_batchThread;
+	QHash<QUaNodeId, QSqlQuery> m_batchInsertStmts;
+	bool getOpenedBatchDatabase(
+		QSqlDatabase& db,
+		QQueue<QUaLog>& logOut
+	);
+	void closeBatchDatabase();
 	// get database handle, creates it if not already
 	bool getOpenedDatabase(
 		QSqlDatabase& db,
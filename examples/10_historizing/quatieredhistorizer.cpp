@@ -0,0 +1,850 @@
+#include "quatieredhistorizer.h"
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include <algorithm>
+#include <limits>
+#include <QThread>
+
+QUaTieredHistorizer::QUaTieredHistorizer()
+{
+	m_coldSet       = false;
+	m_hotWindow     = 60 * 60 * 1000;
+	m_agingInterval = 1000;
+	// move data points older than the hot window
+	QObject::connect(&m_timerAging, &QTimer::timeout, &m_timerAging,
+	[this]() {
+		QQueue<QUaLog> logOut;
+		this->move(false, logOut);
+		if (logOut.isEmpty())
+		{
+			return;
+		}
+		// reported on next write
+		QMutexLocker locker(&m_hotMutex);
+		m_agingLogOut << logOut;
+	}, Qt::QueuedConnection);
+	m_timerAging.start(m_agingInterval);
+}
+
+QUaTieredHistorizer::~QUaTieredHistorizer()
+{
+	m_timerAging.stop();
+	QQueue<QUaLog> logOut;
+	this->move(true, logOut);
+}
+
+qint64 QUaTieredHistorizer::hotWindow() const
+{
+	QMutexLocker locker(&m_hotMutex);
+	return m_hotWindow;
+}
+
+void QUaTieredHistorizer::setHotWindow(const qint64& hotWindow)
+{
+	QMutexLocker locker(&m_hotMutex);
+	m_hotWindow = (std::max)(hotWindow, static_cast<qint64>(0));
+}
+
+int QUaTieredHistorizer::agingInterval() const
+{
+	return m_agingInterval;
+}
+
+void QUaTieredHistorizer::setAgingInterval(const int& agingInterval)
+{
+	m_agingInterval = (std::max)(agingInterval, 1);
+	m_timerAging.start(m_agingInterval);
+}
+
+bool QUaTieredHistorizer::age(QQueue<QUaLog>& logOut)
+{
+	return this->move(false, logOut);
+}
+
+bool QUaTieredHistorizer::flush(QQueue<QUaLog>& logOut)
+{
+	return this->move(true, logOut);
+}
+
+quint64 QUaTieredHistorizer::hotCount() const
+{
+	QMutexLocker locker(&m_hotMutex);
+	quint64 total = 0;
+	for (const auto& series : m_hot)
+	{
+		total += static_cast<quint64>(QUaTieredHistorizer::count(series));
+	}
+	return total;
+}
+
+bool QUaTieredHistorizer::writeHistoryData(
+	const QUaNodeId &nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	qint64 time = dataPoint.timestamp.toMSecsSinceEpoch();
+	{
+		QMutexLocker locker(&m_hotMutex);
+		// report logs of previous aging
+		if (!m_agingLogOut.isEmpty())
+		{
+			logOut << m_agingLogOut;
+			m_agingLogOut.clear();
+		}
+		// fast path, newer than the data points moved to the cold tier
+		auto iter = m_hot.find(nodeId);
+		if (iter != m_hot.end() && QUaTieredHistorizer::isHot(iter.value(), time))
+		{
+			QUaTieredHistorizer::hotInsert(iter.value(), time, dataPoint.value, dataPoint.status);
+			return true;
+		}
+	}
+	return this->writeCold(nodeId, dataPoint, logOut);
+}
+
+bool QUaTieredHistorizer::writeHistoryDataBatch(
+	const QVector<QUaHistoryNodeDataPoint>& points,
+	QQueue<QUaLog>& logOut)
+{
+	// insert in the hot tier with a single lock, then the rest one by one
+	// NOTE : called from the writer thread with asynchronous writes, so the rest is queued
+	bool coldThread = this->inColdThread();
+	QVector<QUaHistoryNodeDataPoint> rest;
+	{
+		QMutexLocker locker(&m_hotMutex);
+		if (!m_agingLogOut.isEmpty())
+		{
+			logOut << m_agingLogOut;
+			m_agingLogOut.clear();
+		}
+		for (const auto& point : points)
+		{
+			qint64 time = point.dataPoint.timestamp.toMSecsSinceEpoch();
+			auto iter = m_hot.find(point.nodeId);
+			if (iter != m_hot.end() && QUaTieredHistorizer::isHot(iter.value(), time))
+			{
+				QUaTieredHistorizer::hotInsert(iter.value(), time, point.dataPoint.value, point.dataPoint.status);
+				continue;
+			}
+			if (!coldThread)
+			{
+				m_coldPending.append(point);
+				continue;
+			}
+			rest.append(point);
+		}
+	}
+	bool ok = true;
+	for (const auto& point : rest)
+	{
+		ok = this->writeCold(point.nodeId, point.dataPoint, logOut) && ok;
+	}
+	return ok;
+}
+
+bool QUaTieredHistorizer::updateHistoryData(
+	const QUaNodeId &nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	QMutexLocker coldLocker(&m_coldMutex);
+	QMutexLocker hotLocker(&m_hotMutex);
+	auto iter = m_hot.find(nodeId);
+	if (iter != m_hot.end() && dataPoint.timestamp.toMSecsSinceEpoch() > iter.value().coldLast)
+	{
+		QUaTieredHistorizer::hotInsert(
+			iter.value(),
+			dataPoint.timestamp.toMSecsSinceEpoch(),
+			dataPoint.value,
+			dataPoint.status
+		);
+		return true;
+	}
+	hotLocker.unlock();
+	return m_cold.updateHistoryData(nodeId, dataPoint, logOut);
+}
+
+bool QUaTieredHistorizer::removeHistoryData(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QQueue<QUaLog>& logOut)
+{
+	Q_ASSERT(timeStart <= timeEnd || !timeEnd.isValid());
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	qint64 end   = timeEnd.isValid() ? timeEnd.toMSecsSinceEpoch() : (std::numeric_limits<qint64>::max)();
+	QMutexLocker coldLocker(&m_coldMutex);
+	QMutexLocker hotLocker(&m_hotMutex);
+	auto iter = m_hot.find(nodeId);
+	if (iter == m_hot.end())
+	{
+		hotLocker.unlock();
+		return m_cold.removeHistoryData(nodeId, timeStart, timeEnd, logOut);
+	}
+	// compact the hot tier in place, keeping the order
+	auto& series = iter.value();
+	int kept = series.head;
+	for (int i = series.head; i < series.times.count(); i++)
+	{
+		if (series.times[i] >= start && series.times[i] <= end)
+		{
+			continue;
+		}
+		if (kept != i)
+		{
+			series.times[kept]    = series.times[i];
+			series.values[kept]   = series.values[i];
+			series.statuses[kept] = series.statuses[i];
+		}
+		kept++;
+	}
+	series.times.resize(kept);
+	series.values.resize(kept);
+	series.statuses.resize(kept);
+	// NOTE : coldLast is kept, so the cold tier stays older than the hot tier
+	if (!QUaTieredHistorizer::hasCold(series) || start > series.coldLast)
+	{
+		return true;
+	}
+	hotLocker.unlock();
+	return m_cold.removeHistoryData(nodeId, timeStart, timeEnd, logOut);
+}
+
+QDateTime QUaTieredHistorizer::firstTimestamp(
+	const QUaNodeId &nodeId,
+	QQueue<QUaLog>& logOut) const
+{
+	QMutexLocker locker(&m_hotMutex);
+	auto iter = m_hot.constFind(nodeId);
+	if (iter == m_hot.constEnd())
+	{
+		locker.unlock();
+		QMutexLocker coldLocker(&m_coldMutex);
+		return m_cold.firstTimestamp(nodeId, logOut);
+	}
+	bool cold = QUaTieredHistorizer::hasCold(iter.value());
+	QDateTime hotFirst = QUaTieredHistorizer::count(iter.value()) > 0 ?
+		QUaTieredHistorizer::timeAt(iter.value(), 0) : QDateTime();
+	locker.unlock();
+	if (cold)
+	{
+		QMutexLocker coldLocker(&m_coldMutex);
+		QDateTime coldFirst = m_cold.firstTimestamp(nodeId, logOut);
+		if (coldFirst.isValid() && (!hotFirst.isValid() || coldFirst < hotFirst))
+		{
+			return coldFirst;
+		}
+	}
+	if (!hotFirst.isValid())
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding first history timestamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+	}
+	return hotFirst;
+}
+
+QDateTime QUaTieredHistorizer::lastTimestamp(
+	const QUaNodeId &nodeId,
+	QQueue<QUaLog>& logOut) const
+{
+	QMutexLocker locker(&m_hotMutex);
+	auto iter = m_hot.constFind(nodeId);
+	// the hot tier is newer than the cold tier
+	if (iter != m_hot.constEnd() && QUaTieredHistorizer::count(iter.value()) > 0)
+	{
+		return QUaTieredHistorizer::timeAt(iter.value(), QUaTieredHistorizer::count(iter.value()) - 1);
+	}
+	if (iter != m_hot.constEnd() && !QUaTieredHistorizer::hasCold(iter.value()))
+	{
+		logOut << QUaLog({
+			QObject::tr("Error finding most recent history timstamp. "
+				"History database does not contain table for node id %1")
+				.arg(nodeId),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+		return QDateTime();
+	}
+	locker.unlock();
+	QMutexLocker coldLocker(&m_coldMutex);
+	return m_cold.lastTimestamp(nodeId, logOut);
+}
+
+bool QUaTieredHistorizer::hasTimestamp(
+	const QUaNodeId &nodeId,
+	const QDateTime& timestamp,
+	QQueue<QUaLog>& logOut) const
+{
+	qint64 time = timestamp.toMSecsSinceEpoch();
+	QMutexLocker locker(&m_hotMutex);
+	auto iter = m_hot.constFind(nodeId);
+	if (iter != m_hot.constEnd())
+	{
+		const auto& series = iter.value();
+		int total = QUaTieredHistorizer::count(series);
+		if (total > 0 && time >= series.times[series.head])
+		{
+			int index = QUaTieredHistorizer::lowerBound(series, time);
+			return index < total && series.times[series.head + index] == time;
+		}
+		if (!QUaTieredHistorizer::hasCold(series))
+		{
+			return false;
+		}
+	}
+	locker.unlock();
+	QMutexLocker coldLocker(&m_coldMutex);
+	return m_cold.hasTimestamp(nodeId, timestamp, logOut);
+}
+
+QDateTime QUaTieredHistorizer::findTimestamp(
+	const QUaNodeId &nodeId,
+	const QDateTime& timestamp,
+	const QUaHistoryBackend::TimeMatch& match,
+	QQueue<QUaLog>& logOut) const
+{
+	qint64 time = timestamp.toMSecsSinceEpoch();
+	QMutexLocker locker(&m_hotMutex);
+	auto iter = m_hot.constFind(nodeId);
+	if (iter == m_hot.constEnd() || QUaTieredHistorizer::count(iter.value()) == 0)
+	{
+		if (iter != m_hot.constEnd() && !QUaTieredHistorizer::hasCold(iter.value()))
+		{
+			logOut << QUaLog({
+				QObject::tr("Error finding history timestamp. "
+					"History database does not contain table for node id %1")
+					.arg(nodeId),
+				QUaLogLevel::Error,
+				QUaLogCategory::History
+				});
+			return QDateTime();
+		}
+		locker.unlock();
+		QMutexLocker coldLocker(&m_coldMutex);
+		return m_cold.findTimestamp(nodeId, timestamp, match, logOut);
+	}
+	// NOTE : the database might or might not contain the input timestamp
+	const auto& series = iter.value();
+	int  total = QUaTieredHistorizer::count(series);
+	bool cold  = QUaTieredHistorizer::hasCold(series);
+	QDateTime hotFirst = QUaTieredHistorizer::timeAt(series, 0);
+	QDateTime coldTime;
+	switch (match)
+	{
+	case QUaHistoryBackend::TimeMatch::ClosestFromAbove:
+	{
+		// within the hot tier, if there is none return last
+		int index = QUaTieredHistorizer::upperBound(series, time);
+		if (index > 0 || !cold)
+		{
+			return QUaTieredHistorizer::timeAt(series, (std::min)(index, total - 1));
+		}
+		// older than the hot tier, closest of the cold tier if older than the hot tier
+		locker.unlock();
+		QMutexLocker coldLocker(&m_coldMutex);
+		coldTime = m_cold.findTimestamp(nodeId, timestamp, match, logOut);
+		return coldTime.isValid() && coldTime > timestamp && coldTime < hotFirst ? coldTime : hotFirst;
+	}
+	break;
+	case QUaHistoryBackend::TimeMatch::ClosestFromBelow:
+	{
+		int index = QUaTieredHistorizer::lowerBound(series, time);
+		if (index > 0)
+		{
+			return QUaTieredHistorizer::timeAt(series, index - 1);
+		}
+		// older than the hot tier, if there is none return first
+		if (!cold)
+		{
+			return hotFirst;
+		}
+		locker.unlock();
+		QMutexLocker coldLocker(&m_coldMutex);
+		coldTime = m_cold.findTimestamp(nodeId, timestamp, match, logOut);
+		return coldTime.isValid() && coldTime < hotFirst ? coldTime : hotFirst;
+	}
+	break;
+	default:
+		Q_ASSERT(false);
+		break;
+	}
+	return QDateTime();
+}
+
+quint64 QUaTieredHistorizer::numDataPointsInRange(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QQueue<QUaLog>& logOut) const
+{
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	QMutexLocker locker(&m_hotMutex);
+	auto iter = m_hot.constFind(nodeId);
+	if (iter == m_hot.constEnd())
+	{
+		locker.unlock();
+		QMutexLocker coldLocker(&m_coldMutex);
+		return m_cold.numDataPointsInRange(nodeId, timeStart, timeEnd, logOut);
+	}
+	const auto& series = iter.value();
+	int total = QUaTieredHistorizer::count(series);
+	int indexIni = QUaTieredHistorizer::lowerBound(series, start);
+	// if the end timestamp is invalid, it means the API is requesting up to the most recent timestamp
+	int indexEnd = timeEnd.isValid() ?
+		QUaTieredHistorizer::upperBound(series, timeEnd.toMSecsSinceEpoch()) :
+		total;
+	quint64 numHot = static_cast<quint64>((std::max)(0, indexEnd - indexIni));
+	// no need for the cold tier if the range starts within the hot tier
+	if (!QUaTieredHistorizer::hasCold(series) || (total > 0 && start >= series.times[series.head]))
+	{
+		return numHot;
+	}
+	// cold tier up to the hot tier, excluding data points moved meanwhile
+	QDateTime coldEnd = timeEnd;
+	if (total > 0 && (!timeEnd.isValid() || timeEnd >= QUaTieredHistorizer::timeAt(series, 0)))
+	{
+		coldEnd = QUaTieredHistorizer::timeAt(series, 0).addMSecs(-1);
+	}
+	locker.unlock();
+	QMutexLocker coldLocker(&m_coldMutex);
+	return numHot + m_cold.numDataPointsInRange(nodeId, timeStart, coldEnd, logOut);
+}
+
+QVector<QUaHistoryDataPoint> QUaTieredHistorizer::readHistoryData(
+	const QUaNodeId &nodeId,
+	const QDateTime& timeStart,
+	const quint64& numPointsOffset,
+	const quint64& numPointsToRead,
+	QQueue<QUaLog>& logOut) const
+{
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	QMutexLocker locker(&m_hotMutex);
+	auto iter = m_hot.constFind(nodeId);
+	if (iter == m_hot.constEnd())
+	{
+		locker.unlock();
+		QMutexLocker coldLocker(&m_coldMutex);
+		return m_cold.readHistoryData(nodeId, timeStart, numPointsOffset, numPointsToRead, logOut);
+	}
+	const auto& series = iter.value();
+	int total = QUaTieredHistorizer::count(series);
+	quint64 index = static_cast<quint64>(QUaTieredHistorizer::lowerBound(series, start));
+	QVector<QUaHistoryDataPoint> points;
+	// fast path, the range starts within the hot tier
+	if (!QUaTieredHistorizer::hasCold(series) || (total > 0 && start >= series.times[series.head]))
+	{
+		points = QUaTieredHistorizer::hotRead(series, index + numPointsOffset, numPointsToRead);
+		locker.unlock();
+		// NOTE : return invalid values if API requests more values than available
+		points.resize(static_cast<int>(numPointsToRead));
+		return points;
+	}
+	// the offset might fall in the cold tier, so copy the hot data points that could be returned
+	quint64 numHot = numPointsOffset > (std::numeric_limits<quint64>::max)() - numPointsToRead ?
+		(std::numeric_limits<quint64>::max)() : numPointsOffset + numPointsToRead;
+	auto hotPoints = QUaTieredHistorizer::hotRead(series, index, numHot);
+	QDateTime hotFirst = total > 0 ? QUaTieredHistorizer::timeAt(series, 0) : QDateTime();
+	locker.unlock();
+	// cold tier up to the hot tier, excluding data points moved meanwhile
+	quint64 numCold = 0;
+	{
+		QMutexLocker coldLocker(&m_coldMutex);
+		QDateTime coldEnd = hotFirst.isValid() ? hotFirst.addMSecs(-1) : QDateTime();
+		numCold = m_cold.numDataPointsInRange(nodeId, timeStart, coldEnd, logOut);
+		if (numPointsOffset < numCold)
+		{
+			points = m_cold.readHistoryData(
+				nodeId,
+				timeStart,
+				numPointsOffset,
+				(std::min)(numPointsToRead, numCold - numPointsOffset),
+				logOut
+			);
+		}
+	}
+	// remove padding of the cold tier
+	while (!points.isEmpty() && (!points.last().timestamp.isValid() ||
+		(hotFirst.isValid() && points.last().timestamp >= hotFirst)))
+	{
+		points.removeLast();
+	}
+	// continue with the hot tier
+	quint64 offsetHot = numPointsOffset > numCold ? numPointsOffset - numCold : 0;
+	for (quint64 i = offsetHot;
+		i < static_cast<quint64>(hotPoints.count()) && static_cast<quint64>(points.count()) < numPointsToRead;
+		i++)
+	{
+		points.append(hotPoints.at(static_cast<int>(i)));
+	}
+	// NOTE : return invalid values if API requests more values than available
+	points.resize(static_cast<int>(numPointsToRead));
+	return points;
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+bool QUaTieredHistorizer::writeHistoryEventsOfType(
+	const QUaNodeId            &eventTypeNodeId,
+	const QList<QUaNodeId>     &emittersNodeIds,
+	const QUaHistoryEventPoint &eventPoint,
+	QQueue<QUaLog>             &logOut
+)
+{
+	QMutexLocker locker(&m_coldMutex);
+	return m_cold.writeHistoryEventsOfType(eventTypeNodeId, emittersNodeIds, eventPoint, logOut);
+}
+
+QVector<QUaNodeId> QUaTieredHistorizer::eventTypesOfEmitter(
+	const QUaNodeId &emitterNodeId,
+	QQueue<QUaLog>  &logOut
+)
+{
+	QMutexLocker locker(&m_coldMutex);
+	return m_cold.eventTypesOfEmitter(emitterNodeId, logOut);
+}
+
+QDateTime QUaTieredHistorizer::findTimestampEventOfType(
+	const QUaNodeId                    &emitterNodeId,
+	const QUaNodeId                    &eventTypeNodeId,
+	const QDateTime                    &timestamp,
+	const QUaHistoryBackend::TimeMatch &match,
+	QQueue<QUaLog>                     &logOut
+)
+{
+	QMutexLocker locker(&m_coldMutex);
+	return m_cold.findTimestampEventOfType(emitterNodeId, eventTypeNodeId, timestamp, match, logOut);
+}
+
+quint64 QUaTieredHistorizer::numEventsOfTypeInRange(
+	const QUaNodeId &emitterNodeId,
+	const QUaNodeId &eventTypeNodeId,
+	const QDateTime &timeStart,
+	const QDateTime &timeEnd,
+	QQueue<QUaLog>  &logOut
+)
+{
+	QMutexLocker locker(&m_coldMutex);
+	return m_cold.numEventsOfTypeInRange(emitterNodeId, eventTypeNodeId, timeStart, timeEnd, logOut);
+}
+
+QVector<QUaHistoryEventPoint> QUaTieredHistorizer::readHistoryEventsOfType(
+	const QUaNodeId &emitterNodeId,
+	const QUaNodeId &eventTypeNodeId,
+	const QDateTime &timeStart,
+	const quint64   &numPointsOffset,
+	const quint64   &numPointsToRead,
+	const QList<QUaBrowsePath> &columnsToRead,
+	QQueue<QUaLog>  &logOut
+)
+{
+	QMutexLocker locker(&m_coldMutex);
+	return m_cold.readHistoryEventsOfType(
+		emitterNodeId,
+		eventTypeNodeId,
+		timeStart,
+		numPointsOffset,
+		numPointsToRead,
+		columnsToRead,
+		logOut
+	);
+}
+
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+bool QUaTieredHistorizer::move(const bool& all, QQueue<QUaLog>& logOut)
+{
+	// NOTE : readers of the cold tier wait until the moved data points are written
+	QMutexLocker coldLocker(&m_coldMutex);
+	bool ok = this->writePending(logOut);
+	if (!m_coldSet)
+	{
+		return ok;
+	}
+	// copy the data points to move, they stay in the hot tier until written to the cold tier
+	// NOTE : meanwhile writes up to movingLast go through writeCold, which waits on m_coldMutex
+	QVector<QUaHistoryNodeDataPoint> points;
+	QHash<QUaNodeId, int> moving;
+	{
+		QMutexLocker hotLocker(&m_hotMutex);
+		for (auto iter = m_hot.begin(); iter != m_hot.end(); iter++)
+		{
+			auto& series = iter.value();
+			int total = QUaTieredHistorizer::count(series);
+			if (total == 0)
+			{
+				continue;
+			}
+			int moved = all ? total :
+				QUaTieredHistorizer::lowerBound(series, series.times.last() - m_hotWindow);
+			if (moved == 0)
+			{
+				continue;
+			}
+			points.reserve(points.count() + moved);
+			for (int i = series.head; i < series.head + moved; i++)
+			{
+				points.append({
+					iter.key(),
+					{
+						QDateTime::fromMSecsSinceEpoch(series.times[i], Qt::UTC),
+						series.values[i],
+						series.statuses[i]
+					}
+				});
+			}
+			series.movingLast = series.times[series.head + moved - 1];
+			moving.insert(iter.key(), moved);
+		}
+	}
+	if (points.isEmpty())
+	{
+		return ok;
+	}
+	// write as a single batch
+	bool written = m_cold.writeHistoryDataBatch(points, logOut);
+	QMutexLocker hotLocker(&m_hotMutex);
+	for (auto iter = moving.constBegin(); iter != moving.constEnd(); iter++)
+	{
+		auto hotIter = m_hot.find(iter.key());
+		if (hotIter == m_hot.end())
+		{
+			continue;
+		}
+		auto& series = hotIter.value();
+		if (!written)
+		{
+			// keep in the hot tier, moved again on next aging
+			series.movingLast = (std::numeric_limits<qint64>::min)();
+			continue;
+		}
+		int moved = iter.value();
+		for (int i = series.head; i < series.head + moved; i++)
+		{
+			series.values[i] = QVariant();
+		}
+		series.coldLast   = series.movingLast;
+		series.movingLast = (std::numeric_limits<qint64>::min)();
+		series.head += moved;
+		// compact once half of the arrays were moved
+		if (series.head >= series.times.count() / 2)
+		{
+			series.times.remove(0, series.head);
+			series.values.remove(0, series.head);
+			series.statuses.remove(0, series.head);
+			series.head = 0;
+		}
+	}
+	if (!written)
+	{
+		logOut << QUaLog({
+			QObject::tr("Failed to move %1 history data points to the cold tier. "
+				"Data points are kept in memory and moved on next aging.")
+				.arg(points.count()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+			});
+	}
+	return ok && written;
+}
+
+bool QUaTieredHistorizer::writePending(QQueue<QUaLog>& logOut)
+{
+	// NOTE : m_coldMutex must be locked
+	QVector<QUaHistoryNodeDataPoint> pending;
+	{
+		QMutexLocker hotLocker(&m_hotMutex);
+		pending.swap(m_coldPending);
+	}
+	if (pending.isEmpty())
+	{
+		return true;
+	}
+	// resolve series of new nodes first, without holding m_hotMutex while reading the cold tier
+	QHash<QUaNodeId, HotSeries> newSeries;
+	for (const auto& point : qAsConst(pending))
+	{
+		if (newSeries.contains(point.nodeId))
+		{
+			continue;
+		}
+		QMutexLocker hotLocker(&m_hotMutex);
+		bool exists = m_hot.contains(point.nodeId);
+		hotLocker.unlock();
+		if (!exists)
+		{
+			newSeries.insert(point.nodeId, this->newSeries(point.nodeId));
+		}
+	}
+	// route to the hot tier or to the cold tier, keeping the order of the writes
+	QVector<QUaHistoryNodeDataPoint> cold;
+	{
+		QMutexLocker hotLocker(&m_hotMutex);
+		for (auto iter = newSeries.constBegin(); iter != newSeries.constEnd(); iter++)
+		{
+			m_hot.insert(iter.key(), iter.value());
+		}
+		for (const auto& point : qAsConst(pending))
+		{
+			qint64 time = point.dataPoint.timestamp.toMSecsSinceEpoch();
+			auto& series = m_hot[point.nodeId];
+			if (QUaTieredHistorizer::isHot(series, time))
+			{
+				QUaTieredHistorizer::hotInsert(series, time, point.dataPoint.value, point.dataPoint.status);
+				continue;
+			}
+			cold.append(point);
+		}
+	}
+	if (cold.isEmpty())
+	{
+		return true;
+	}
+	return m_cold.writeHistoryDataBatch(cold, logOut);
+}
+
+bool QUaTieredHistorizer::writeCold(
+	const QUaNodeId& nodeId,
+	const QUaHistoryDataPoint& dataPoint,
+	QQueue<QUaLog>& logOut)
+{
+	qint64 time = dataPoint.timestamp.toMSecsSinceEpoch();
+	// queue writes of other threads, written on next aging
+	if (!this->inColdThread())
+	{
+		QMutexLocker hotLocker(&m_hotMutex);
+		m_coldPending.append({ nodeId, dataPoint });
+		return true;
+	}
+	QMutexLocker coldLocker(&m_coldMutex);
+	QMutexLocker hotLocker(&m_hotMutex);
+	auto iter = m_hot.find(nodeId);
+	if (iter == m_hot.end())
+	{
+		hotLocker.unlock();
+		HotSeries series = this->newSeries(nodeId);
+		hotLocker.relock();
+		iter = m_hot.insert(nodeId, series);
+	}
+	if (QUaTieredHistorizer::isHot(iter.value(), time))
+	{
+		QUaTieredHistorizer::hotInsert(iter.value(), time, dataPoint.value, dataPoint.status);
+		return true;
+	}
+	// older than the data points moved to the cold tier
+	hotLocker.unlock();
+	return m_cold.writeHistoryData(nodeId, dataPoint, logOut);
+}
+
+QUaTieredHistorizer::HotSeries QUaTieredHistorizer::newSeries(const QUaNodeId& nodeId) const
+{
+	// NOTE : m_coldMutex must be locked
+	// first write of the node, continue after the data points of the cold tier
+	// NOTE : the cold tier logs an error if it has no data points for the node
+	QQueue<QUaLog> coldLogOut;
+	QDateTime coldLast = m_coldSet ? m_cold.lastTimestamp(nodeId, coldLogOut) : QDateTime();
+	HotSeries series;
+	series.head       = 0;
+	series.coldLast   = coldLast.isValid() ?
+		coldLast.toMSecsSinceEpoch() :
+		(std::numeric_limits<qint64>::min)();
+	series.movingLast = (std::numeric_limits<qint64>::min)();
+	return series;
+}
+
+bool QUaTieredHistorizer::inColdThread() const
+{
+	return QThread::currentThread() == m_timerAging.thread();
+}
+
+void QUaTieredHistorizer::hotInsert(
+	HotSeries& series,
+	const qint64& time,
+	const QVariant& value,
+	const quint32& status)
+{
+	// fast path, data points usually arrive in order
+	if (QUaTieredHistorizer::count(series) == 0 || time > series.times.last())
+	{
+		series.times.append(time);
+		series.values.append(value);
+		series.statuses.append(status);
+		return;
+	}
+	int index = series.head + QUaTieredHistorizer::lowerBound(series, time);
+	// overwrite existing
+	if (series.times[index] == time)
+	{
+		series.values[index]   = value;
+		series.statuses[index] = status;
+		return;
+	}
+	// out of order
+	series.times.insert(index, time);
+	series.values.insert(index, value);
+	series.statuses.insert(index, status);
+}
+
+bool QUaTieredHistorizer::isHot(const HotSeries& series, const qint64& time)
+{
+	return time > series.coldLast && time > series.movingLast;
+}
+
+bool QUaTieredHistorizer::hasCold(const HotSeries& series)
+{
+	return series.coldLast != (std::numeric_limits<qint64>::min)();
+}
+
+int QUaTieredHistorizer::count(const HotSeries& series)
+{
+	return series.times.count() - series.head;
+}
+
+int QUaTieredHistorizer::lowerBound(const HotSeries& series, const qint64& time)
+{
+	auto iter = std::lower_bound(series.times.constBegin() + series.head, series.times.constEnd(), time);
+	return static_cast<int>(iter - series.times.constBegin()) - series.head;
+}
+
+int QUaTieredHistorizer::upperBound(const HotSeries& series, const qint64& time)
+{
+	auto iter = std::upper_bound(series.times.constBegin() + series.head, series.times.constEnd(), time);
+	return static_cast<int>(iter - series.times.constBegin()) - series.head;
+}
+
+QDateTime QUaTieredHistorizer::timeAt(const HotSeries& series, const int& index)
+{
+	return QDateTime::fromMSecsSinceEpoch(series.times[series.head + index], Qt::UTC);
+}
+
+QVector<QUaHistoryDataPoint> QUaTieredHistorizer::hotRead(
+	const HotSeries& series,
+	const quint64& index,
+	const quint64& numPoints)
+{
+	QVector<QUaHistoryDataPoint> points;
+	quint64 total = static_cast<quint64>(QUaTieredHistorizer::count(series));
+	if (index >= total)
+	{
+		return points;
+	}
+	int first = series.head + static_cast<int>(index);
+	int last  = first + static_cast<int>((std::min)(numPoints, total - index));
+	points.reserve(last - first);
+	for (int i = first; i < last; i++)
+	{
+		points.append({
+			QDateTime::fromMSecsSinceEpoch(series.times[i], Qt::UTC),
+			series.values[i],
+			series.statuses[i]
+		});
+	}
+	return points;
+}
+
+#endif // UA_ENABLE_HISTORIZING
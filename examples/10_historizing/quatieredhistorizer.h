@@ -0,0 +1,231 @@
+#ifndef QUATIEREDHISTORIZER_H
+#define QUATIEREDHISTORIZER_H
+
+#include <QUaHistoryBackend>
+
+#ifdef UA_ENABLE_HISTORIZING
+
+#include <QMutex>
+#include <QTimer>
+
+// historizer which keeps the most recent data points of each node in memory (hot tier) and
+// periodically moves the older ones in batches to any other historizer (cold tier)
+// reads within the hot window are served from memory, older ranges are merged from both tiers
+// NOTE : the cold historizer is only called from the thread of this historizer, so it can be
+//        bound to that thread (e.g. QUaSqliteHistorizer). Writes from other threads (see
+//        QUaServer::setHistoryWriteAsync) that need the cold tier are queued and written on
+//        the next aging, they are not visible to reads until then
+// NOTE : all data points of the cold tier are older than the ones of the hot tier, so a data
+//        point older than the ones moved to the cold tier is written directly to the cold tier
+// NOTE : moved data points are only removed from the hot tier once written to the cold tier,
+//        on error they are kept and moved again on the next aging
+// NOTE : events are written to and read from the cold tier
+class QUaTieredHistorizer
+{
+public:
+	QUaTieredHistorizer();
+	// moves the hot tier to the cold tier
+	~QUaTieredHistorizer();
+
+	// set the historizer of the cold tier, type T must implement the API required by
+	// QUaServer::setHistorizer and must live at least as long as this historizer
+	// NOTE : must be set before writing, data points are only moved to a cold tier
+	template<typename T>
+	void setColdHistorizer(T& historizer);
+
+	// time span in milliseconds of the data points kept in memory for each node, counted
+	// back from the node's most recent data point (default 1 hour)
+	qint64 hotWindow() const;
+	void   setHotWindow(const qint64& hotWindow);
+	// period in milliseconds at which data points older than the hot window are moved to
+	// the cold tier (default 1 second)
+	int  agingInterval() const;
+	void setAgingInterval(const int& agingInterval);
+	// move the data points older than the hot window to the cold tier now, as done
+	// periodically, return false on error
+	// NOTE : must be called from the thread of this historizer
+	bool age(QQueue<QUaLog>& logOut);
+	// move all data points of the hot tier to the cold tier, return false on error
+	// NOTE : must be called from the thread of this historizer
+	bool flush(QQueue<QUaLog>& logOut);
+	// number of data points in the hot tier
+	quint64 hotCount() const;
+
+	// required API for QUaServer::setHistorizer
+	// write data point to backend, return true on success
+	bool writeHistoryData(
+		const QUaNodeId &nodeId,
+		const QUaHistoryDataPoint& dataPoint,
+		QQueue<QUaLog>& logOut
+	);
+	// optional API for QUaServer::setHistorizer
+	// write a batch of data points to backend, used with QUaServer::setHistoryWriteAsync
+	bool writeHistoryDataBatch(
+		const QVector<QUaHistoryNodeDataPoint>& points,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// update an existing node's data point in backend, return true on success
+	bool updateHistoryData(
+		const QUaNodeId &nodeId,
+		const QUaHistoryDataPoint& dataPoint,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// remove an existing node's data points within a range, return true on success
+	bool removeHistoryData(
+		const QUaNodeId &nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QQueue<QUaLog>& logOut
+	);
+	// required API for QUaServer::setHistorizer
+	// return the timestamp of the first sample available for the given node
+	QDateTime firstTimestamp(
+		const QUaNodeId &nodeId,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the timestamp of the latest sample available for the given node
+	QDateTime lastTimestamp(
+		const QUaNodeId &nodeId,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return true if given timestamp is available for the given node
+	bool hasTimestamp(
+		const QUaNodeId &nodeId,
+		const QDateTime& timestamp,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return a timestamp matching the criteria for the given node
+	QDateTime findTimestamp(
+		const QUaNodeId &nodeId,
+		const QDateTime& timestamp,
+		const QUaHistoryBackend::TimeMatch& match,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the number for data points within a time range for the given node
+	quint64 numDataPointsInRange(
+		const QUaNodeId &nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QQueue<QUaLog>& logOut
+	) const;
+	// required API for QUaServer::setHistorizer
+	// return the numPointsToRead data points for the given node from the given start time
+	QVector<QUaHistoryDataPoint> readHistoryData(
+		const QUaNodeId & nodeId,
+		const QDateTime &timeStart,
+		const quint64   &numPointsOffset,
+		const quint64   &numPointsToRead,
+		QQueue<QUaLog>  &logOut
+	) const;
+
+	// event history support
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// write a event's data to backend
+	bool writeHistoryEventsOfType(
+		const QUaNodeId            &eventTypeNodeId,
+		const QList<QUaNodeId>     &emittersNodeIds,
+		const QUaHistoryEventPoint &eventPoint,
+		QQueue<QUaLog>             &logOut
+	);
+	// get event types (node ids) for which there are events stored for the
+	// given emitter
+	QVector<QUaNodeId> eventTypesOfEmitter(
+		const QUaNodeId &emitterNodeId,
+		QQueue<QUaLog>  &logOut
+	);
+	// find a timestamp matching the criteria for the emitter and event type
+	QDateTime findTimestampEventOfType(
+		const QUaNodeId                    &emitterNodeId,
+		const QUaNodeId                    &eventTypeNodeId,
+		const QDateTime                    &timestamp,
+		const QUaHistoryBackend::TimeMatch &match,
+		QQueue<QUaLog>                     &logOut
+	);
+	// get the number for events within a time range for the given emitter and event type
+	quint64 numEventsOfTypeInRange(
+		const QUaNodeId &emitterNodeId,
+		const QUaNodeId &eventTypeNodeId,
+		const QDateTime &timeStart,
+		const QDateTime &timeEnd,
+		QQueue<QUaLog>  &logOut
+	);
+	// return the numPointsToRead events for the given emitter and event type,
+	// starting from the numPointsOffset offset after given start time (pagination)
+	QVector<QUaHistoryEventPoint> readHistoryEventsOfType(
+		const QUaNodeId &emitterNodeId,
+		const QUaNodeId &eventTypeNodeId,
+		const QDateTime &timeStart,
+		const quint64   &numPointsOffset,
+		const quint64   &numPointsToRead,
+		const QList<QUaBrowsePath> &columnsToRead,
+		QQueue<QUaLog>  &logOut
+	);
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+private:
+	// data points of a node in the hot tier, ordered by time, one array per field
+	struct HotSeries
+	{
+		QVector<qint64>   times; // milliseconds since epoch (UTC)
+		QVector<QVariant> values;
+		QVector<quint32>  statuses;
+		int    head;       // index of the first data point, the ones before were moved
+		qint64 coldLast;   // time of the most recent data point in the cold tier
+		qint64 movingLast; // time of the most recent data point being moved, see move
+	};
+	// the cold historizer is type erased by a backend, m_coldMutex serializes the calls to it
+	// and keeps readers of the cold tier waiting while data points are moved
+	// NOTE : lock order is m_coldMutex then m_hotMutex, so writes to the hot tier only wait
+	//        while the data points to move are copied
+	QUaHistoryBackend m_cold;
+	bool              m_coldSet;
+	mutable QMutex    m_coldMutex;
+	mutable QMutex    m_hotMutex;
+	QHash<QUaNodeId, HotSeries> m_hot;
+	qint64            m_hotWindow;
+	QTimer            m_timerAging;
+	int               m_agingInterval;
+	QQueue<QUaLog>    m_agingLogOut; // guarded by m_hotMutex
+	// writes from other threads that need the cold tier, guarded by m_hotMutex
+	QVector<QUaHistoryNodeDataPoint> m_coldPending;
+	// move the data points older than the hot window (or all) to the cold tier
+	bool move(const bool& all, QQueue<QUaLog>& logOut);
+	// write the queued writes of other threads, m_coldMutex must be locked
+	bool writePending(QQueue<QUaLog>& logOut);
+
+	// write to the cold tier if older than the data points already moved, else to the hot tier
+	bool writeCold(const QUaNodeId& nodeId, const QUaHistoryDataPoint& dataPoint, QQueue<QUaLog>& logOut);
+	// new series which continues after the data points of the cold tier, m_coldMutex must be locked
+	HotSeries newSeries(const QUaNodeId& nodeId) const;
+	// true if the cold historizer can be called from the current thread
+	bool inColdThread() const;
+	static void hotInsert(HotSeries& series, const qint64& time, const QVariant& value, const quint32& status);
+	// true if a data point with the given time belongs to the hot tier
+	static bool isHot(const HotSeries& series, const qint64& time);
+	static bool hasCold(const HotSeries& series);
+	static int  count(const HotSeries& series);
+	// index relative to head of the first data point with time >= (lower) or > (upper) than given time
+	static int  lowerBound(const HotSeries& series, const qint64& time);
+	static int  upperBound(const HotSeries& series, const qint64& time);
+	static QDateTime timeAt(const HotSeries& series, const int& index);
+	// copy of up to numPoints data points of the hot tier starting at index
+	static QVector<QUaHistoryDataPoint> hotRead(const HotSeries& series, const quint64& index, const quint64& numPoints);
+};
+
+template<typename T>
+inline void QUaTieredHistorizer::setColdHistorizer(T& historizer)
+{
+	QMutexLocker locker(&m_coldMutex);
+	m_cold.setHistorizer(historizer);
+	m_coldSet = true;
+}
+
+#endif // UA_ENABLE_HISTORIZING
+
+#endif // QUATIEREDHISTORIZER_H
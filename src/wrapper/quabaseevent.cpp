@@ -56,6 +56,7 @@ QUaNodeId QUaBaseEvent::sourceNode() const
 
 void QUaBaseEvent::setSourceNode(const QUaNodeId& sourceNodeId)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// set cache
 	UA_NodeId_clear(&m_sourceNodeId);
 	m_sourceNodeId = sourceNodeId;
@@ -161,6 +162,7 @@ void QUaBaseEvent::setSeverity(const quint16 & intSeverity)
 
 void QUaBaseEvent::trigger()
 {
+    QUaIterateLocker locker(m_qUaServer);
     this->setEventId(QUaBaseEvent::generateEventId());
     this->triggerInternal();
 }
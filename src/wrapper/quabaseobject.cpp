@@ -47,6 +47,7 @@ QUaBaseObject::QUaBaseObject(
 
 quint8 QUaBaseObject::eventNotifier() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	UA_Byte outByte;
 	auto st = UA_Server_readEventNotifier(m_qUaServer->m_server, m_nodeId, &outByte);
 	Q_ASSERT(st == UA_STATUSCODE_GOOD);
@@ -56,6 +57,7 @@ quint8 QUaBaseObject::eventNotifier() const
 
 void QUaBaseObject::setEventNotifier(const quint8 & eventNotifier)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	auto st = UA_Server_writeEventNotifier(m_qUaServer->m_server, m_nodeId, eventNotifier);
 	Q_ASSERT(st == UA_STATUSCODE_GOOD);
 	Q_UNUSED(st);
@@ -52,6 +52,39 @@ UA_DataType* getDataTypeFromNodeId(const UA_NodeId& optNodeId)
 #endif // !OPEN62541_ISSUE3934_RESOLVED
 #endif // UA_GENERATED_NAMESPACE_ZERO_FULL
 
+// bits of QUaBaseVariable::m_cacheValid
+#define QUA_CACHE_VALUE           0x01
+#define QUA_CACHE_STATUSCODE      0x02
+#define QUA_CACHE_SOURCETIMESTAMP 0x04
+#define QUA_CACHE_SERVERTIMESTAMP 0x08
+
+// approximate heap memory used by a QVariant value (not including the QVariant itself)
+static quint64 variantMemorySize(const QVariant& value)
+{
+	int type = value.userType();
+	if (type == QMetaType::QString)
+	{
+		return static_cast<quint64>(value.toString().capacity()) * sizeof(QChar);
+	}
+	if (type == QMetaType::QByteArray)
+	{
+		return static_cast<quint64>(value.toByteArray().capacity());
+	}
+	if (type == QMetaType::QVariantList)
+	{
+		auto list = value.toList();
+		quint64 size = static_cast<quint64>(list.count()) * sizeof(QVariant);
+		for (const auto& item : list)
+		{
+			size += variantMemorySize(item);
+		}
+		return size;
+	}
+	// NOTE : small types are stored inside the QVariant
+	int typeSize = QMetaType(type).sizeOf();
+	return typeSize > static_cast<int>(sizeof(double)) ? static_cast<quint64>(typeSize) : 0;
+}
+
 // [STATIC] : always called by open62541 library after a write, used by QUaServer 
 // to emit signals and to make differentiation between network or programmatic value change
 void QUaBaseVariable::onWrite(UA_Server             *server, 
@@ -64,7 +97,6 @@ void QUaBaseVariable::onWrite(UA_Server             *server,
 {
 	Q_UNUSED(sessionContext);
 	Q_UNUSED(nodeId);
-	Q_UNUSED(range);
 	// get variable from context
 #ifdef QT_DEBUG 
 	auto var = qobject_cast<QUaBaseVariable*>(static_cast<QObject*>(nodeContext));
@@ -76,6 +108,8 @@ void QUaBaseVariable::onWrite(UA_Server             *server,
 	{
 		return;
 	}
+	// keep cache coherent, with written value instead of reading it back
+	var->updateValueCache(data, range != nullptr);
 	// get server
 	void* serverContext = nullptr;
 	auto st = UA_Server_getNodeContext(server, UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER), &serverContext);
@@ -91,6 +125,13 @@ void QUaBaseVariable::onWrite(UA_Server             *server,
 	// NOTE : sometimes happens that !srv->m_hashSessions.contains(*sessionId)
 	srv->m_currentSession = srv->m_hashSessions.contains(*sessionId) ?
 		srv->m_hashSessions[*sessionId] : nullptr;
+	// signals are emitted later if writing in batch (see QUaServer::writeValues)
+	if (srv->m_deferWriteSignals)
+	{
+		srv->deferWriteSignals(var, data);
+		var->m_bInternalWrite = false;
+		return;
+	}
 	// do not process if nobody listening
 	static const QMetaMethod valueSignal = QMetaMethod::fromSignal(&QUaBaseVariable::valueChanged);
 	if (var->isSignalConnected(valueSignal))
@@ -204,7 +245,15 @@ QUaBaseVariable::QUaBaseVariable(
 #endif // UA_ENABLE_HISTORIZING
 }
 
+QUaBaseVariable::~QUaBaseVariable()
+{
+	// remove from server's cache memory count
+	m_cacheEnabled = false;
+	this->clearValueCache();
+}
+
 void QUaBaseVariable::setReadCallback(const std::function<QVariant()>& readCallback){
+	QUaIterateLocker locker(m_qUaServer);
 	UA_ValueCallback callback;
 	if (readCallback)
 	{
@@ -217,6 +266,8 @@ void QUaBaseVariable::setReadCallback(const std::function<QVariant()>& readCallb
 		callback.onRead = nullptr;
 		m_readCallback = readCallback;
 	}
+	// cache might be outdated if read callback was used
+	m_cacheValid = 0;
 	callback.onWrite = &QUaBaseVariable::onWrite;
 	// this replaces the previous callback, if any
 	UA_Server_setVariableNode_valueCallback(m_qUaServer->m_server, m_nodeId, callback);
@@ -227,32 +278,206 @@ QVariant QUaBaseVariable::value() const
 	return this->getValueInternal();
 }
 
+bool QUaBaseVariable::valueCacheEnabled() const
+{
+	return m_cacheEnabled;
+}
+
+void QUaBaseVariable::setValueCacheEnabled(const bool& valueCacheEnabled)
+{
+	QUaIterateLocker locker(m_qUaServer);
+	if (valueCacheEnabled == m_cacheEnabled)
+	{
+		return;
+	}
+	m_cacheEnabled = valueCacheEnabled;
+	// NOTE : cache is filled on next read or write
+	this->clearValueCache();
+}
+
+quint64 QUaBaseVariable::valueCacheMemory() const
+{
+	QUaIterateLocker locker(m_qUaServer);
+	return m_cacheMemory;
+}
+
+bool QUaBaseVariable::useValueCache() const
+{
+	return m_cacheEnabled && !m_readCallback;
+}
+
+void QUaBaseVariable::updateValueCache(const UA_DataValue* data, const bool& isPartial)
+{
+	if (!this->useValueCache())
+	{
+		return;
+	}
+	// only convert value if going to be used right away (see onWrite), else convert on next read
+	static const QMetaMethod valueSignal = QMetaMethod::fromSignal(&QUaBaseVariable::valueChanged);
+	if (data->hasValue && !isPartial && this->isSignalConnected(valueSignal))
+	{
+		m_cacheValue = QUaTypesConverter::uaVariantToQVariant(data->value);
+		m_cacheValid |= QUA_CACHE_VALUE;
+	}
+	else
+	{
+		m_cacheValue = QVariant();
+		m_cacheValid &= ~QUA_CACHE_VALUE;
+	}
+	// NOTE : status is copied even if hasStatus is false (see setSourceTimestamp)
+	m_cacheStatusCode = data->status;
+	m_cacheValid |= QUA_CACHE_STATUSCODE;
+	if (data->hasSourceTimestamp)
+	{
+		m_cacheSourceTimestamp = QUaTypesConverter::uaVariantToQVariantScalar
+			<QDateTime, UA_DateTime>(&data->sourceTimestamp);
+		m_cacheValid |= QUA_CACHE_SOURCETIMESTAMP;
+	}
+	else
+	{
+		m_cacheValid &= ~QUA_CACHE_SOURCETIMESTAMP;
+	}
+	// NOTE : server might set its own timestamp, read it back when needed
+	if (data->hasServerTimestamp)
+	{
+		m_cacheServerTimestamp = QUaTypesConverter::uaVariantToQVariantScalar
+			<QDateTime, UA_DateTime>(&data->serverTimestamp);
+		m_cacheValid |= QUA_CACHE_SERVERTIMESTAMP;
+	}
+	else
+	{
+		m_cacheValid &= ~QUA_CACHE_SERVERTIMESTAMP;
+	}
+	this->updateValueCacheMemory();
+}
+
+void QUaBaseVariable::updateValueCacheMemory() const
+{
+	quint64 memory = !m_cacheEnabled ? 0 :
+		sizeof(QVariant) + sizeof(QUaStatusCode) + 2 * sizeof(QDateTime) +
+		variantMemorySize(m_cacheValue);
+	// NOTE : unsigned wrap around gives the right result when memory decreases
+	m_qUaServer->m_valueCacheMemory += memory - m_cacheMemory;
+	m_cacheMemory = memory;
+}
+
+void QUaBaseVariable::clearValueCache()
+{
+	m_cacheValid = 0;
+	m_cacheValue = QVariant();
+	m_cacheSourceTimestamp = QDateTime();
+	m_cacheServerTimestamp = QDateTime();
+	this->updateValueCacheMemory();
+}
+
 QVariant QUaBaseVariable::getValueInternal(
 	const QUaTypesConverter::ArrayType& arrType
 	 /* = QUaTypesConverter::ArrayType::QList*/
 ) const
 {
-	Q_CHECK_PTR(m_qUaServer);
+	QUaIterateLocker locker(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (UA_NodeId_isNull(&m_nodeId))
 	{
 		return QVariant();
 	}
+	// NOTE : cache only holds QList arrays, same as value()
+	bool useCache = arrType == QUaTypesConverter::ArrayType::QList && this->useValueCache();
+	if (useCache && (m_cacheValid & QUA_CACHE_VALUE))
+	{
+		return m_cacheValue;
+	}
 	// get value
+	UA_DataValue value = this->getDataValueInternal();
+	// convert
+	QVariant outVar = QUaTypesConverter::uaVariantToQVariant(value.value, arrType);
+	// clenaup
+	UA_DataValue_clear(&value);
+	if (useCache)
+	{
+		m_cacheValue = outVar;
+		m_cacheValid |= QUA_CACHE_VALUE;
+		this->updateValueCacheMemory();
+	}
+	return outVar;
+}
+
+UA_DataValue QUaBaseVariable::getDataValueInternal() const
+{
+	QUaIterateLocker locker(m_qUaServer);
+	Q_CHECK_PTR(m_qUaServer);
 	UA_ReadValueId rv;
 	UA_ReadValueId_init(&rv);
 	rv.nodeId      = m_nodeId;
 	rv.attributeId = UA_ATTRIBUTEID_VALUE;
-	UA_DataValue value = UA_Server_read(
+	return UA_Server_read(
 		m_qUaServer->m_server,
 		&rv,
 		UA_TIMESTAMPSTORETURN_NEITHER
 	);
-	// convert
-	QVariant outVar = QUaTypesConverter::uaVariantToQVariant(value.value, arrType);
-	// clenaup
-	UA_DataValue_clear(&value);
-	return outVar;
+}
+
+void QUaBaseVariable::setValueNative(
+	const UA_Variant    &value,
+	const QUaStatusCode &statusCode,
+	const QDateTime     &sourceTimestamp,
+	const QDateTime     &serverTimestamp
+)
+{
+	QUaIterateLocker locker(m_qUaServer);
+	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
+	// mask as internal write to avoid emitting valueChange signal on QUaBaseVariable::onWrite
+	m_bInternalWrite = true;
+	auto st = this->setValueInternal(
+		value,
+		statusCode,
+		sourceTimestamp,
+		serverTimestamp
+	);
+	Q_ASSERT(st == UA_STATUSCODE_GOOD);
+	Q_UNUSED(st);
+}
+
+bool QUaBaseVariable::setValueIfNative(
+	const QVariant      &value,
+	const QUaStatusCode &statusCode,
+	const QDateTime     &sourceTimestamp,
+	const QDateTime     &serverTimestamp
+)
+{
+	int type = value.userType();
+	// these values are maped to the same (see setValue), but not long whose size depends on platform
+	if      (type == QMetaType::SChar    ) { type = QMetaType::Char;  }
+	else if (type == QMetaType::LongLong ) { type = QMetaType::Long;  }
+	else if (type == QMetaType::ULongLong) { type = QMetaType::ULong; }
+	else if (type == QMetaType::Long || type == QMetaType::ULong) { return false; }
+	if (type != m_dataType)
+	{
+		return false;
+	}
+	// same as native_type_traits
+	int uaType = -1;
+	switch (type)
+	{
+	case QMetaType::Bool  : uaType = UA_TYPES_BOOLEAN; break;
+	case QMetaType::Char  : uaType = UA_TYPES_SBYTE  ; break;
+	case QMetaType::UChar : uaType = UA_TYPES_BYTE   ; break;
+	case QMetaType::Short : uaType = UA_TYPES_INT16  ; break;
+	case QMetaType::UShort: uaType = UA_TYPES_UINT16 ; break;
+	case QMetaType::Int   : uaType = UA_TYPES_INT32  ; break;
+	case QMetaType::UInt  : uaType = UA_TYPES_UINT32 ; break;
+	case QMetaType::Long  : uaType = UA_TYPES_INT64  ; break;
+	case QMetaType::ULong : uaType = UA_TYPES_UINT64 ; break;
+	case QMetaType::Float : uaType = UA_TYPES_FLOAT  ; break;
+	case QMetaType::Double: uaType = UA_TYPES_DOUBLE ; break;
+	default:
+		return false;
+	}
+	// NOTE : no copy, UA_Server_write makes its own
+	UA_Variant uaVar;
+	UA_Variant_setScalar(&uaVar, const_cast<void*>(value.constData()), &UA_TYPES[uaType]);
+	this->setValueNative(uaVar, statusCode, sourceTimestamp, serverTimestamp);
+	return true;
 }
 
 void QUaBaseVariable::setValue(
@@ -263,6 +488,7 @@ void QUaBaseVariable::setValue(
 	const QMetaType::Type &newTypeConst    /*= QMetaType::UnknownType*/
 )
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// get types
@@ -420,6 +646,12 @@ void QUaBaseVariable::setValue(
 
 QDateTime QUaBaseVariable::sourceTimestamp() const
 {
+	QUaIterateLocker locker(m_qUaServer);
+	bool useCache = this->useValueCache();
+	if (useCache && (m_cacheValid & QUA_CACHE_SOURCETIMESTAMP))
+	{
+		return m_cacheSourceTimestamp;
+	}
 	UA_ReadValueId rv;
 	UA_ReadValueId_init(&rv);
 	rv.nodeId      = m_nodeId;
@@ -432,11 +664,17 @@ QDateTime QUaBaseVariable::sourceTimestamp() const
 	QDateTime time = QUaTypesConverter::uaVariantToQVariantScalar<QDateTime, UA_DateTime>(&value.sourceTimestamp);
 	// clean up
 	UA_DataValue_clear(&value);
+	if (useCache)
+	{
+		m_cacheSourceTimestamp = time;
+		m_cacheValid |= QUA_CACHE_SOURCETIMESTAMP;
+	}
 	return time;
 }
 
 void QUaBaseVariable::setSourceTimestamp(const QDateTime& sourceTimestamp)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// get value
 	UA_ReadValueId rv;
 	UA_ReadValueId_init(&rv);
@@ -478,6 +716,12 @@ void QUaBaseVariable::setSourceTimestamp(const QDateTime& sourceTimestamp)
 
 QDateTime QUaBaseVariable::serverTimestamp() const
 {
+	QUaIterateLocker locker(m_qUaServer);
+	bool useCache = this->useValueCache();
+	if (useCache && (m_cacheValid & QUA_CACHE_SERVERTIMESTAMP))
+	{
+		return m_cacheServerTimestamp;
+	}
 	UA_ReadValueId rv;
 	UA_ReadValueId_init(&rv);
 	rv.nodeId      = m_nodeId;
@@ -490,11 +734,17 @@ QDateTime QUaBaseVariable::serverTimestamp() const
 	QDateTime time = QUaTypesConverter::uaVariantToQVariantScalar<QDateTime, UA_DateTime>(&value.serverTimestamp);
 	// clean up
 	UA_DataValue_clear(&value);
+	if (useCache)
+	{
+		m_cacheServerTimestamp = time;
+		m_cacheValid |= QUA_CACHE_SERVERTIMESTAMP;
+	}
 	return time;
 }
 
 void QUaBaseVariable::setServerTimestamp(const QDateTime& serverTimestamp)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// get value
 	UA_ReadValueId rv;
 	UA_ReadValueId_init(&rv);
@@ -536,6 +786,12 @@ void QUaBaseVariable::setServerTimestamp(const QDateTime& serverTimestamp)
 
 QUaStatusCode QUaBaseVariable::statusCode() const
 {
+	QUaIterateLocker locker(m_qUaServer);
+	bool useCache = this->useValueCache();
+	if (useCache && (m_cacheValid & QUA_CACHE_STATUSCODE))
+	{
+		return m_cacheStatusCode;
+	}
 	UA_ReadValueId rv;
 	UA_ReadValueId_init(&rv);
 	rv.nodeId      = m_nodeId;
@@ -548,11 +804,17 @@ QUaStatusCode QUaBaseVariable::statusCode() const
 	QUaStatusCode statusCode = value.status;
 	// clean up
 	UA_DataValue_clear(&value);
+	if (useCache)
+	{
+		m_cacheStatusCode = statusCode;
+		m_cacheValid |= QUA_CACHE_STATUSCODE;
+	}
 	return statusCode;
 }
 
 void QUaBaseVariable::setStatusCode(const QUaStatusCode& statusCode)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// get value
 	UA_ReadValueId rv;
 	UA_ReadValueId_init(&rv);
@@ -594,6 +856,7 @@ QMetaType::Type QUaBaseVariable::dataType() const
 
 QString QUaBaseVariable::dataTypeNodeId() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (UA_NodeId_isNull(&m_nodeId))
@@ -627,6 +890,7 @@ QString QUaBaseVariable::dataTypeNodeId() const
 
 void QUaBaseVariable::setDataType(const QMetaType::Type & newTypeConst)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	auto dataType = newTypeConst;
@@ -722,6 +986,7 @@ void QUaBaseVariable::setDataType(const QMetaType::Type & newTypeConst)
 
 void QUaBaseVariable::setDataTypeEnum(const QMetaEnum & metaEnum)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// compose enum name
@@ -746,6 +1011,7 @@ void QUaBaseVariable::setDataTypeEnum(const QMetaEnum & metaEnum)
 
 bool QUaBaseVariable::setDataTypeEnum(const QString & strEnumName)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// check if exists in server's hash
 	if (!m_qUaServer->m_hashEnums.contains(strEnumName))
 	{
@@ -761,6 +1027,7 @@ bool QUaBaseVariable::setDataTypeEnum(const QString & strEnumName)
 
 void QUaBaseVariable::setDataTypeEnum(const UA_NodeId & enumTypeNodeId)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// need to "reset" dataType before setting a new value
 	auto st = UA_Server_writeDataType(m_qUaServer->m_server,
 		m_nodeId,
@@ -828,6 +1095,7 @@ void QUaBaseVariable::setDataTypeEnum(const UA_NodeId & enumTypeNodeId)
 #ifdef UA_GENERATED_NAMESPACE_ZERO_FULL
 bool QUaBaseVariable::setDataTypeOptionSet(const QString& strOptionSetName)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// check if exists in server's hash
 	if (!m_qUaServer->m_hashOptionSets.contains(strOptionSetName))
 	{
@@ -844,6 +1112,7 @@ bool QUaBaseVariable::setDataTypeOptionSet(const QString& strOptionSetName)
 // TODO : update to specific type and handle conversions there
 void QUaBaseVariable::setDataTypeOptionSet(const UA_NodeId& optionSetTypeNodeId)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// need to "reset" dataType before setting a new value
 	auto st = UA_Server_writeDataType(m_qUaServer->m_server,
 		m_nodeId,
@@ -897,6 +1166,7 @@ void QUaBaseVariable::setDataTypeOptionSet(const UA_NodeId& optionSetTypeNodeId)
 
 QMetaType::Type QUaBaseVariable::dataTypeInternal() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (UA_NodeId_isNull(&m_nodeId))
@@ -934,6 +1204,7 @@ UA_StatusCode QUaBaseVariable::setValueInternal(
 	const QDateTime     &sourceTimestamp, 
 	const QDateTime     &serverTimestamp)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// set value
 	UA_WriteValue wv;
 	UA_WriteValue_init(&wv);
@@ -964,6 +1235,7 @@ UA_StatusCode QUaBaseVariable::setValueInternal(
 
 qint32 QUaBaseVariable::valueRank() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (UA_NodeId_isNull(&m_nodeId))
@@ -979,6 +1251,7 @@ qint32 QUaBaseVariable::valueRank() const
 }
 
 void QUaBaseVariable::setValueRank(const qint32& valueRank){
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	auto st = UA_Server_writeValueRank(m_qUaServer->m_server, m_nodeId, valueRank);
@@ -988,6 +1261,7 @@ void QUaBaseVariable::setValueRank(const qint32& valueRank){
 
 QVector<quint32> QUaBaseVariable::arrayDimensions() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (UA_NodeId_isNull(&m_nodeId))
@@ -1013,6 +1287,7 @@ QVector<quint32> QUaBaseVariable::arrayDimensions() const
 /*
 void QUaBaseVariable::setArrayDimensions(const quint32 &size) // const QVector<quint32> &arrayDimenstions
 {
+	QUaIterateLocker locker(m_qUaServer);
 	UA_Variant uaArrayDimensions;
 	UA_UInt32 arrayDims[1] = { size };
 	UA_Variant_setArray(&uaArrayDimensions, arrayDims, 1, &UA_TYPES[UA_TYPES_UINT32]);
@@ -1022,6 +1297,7 @@ void QUaBaseVariable::setArrayDimensions(const quint32 &size) // const QVector<q
 
 quint8 QUaBaseVariable::accessLevel() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (UA_NodeId_isNull(&m_nodeId))
@@ -1038,6 +1314,7 @@ quint8 QUaBaseVariable::accessLevel() const
 
 void QUaBaseVariable::setAccessLevel(const quint8 & accessLevel)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// set accessLevel
@@ -1048,6 +1325,7 @@ void QUaBaseVariable::setAccessLevel(const quint8 & accessLevel)
 
 double QUaBaseVariable::minimumSamplingInterval() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (UA_NodeId_isNull(&m_nodeId))
@@ -1065,6 +1343,7 @@ double QUaBaseVariable::minimumSamplingInterval() const
 
 void QUaBaseVariable::setMinimumSamplingInterval(const double & minimumSamplingInterval)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// set minimumSamplingInterval
@@ -1075,6 +1354,7 @@ void QUaBaseVariable::setMinimumSamplingInterval(const double & minimumSamplingI
 
 bool QUaBaseVariable::historizing() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (UA_NodeId_isNull(&m_nodeId))
@@ -1092,6 +1372,7 @@ bool QUaBaseVariable::historizing() const
 #ifdef UA_ENABLE_HISTORIZING
 void QUaBaseVariable::setHistorizing(const bool& historizing)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// set historizing
@@ -30,9 +30,35 @@ struct is_qvector_traits : std::false_type {};
 template <typename T>
 struct is_qvector_traits<QVector<T>> : std::true_type {};
 
+// traits to detect if T is binary compatible with an open62541 builtin type,
+// used by setValue<T> and value<T> to skip intermediate QVariant conversions
+template <typename T>
+struct native_type_traits : std::false_type {};
+
+template <> struct native_type_traits<bool   > : std::true_type { enum { uaType = UA_TYPES_BOOLEAN, qtType = QMetaType::Bool   }; };
+template <> struct native_type_traits<char   > : std::true_type { enum { uaType = UA_TYPES_SBYTE  , qtType = QMetaType::Char   }; };
+template <> struct native_type_traits<uchar  > : std::true_type { enum { uaType = UA_TYPES_BYTE   , qtType = QMetaType::UChar  }; };
+template <> struct native_type_traits<qint16 > : std::true_type { enum { uaType = UA_TYPES_INT16  , qtType = QMetaType::Short  }; };
+template <> struct native_type_traits<quint16> : std::true_type { enum { uaType = UA_TYPES_UINT16 , qtType = QMetaType::UShort }; };
+template <> struct native_type_traits<qint32 > : std::true_type { enum { uaType = UA_TYPES_INT32  , qtType = QMetaType::Int    }; };
+template <> struct native_type_traits<quint32> : std::true_type { enum { uaType = UA_TYPES_UINT32 , qtType = QMetaType::UInt   }; };
+template <> struct native_type_traits<qint64 > : std::true_type { enum { uaType = UA_TYPES_INT64  , qtType = QMetaType::Long   }; };
+template <> struct native_type_traits<quint64> : std::true_type { enum { uaType = UA_TYPES_UINT64 , qtType = QMetaType::ULong  }; };
+template <> struct native_type_traits<float  > : std::true_type { enum { uaType = UA_TYPES_FLOAT  , qtType = QMetaType::Float  }; };
+template <> struct native_type_traits<double > : std::true_type { enum { uaType = UA_TYPES_DOUBLE , qtType = QMetaType::Double }; };
+
+// 0 : generic (QVariant), 1 : native scalar, 2 : native contiguous array
+template <typename T>
+struct native_value_kind : std::integral_constant<int, native_type_traits<T>::value ? 1 : 0> {};
+
+template <typename T>
+struct native_value_kind<QVector<T>> : std::integral_constant<int, native_type_traits<T>::value ? 2 : 0> {};
+
 class QUaBaseVariable : public QUaNode
 {
 	Q_OBJECT
+
+	friend class QUaServer;
 	// Variable Attributes
 
 	Q_PROPERTY(QVariant          value               READ value               WRITE setValue           NOTIFY valueChanged          )
@@ -61,6 +87,7 @@ public:
 	explicit QUaBaseVariable(
 		QUaServer* server
 	);
+	~QUaBaseVariable();
 
 	// Attributes API
 
@@ -155,6 +182,14 @@ public:
 	// set callback which is called before a read is performed
 	// call with the default argument for no pre-read callback
 	void              setReadCallback(const std::function<QVariant()>& readCallback=std::function<QVariant()>());
+	// keep a copy of the last value, status code and timestamps, so value(), statusCode(),
+	// sourceTimestamp() and serverTimestamp() do not read and convert from the server each time
+	// the copy is updated on every programmatic or network write (disabled by default)
+	// NOTE : ignored while a read callback is set
+	bool              valueCacheEnabled() const;
+	void              setValueCacheEnabled(const bool& valueCacheEnabled);
+	// approximate memory used by the cache in bytes (0 if disabled)
+	quint64           valueCacheMemory() const;
 
 	// Helpers
 
@@ -212,6 +247,18 @@ private:
 	bool m_bInternalWrite = false;
 	std::function<QVariant()> m_readCallback;
 	bool m_readCallbackRunning = false;
+	// last value cache (see setValueCacheEnabled), valid bits tell which members are up to date
+	bool                  m_cacheEnabled = false;
+	mutable quint8        m_cacheValid   = 0;
+	mutable QVariant      m_cacheValue;
+	mutable QUaStatusCode m_cacheStatusCode;
+	mutable QDateTime     m_cacheSourceTimestamp;
+	mutable QDateTime     m_cacheServerTimestamp;
+	mutable quint64       m_cacheMemory  = 0;
+	bool useValueCache() const;
+	void updateValueCache(const UA_DataValue* data, const bool& isPartial);
+	void updateValueCacheMemory() const;
+	void clearValueCache();
 #ifdef UA_ENABLE_HISTORIZING
 	quint64 m_maxHistoryDataResponseSize;
 #endif // UA_ENABLE_HISTORIZING
@@ -229,10 +276,62 @@ protected:
     // if T array
     template<typename T>
     T valueInternal(std::true_type) const;
+	// typed versions, native_value_kind<T> selects generic, native scalar or native array
+	template<typename T>
+	T valueTyped(std::integral_constant<int, 0>) const;
+	template<typename T>
+	T valueTyped(std::integral_constant<int, 1>) const;
+	template<typename T>
+	T valueTyped(std::integral_constant<int, 2>) const;
+	template<typename T>
+	void setValueTyped(
+		const T& value,
+		const QUaStatusCode& statusCode,
+		const QDateTime& sourceTimestamp,
+		const QDateTime& serverTimestamp,
+		const QMetaType::Type& newDataType,
+		std::integral_constant<int, 0>
+	);
+	template<typename T>
+	void setValueTyped(
+		const T& value,
+		const QUaStatusCode& statusCode,
+		const QDateTime& sourceTimestamp,
+		const QDateTime& serverTimestamp,
+		const QMetaType::Type& newDataType,
+		std::integral_constant<int, 1>
+	);
+	template<typename T>
+	void setValueTyped(
+		const T& value,
+		const QUaStatusCode& statusCode,
+		const QDateTime& sourceTimestamp,
+		const QDateTime& serverTimestamp,
+		const QMetaType::Type& newDataType,
+		std::integral_constant<int, 2>
+	);
+	// writes a variant which already matches the cached data type (no type inference),
+	// overwrite to react to typed writes the same way as to setValue(const QVariant&, ...)
+	virtual void setValueNative(
+		const UA_Variant    &value,
+		const QUaStatusCode &statusCode,
+		const QDateTime     &sourceTimestamp,
+		const QDateTime     &serverTimestamp
+	);
+	// writes with setValueNative if the variant holds a scalar of the cached data type,
+	// else returns false and setValue is required (see QUaServer::writeValues)
+	bool setValueIfNative(
+		const QVariant      &value,
+		const QUaStatusCode &statusCode,
+		const QDateTime     &sourceTimestamp,
+		const QDateTime     &serverTimestamp
+	);
 	// internal
 	QVariant getValueInternal(
 		const QUaTypesConverter::ArrayType& arrType = QUaTypesConverter::ArrayType::QList
 	) const;
+	// NOTE : caller must UA_DataValue_clear the result
+	UA_DataValue getDataValueInternal() const;
 	UA_StatusCode setValueInternal(
 		const UA_Variant    &value,
 		const UA_StatusCode &status = UA_STATUSCODE_GOOD,
@@ -243,9 +342,53 @@ protected:
 // generic version scalar or array
 template<typename T>
 inline T QUaBaseVariable::value() const
+{
+    return this->template valueTyped<T>(native_value_kind<T>());
+}
+// if not binary compatible
+template<typename T>
+inline T QUaBaseVariable::valueTyped(std::integral_constant<int, 0>) const
 {
     return this->template valueInternal<T>(is_qvector_traits<T>());
 }
+// if binary compatible scalar, copy directly from variant
+template<typename T>
+inline T QUaBaseVariable::valueTyped(std::integral_constant<int, 1>) const
+{
+	// cached value is cheaper than reading from server
+	if (this->useValueCache())
+	{
+		return this->template valueInternal<T>(std::false_type());
+	}
+	UA_DataValue value = this->getDataValueInternal();
+	if (value.value.type != &UA_TYPES[native_type_traits<T>::uaType] ||
+		!UA_Variant_isScalar(&value.value))
+	{
+		UA_DataValue_clear(&value);
+		return this->template valueInternal<T>(std::false_type());
+	}
+	T outValue = *static_cast<T*>(value.value.data);
+	UA_DataValue_clear(&value);
+	return outValue;
+}
+// if binary compatible array, copy directly from variant
+template<typename T>
+inline T QUaBaseVariable::valueTyped(std::integral_constant<int, 2>) const
+{
+	typedef typename T::value_type inner_type;
+	UA_DataValue value = this->getDataValueInternal();
+	if (value.value.type != &UA_TYPES[native_type_traits<inner_type>::uaType] ||
+		UA_Variant_isScalar(&value.value))
+	{
+		UA_DataValue_clear(&value);
+		return this->template valueInternal<T>(std::true_type());
+	}
+	T outValue(static_cast<int>(value.value.arrayLength));
+	const inner_type* data = static_cast<const inner_type*>(value.value.data);
+	std::copy(data, data + value.value.arrayLength, outValue.begin());
+	UA_DataValue_clear(&value);
+	return outValue;
+}
 // if scalar
 template<typename T>
 inline T QUaBaseVariable::valueInternal(std::false_type) const
@@ -266,6 +409,25 @@ inline void QUaBaseVariable::setValue(
 	const QDateTime& sourceTimestamp,
 	const QDateTime& serverTimestamp,
 	const QMetaType::Type& newDataType)
+{
+	this->template setValueTyped<T>(
+		value,
+		statusCode,
+		sourceTimestamp,
+		serverTimestamp,
+		newDataType,
+		native_value_kind<T>()
+	);
+}
+// if not binary compatible
+template<typename T>
+inline void QUaBaseVariable::setValueTyped(
+	const T& value,
+	const QUaStatusCode& statusCode,
+	const QDateTime& sourceTimestamp,
+	const QDateTime& serverTimestamp,
+	const QMetaType::Type& newDataType,
+	std::integral_constant<int, 0>)
 {
 	this->setValue(
 		QVariant::fromValue(value),
@@ -275,6 +437,74 @@ inline void QUaBaseVariable::setValue(
 		newDataType
 	);
 }
+// if binary compatible scalar, write directly if type does not change
+template<typename T>
+inline void QUaBaseVariable::setValueTyped(
+	const T& value,
+	const QUaStatusCode& statusCode,
+	const QDateTime& sourceTimestamp,
+	const QDateTime& serverTimestamp,
+	const QMetaType::Type& newDataType,
+	std::integral_constant<int, 1>)
+{
+	const QMetaType::Type nativeType = static_cast<QMetaType::Type>(native_type_traits<T>::qtType);
+	if (m_dataType != nativeType ||
+		(newDataType != QMetaType::UnknownType && newDataType != nativeType))
+	{
+		// type inference or conversion required
+		this->setValue(
+			QVariant::fromValue(value),
+			statusCode,
+			sourceTimestamp,
+			serverTimestamp,
+			newDataType
+		);
+		return;
+	}
+	// NOTE : no copy, UA_Server_write makes its own
+	UA_Variant uaVar;
+	UA_Variant_setScalar(&uaVar, const_cast<T*>(&value), &UA_TYPES[native_type_traits<T>::uaType]);
+	this->setValueNative(uaVar, statusCode, sourceTimestamp, serverTimestamp);
+}
+// if binary compatible array, write directly if type does not change
+template<typename T>
+inline void QUaBaseVariable::setValueTyped(
+	const T& value,
+	const QUaStatusCode& statusCode,
+	const QDateTime& sourceTimestamp,
+	const QDateTime& serverTimestamp,
+	const QMetaType::Type& newDataType,
+	std::integral_constant<int, 2>)
+{
+	typedef typename T::value_type inner_type;
+	const QMetaType::Type nativeType = static_cast<QMetaType::Type>(native_type_traits<inner_type>::qtType);
+	if (value.isEmpty() || m_dataType != nativeType ||
+		(newDataType != QMetaType::UnknownType && newDataType != nativeType))
+	{
+		// type inference or conversion required
+		this->setValue(
+			QVariant::fromValue(value),
+			statusCode,
+			sourceTimestamp,
+			serverTimestamp,
+			newDataType
+		);
+		return;
+	}
+	// NOTE : no copy, UA_Server_write makes its own
+	UA_Variant uaVar;
+	UA_Variant_setArray(
+		&uaVar,
+		const_cast<inner_type*>(value.constData()),
+		static_cast<size_t>(value.size()),
+		&UA_TYPES[native_type_traits<inner_type>::uaType]
+	);
+	// same as QUaTypesConverter::uaVariantFromQVariantArray
+	UA_UInt32 arrayDimensions = static_cast<UA_UInt32>(value.size());
+	uaVar.arrayDimensions     = &arrayDimensions;
+	uaVar.arrayDimensionsSize = 1;
+	this->setValueNative(uaVar, statusCode, sourceTimestamp, serverTimestamp);
+}
 
 template<>
 inline void QUaBaseVariable::setValue(
@@ -284,12 +514,13 @@ inline void QUaBaseVariable::setValue(
 	const QDateTime& serverTimestamp,
 	const QMetaType::Type& newDataType)
 {
-	this->setValue(
-		QVariant::fromValue(value),
+	this->template setValueTyped<qint64>(
+		value,
 		statusCode,
 		sourceTimestamp,
 		serverTimestamp,
-		newDataType == QMetaType::UnknownType ? QMetaType::Long : newDataType
+		newDataType == QMetaType::UnknownType ? QMetaType::Long : newDataType,
+		native_value_kind<qint64>()
 	);
 }
 
@@ -301,12 +532,13 @@ inline void QUaBaseVariable::setValue(
 	const QDateTime& serverTimestamp,
 	const QMetaType::Type& newDataType)
 {
-	this->setValue(
-		QVariant::fromValue(value),
+	this->template setValueTyped<quint64>(
+		value,
 		statusCode,
 		sourceTimestamp,
 		serverTimestamp,
-		newDataType == QMetaType::UnknownType ? QMetaType::ULong : newDataType
+		newDataType == QMetaType::UnknownType ? QMetaType::ULong : newDataType,
+		native_value_kind<quint64>()
 	);
 }
 
@@ -30,6 +30,18 @@ void QUaConditionVariable::setValue(
 	this->getSourceTimestamp()->setValue(QUaBaseVariable::sourceTimestamp());
 }
 
+void QUaConditionVariable::setValueNative(
+	const UA_Variant& value, 
+	const QUaStatusCode& statusCode, 
+	const QDateTime& sourceTimestamp, 
+	const QDateTime& serverTimestamp)
+{
+	// call base implementation
+	QUaBaseVariable::setValueNative(value, statusCode, sourceTimestamp, serverTimestamp);
+	// update child property
+	this->getSourceTimestamp()->setValue(QUaBaseVariable::sourceTimestamp());
+}
+
 void QUaConditionVariable::setSourceTimestamp(const QDateTime& sourceTimestamp)
 {
 	// call base implementation
@@ -34,6 +34,15 @@ public:
 	// Overwrite to sync this variable's source timestamp with the child property
 	void setSourceTimestamp(const QDateTime& sourceTimestamp) override;
 
+protected:
+	// also sync child property when written through typed setValue<T>
+	void setValueNative(
+		const UA_Variant    &value,
+		const QUaStatusCode &statusCode,
+		const QDateTime     &sourceTimestamp,
+		const QDateTime     &serverTimestamp
+	) override;
+
 private slots:
 	void on_setSourceTimestampChanged(const QDateTime& sourceTimestamp);
 
@@ -2,6 +2,7 @@
 
 #include <QUaTypesConverter>
 #include <QStringView>
+#include <QMutex>
 
 /* NOTE : for registering new custom types wrapping open62541 types follow steps below:
 - Create a wrapper class for the underlying open62541 type (e.g. QUaQualifiedName for UA_QualifiedName)
@@ -337,13 +338,14 @@ void QUaStatusCode::operator=(const QString& strStatus)
 	*this = QUaStatusCode(strStatus.toUtf8());
 }
 
-QUaQualifiedName::QUaQualifiedName() : m_namespace(0)
+QUaQualifiedName::QUaQualifiedName() : m_namespace(0), m_hash(0)
 {
 }
 
 QUaQualifiedName::QUaQualifiedName(const quint16& namespaceIndex, const QString& name) :
 	m_namespace(namespaceIndex),
-	m_name(name)
+	m_name(name),
+	m_hash(0)
 {
 }
 
@@ -380,12 +382,14 @@ QUaQualifiedName::operator QString() const
 
 void QUaQualifiedName::operator=(const UA_QualifiedName& uaQualName)
 {
+	m_hash = 0;
 	m_namespace = uaQualName.namespaceIndex;
 	m_name = QUaTypesConverter::uaStringToQString(uaQualName.name);
 }
 
 void QUaQualifiedName::operator=(const QString& strXmlQualName)
 {
+	m_hash = 0;
 	m_namespace = 0;
 	auto components = QStringView(strXmlQualName).split(QLatin1Char(';'));
 	// check if valid xml format
@@ -463,6 +467,7 @@ quint16 QUaQualifiedName::namespaceIndex() const
 
 void QUaQualifiedName::setNamespaceIndex(const quint16& index)
 {
+	m_hash = 0;
 	m_namespace = index;
 }
 
@@ -473,6 +478,7 @@ QString QUaQualifiedName::name() const
 
 void QUaQualifiedName::setName(const QString& name)
 {
+	m_hash = 0;
 	m_name = name;
 }
 
@@ -493,6 +499,19 @@ bool QUaQualifiedName::isEmpty() const
 	return m_name.isEmpty();
 }
 
+#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
+uint QUaQualifiedName::hash() const
+#else
+size_t QUaQualifiedName::hash() const
+#endif
+{
+	if (m_hash == 0)
+	{
+		m_hash = qHash(m_name, m_namespace);
+	}
+	return m_hash;
+}
+
 QUaQualifiedName QUaQualifiedName::fromXmlString(const QString& strXmlQualName)
 {
 	return QUaQualifiedName(strXmlQualName);
@@ -806,82 +825,133 @@ UA_LocalizedText QUaLocalizedText::toUaLocalizedText() const
 	return *this;
 }
 
-QUaNodeId::QUaNodeId() : m_nodeId(UA_NODEID_NULL)
+struct QUaNodeIdData
+{
+	QUaNodeIdData() : ref(1), nodeId(UA_NODEID_NULL), hash(0), interned(false)
+	{
+	}
+	QAtomicInt ref;
+	UA_NodeId  nodeId;
+	quint32    hash;
+	bool       interned;
+};
+
+// process-wide pool of interned node ids (see QUaNodeId::interned)
+// NOTE : keys are shallow copies of the interned buffers, entries are removed by their last owner
+static QMutex& qUaNodeIdPoolMutex()
+{
+	static QMutex mutex;
+	return mutex;
+}
+
+static QHash<UA_NodeId, QUaNodeIdData*>& qUaNodeIdPool()
 {
+	static QHash<UA_NodeId, QUaNodeIdData*> pool;
+	return pool;
 }
+
+QUaNodeId::QUaNodeId()
+	: m_nodeId(UA_NODEID_NULL),
+	m_data(nullptr)
+{
+}
+
 QUaNodeId::QUaNodeId(const quint16& index, const quint32& numericId)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(UA_NODEID_NUMERIC(index, numericId)),
+	m_data(nullptr)
 {
-	this->setNamespaceIndex(index);
-	this->setNumericId(numericId);
 }
 
 QUaNodeId::QUaNodeId(const quint16& index, const QString& stringId)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(UA_NODEID_NULL),
+	m_data(nullptr)
 {
-	this->setNamespaceIndex(index);
+	m_nodeId.namespaceIndex = index;
 	this->setStringId(stringId);
 }
 
 QUaNodeId::QUaNodeId(const quint16& index, const char* stringId)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(UA_NODEID_NULL),
+	m_data(nullptr)
 {
 	*this = QUaNodeId(index, QString::fromUtf8(stringId));
 }
 
 QUaNodeId::QUaNodeId(const quint16& index, const QUuid& uuId)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(UA_NODEID_NULL),
+	m_data(nullptr)
 {
-	this->setNamespaceIndex(index);
+	m_nodeId.namespaceIndex = index;
 	this->setUuId(uuId);
 }
 
 QUaNodeId::QUaNodeId(const quint16& index, const QByteArray& byteArrayId)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(UA_NODEID_NULL),
+	m_data(nullptr)
 {
-	this->setNamespaceIndex(index);
+	m_nodeId.namespaceIndex = index;
 	this->setByteArrayId(byteArrayId);
 }
 
 QUaNodeId::QUaNodeId(const QUaNodeId& other)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(other.m_nodeId),
+	m_data(other.m_data)
 {
-	*this = other;
+	// share buffer
+	if (m_data)
+	{
+		m_data->ref.ref();
+	}
 }
 
 QUaNodeId::QUaNodeId(const UA_NodeId& uaNodeId)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(UA_NODEID_NULL),
+	m_data(nullptr)
 {
 	*this = uaNodeId;
 }
 
 QUaNodeId::QUaNodeId(const QString& strXmlNodeId)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(UA_NODEID_NULL),
+	m_data(nullptr)
 {
 	*this = strXmlNodeId;
 }
 
 QUaNodeId::QUaNodeId(const char* strXmlNodeId)
-	: m_nodeId(UA_NODEID_NULL)
+	: m_nodeId(UA_NODEID_NULL),
+	m_data(nullptr)
 {
 	*this = strXmlNodeId;
 }
 
 QUaNodeId::~QUaNodeId()
 {
-	this->clear();
+	this->release();
 }
 
 void QUaNodeId::operator=(const UA_NodeId& uaNodeId)
 {
-	this->clear();
-	UA_NodeId_copy(&uaNodeId, &this->m_nodeId);
+	if (UA_NodeId_isNull(&uaNodeId))
+	{
+		this->release();
+		return;
+	}
+	UA_NodeId nodeId;
+	UA_NodeId_copy(&uaNodeId, &nodeId);
+	this->assign(nodeId);
 }
 
 void QUaNodeId::operator=(const QString& strXmlNodeId)
 {
-	this->clear();
-	m_nodeId = QUaTypesConverter::nodeIdFromQString(strXmlNodeId);
+	UA_NodeId nodeId = QUaTypesConverter::nodeIdFromQString(strXmlNodeId);
+	if (UA_NodeId_isNull(&nodeId))
+	{
+		UA_NodeId_clear(&nodeId);
+		this->release();
+		return;
+	}
+	this->assign(nodeId);
 }
 
 void QUaNodeId::operator=(const char* strXmlNodeId)
@@ -891,8 +961,16 @@ void QUaNodeId::operator=(const char* strXmlNodeId)
 
 void QUaNodeId::operator=(const QUaNodeId& other)
 {
-	this->clear();
-	UA_NodeId_copy(&other.m_nodeId, &this->m_nodeId);
+	// NOTE : ref and copy before release in case of self assignment
+	QUaNodeIdData* data = other.m_data;
+	UA_NodeId nodeId = other.m_nodeId;
+	if (data)
+	{
+		data->ref.ref();
+	}
+	this->release();
+	m_nodeId = nodeId;
+	m_data   = data;
 }
 
 QUaNodeId::operator UA_NodeId() const
@@ -909,24 +987,38 @@ QUaNodeId::operator QString() const
 
 bool QUaNodeId::operator==(const QUaNodeId& other) const
 {
-	return UA_NodeId_equal(&this->m_nodeId, &other.m_nodeId);
+	// same buffer, or interned node ids are unique per value
+	if (m_data && other.m_data)
+	{
+		if (m_data == other.m_data)
+		{
+			return true;
+		}
+		if (m_data->hash != other.m_data->hash ||
+			(m_data->interned && other.m_data->interned))
+		{
+			return false;
+		}
+	}
+	// numeric node ids are compared inline
+	return UA_NodeId_equal(&m_nodeId, &other.m_nodeId);
 }
 
 bool QUaNodeId::operator!=(const QUaNodeId& other) const
 {
-	return !UA_NodeId_equal(&this->m_nodeId, &other.m_nodeId);
+	return !(*this == other);
 }
 
 bool QUaNodeId::operator==(const UA_NodeId& other) const
 {
-	return UA_NodeId_equal(&this->m_nodeId, &other);
+	return UA_NodeId_equal(&m_nodeId, &other);
 }
 
 bool QUaNodeId::operator<(const QUaNodeId& other) const
 {
-	if (m_nodeId.namespaceIndex != other.m_nodeId.namespaceIndex)
+	if (this->namespaceIndex() != other.namespaceIndex())
 	{
-		return m_nodeId.namespaceIndex < other.m_nodeId.namespaceIndex;
+		return this->namespaceIndex() < other.namespaceIndex();
 	}
 	switch (this->type())
 	{
@@ -950,7 +1042,13 @@ quint16 QUaNodeId::namespaceIndex() const
 
 void QUaNodeId::setNamespaceIndex(const quint16& index)
 {
-	m_nodeId.namespaceIndex = index;
+	if (!m_data)
+	{
+		m_nodeId.namespaceIndex = index;
+		return;
+	}
+	this->detach().namespaceIndex = index;
+	this->updateHash();
 }
 
 QUaNodeIdType QUaNodeId::type() const
@@ -965,14 +1063,9 @@ quint32 QUaNodeId::numericId() const
 
 void QUaNodeId::setNumericId(const quint32& numericId)
 {
-	if (m_nodeId.identifierType != UA_NodeIdType::UA_NODEIDTYPE_NUMERIC)
-	{
-		auto index = m_nodeId.namespaceIndex;
-		this->clear();
-		m_nodeId.namespaceIndex = index;
-		m_nodeId.identifierType = UA_NodeIdType::UA_NODEIDTYPE_NUMERIC;
-	}
-	m_nodeId.identifier.numeric = numericId;
+	auto index = m_nodeId.namespaceIndex;
+	this->release();
+	m_nodeId = UA_NODEID_NUMERIC(index, numericId);
 }
 
 QString QUaNodeId::stringId() const
@@ -982,14 +1075,11 @@ QString QUaNodeId::stringId() const
 
 void QUaNodeId::setStringId(const QString& stringId)
 {
-	if (m_nodeId.identifierType != UA_NodeIdType::UA_NODEIDTYPE_STRING)
-	{
-		auto index = m_nodeId.namespaceIndex;
-		this->clear();
-		m_nodeId.namespaceIndex = index;
-		m_nodeId.identifierType = UA_NodeIdType::UA_NODEIDTYPE_STRING;
-	}
-	QUaTypesConverter::uaVariantFromQVariantScalar<UA_String, QString>(stringId, &m_nodeId.identifier.string);
+	UA_NodeId nodeId;
+	nodeId.namespaceIndex = m_nodeId.namespaceIndex;
+	nodeId.identifierType = UA_NodeIdType::UA_NODEIDTYPE_STRING;
+	QUaTypesConverter::uaVariantFromQVariantScalar<UA_String, QString>(stringId, &nodeId.identifier.string);
+	this->assign(nodeId);
 }
 
 QUuid QUaNodeId::uuId() const
@@ -999,14 +1089,11 @@ QUuid QUaNodeId::uuId() const
 
 void QUaNodeId::setUuId(const QUuid& uuId)
 {
-	if (m_nodeId.identifierType != UA_NodeIdType::UA_NODEIDTYPE_GUID)
-	{
-		auto index = m_nodeId.namespaceIndex;
-		this->clear();
-		m_nodeId.namespaceIndex = index;
-		m_nodeId.identifierType = UA_NodeIdType::UA_NODEIDTYPE_GUID;
-	}
-	QUaTypesConverter::uaVariantFromQVariantScalar<UA_Guid, QUuid>(uuId, &m_nodeId.identifier.guid);
+	UA_NodeId nodeId;
+	nodeId.namespaceIndex = m_nodeId.namespaceIndex;
+	nodeId.identifierType = UA_NodeIdType::UA_NODEIDTYPE_GUID;
+	QUaTypesConverter::uaVariantFromQVariantScalar<UA_Guid, QUuid>(uuId, &nodeId.identifier.guid);
+	this->assign(nodeId);
 }
 
 QByteArray QUaNodeId::byteArrayId() const
@@ -1016,14 +1103,11 @@ QByteArray QUaNodeId::byteArrayId() const
 
 void QUaNodeId::setByteArrayId(const QByteArray& byteArrayId)
 {
-	if (m_nodeId.identifierType != UA_NodeIdType::UA_NODEIDTYPE_BYTESTRING)
-	{
-		auto index = m_nodeId.namespaceIndex;
-		this->clear();
-		m_nodeId.namespaceIndex = index;
-		m_nodeId.identifierType = UA_NodeIdType::UA_NODEIDTYPE_BYTESTRING;
-	}
-	QUaTypesConverter::uaVariantFromQVariantScalar<UA_ByteString, QByteArray>(byteArrayId, &m_nodeId.identifier.byteString);
+	UA_NodeId nodeId;
+	nodeId.namespaceIndex = m_nodeId.namespaceIndex;
+	nodeId.identifierType = UA_NodeIdType::UA_NODEIDTYPE_BYTESTRING;
+	QUaTypesConverter::uaVariantFromQVariantScalar<UA_ByteString, QByteArray>(byteArrayId, &nodeId.identifier.byteString);
+	this->assign(nodeId);
 }
 
 QString QUaNodeId::toXmlString() const
@@ -1045,17 +1129,124 @@ bool QUaNodeId::isNull() const
 
 void QUaNodeId::clear()
 {
-	if (UA_NodeId_isNull(&m_nodeId))
+	this->release();
+}
+
+quint32 QUaNodeId::internalHash() const
+{
+	// only buffers cache the hash, numeric ones are cheap to hash
+	return m_data ? m_data->hash : UA_NodeId_hash(&m_nodeId);
+}
+
+QUaNodeId QUaNodeId::interned() const
+{
+	if (!m_data || m_data->interned)
+	{
+		return *this;
+	}
+	QMutexLocker locker(&qUaNodeIdPoolMutex());
+	auto& pool = qUaNodeIdPool();
+	QUaNodeId retNodeId;
+	auto it = pool.find(m_data->nodeId);
+	if (it != pool.end())
 	{
+		// share existing buffer unless its last owner is releasing it
+		QUaNodeIdData* data = it.value();
+		int ref = data->ref.loadAcquire();
+		while (ref > 0 && !data->ref.testAndSetOrdered(ref, ref + 1))
+		{
+			ref = data->ref.loadAcquire();
+		}
+		if (ref > 0)
+		{
+			retNodeId.m_data   = data;
+			retNodeId.m_nodeId = data->nodeId;
+			return retNodeId;
+		}
+		// being released, replace entry (releasing owner only removes its own entry)
+		pool.erase(it);
+	}
+	QUaNodeIdData* data = new QUaNodeIdData;
+	UA_NodeId_copy(&m_data->nodeId, &data->nodeId);
+	data->hash     = m_data->hash;
+	data->interned = true;
+	pool.insert(data->nodeId, data);
+	retNodeId.m_data   = data;
+	retNodeId.m_nodeId = data->nodeId;
+	return retNodeId;
+}
+
+bool QUaNodeId::isInterned() const
+{
+	return m_data && m_data->interned;
+}
+
+const UA_NodeId& QUaNodeId::uaNodeId() const
+{
+	return m_nodeId;
+}
+
+void QUaNodeId::assign(UA_NodeId& nodeId)
+{
+	this->release();
+	if (nodeId.identifierType == UA_NodeIdType::UA_NODEIDTYPE_NUMERIC)
+	{
+		m_nodeId = nodeId;
 		return;
 	}
-	UA_NodeId_clear(&m_nodeId);
-	m_nodeId = UA_NODEID_NULL;
+	// take ownership
+	m_data = new QUaNodeIdData;
+	m_data->nodeId = nodeId;
+	this->updateHash();
 }
 
-quint32 QUaNodeId::internalHash() const
+UA_NodeId& QUaNodeId::detach()
 {
-	return UA_NodeId_hash(&m_nodeId);
+	Q_ASSERT(m_data);
+	if (!m_data->interned && m_data->ref.loadAcquire() == 1)
+	{
+		return m_data->nodeId;
+	}
+	QUaNodeIdData* data = new QUaNodeIdData;
+	UA_NodeId_copy(&m_data->nodeId, &data->nodeId);
+	this->release();
+	m_data = data;
+	return m_data->nodeId;
+}
+
+void QUaNodeId::updateHash()
+{
+	Q_ASSERT(m_data);
+	m_data->hash = UA_NodeId_hash(&m_data->nodeId);
+	// shallow view of the buffer
+	m_nodeId = m_data->nodeId;
+}
+
+void QUaNodeId::release()
+{
+	m_nodeId = UA_NODEID_NULL;
+	if (!m_data)
+	{
+		return;
+	}
+	QUaNodeIdData* data = m_data;
+	m_data = nullptr;
+	if (data->ref.deref())
+	{
+		return;
+	}
+	if (data->interned)
+	{
+		QMutexLocker locker(&qUaNodeIdPoolMutex());
+		auto& pool = qUaNodeIdPool();
+		auto it = pool.find(data->nodeId);
+		if (it != pool.end() && it.value() == data)
+		{
+			pool.erase(it);
+		}
+	}
+	UA_NodeId_clear(&data->nodeId);
+	delete data;
 }
 
 QMetaEnum QUaExclusiveLimitState::m_metaEnum = QMetaEnum::fromType<QUa::ExclusiveLimitState>();
@@ -444,6 +444,10 @@ Q_DECLARE_METATYPE(QUaStatusCode);
 
 typedef QUa::NodeIdType QUaNodeIdType;
 
+struct QUaNodeIdData;
+
+// NOTE : numeric node ids are kept inline, string, guid and bytestring identifiers are kept
+//        in an immutable buffer shared by copies (copy on write) with its hash computed once
 class QUaNodeId
 {
 public:
@@ -492,8 +496,27 @@ public:
 
     quint32 internalHash() const;
 
+    // returns an equal node id that shares one buffer with all other interned equal
+    // node ids, so equality between interned node ids is a pointer compare
+    // NOTE : numeric node ids have no buffer, they are returned as is
+    QUaNodeId interned() const;
+    bool      isInterned() const;
+
 private:
-    UA_NodeId m_nodeId;
+    // numeric node id, or shallow copy of the buffer's node id
+    UA_NodeId       m_nodeId;
+    // NOTE : nullptr for numeric (and null) node ids
+    QUaNodeIdData * m_data;
+    // no copy, valid while this instance is not modified
+    const UA_NodeId& uaNodeId() const;
+    // takes ownership of the node id, a buffer is only created if not numeric
+    void assign(UA_NodeId& nodeId);
+    // unshared buffer to modify, must call updateHash after modifying
+    UA_NodeId& detach();
+    void updateHash();
+    void release();
+    // NOTE : to look up uaNodeId without copying (see QUaServer::nodeById)
+    friend class QUaServer;
     friend QDataStream& operator<<(QDataStream& outStream, const QUaNodeId& inNodeId);
     friend QDataStream& operator>>(QDataStream& inStream, QUaNodeId& outNodeId);
 };
@@ -506,24 +529,19 @@ inline uint qHash(const QUaNodeId& key, uint seed)
 inline size_t qHash(const QUaNodeId& key, size_t seed)
 #endif
 {
-    return
-            qHash(key.namespaceIndex(), seed) ^
-            qHash(static_cast<int>(key.type()), seed) ^
-            (key.type() == QUaNodeIdType::Numeric ?
-                 qHash(key.numericId(), seed) :
-                 key.internalHash()
-                 );
+    // NOTE : internal hash is cached
+    return qHash(key.internalHash(), seed);
 }
 
 inline QDataStream& operator<<(QDataStream& outStream, const QUaNodeId& inNodeId)
 {
-    outStream << inNodeId.m_nodeId.namespaceIndex;
-    outStream << static_cast<quint8>(inNodeId.m_nodeId.identifierType);
+    outStream << inNodeId.namespaceIndex();
+    outStream << static_cast<quint8>(inNodeId.type());
     QUaNodeIdType type = inNodeId.type();
     switch (type)
     {
     case QUaNodeIdType::Numeric:
-        outStream << inNodeId.m_nodeId.identifier.numeric;
+        outStream << inNodeId.numericId();
         break;
     case QUaNodeIdType::String:
         outStream << inNodeId.stringId();
@@ -542,37 +560,40 @@ inline QDataStream& operator<<(QDataStream& outStream, const QUaNodeId& inNodeId
 
 inline QDataStream& operator>>(QDataStream& inStream, QUaNodeId& outNodeId)
 {
-    inStream >> outNodeId.m_nodeId.namespaceIndex;
+    quint16 namespaceIndex;
+    inStream >> namespaceIndex;
     quint8 identifierType;
     inStream >> identifierType;
-    outNodeId.m_nodeId.identifierType = static_cast<UA_NodeIdType>(identifierType);
-    QUaNodeIdType type = outNodeId.type();
+    outNodeId.clear();
+    QUaNodeIdType type = static_cast<QUaNodeIdType>(identifierType);
     switch (type)
     {
     case QUaNodeIdType::Numeric:
     {
-        inStream >> outNodeId.m_nodeId.identifier.numeric;
+        quint32 numericId;
+        inStream >> numericId;
+        outNodeId = QUaNodeId(namespaceIndex, numericId);
     }
         break;
     case QUaNodeIdType::String:
     {
         QString strId;
         inStream >> strId;
-        outNodeId.setStringId(strId);
+        outNodeId = QUaNodeId(namespaceIndex, strId);
     }
         break;
     case QUaNodeIdType::Guid:
     {
         QUuid uuId;
         inStream >> uuId;
-        outNodeId.setUuId(uuId);
+        outNodeId = QUaNodeId(namespaceIndex, uuId);
     }
         break;
     case QUaNodeIdType::ByteString:
     {
         QByteArray byteId;
         inStream >> byteId;
-        outNodeId.setByteArrayId(byteId);
+        outNodeId = QUaNodeId(namespaceIndex, byteId);
     }
         break;
     default:
@@ -643,6 +664,13 @@ public:
 
     bool isEmpty() const;
 
+    // cached, names are mostly used as keys of the child index (see QUaNode::browseChild)
+#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
+    uint   hash() const;
+#else
+    size_t hash() const;
+#endif
+
     // helpers
 
     static QUaQualifiedName fromXmlString(const QString& strXmlQualName);
@@ -660,6 +688,12 @@ public:
 private:
     quint16 m_namespace;
     QString m_name;
+    // NOTE : zero means not computed yet
+#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
+    mutable uint   m_hash;
+#else
+    mutable size_t m_hash;
+#endif
 
     friend QDataStream& operator<<(QDataStream& outStream, const QUaQualifiedName& inQualName);
     friend QDataStream& operator>>(QDataStream& inStream, QUaQualifiedName& outQualName);
@@ -673,7 +707,7 @@ inline uint qHash(const QUaQualifiedName& key)
 inline size_t qHash(const QUaQualifiedName& key)
 #endif
 {
-    return qHash(key.name(), key.namespaceIndex());
+    return key.hash();
 }
 
 #if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
@@ -682,7 +716,7 @@ inline uint qHash(const QUaQualifiedName& key, uint seed)
 inline size_t qHash(const QUaQualifiedName& key, size_t seed)
 #endif
 {
-    return qHash(key.name(), seed) ^ key.namespaceIndex();
+    return key.hash() ^ seed;
 }
 
 inline QDataStream& operator<<(QDataStream& outStream, const QUaQualifiedName& inQualName)
@@ -695,6 +729,7 @@ inline QDataStream& operator<<(QDataStream& outStream, const QUaQualifiedName& i
 inline QDataStream& operator>>(QDataStream& inStream, QUaQualifiedName& outQualName)
 {
     inStream >> outQualName.m_namespace;
+    outQualName.m_hash = 0;
     inStream >> outQualName.m_name;
     return inStream;
 }
@@ -805,6 +840,16 @@ inline bool operator==(const QUaChangeStructureDataType& lhs, const QUaChangeStr
             lhs.m_uiVerb == rhs.m_uiVerb;
 }
 
+#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
+inline uint qHash(const QUaChangeStructureDataType& key, uint seed = 0)
+#else
+inline size_t qHash(const QUaChangeStructureDataType& key, size_t seed = 0)
+#endif
+{
+    // NOTE : affected type is implied by affected node
+    return qHash(key.m_nodeIdAffected, seed) ^ key.m_uiVerb;
+}
+
 Q_DECLARE_METATYPE(QUaChangeStructureDataType);
 
 // NOTE : automatic
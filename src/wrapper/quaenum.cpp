@@ -54,6 +54,7 @@ UA_StatusCode QUaServer::addEnumValues(UA_Server * server, UA_NodeId * parent, c
 
 void QUaServer::registerEnum(const QString& strEnumName, const QUaEnumMap& enumMap, const QUaNodeId& nodeId)
 {
+	QUaIterateLocker locker(this);
 	// check if already exists
 	if (m_hashEnums.contains(strEnumName))
 	{
@@ -120,6 +121,7 @@ bool QUaServer::isEnumRegistered(const QString& strEnumName) const
 // NOTE : expensive, creates a copy
 QUaEnumMap QUaServer::enumMap(const QString& strEnumName) const
 {
+	QUaIterateLocker locker(this);
 	auto retMap = QUaEnumMap();
 	// if it does not exist, return empty
 	if (!m_hashEnums.contains(strEnumName))
@@ -145,6 +147,7 @@ QUaEnumMap QUaServer::enumMap(const QString& strEnumName) const
 
 void QUaServer::setEnumMap(const QString& strEnumName, const QUaEnumMap& enumMap)
 {
+	QUaIterateLocker locker(this);
 	// if it does not exist, create it with one entry
 	if (!m_hashEnums.contains(strEnumName))
 	{
@@ -160,6 +163,7 @@ void QUaServer::setEnumMap(const QString& strEnumName, const QUaEnumMap& enumMap
 //        to insert multiple elements at once use QUaServer::updateEnum
 void QUaServer::updateEnumEntry(const QString& strEnumName, const QUaEnumKey& enumValue, const QUaEnumEntry& enumEntry)
 {
+	QUaIterateLocker locker(this);
 	// if it does not exist, create it with one entry
 	if (!m_hashEnums.contains(strEnumName))
 	{
@@ -179,6 +183,7 @@ void QUaServer::updateEnumEntry(const QString& strEnumName, const QUaEnumKey& en
 //        to insert multiple elements at once use QUaServer::updateEnum with empty argument
 void QUaServer::removeEnumEntry(const QString& strEnumName, const QUaEnumKey& enumValue)
 {
+	QUaIterateLocker locker(this);
 	// if it does not exist, do nothing
 	if (!m_hashEnums.contains(strEnumName))
 	{
@@ -254,6 +259,7 @@ UA_Variant QUaServer::enumValues(const UA_NodeId& enumNodeId) const
 
 void QUaServer::updateEnum(const UA_NodeId& enumNodeId, const QUaEnumMap& mapEnum)
 {
+	QUaIterateLocker locker(this);
 	// get enum values as ua variant
 	auto enumValuesNodeId = this->enumValuesNodeId(enumNodeId);
 	auto enumValues = this->enumValues(enumNodeId);
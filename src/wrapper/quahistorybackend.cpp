@@ -4,6 +4,14 @@
 
 #ifdef UA_ENABLE_HISTORIZING
 
+#include <QThread>
+#include <QTemporaryFile>
+#include <QDir>
+#include <QDataStream>
+#include <QElapsedTimer>
+
+#include <cmath>
+
 UA_StatusCode UA_DataValue_backend_copyRange(
 	const UA_DataValue &src, 
 	UA_DataValue &dst, 
@@ -17,22 +25,79 @@ UA_StatusCode UA_DataValue_backend_copyRange(
 
 UA_HistoryDataBackend QUaHistoryBackend::m_historUaBackend = QUaHistoryBackend::CreateUaBackend();
 
-QUaHistoryDataPoint QUaHistoryBackend::dataValueToPoint(const UA_DataValue* value)
+// position of a paginated history read, travels in the continuation point so the next page
+// seeks to the last timestamp read instead of skipping all the points of previous pages
+struct QUaHistoryReadCursor
+{
+	qint64  time; // timestamp of the last point read
+	quint64 skip; // points already read with that timestamp (tie breaker)
+
+	// move past the first count points read, ordered by time
+	template<typename T>
+	void advance(const QVector<T>& points, const int& count)
+	{
+		int last = count - 1;
+		// ignore invalid points padded by the historizer
+		while (last >= 0 && !points.at(last).timestamp.isValid())
+		{
+			last--;
+		}
+		if (last < 0)
+		{
+			return;
+		}
+		qint64  lastTime = points.at(last).timestamp.toMSecsSinceEpoch();
+		quint64 ties     = 0;
+		int i = last;
+		for (; i >= 0 && points.at(i).timestamp.toMSecsSinceEpoch() == lastTime; i--)
+		{
+			ties++;
+		}
+		// whole page with the same timestamp as the previous one
+		if (i < 0 && lastTime == time)
+		{
+			skip += ties;
+			return;
+		}
+		time = lastTime;
+		skip = ties;
+	};
+};
+
+// thread that commits queued data points, see QUaHistoryBackend::setWriteAsync
+class QUaHistoryWriteThread : public QThread
+{
+public:
+	explicit QUaHistoryWriteThread(const std::function<void(void)> &loop)
+		: QThread(), m_loop(loop)
+	{
+	};
+protected:
+	void run() override
+	{
+		m_loop();
+	};
+private:
+	std::function<void(void)> m_loop;
+};
+
+UA_DateTime QUaHistoryBackend::dataValueTimestamp(const UA_DataValue* value)
 {
 	// get or create timestamp for new point
-	UA_DateTime timestamp = 0;
 	if (value->hasSourceTimestamp)
 	{
-		timestamp = value->sourceTimestamp;
-	}
-	else if (value->hasServerTimestamp)
-	{
-		timestamp = value->serverTimestamp;
+		return value->sourceTimestamp;
 	}
-	else
+	if (value->hasServerTimestamp)
 	{
-		timestamp = UA_DateTime_now();
+		return value->serverTimestamp;
 	}
+	return UA_DateTime_now();
+}
+
+QUaHistoryDataPoint QUaHistoryBackend::dataValueToPoint(const UA_DataValue* value)
+{
+	UA_DateTime timestamp = QUaHistoryBackend::dataValueTimestamp(value);
 	return {
 			QUaTypesConverter::uaVariantToQVariantScalar<QDateTime, UA_DateTime>(&timestamp),
 			QUaTypesConverter::uaVariantToQVariant(value->value),
@@ -144,9 +209,9 @@ UA_HistoryDataBackend QUaHistoryBackend::CreateUaBackend()
 		QQueue<QUaLog> logOut;
 		QUaServer* srv = QUaServer::getServerNodeContext(server);
 		// call internal backend method
-		if (!srv->m_historBackend.writeHistoryData(
+		if (!srv->m_historBackend.writeHistoryDataValue(
 			*nodeId,
-			dataValueToPoint(value),
+			value,
 			logOut
 		))
 		{
@@ -391,16 +456,17 @@ UA_HistoryDataBackend QUaHistoryBackend::CreateUaBackend()
 		QUaNodeId nodeIdQt = *nodeId;
 		QDateTime timeStart = startIndex == LLONG_MAX ? QDateTime() : QDateTime::fromMSecsSinceEpoch(startIndex, Qt::UTC);
 		QDateTime timeEnd = endIndex == LLONG_MAX ? QDateTime() : QDateTime::fromMSecsSinceEpoch(endIndex, Qt::UTC);
-		// get offset wrt to previous call
-		quint64 offset = 0;
-		if (continuationPoint->length > 0)
+		// get cursor of previous call
+		bool hasCursor = continuationPoint->length > 0;
+		QUaHistoryReadCursor cursor = { 0, 0 };
+		if (hasCursor)
 		{
-			Q_ASSERT(continuationPoint->length == sizeof(size_t));
-			if (continuationPoint->length != sizeof(size_t))
+			Q_ASSERT(continuationPoint->length == sizeof(QUaHistoryReadCursor));
+			if (continuationPoint->length != sizeof(QUaHistoryReadCursor))
 			{
 				return UA_STATUSCODE_BADCONTINUATIONPOINTINVALID;
 			}
-			offset = static_cast<quint64>(*((size_t*)(continuationPoint->data)));
+			memcpy(&cursor, continuationPoint->data, sizeof(QUaHistoryReadCursor));
 		}
 		// get server
 		QQueue<QUaLog> logOut;
@@ -427,11 +493,16 @@ UA_HistoryDataBackend QUaHistoryBackend::CreateUaBackend()
 			"QUaHistoryBackend::copyDataValues",
 			"Error; invalid endIndex"
 		);
+		// first page starts at the start timestamp, next ones where the previous one ended
+		if (!hasCursor)
+		{
+			cursor = { timeStart.toMSecsSinceEpoch(), 0 };
+		}
 		// read data, points must always come back in incresing timestamp order
 		QVector<QUaHistoryDataPoint> points = srv->m_historBackend.readHistoryData(
 			nodeIdQt,
-			timeStart,
-			offset,
+			QDateTime::fromMSecsSinceEpoch(cursor.time, Qt::UTC),
+			cursor.skip,
 			static_cast<quint64>(valueSize),
 			logOut
 		);
@@ -461,13 +532,11 @@ UA_HistoryDataBackend QUaHistoryBackend::CreateUaBackend()
 			return retVal;
 		});
 		// calculate next continuation point
-		offset += static_cast<quint64>(valueSize);
+		cursor.advance(points, static_cast<int>(valueSize));
+		outContinuationPoint->length = sizeof(QUaHistoryReadCursor);
+		outContinuationPoint->data = (UA_Byte*)UA_malloc(sizeof(QUaHistoryReadCursor));
+		memcpy(outContinuationPoint->data, &cursor, sizeof(QUaHistoryReadCursor));
 
-		outContinuationPoint->length = sizeof(size_t);
-		size_t t = sizeof(size_t);
-		outContinuationPoint->data = (UA_Byte*)UA_malloc(t);
-		*((size_t*)(outContinuationPoint->data)) = static_cast<size_t>(offset);
-		
 		// success
 		return UA_STATUSCODE_GOOD;
 	};
@@ -527,15 +596,13 @@ UA_HistoryDataBackend QUaHistoryBackend::CreateUaBackend()
 		{
 			return UA_STATUSCODE_BADINVALIDTIMESTAMP;
 		}
-		QUaNodeId nodeIdQt = *nodeId;
-		auto    dataPoint = QUaHistoryBackend::dataValueToPoint(value);
 		// get server
 		QQueue<QUaLog> logOut;
 		QUaServer* srv = QUaServer::getServerNodeContext(server);
 		// call internal backend method
-		if (!srv->m_historBackend.writeHistoryData(
-			nodeIdQt,
-			dataValueToPoint(value),
+		if (!srv->m_historBackend.writeHistoryDataValue(
+			*nodeId,
+			value,
 			logOut
 		))
 		{
@@ -636,7 +703,18 @@ UA_HistoryDataBackend QUaHistoryBackend::CreateUaBackend()
 
 QUaHistoryBackend::QUaHistoryBackend()
 {
+	m_writeThread       = nullptr;
+	m_writeStop         = false;
+	m_writeQueueSize    = 10000;
+	m_writeInFlight     = 0;
+	m_writeBackpressure = WriteBackpressure::Block;
+	m_spillFile         = nullptr;
+	m_spillReadPos      = 0;
+	m_spillCount        = 0;
+	this->resetWriteStats();
 	m_writeHistoryData = nullptr;
+	m_writeHistoryDataBatch = nullptr;
+	m_writeHistoryDataRaw = nullptr;
 	m_updateHistoryData = nullptr;
 	m_removeHistoryData = nullptr;
 	m_firstTimestamp = nullptr;
@@ -645,6 +723,7 @@ QUaHistoryBackend::QUaHistoryBackend()
 	m_findTimestamp = nullptr;
 	m_numDataPointsInRange = nullptr;
 	m_readHistoryData = nullptr;
+	m_readHistoryRollups = nullptr;
 	// event history support
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	m_writeHistoryEventsOfType = nullptr;
@@ -655,6 +734,376 @@ QUaHistoryBackend::QUaHistoryBackend()
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 }
 
+QUaHistoryBackend::~QUaHistoryBackend()
+{
+	QQueue<QUaLog> logOut;
+	this->stopWriteThread(logOut);
+}
+
+bool QUaHistoryBackend::writeAsync() const
+{
+	QMutexLocker locker(&m_writeMutex);
+	return m_writeThread != nullptr;
+}
+
+void QUaHistoryBackend::setWriteAsync(const bool& async, QQueue<QUaLog>& logOut)
+{
+	if (async)
+	{
+		this->startWriteThread();
+		return;
+	}
+	this->stopWriteThread(logOut);
+}
+
+int QUaHistoryBackend::writeQueueSize() const
+{
+	QMutexLocker locker(&m_writeMutex);
+	return m_writeQueueSize;
+}
+
+void QUaHistoryBackend::setWriteQueueSize(const int& size)
+{
+	QMutexLocker locker(&m_writeMutex);
+	m_writeQueueSize = qMax(1, size);
+	m_writeNotFull.wakeAll();
+}
+
+QUaHistoryBackend::WriteBackpressure QUaHistoryBackend::writeBackpressure() const
+{
+	QMutexLocker locker(&m_writeMutex);
+	return m_writeBackpressure;
+}
+
+void QUaHistoryBackend::setWriteBackpressure(const WriteBackpressure& policy)
+{
+	QMutexLocker locker(&m_writeMutex);
+	m_writeBackpressure = policy;
+	m_writeNotFull.wakeAll();
+}
+
+QString QUaHistoryBackend::spillFileName() const
+{
+	QMutexLocker locker(&m_writeMutex);
+	return m_spillFileName;
+}
+
+void QUaHistoryBackend::setSpillFileName(const QString& fileName)
+{
+	QMutexLocker locker(&m_writeMutex);
+	m_spillFileName = fileName;
+	// next spill opens the new file, unless current one still holds points
+	if (m_spillCount == 0)
+	{
+		this->clearSpill();
+		delete m_spillFile;
+		m_spillFile = nullptr;
+	}
+}
+
+void QUaHistoryBackend::flushWrites(QQueue<QUaLog>& logOut)
+{
+	QMutexLocker locker(&m_writeMutex);
+	this->waitWrites();
+	// report logs of the commits, else lost if there are no more writes
+	logOut << m_writeLogOut;
+	m_writeLogOut.clear();
+}
+
+void QUaHistoryBackend::waitWrites()
+{
+	// NOTE : m_writeMutex must be locked
+	while (m_writeThread && (!m_writeQueue.isEmpty() || m_spillCount > 0 || m_writeInFlight > 0))
+	{
+		m_writeDrained.wait(&m_writeMutex);
+	}
+}
+
+void QUaHistoryBackend::waitStopped()
+{
+	// NOTE : m_writeMutex must be locked, stopWriteThread wakes m_writeDrained once stopped
+	while (m_writeThread && m_writeStop)
+	{
+		m_writeDrained.wait(&m_writeMutex);
+	}
+}
+
+QUaHistoryWriteStats QUaHistoryBackend::writeStats() const
+{
+	QMutexLocker locker(&m_writeMutex);
+	QUaHistoryWriteStats stats = m_writeStats;
+	stats.queueDepth = m_writeQueue.count() + m_spillCount;
+	return stats;
+}
+
+void QUaHistoryBackend::resetWriteStats()
+{
+	QMutexLocker locker(&m_writeMutex);
+	m_writeStats.queueDepth       = 0;
+	m_writeStats.queueMaxDepth    = m_writeQueue.count() + m_spillCount;
+	m_writeStats.committed        = 0;
+	m_writeStats.batches          = 0;
+	m_writeStats.dropped          = 0;
+	m_writeStats.spilled          = 0;
+	m_writeStats.commitLatency    = 0;
+	m_writeStats.commitMaxLatency = 0;
+}
+
+void QUaHistoryBackend::startWriteThread()
+{
+	QMutexLocker locker(&m_writeMutex);
+	if (m_writeThread)
+	{
+		return;
+	}
+	m_writeStop   = false;
+	m_writeThread = new QUaHistoryWriteThread([this]() {
+		this->writeLoop();
+	});
+	m_writeThread->start();
+}
+
+void QUaHistoryBackend::stopWriteThread(QQueue<QUaLog>& logOut)
+{
+	QThread * thread = nullptr;
+	{
+		QMutexLocker locker(&m_writeMutex);
+		if (!m_writeThread)
+		{
+			return;
+		}
+		// new points are written synchronously from now on
+		m_writeStop = true;
+		m_writeNotEmpty.wakeAll();
+		thread = m_writeThread;
+	}
+	// writer returns once queue and spill are committed
+	thread->wait();
+	QMutexLocker locker(&m_writeMutex);
+	delete thread;
+	m_writeThread = nullptr;
+	m_writeStop   = false;
+	this->clearSpill();
+	delete m_spillFile;
+	m_spillFile = nullptr;
+	m_writeNotFull.wakeAll();
+	m_writeDrained.wakeAll();
+	// report logs of the last commits
+	logOut << m_writeLogOut;
+	m_writeLogOut.clear();
+}
+
+void QUaHistoryBackend::writeLoop()
+{
+	QVector<QUaHistoryNodeDataPoint> batch;
+	while (true)
+	{
+		batch.clear();
+		{
+			QMutexLocker locker(&m_writeMutex);
+			while (m_writeQueue.isEmpty() && m_spillCount == 0 && !m_writeStop)
+			{
+				m_writeNotEmpty.wait(&m_writeMutex);
+			}
+			if (m_writeQueue.isEmpty() && m_spillCount == 0)
+			{
+				// stop requested and all committed
+				return;
+			}
+			// queue holds the oldest points, spill the newest
+			if (!m_writeQueue.isEmpty())
+			{
+				// take the whole queue, so producers find room right away
+				batch.reserve(m_writeQueue.count());
+				for (const auto& point : qAsConst(m_writeQueue))
+				{
+					batch.append(point);
+				}
+				m_writeQueue.clear();
+			}
+			else
+			{
+				this->readSpill(batch);
+			}
+			m_writeInFlight = batch.count();
+			m_writeNotFull.wakeAll();
+		}
+		QQueue<QUaLog> logOut;
+		QElapsedTimer timer;
+		timer.start();
+		// commit in chunks, so reads of the server do not wait for the whole batch
+		for (int i = 0; m_writeHistoryDataBatch && i < batch.count(); i += writeChunkSize)
+		{
+			// NOTE : mid of the whole batch shares it, no copy
+			QMutexLocker locker(&m_historizerMutex);
+			m_writeHistoryDataBatch(batch.mid(i, writeChunkSize), logOut);
+		}
+		qint64 latency = timer.nsecsElapsed();
+		QMutexLocker locker(&m_writeMutex);
+		m_writeInFlight = 0;
+		m_writeStats.committed += static_cast<quint64>(batch.count());
+		m_writeStats.batches++;
+		m_writeStats.commitLatency    = latency;
+		m_writeStats.commitMaxLatency = qMax(m_writeStats.commitMaxLatency, latency);
+		// reported on next write, from the server's thread
+		m_writeLogOut << logOut;
+		if (m_writeQueue.isEmpty() && m_spillCount == 0)
+		{
+			m_writeDrained.wakeAll();
+		}
+	}
+}
+
+bool QUaHistoryBackend::enqueueWrite(
+	const QUaHistoryNodeDataPoint& point,
+	QQueue<QUaLog>& logOut)
+{
+	// NOTE : m_writeMutex must be locked
+	// keep order, once spilling all new points go to disk until the spill is committed
+	if (m_spillCount > 0)
+	{
+		return this->spillWrite(point, logOut);
+	}
+	if (m_writeQueue.count() >= m_writeQueueSize)
+	{
+		switch (m_writeBackpressure)
+		{
+		case WriteBackpressure::Block:
+			while (m_writeQueue.count() >= m_writeQueueSize &&
+				m_writeBackpressure == WriteBackpressure::Block)
+			{
+				m_writeNotFull.wait(&m_writeMutex);
+			}
+			// policy might have changed while waiting
+			if (m_writeQueue.count() >= m_writeQueueSize)
+			{
+				return this->enqueueWrite(point, logOut);
+			}
+			break;
+		case WriteBackpressure::DropOldest:
+			m_writeQueue.dequeue();
+			m_writeStats.dropped++;
+			break;
+		case WriteBackpressure::SpillToDisk:
+			return this->spillWrite(point, logOut);
+		}
+	}
+	m_writeQueue.enqueue(point);
+	m_writeStats.queueMaxDepth = qMax(m_writeStats.queueMaxDepth, m_writeQueue.count() + m_spillCount);
+	m_writeNotEmpty.wakeOne();
+	return true;
+}
+
+bool QUaHistoryBackend::spillWrite(
+	const QUaHistoryNodeDataPoint& point,
+	QQueue<QUaLog>& logOut)
+{
+	// NOTE : m_writeMutex must be locked
+	if (!m_spillFile)
+	{
+		bool ok = false;
+		if (m_spillFileName.isEmpty())
+		{
+			auto tmpFile = new QTemporaryFile(QDir::temp().filePath("quahistory_XXXXXX.spill"));
+			ok = tmpFile->open();
+			m_spillFile = tmpFile;
+		}
+		else
+		{
+			m_spillFile = new QFile(m_spillFileName);
+			ok = m_spillFile->open(QIODevice::ReadWrite | QIODevice::Truncate);
+		}
+		if (!ok)
+		{
+			logOut << QUaLog({
+				QObject::tr("Failed to open history spill file %1. Error : %2.")
+					.arg(m_spillFile->fileName())
+					.arg(m_spillFile->errorString()),
+				QUaLogLevel::Error,
+				QUaLogCategory::History
+			});
+			delete m_spillFile;
+			m_spillFile = nullptr;
+			return false;
+		}
+	}
+	qint64 size = m_spillFile->size();
+	m_spillFile->seek(size);
+	QDataStream stream(m_spillFile);
+	stream << point.nodeId
+		<< point.dataPoint.timestamp
+		<< point.dataPoint.value
+		<< point.dataPoint.status;
+	if (stream.status() != QDataStream::Ok)
+	{
+		logOut << QUaLog({
+			QObject::tr("Failed to spill history data point of node %1 to %2.")
+				.arg(point.nodeId.toXmlString())
+				.arg(m_spillFile->fileName()),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		// discard partial write
+		m_spillFile->resize(size);
+		return false;
+	}
+	m_spillCount++;
+	m_writeStats.spilled++;
+	m_writeStats.queueMaxDepth = qMax(m_writeStats.queueMaxDepth, m_writeQueue.count() + m_spillCount);
+	m_writeNotEmpty.wakeOne();
+	return true;
+}
+
+void QUaHistoryBackend::readSpill(QVector<QUaHistoryNodeDataPoint>& batch)
+{
+	// NOTE : m_writeMutex must be locked
+	Q_CHECK_PTR(m_spillFile);
+	m_spillFile->seek(m_spillReadPos);
+	QDataStream stream(m_spillFile);
+	// same batch size as a full queue
+	int count = qMin(m_spillCount, m_writeQueueSize);
+	batch.reserve(count);
+	for (int i = 0; i < count; i++)
+	{
+		QUaHistoryNodeDataPoint point;
+		stream >> point.nodeId
+			>> point.dataPoint.timestamp
+			>> point.dataPoint.value
+			>> point.dataPoint.status;
+		if (stream.status() != QDataStream::Ok)
+		{
+			m_writeLogOut << QUaLog({
+				QObject::tr("Failed to read history spill file %1, discarding %2 spilled data points.")
+					.arg(m_spillFile->fileName())
+					.arg(m_spillCount - i),
+				QUaLogLevel::Error,
+				QUaLogCategory::History
+			});
+			m_writeStats.dropped += static_cast<quint64>(m_spillCount - i);
+			this->clearSpill();
+			return;
+		}
+		batch.append(point);
+	}
+	m_spillCount  -= count;
+	m_spillReadPos = m_spillFile->pos();
+	if (m_spillCount == 0)
+	{
+		this->clearSpill();
+	}
+}
+
+void QUaHistoryBackend::clearSpill()
+{
+	// NOTE : m_writeMutex must be locked
+	m_spillCount   = 0;
+	m_spillReadPos = 0;
+	if (m_spillFile)
+	{
+		m_spillFile->resize(0);
+	}
+}
+
 bool QUaHistoryBackend::writeHistoryData(
 	const QUaNodeId& nodeId,
 	const QUaHistoryDataPoint& dataPoint,
@@ -669,9 +1118,69 @@ bool QUaHistoryBackend::writeHistoryData(
 		});
 		return false;
 	}
+	QMutexLocker writeLocker(&m_writeMutex);
+	if (m_writeThread && !m_writeStop)
+	{
+		// report logs of previous asynchronous commits
+		logOut << m_writeLogOut;
+		m_writeLogOut.clear();
+		return this->enqueueWrite({ nodeId, dataPoint }, logOut);
+	}
+	// stopping, wait until the writer committed the queue, else this point goes before it
+	this->waitStopped();
+	writeLocker.unlock();
+	QMutexLocker locker(&m_historizerMutex);
 	return m_writeHistoryData(nodeId, dataPoint, logOut);
 }
 
+bool QUaHistoryBackend::writeHistoryDataBatch(
+	const QVector<QUaHistoryNodeDataPoint>& points,
+	QQueue<QUaLog>& logOut)
+{
+	if (!m_writeHistoryDataBatch)
+	{
+		logOut << QUaLog({
+			QObject::tr("Historizing enabled, but historized not set."),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	QMutexLocker writeLocker(&m_writeMutex);
+	if (m_writeThread && !m_writeStop)
+	{
+		// report logs of previous asynchronous commits
+		logOut << m_writeLogOut;
+		m_writeLogOut.clear();
+		bool ok = true;
+		for (const auto& point : points)
+		{
+			ok = this->enqueueWrite(point, logOut) && ok;
+		}
+		return ok;
+	}
+	// stopping, wait until the writer committed the queue, else these points go before it
+	this->waitStopped();
+	writeLocker.unlock();
+	QMutexLocker locker(&m_historizerMutex);
+	return m_writeHistoryDataBatch(points, logOut);
+}
+
+bool QUaHistoryBackend::writeHistoryDataValue(
+	const UA_NodeId& nodeId,
+	const UA_DataValue* value,
+	QQueue<QUaLog>& logOut)
+{
+	// NOTE : queued data points must own their value, so asynchronous writes are converted
+	if (!m_writeHistoryDataRaw || this->writeAsync())
+	{
+		return this->writeHistoryData(nodeId, QUaHistoryBackend::dataValueToPoint(value), logOut);
+	}
+	UA_DateTime timestamp = QUaHistoryBackend::dataValueTimestamp(value);
+	QMutexLocker locker(&m_historizerMutex);
+	return m_writeHistoryDataRaw(nodeId, timestamp, value->value, value->status, logOut);
+}
+
 bool QUaHistoryBackend::updateHistoryData(
 	const QUaNodeId& nodeId,
 	const QUaHistoryDataPoint& dataPoint,
@@ -686,6 +1195,7 @@ bool QUaHistoryBackend::updateHistoryData(
 		});
 		return false;
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_updateHistoryData(nodeId, dataPoint, logOut);
 }
 
@@ -704,6 +1214,7 @@ bool QUaHistoryBackend::removeHistoryData(
 		});
 		return false;
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_removeHistoryData(nodeId, timeStart, timeEnd, logOut);
 }
 
@@ -721,6 +1232,7 @@ QDateTime QUaHistoryBackend::firstTimestamp(
 		});
 		return QDateTime();
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_firstTimestamp(nodeId, logOut);
 }
 
@@ -738,6 +1250,7 @@ QDateTime QUaHistoryBackend::lastTimestamp(
 		});
 		return QDateTime();
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_lastTimestamp(nodeId, logOut);
 }
 
@@ -756,6 +1269,7 @@ bool QUaHistoryBackend::hasTimestamp(
 		});
 		return false;
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_hasTimestamp(nodeId, timestamp, logOut);
 }
 
@@ -775,6 +1289,7 @@ QDateTime QUaHistoryBackend::findTimestamp(
 		});
 		return QDateTime();
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_findTimestamp(nodeId, timestamp, match, logOut);
 }
 
@@ -794,6 +1309,7 @@ quint64 QUaHistoryBackend::numDataPointsInRange(
 		});
 		return 0;
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_numDataPointsInRange(nodeId, timeStart, timeEnd, logOut);
 }
 
@@ -814,6 +1330,7 @@ QUaHistoryBackend::readHistoryData(
 		});
 		return QVector<QUaHistoryDataPoint>();
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_readHistoryData(
 		nodeId,
 		timeStart,
@@ -823,6 +1340,424 @@ QUaHistoryBackend::readHistoryData(
 	);
 }
 
+QVector<QUaHistoryDataPoint>
+QUaHistoryBackend::readHistoryAggregate(
+	const QUaNodeId& nodeId,
+	const Aggregate& aggregate,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	const qint64& interval,
+	QQueue<QUaLog>& logOut) const
+{
+	QVector<QUaHistoryDataPoint> points;
+	if (!timeStart.isValid() || !timeEnd.isValid() || timeEnd <= timeStart || interval < 0)
+	{
+		return points;
+	}
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	qint64 end   = timeEnd.toMSecsSinceEpoch();
+	qint64 step  = interval > 0 ? interval : end - start;
+	// NOTE : interval comes from the client, bound the number of data points to return
+	qint64 numIntervals = (end - start + step - 1) / step;
+	if (numIntervals > QUaHistoryBackend::maxAggregateIntervals)
+	{
+		logOut << QUaLog({
+			QObject::tr("Error reading history aggregate. Range of node id %1 contains %2 intervals, "
+				"maximum is %3.")
+				.arg(nodeId).arg(numIntervals).arg(QUaHistoryBackend::maxAggregateIntervals),
+			QUaLogLevel::Error,
+			QUaLogCategory::History
+		});
+		return points;
+	}
+	// rollups ordered by time, optionally preceded and followed by the closest ones outside the range
+	QVector<QUaHistoryRollup> rollups;
+	bool ok = false;
+	if (m_readHistoryRollups)
+	{
+		QMutexLocker locker(&m_historizerMutex);
+		ok = m_readHistoryRollups(nodeId, timeStart, timeEnd, interval, rollups, logOut);
+	}
+	if (!ok)
+	{
+		rollups.clear();
+		if (!this->readRawRollups(nodeId, start, end, step, rollups, logOut))
+		{
+			return points;
+		}
+	}
+	const QUaHistoryRollup* before = !rollups.isEmpty() && rollups.first().timeStart < start ?
+		&rollups.first() : nullptr;
+	const QUaHistoryRollup* after  = !rollups.isEmpty() && rollups.last().timeStart >= end ?
+		&rollups.last() : nullptr;
+	int index = before ? 1 : 0;
+	int last  = rollups.count() - (after ? 1 : 0);
+	// value at time t of the line from (ta, va) to (tb, vb)
+	auto interpolate = [](const qint64& ta, const double& va, const qint64& tb, const double& vb, const qint64& t) -> double {
+		return tb == ta ? va : va + (vb - va) * static_cast<double>(t - ta) / static_cast<double>(tb - ta);
+	};
+	// closest data point before the current interval
+	bool   hasPrev   = before != nullptr;
+	qint64 prevTime  = hasPrev ? before->timeLast  : 0;
+	double prevValue = hasPrev ? before->valueLast : 0.0;
+	points.reserve(static_cast<int>(numIntervals));
+	for (qint64 t0 = start; t0 < end; t0 += step)
+	{
+		qint64 t1 = (std::min)(t0 + step, end);
+		// merge rollups within current interval
+		bool hasCur = false;
+		QUaHistoryRollup cur;
+		for (; index < last && rollups.at(index).timeStart < t1; index++)
+		{
+			if (!hasCur)
+			{
+				cur    = rollups.at(index);
+				hasCur = true;
+				continue;
+			}
+			QUaHistoryRollupTiers::mergeRollup(cur, rollups.at(index));
+		}
+		// closest data point after the current interval
+		bool   hasNext   = index < last || after != nullptr;
+		qint64 nextTime  = index < last ? rollups.at(index).timeFirst  : after ? after->timeFirst  : 0;
+		double nextValue = index < last ? rollups.at(index).valueFirst : after ? after->valueFirst : 0.0;
+		QUaHistoryDataPoint point = {
+			QDateTime::fromMSecsSinceEpoch(t0, Qt::UTC),
+			QVariant(),
+			UA_STATUSCODE_GOOD
+		};
+		switch (aggregate)
+		{
+		case Aggregate::Count:
+			point.value = hasCur ? static_cast<qint32>(cur.count) : 0;
+			break;
+		case Aggregate::Minimum:
+			point.value  = hasCur ? QVariant(cur.min) : QVariant();
+			point.status = hasCur ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADNODATA;
+			break;
+		case Aggregate::Maximum:
+			point.value  = hasCur ? QVariant(cur.max) : QVariant();
+			point.status = hasCur ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADNODATA;
+			break;
+		case Aggregate::Average:
+			point.value  = hasCur ? QVariant(cur.sum / cur.count) : QVariant();
+			point.status = hasCur ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADNODATA;
+			break;
+		case Aggregate::Interpolative:
+			if (hasCur && cur.timeFirst == t0)
+			{
+				point.value = cur.valueFirst;
+			}
+			else if (hasPrev && (hasCur || hasNext))
+			{
+				point.value = hasCur ?
+					interpolate(prevTime, prevValue, cur.timeFirst, cur.valueFirst, t0) :
+					interpolate(prevTime, prevValue, nextTime, nextValue, t0);
+			}
+			else if (hasPrev)
+			{
+				// extrapolated
+				point.value  = prevValue;
+				point.status = UA_STATUSCODE_UNCERTAINDATASUBNORMAL;
+			}
+			else
+			{
+				point.status = UA_STATUSCODE_BADNODATA;
+			}
+			break;
+		case Aggregate::TimeAverage:
+		{
+			// integral of the interpolated value over the part of the interval with bounding data points
+			double area    = 0.0;
+			qint64 covered = 0;
+			if (hasCur)
+			{
+				area    += cur.integral;
+				covered += cur.timeLast - cur.timeFirst;
+				if (hasPrev && cur.timeFirst > t0)
+				{
+					double v0 = interpolate(prevTime, prevValue, cur.timeFirst, cur.valueFirst, t0);
+					area    += (cur.timeFirst - t0) * (v0 + cur.valueFirst) / 2.0;
+					covered += cur.timeFirst - t0;
+				}
+				if (hasNext && cur.timeLast < t1)
+				{
+					double v1 = interpolate(cur.timeLast, cur.valueLast, nextTime, nextValue, t1);
+					area    += (t1 - cur.timeLast) * (cur.valueLast + v1) / 2.0;
+					covered += t1 - cur.timeLast;
+				}
+			}
+			else if (hasPrev && hasNext)
+			{
+				double v0 = interpolate(prevTime, prevValue, nextTime, nextValue, t0);
+				double v1 = interpolate(prevTime, prevValue, nextTime, nextValue, t1);
+				area    = (t1 - t0) * (v0 + v1) / 2.0;
+				covered = t1 - t0;
+			}
+			if (covered > 0)
+			{
+				point.value  = area / covered;
+				point.status = covered < t1 - t0 ? UA_STATUSCODE_UNCERTAINDATASUBNORMAL : UA_STATUSCODE_GOOD;
+			}
+			else if (hasCur)
+			{
+				// single instant
+				point.value = cur.sum / cur.count;
+			}
+			else
+			{
+				point.status = UA_STATUSCODE_BADNODATA;
+			}
+		}
+			break;
+		}
+		points << point;
+		if (hasCur)
+		{
+			hasPrev   = true;
+			prevTime  = cur.timeLast;
+			prevValue = cur.valueLast;
+		}
+	}
+	return points;
+}
+
+bool QUaHistoryBackend::readRawRollups(
+	const QUaNodeId& nodeId,
+	const qint64& timeStart,
+	const qint64& timeEnd,
+	const qint64& interval,
+	QVector<QUaHistoryRollup>& rollups,
+	QQueue<QUaLog>& logOut) const
+{
+	if (!m_readHistoryData || !m_findTimestamp || !m_hasTimestamp)
+	{
+		logOut << QUaLog({
+			QObject::tr("Historizing enabled, but historized not set."),
+			QUaLogLevel::Warning,
+			QUaLogCategory::History
+		});
+		return false;
+	}
+	double value;
+	// closest data point before the range, for interpolation
+	QDateTime start = QDateTime::fromMSecsSinceEpoch(timeStart, Qt::UTC);
+	QDateTime timePrev = this->findTimestamp(nodeId, start, TimeMatch::ClosestFromBelow, logOut);
+	if (timePrev.isValid() && timePrev < start)
+	{
+		auto prev = this->readHistoryData(nodeId, timePrev, 0, 1, logOut);
+		if (!prev.isEmpty() && QUaHistoryRollupTiers::numericValue(prev.first(), value))
+		{
+			qint64 time = timePrev.toMSecsSinceEpoch();
+			rollups << QUaHistoryRollupTiers::createRollup(time, time, value);
+		}
+	}
+	// data points within the range, plus the first one after the range
+	// NOTE : reads must start at an existing timestamp
+	QDateTime timeFirst = this->hasTimestamp(nodeId, start, logOut) ?
+		start : this->findTimestamp(nodeId, start, TimeMatch::ClosestFromAbove, logOut);
+	if (!timeFirst.isValid() || timeFirst < start)
+	{
+		return true;
+	}
+	const quint64 pageSize = 10000;
+	QUaHistoryReadCursor cursor = { timeFirst.toMSecsSinceEpoch(), 0 };
+	bool hasCur = false;
+	QUaHistoryRollup cur;
+	bool done = false;
+	while (!done)
+	{
+		auto page = this->readHistoryData(
+			nodeId,
+			QDateTime::fromMSecsSinceEpoch(cursor.time, Qt::UTC),
+			cursor.skip,
+			pageSize,
+			logOut
+		);
+		done = static_cast<quint64>(page.count()) < pageSize;
+		int count = 0;
+		for (const auto& point : page)
+		{
+			// invalid points padded by the historizer
+			if (!point.timestamp.isValid())
+			{
+				done = true;
+				break;
+			}
+			count++;
+			qint64 time = point.timestamp.toMSecsSinceEpoch();
+			if (time >= timeEnd)
+			{
+				if (hasCur)
+				{
+					rollups << cur;
+					hasCur = false;
+				}
+				if (QUaHistoryRollupTiers::numericValue(point, value))
+				{
+					rollups << QUaHistoryRollupTiers::createRollup(time, time, value);
+				}
+				done = true;
+				break;
+			}
+			if (time < timeStart || !QUaHistoryRollupTiers::numericValue(point, value))
+			{
+				continue;
+			}
+			qint64 intervalStart = timeStart + ((time - timeStart) / interval) * interval;
+			if (hasCur && cur.timeStart == intervalStart)
+			{
+				QUaHistoryRollupTiers::appendRollup(cur, time, value);
+				continue;
+			}
+			if (hasCur)
+			{
+				rollups << cur;
+			}
+			cur    = QUaHistoryRollupTiers::createRollup(intervalStart, time, value);
+			hasCur = true;
+		}
+		cursor.advance(page, count);
+	}
+	if (hasCur)
+	{
+		rollups << cur;
+	}
+	return true;
+}
+
+bool QUaHistoryBackend::aggregateFromNodeId(
+	const UA_NodeId& nodeId,
+	Aggregate& aggregate)
+{
+	if (nodeId.namespaceIndex != 0 || nodeId.identifierType != UA_NODEIDTYPE_NUMERIC)
+	{
+		return false;
+	}
+	switch (nodeId.identifier.numeric)
+	{
+	case UA_NS0ID_AGGREGATEFUNCTION_INTERPOLATIVE:
+		aggregate = Aggregate::Interpolative;
+		return true;
+	case UA_NS0ID_AGGREGATEFUNCTION_AVERAGE:
+		aggregate = Aggregate::Average;
+		return true;
+	case UA_NS0ID_AGGREGATEFUNCTION_TIMEAVERAGE:
+		aggregate = Aggregate::TimeAverage;
+		return true;
+	case UA_NS0ID_AGGREGATEFUNCTION_MINIMUM:
+		aggregate = Aggregate::Minimum;
+		return true;
+	case UA_NS0ID_AGGREGATEFUNCTION_MAXIMUM:
+		aggregate = Aggregate::Maximum;
+		return true;
+	case UA_NS0ID_AGGREGATEFUNCTION_COUNT:
+		aggregate = Aggregate::Count;
+		return true;
+	default:
+		break;
+	}
+	return false;
+}
+
+// NOTE : all intervals of a node are returned at once, without continuation points
+void QUaHistoryBackend::readProcessed(
+    UA_Server*                    server,
+    void*                         hdbContext,
+    const UA_NodeId*              sessionId,
+    void*                         sessionContext,
+    const UA_RequestHeader*       requestHeader,
+    const UA_ReadProcessedDetails* historyReadDetails,
+    UA_TimestampsToReturn         timestampsToReturn,
+    UA_Boolean                    releaseContinuationPoints,
+    size_t                        nodesToReadSize,
+    const UA_HistoryReadValueId*  nodesToRead,
+    UA_HistoryReadResponse*       response,
+    UA_HistoryData* const* const  historyData)
+{
+	Q_UNUSED(hdbContext);
+	Q_UNUSED(sessionId);
+	Q_UNUSED(sessionContext);
+	Q_UNUSED(requestHeader);
+	Q_UNUSED(timestampsToReturn);
+	Q_UNUSED(releaseContinuationPoints);
+	QQueue<QUaLog> logOut;
+	auto srv = QUaServer::getServerNodeContext(server);
+	// one aggregate per node
+	if (historyReadDetails->aggregateTypeSize != nodesToReadSize)
+	{
+		response->responseHeader.serviceResult = UA_STATUSCODE_BADAGGREGATELISTMISMATCH;
+		return;
+	}
+	auto startTimestamp = historyReadDetails->startTime;
+	auto endTimestamp   = historyReadDetails->endTime;
+	QDateTime timeStart = startTimestamp == LLONG_MAX ? QDateTime() : QUaTypesConverter::uaVariantToQVariantScalar<QDateTime, UA_DateTime>(&startTimestamp);
+	QDateTime timeEnd   = endTimestamp   == LLONG_MAX ? QDateTime() : QUaTypesConverter::uaVariantToQVariantScalar<QDateTime, UA_DateTime>(&endTimestamp);
+	// intervals are returned in reverse order if end time is before start time
+	bool reverse = timeStart.isValid() && timeEnd.isValid() && timeEnd < timeStart;
+	if (reverse)
+	{
+		std::swap(timeStart, timeEnd);
+	}
+	// NOTE : timestamps have millisecond resolution, fractional intervals are not supported
+	//        instead of silently truncating them (e.g. 0.5 ms to 0, a single interval)
+	double processingInterval = historyReadDetails->processingInterval;
+	bool   validInterval = std::isfinite(processingInterval) &&
+		processingInterval >= 0.0 && std::floor(processingInterval) == processingInterval;
+	qint64 interval = validInterval ? static_cast<qint64>(processingInterval) : -1;
+	for (size_t ithNode = 0; ithNode < nodesToReadSize; ++ithNode)
+	{
+		Aggregate aggregate;
+		if (!QUaHistoryBackend::aggregateFromNodeId(historyReadDetails->aggregateType[ithNode], aggregate))
+		{
+			response->results[ithNode].statusCode = UA_STATUSCODE_BADAGGREGATENOTSUPPORTED;
+			continue;
+		}
+		if (!validInterval)
+		{
+			response->results[ithNode].statusCode = UA_STATUSCODE_BADAGGREGATEINVALIDINPUTS;
+			continue;
+		}
+		if (!timeStart.isValid() || !timeEnd.isValid() || timeStart == timeEnd)
+		{
+			response->results[ithNode].statusCode = UA_STATUSCODE_BADINVALIDTIMESTAMPARGUMENT;
+			continue;
+		}
+		// refuse before reading, see readHistoryAggregate
+		qint64 span = timeEnd.toMSecsSinceEpoch() - timeStart.toMSecsSinceEpoch();
+		if (interval > 0 && (span + interval - 1) / interval > QUaHistoryBackend::maxAggregateIntervals)
+		{
+			response->results[ithNode].statusCode = UA_STATUSCODE_BADTOOMANYOPERATIONS;
+			continue;
+		}
+		auto points = srv->m_historBackend.readHistoryAggregate(
+			QUaNodeId(nodesToRead[ithNode].nodeId),
+			aggregate,
+			timeStart,
+			timeEnd,
+			interval,
+			logOut
+		);
+		if (reverse)
+		{
+			std::reverse(points.begin(), points.end());
+		}
+		size_t numPoints = static_cast<size_t>(points.count());
+		historyData[ithNode]->dataValuesSize = numPoints;
+		historyData[ithNode]->dataValues = (UA_DataValue*)
+			UA_Array_new(numPoints, &UA_TYPES[UA_TYPES_DATAVALUE]);
+		for (size_t i = 0; i < numPoints; i++)
+		{
+			auto point = &points.at(static_cast<int>(i));
+			historyData[ithNode]->dataValues[i] = QUaHistoryBackend::dataPointToValue(point);
+			// intervals without data only have a status
+			historyData[ithNode]->dataValues[i].hasValue = point->value.isValid();
+		}
+	}
+	QUaHistoryBackend::processServerLog(srv, logOut);
+	response->responseHeader.serviceResult = UA_STATUSCODE_GOOD;
+}
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 
 bool QUaHistoryBackend::writeHistoryEventsOfType(
@@ -841,6 +1776,7 @@ bool QUaHistoryBackend::writeHistoryEventsOfType(
 		});
 		return false;
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_writeHistoryEventsOfType(
 		eventTypeNodeId,
 		emittersNodeIds,
@@ -863,6 +1799,7 @@ QVector<QUaNodeId> QUaHistoryBackend::eventTypesOfEmitter(
 		});
 		return QVector<QUaNodeId>();
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_eventTypesOfEmitter(
 		emitterNodeId,
 		logOut
@@ -886,6 +1823,7 @@ QDateTime QUaHistoryBackend::findTimestampEventOfType(
 		});
 		return QDateTime();
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_findTimestampEventOfType(
 		emitterNodeId,
 		eventTypeNodeId,
@@ -912,6 +1850,7 @@ quint64 QUaHistoryBackend::numEventsOfTypeInRange(
 		});
 		return 0;
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_numEventsOfTypeInRange(
 		emitterNodeId,
 		eventTypeNodeId,
@@ -940,6 +1879,7 @@ QVector<QUaHistoryEventPoint> QUaHistoryBackend::readHistoryEventsOfType(
 		});
 		return QVector<QUaHistoryEventPoint>();
 	}
+	QMutexLocker locker(&m_historizerMutex);
 	return m_readHistoryEventsOfType(
 		emitterNodeId,
 		eventTypeNodeId,
@@ -1169,9 +2109,16 @@ void QUaHistoryBackend::readEvent(
 			}
 			totalToReadForThisType = (std::min)(totalToReadForThisType, static_cast<quint64>(eventsOfType.size()));
 			Q_ASSERT(totalToReadForThisType > 0);
-			// update continuation
-			queryData[eventTypeNodeId].m_numEventsToRead      -= totalToReadForThisType;
-			queryData[eventTypeNodeId].m_numEventsAlreadyRead += totalToReadForThisType;
+			// update continuation, next read seeks to the last event read
+			auto& typeQueryData = queryData[eventTypeNodeId];
+			QUaHistoryReadCursor cursor = {
+				typeQueryData.m_timeStartExisting.toMSecsSinceEpoch(),
+				typeQueryData.m_numEventsAlreadyRead
+			};
+			cursor.advance(eventsOfType, static_cast<int>(totalToReadForThisType));
+			typeQueryData.m_timeStartExisting     = QDateTime::fromMSecsSinceEpoch(cursor.time, Qt::UTC);
+			typeQueryData.m_numEventsAlreadyRead  = cursor.skip;
+			typeQueryData.m_numEventsToRead      -= totalToReadForThisType;
 			if (queryData[eventTypeNodeId].m_numEventsToRead == 0)
 			{
 				queryData.remove(eventTypeNodeId);
@@ -1242,6 +2189,300 @@ void QUaHistoryBackend::readEvent(
 }
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 
+QUaHistoryRollupTiers::QUaHistoryRollupTiers(const QVector<qint64>& intervals)
+	: m_intervals(intervals)
+{
+	Q_ASSERT_X(!m_intervals.isEmpty(), "QUaHistoryRollupTiers", "At least one interval is required.");
+	for (int i = 0; i < m_intervals.count(); i++)
+	{
+		Q_ASSERT_X(m_intervals.at(i) > 0 && (i == 0 || m_intervals.at(i) % m_intervals.at(i - 1) == 0),
+			"QUaHistoryRollupTiers", "Each interval must be a multiple of the previous one.");
+	}
+}
+
+QVector<qint64> QUaHistoryRollupTiers::intervals() const
+{
+	return m_intervals;
+}
+
+bool QUaHistoryRollupTiers::add(
+	const QUaNodeId& nodeId,
+	const QUaHistoryDataPoint& dataPoint)
+{
+	if (!m_nodes.contains(nodeId))
+	{
+		NodeTiers node;
+		node.timeLast = (std::numeric_limits<qint64>::min)();
+		node.tiers.resize(m_intervals.count());
+		m_nodes.insert(nodeId, node);
+	}
+	auto& node = m_nodes[nodeId];
+	qint64 time = dataPoint.timestamp.toMSecsSinceEpoch();
+	if (time <= node.timeLast)
+	{
+		return false;
+	}
+	node.timeLast = time;
+	double value;
+	if (!QUaHistoryRollupTiers::numericValue(dataPoint, value))
+	{
+		return true;
+	}
+	for (int i = 0; i < m_intervals.count(); i++)
+	{
+		auto& tier = node.tiers[i];
+		qint64 start = QUaHistoryRollupTiers::intervalStart(time, m_intervals.at(i));
+		if (!tier.isEmpty() && tier.last().timeStart == start)
+		{
+			QUaHistoryRollupTiers::appendRollup(tier.last(), time, value);
+			continue;
+		}
+		tier << QUaHistoryRollupTiers::createRollup(start, time, value);
+	}
+	return true;
+}
+
+void QUaHistoryRollupTiers::rebuildRange(
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	QDateTime& rangeStart,
+	QDateTime& rangeEnd) const
+{
+	// NOTE : coarser tiers are recomputed from the finest one, see rebuild
+	qint64 finest = m_intervals.first();
+	rangeStart = QDateTime::fromMSecsSinceEpoch(
+		QUaHistoryRollupTiers::intervalStart(timeStart.toMSecsSinceEpoch(), finest), Qt::UTC);
+	// NOTE : range end is excluded
+	rangeEnd = !timeEnd.isValid() ? QDateTime() : QDateTime::fromMSecsSinceEpoch(
+		QUaHistoryRollupTiers::intervalStart(timeEnd.toMSecsSinceEpoch(), finest) + finest, Qt::UTC);
+}
+
+void QUaHistoryRollupTiers::rebuild(
+	const QUaNodeId& nodeId,
+	const QDateTime& rangeStart,
+	const QDateTime& rangeEnd,
+	const QVector<QUaHistoryDataPoint>& dataPoints)
+{
+	if (!m_nodes.contains(nodeId))
+	{
+		NodeTiers node;
+		node.timeLast = (std::numeric_limits<qint64>::min)();
+		node.tiers.resize(m_intervals.count());
+		m_nodes.insert(nodeId, node);
+	}
+	auto& node = m_nodes[nodeId];
+	qint64 start = rangeStart.toMSecsSinceEpoch();
+	qint64 end   = rangeEnd.isValid() ? rangeEnd.toMSecsSinceEpoch() : (std::numeric_limits<qint64>::max)();
+	auto lessStart = [](const QUaHistoryRollup& rollup, const qint64& time) -> bool {
+		return rollup.timeStart < time;
+	};
+	// finest tier from the given data points
+	QVector<QUaHistoryRollup> rollups;
+	double value;
+	for (const auto& dataPoint : dataPoints)
+	{
+		if (!QUaHistoryRollupTiers::numericValue(dataPoint, value))
+		{
+			continue;
+		}
+		qint64 time = dataPoint.timestamp.toMSecsSinceEpoch();
+		qint64 timeStart = QUaHistoryRollupTiers::intervalStart(time, m_intervals.first());
+		if (!rollups.isEmpty() && rollups.last().timeStart == timeStart)
+		{
+			QUaHistoryRollupTiers::appendRollup(rollups.last(), time, value);
+			continue;
+		}
+		rollups << QUaHistoryRollupTiers::createRollup(timeStart, time, value);
+	}
+	for (int i = 0; i < m_intervals.count(); i++)
+	{
+		auto& tier = node.tiers[i];
+		// coarser tiers, buckets containing the range merged from the finer tier
+		if (i > 0)
+		{
+			qint64 interval = m_intervals.at(i);
+			start = QUaHistoryRollupTiers::intervalStart(start, interval);
+			if (end != (std::numeric_limits<qint64>::max)())
+			{
+				end = QUaHistoryRollupTiers::intervalStart(end - 1, interval) + interval;
+			}
+			const auto& finer = node.tiers.at(i - 1);
+			int first = std::lower_bound(finer.begin(), finer.end(), start, lessStart) - finer.begin();
+			int last  = std::lower_bound(finer.begin() + first, finer.end(), end, lessStart) - finer.begin();
+			rollups.clear();
+			for (int k = first; k < last; k++)
+			{
+				qint64 timeStart = QUaHistoryRollupTiers::intervalStart(finer.at(k).timeStart, interval);
+				if (!rollups.isEmpty() && rollups.last().timeStart == timeStart)
+				{
+					QUaHistoryRollupTiers::mergeRollup(rollups.last(), finer.at(k));
+					continue;
+				}
+				rollups << finer.at(k);
+				rollups.last().timeStart = timeStart;
+			}
+		}
+		// replace the ones within the range
+		int first = std::lower_bound(tier.begin(), tier.end(), start, lessStart) - tier.begin();
+		int last  = std::lower_bound(tier.begin() + first, tier.end(), end, lessStart) - tier.begin();
+		tier = tier.mid(0, first) + rollups + tier.mid(last);
+	}
+	// NOTE : if rebuilt up to the end, data points before the range are older than its start
+	if (!rangeEnd.isValid())
+	{
+		node.timeLast = dataPoints.isEmpty() ? rangeStart.toMSecsSinceEpoch() - 1 : dataPoints.last().timestamp.toMSecsSinceEpoch();
+	}
+	else if (!dataPoints.isEmpty())
+	{
+		node.timeLast = (std::max)(node.timeLast, dataPoints.last().timestamp.toMSecsSinceEpoch());
+	}
+}
+
+void QUaHistoryRollupTiers::remove(const QUaNodeId& nodeId)
+{
+	m_nodes.remove(nodeId);
+}
+
+bool QUaHistoryRollupTiers::read(
+	const QUaNodeId& nodeId,
+	const QDateTime& timeStart,
+	const QDateTime& timeEnd,
+	const qint64& interval,
+	QVector<QUaHistoryRollup>& rollups) const
+{
+	qint64 start = timeStart.toMSecsSinceEpoch();
+	qint64 end   = timeEnd.toMSecsSinceEpoch();
+	// coarsest sufficient tier
+	int i = m_intervals.count() - 1;
+	for (; i >= 0; i--)
+	{
+		qint64 tierInterval = m_intervals.at(i);
+		if (interval % tierInterval == 0 && start % tierInterval == 0 && end % tierInterval == 0)
+		{
+			break;
+		}
+	}
+	if (i < 0)
+	{
+		return false;
+	}
+	rollups.clear();
+	auto node = m_nodes.find(nodeId);
+	if (node == m_nodes.end())
+	{
+		return true;
+	}
+	auto lessStart = [](const QUaHistoryRollup& rollup, const qint64& time) -> bool {
+		return rollup.timeStart < time;
+	};
+	const auto& tier = node.value().tiers.at(i);
+	auto first = std::lower_bound(tier.begin(), tier.end(), start, lessStart);
+	auto last  = std::lower_bound(first, tier.end(), end, lessStart);
+	rollups.reserve(static_cast<int>(last - first) + 2);
+	if (first != tier.begin())
+	{
+		rollups << *(first - 1);
+	}
+	for (auto it = first; it != last; ++it)
+	{
+		rollups << *it;
+	}
+	if (last != tier.end())
+	{
+		rollups << *last;
+	}
+	return true;
+}
+
+bool QUaHistoryRollupTiers::numericValue(
+	const QUaHistoryDataPoint& dataPoint,
+	double& value)
+{
+	// bad status severity
+	if ((dataPoint.status & 0x80000000) != 0)
+	{
+		return false;
+	}
+	switch (dataPoint.value.userType())
+	{
+	case QMetaType::Bool:
+	case QMetaType::Char:
+	case QMetaType::SChar:
+	case QMetaType::UChar:
+	case QMetaType::Short:
+	case QMetaType::UShort:
+	case QMetaType::Int:
+	case QMetaType::UInt:
+	case QMetaType::Long:
+	case QMetaType::ULong:
+	case QMetaType::LongLong:
+	case QMetaType::ULongLong:
+	case QMetaType::Float:
+	case QMetaType::Double:
+		value = dataPoint.value.toDouble();
+		return true;
+	default:
+		break;
+	}
+	return false;
+}
+
+QUaHistoryRollup QUaHistoryRollupTiers::createRollup(
+	const qint64& timeStart,
+	const qint64& time,
+	const double& value)
+{
+	return {
+		timeStart,
+		1,
+		value,
+		value,
+		value,
+		time,
+		value,
+		time,
+		value,
+		0.0
+	};
+}
+
+void QUaHistoryRollupTiers::appendRollup(
+	QUaHistoryRollup& rollup,
+	const qint64& time,
+	const double& value)
+{
+	rollup.integral += (time - rollup.timeLast) * (rollup.valueLast + value) / 2.0;
+	rollup.count++;
+	rollup.sum += value;
+	rollup.min  = (std::min)(rollup.min, value);
+	rollup.max  = (std::max)(rollup.max, value);
+	rollup.timeLast  = time;
+	rollup.valueLast = value;
+}
+
+void QUaHistoryRollupTiers::mergeRollup(
+	QUaHistoryRollup& rollup,
+	const QUaHistoryRollup& next)
+{
+	// segment between both rollups plus the next one's integral
+	rollup.integral += (next.timeFirst - rollup.timeLast) * (rollup.valueLast + next.valueFirst) / 2.0;
+	rollup.integral += next.integral;
+	rollup.count += next.count;
+	rollup.sum   += next.sum;
+	rollup.min    = (std::min)(rollup.min, next.min);
+	rollup.max    = (std::max)(rollup.max, next.max);
+	rollup.timeLast  = next.timeLast;
+	rollup.valueLast = next.valueLast;
+}
+
+qint64 QUaHistoryRollupTiers::intervalStart(
+	const qint64& time,
+	const qint64& interval)
+{
+	qint64 remainder = time % interval;
+	return remainder < 0 ? time - remainder - interval : time - remainder;
+}
+
 #endif // UA_ENABLE_HISTORIZING
 
 
@@ -8,7 +8,11 @@
 #include <QVector>
 #include <QVariant>
 #include <QDateTime>
+#include <QMutex>
+#include <QWaitCondition>
 
+class QThread;
+class QFile;
 class QUaServer;
 class QUaBaseVariable;
 
@@ -25,6 +29,146 @@ struct QUaHistoryEventPoint
 	QHash<QUaBrowsePath, QVariant> fields;
 };
 
+// data point of a node, element of a batch of history writes
+struct QUaHistoryNodeDataPoint
+{
+	QUaNodeId           nodeId;
+	QUaHistoryDataPoint dataPoint;
+};
+
+// asynchronous history write metrics, see QUaServer::historyWriteStats
+struct QUaHistoryWriteStats
+{
+	int     queueDepth;         // data points currently queued (including spilled)
+	int     queueMaxDepth;      // maximum queue depth since last reset
+	quint64 committed;          // data points committed to the historizer
+	quint64 batches;            // batches committed to the historizer
+	quint64 dropped;            // data points discarded by DropOldest
+	quint64 spilled;            // data points spilled to disk by SpillToDisk
+	qint64  commitLatency;      // nanoseconds taken by the last batch commit
+	qint64  commitMaxLatency;   // maximum nanoseconds taken by a batch commit
+};
+
+// summary of the numeric data points of a node within an interval, used by aggregate history
+// reads (see QUaHistoryBackend::readHistoryAggregate), times in milliseconds since epoch (UTC)
+struct QUaHistoryRollup
+{
+	qint64  timeStart;  // start of the interval
+	quint64 count;
+	double  sum;
+	double  min;
+	double  max;
+	qint64  timeFirst;
+	double  valueFirst;
+	qint64  timeLast;
+	double  valueLast;
+	double  integral;   // of the linearly interpolated value from first to last data point (value x ms)
+};
+
+// rollup tiers of nested intervals maintained incrementally on write, for historizers
+// which implement the optional readHistoryRollups API (see QUaInMemoryHistorizer)
+class QUaHistoryRollupTiers
+{
+public:
+	// 1 minute, 1 hour and 1 day by default
+	// NOTE : each interval must be a multiple of the previous one
+	explicit QUaHistoryRollupTiers(
+		const QVector<qint64>& intervals = QVector<qint64>({ 60 * 1000, 60 * 60 * 1000, 24 * 60 * 60 * 1000 })
+	);
+
+	QVector<qint64> intervals() const;
+	// update the tiers with a new data point, return false if the data point is not newer than
+	// the last one added for the node, in which case nothing is updated and the range given by
+	// rebuildRange must be rebuilt
+	bool add(const QUaNodeId& nodeId, const QUaHistoryDataPoint& dataPoint);
+	// range to rebuild after changing data points within [timeStart, timeEnd], aligned to
+	// the finest interval (an invalid time end means up to the most recent data point)
+	void rebuildRange(
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		QDateTime& rangeStart,
+		QDateTime& rangeEnd
+	) const;
+	// replace the rollups within a range returned by rebuildRange with the ones of all
+	// the data points within that range, ordered by time, coarser tiers only recompute
+	// their buckets containing the range from the rollups of the finer tier
+	void rebuild(
+		const QUaNodeId& nodeId,
+		const QDateTime& rangeStart,
+		const QDateTime& rangeEnd,
+		const QVector<QUaHistoryDataPoint>& dataPoints
+	);
+	void remove(const QUaNodeId& nodeId);
+	// implements the optional readHistoryRollups API : the non-empty rollups of the coarsest
+	// tier whose interval divides the given interval and the time range, plus the closest
+	// non-empty rollups before and after the range, return false if no tier can be used
+	bool read(
+		const QUaNodeId& nodeId,
+		const QDateTime& timeStart,
+		const QDateTime& timeEnd,
+		const qint64&    interval,
+		QVector<QUaHistoryRollup>& rollups
+	) const;
+
+	// false for non numeric values and bad statuses, which are not summarized
+	static bool numericValue(const QUaHistoryDataPoint& dataPoint, double& value);
+	static QUaHistoryRollup createRollup(const qint64& timeStart, const qint64& time, const double& value);
+	// data point newer than the rollup's last one
+	static void appendRollup(QUaHistoryRollup& rollup, const qint64& time, const double& value);
+	// rollup newer than the given rollup
+	static void mergeRollup(QUaHistoryRollup& rollup, const QUaHistoryRollup& next);
+	// start of the interval containing time, also for negative times
+	static qint64 intervalStart(const qint64& time, const qint64& interval);
+
+private:
+	QVector<qint64> m_intervals;
+	struct NodeTiers
+	{
+		qint64 timeLast;
+		QVector<QVector<QUaHistoryRollup>> tiers; // same order as m_intervals
+	};
+	QHash<QUaNodeId, NodeTiers> m_nodes;
+};
+
+// trait used to check if historizer has
+// bool T::readHistoryRollups(const QUaNodeId&, const QDateTime&, const QDateTime&, const qint64&, QVector<QUaHistoryRollup>&, QQueue<QUaLog>&) const
+template <typename T, typename = void>
+struct QUaHasMethodReadHistoryRollups
+	: std::false_type
+{};
+
+template <typename T>
+struct QUaHasMethodReadHistoryRollups<T,
+	typename std::enable_if<std::is_same<decltype(&T::readHistoryRollups), bool(T::*)(const QUaNodeId&, const QDateTime&, const QDateTime&, const qint64&, QVector<QUaHistoryRollup>&, QQueue<QUaLog>&) const>::value>::type>
+	: std::true_type
+{};
+
+// trait used to check if historizer has
+// bool T::writeHistoryDataBatch(const QVector<QUaHistoryNodeDataPoint>&, QQueue<QUaLog>&)
+template <typename T, typename = void>
+struct QUaHasMethodWriteHistoryDataBatch
+	: std::false_type
+{};
+
+template <typename T>
+struct QUaHasMethodWriteHistoryDataBatch<T,
+	typename std::enable_if<std::is_same<decltype(&T::writeHistoryDataBatch), bool(T::*)(const QVector<QUaHistoryNodeDataPoint>&, QQueue<QUaLog>&)>::value>::type>
+	: std::true_type
+{};
+
+// trait used to check if historizer has
+// bool T::writeHistoryDataRaw(const UA_NodeId&, const UA_DateTime&, const UA_Variant&, const UA_StatusCode&, QQueue<QUaLog>&)
+template <typename T, typename = void>
+struct QUaHasMethodWriteHistoryDataRaw
+	: std::false_type
+{};
+
+template <typename T>
+struct QUaHasMethodWriteHistoryDataRaw<T,
+	typename std::enable_if<std::is_same<decltype(&T::writeHistoryDataRaw), bool(T::*)(const UA_NodeId&, const UA_DateTime&, const UA_Variant&, const UA_StatusCode&, QQueue<QUaLog>&)>::value>::type>
+	: std::true_type
+{};
+
 class QUaHistoryBackend
 {
 	friend class QUaServer;
@@ -34,6 +178,7 @@ class QUaHistoryBackend
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 public:
 	QUaHistoryBackend();
+	~QUaHistoryBackend();
 
 	enum class TimeMatch
 	{
@@ -41,16 +186,76 @@ public:
 		ClosestFromBelow
 	};
 
+	// what to do with a new data point when the asynchronous write queue is full
+	enum class WriteBackpressure
+	{
+		Block,      // wait until the writer thread makes room
+		DropOldest, // discard the oldest queued data point
+		SpillToDisk // append to a spill file, committed once the queue is drained
+	};
+
+	// aggregates supported by processed history reads
+	enum class Aggregate
+	{
+		Interpolative,
+		Average,
+		TimeAverage,
+		Minimum,
+		Maximum,
+		Count
+	};
+	// maximum number of intervals per node of a processed history read, larger
+	// reads are refused (see readHistoryAggregate)
+	static const qint64 maxAggregateIntervals = 100000;
+
 	// Type T must implement the public API below
+	// T can optionally implement:
+	// bool T::writeHistoryDataBatch(const QVector<QUaHistoryNodeDataPoint>& points, QQueue<QUaLog>& logOut);
+	// which is used by the asynchronous writer thread instead of one writeHistoryData per point
+	// bool T::writeHistoryDataRaw(const UA_NodeId& nodeId, const UA_DateTime& timestamp, const UA_Variant& value,
+	//                             const UA_StatusCode& status, QQueue<QUaLog>& logOut);
+	// which is used by synchronous writes of the server instead of writeHistoryData, without converting the
+	// data point to QDateTime and QVariant (the value is only valid during the call)
+	// bool T::readHistoryRollups(const QUaNodeId& nodeId, const QDateTime& timeStart, const QDateTime& timeEnd,
+	//                            const qint64& interval, QVector<QUaHistoryRollup>& rollups, QQueue<QUaLog>& logOut) const;
+	// which is used by aggregate history reads instead of reading the raw data points (see QUaHistoryRollupTiers::read)
 	template<typename T>
 	void setHistorizer(T& historizer);
 
+	// asynchronous writes, see QUaServer::setHistoryWriteAsync
+	// NOTE : logs of the writer thread are reported on next write, or when flushed or stopped
+	bool writeAsync() const;
+	void setWriteAsync(const bool& async, QQueue<QUaLog>& logOut);
+	int  writeQueueSize() const;
+	void setWriteQueueSize(const int& size);
+	WriteBackpressure writeBackpressure() const;
+	void setWriteBackpressure(const WriteBackpressure& policy);
+	QString spillFileName() const;
+	void    setSpillFileName(const QString& fileName);
+	// block until all queued data points are committed
+	void flushWrites(QQueue<QUaLog>& logOut);
+	QUaHistoryWriteStats writeStats() const;
+	void resetWriteStats();
+
 	// write a node's data point to backend
 	bool writeHistoryData(
 		const QUaNodeId &nodeId, 
 		const QUaHistoryDataPoint &dataPoint,
 		QQueue<QUaLog> &logOut
 	);
+	// write a batch of data points to backend, with the historizer's writeHistoryDataBatch if
+	// available (else one writeHistoryData per point), or queued if writes are asynchronous
+	bool writeHistoryDataBatch(
+		const QVector<QUaHistoryNodeDataPoint> &points,
+		QQueue<QUaLog> &logOut
+	);
+	// write a node's data value to backend, passed as is to the historizer's writeHistoryDataRaw
+	// if available and writes are synchronous, else converted and written with writeHistoryData
+	bool writeHistoryDataValue(
+		const UA_NodeId    &nodeId,
+		const UA_DataValue *value,
+		QQueue<QUaLog>     &logOut
+	);
 	// update an existing node's data point in backend
 	bool updateHistoryData(
 		const QUaNodeId &nodeId, 
@@ -95,6 +300,8 @@ public:
 		QQueue<QUaLog>  &logOut
 	) const;
 	// return the numPointsToRead data points for the given node from the given start time
+	// NOTE : paginated reads resume at the timestamp of the last point read, numPointsOffset
+	//        only skips the points already read with that timestamp
 	QVector<QUaHistoryDataPoint> readHistoryData(
 		const QUaNodeId &nodeId,
 		const QDateTime &timeStart,
@@ -103,6 +310,19 @@ public:
 		QQueue<QUaLog>  &logOut
 	) const;
 
+	// return one data point per interval within [timeStart, timeEnd) with the aggregate of
+	// the node's data points in that interval (a single interval if interval is zero), from
+	// the historizer's rollups if possible, else from the raw data points
+	// NOTE : returns no data points if there are more than maxAggregateIntervals intervals
+	QVector<QUaHistoryDataPoint> readHistoryAggregate(
+		const QUaNodeId &nodeId,
+		const Aggregate &aggregate,
+		const QDateTime &timeStart,
+		const QDateTime &timeEnd,
+		const qint64    &interval,
+		QQueue<QUaLog>  &logOut
+	) const;
+
 	// event history support
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	// write a event's data to backend
@@ -136,6 +356,7 @@ public:
 	);
 	// return the numPointsToRead events for the given emitter and event type,
 	// starting from the numPointsOffset offset after given start time (pagination)
+	// NOTE : as for data points, the offset only skips the events already read with the start time
 	QVector<QUaHistoryEventPoint> readHistoryEventsOfType(
 		const QUaNodeId &emitterNodeId,
 		const QUaNodeId &eventTypeNodeId,
@@ -151,17 +372,89 @@ private:
 
 	// helpers
 	static QUaHistoryDataPoint dataValueToPoint(const UA_DataValue *value);
+	// source timestamp, else server timestamp, else now
+	static UA_DateTime dataValueTimestamp(const UA_DataValue *value);
 	static UA_DataValue dataPointToValue(const QUaHistoryDataPoint *point);
 	static void processServerLog(QUaServer* server, QQueue<QUaLog>& logOut);
 	static QMetaType::Type QVariantToQtType(const QVariant& value);
 	static void fixOutputVariantType(QVariant& value, const QMetaType::Type& metaType);
+	static bool aggregateFromNodeId(const UA_NodeId& nodeId, Aggregate& aggregate);
+	// per interval rollups from the raw data points, plus the closest data points outside the range
+	bool readRawRollups(
+		const QUaNodeId &nodeId,
+		const qint64    &timeStart,
+		const qint64    &timeEnd,
+		const qint64    &interval,
+		QVector<QUaHistoryRollup> &rollups,
+		QQueue<QUaLog>  &logOut
+	) const;
 
 	// static and unique since implementation is instance independent
 	static UA_HistoryDataBackend CreateUaBackend();
 	static UA_HistoryDataBackend m_historUaBackend;
 
+	// asynchronous writes
+	// NOTE : the writer thread and the server share the historizer, so all historizer calls
+	//        are serialized with m_historizerMutex, the queue and stats with m_writeMutex
+	// NOTE : the writer takes m_historizerMutex once per writeChunkSize points of a batch,
+	//        so reads wait for one chunk at most instead of the whole queue
+	static const int writeChunkSize = 1000;
+	mutable QMutex m_historizerMutex;
+	mutable QMutex m_writeMutex;
+	QWaitCondition m_writeNotEmpty;
+	QWaitCondition m_writeNotFull;
+	QWaitCondition m_writeDrained;
+	QThread * m_writeThread;
+	bool      m_writeStop;
+	int       m_writeQueueSize;
+	int       m_writeInFlight;
+	WriteBackpressure m_writeBackpressure;
+	QQueue<QUaHistoryNodeDataPoint> m_writeQueue;
+	QQueue<QUaLog> m_writeLogOut;
+	QUaHistoryWriteStats m_writeStats;
+	// spill file, holds data points newer than the ones in the queue
+	QString m_spillFileName;
+	QFile * m_spillFile;
+	qint64  m_spillReadPos;
+	int     m_spillCount;
+	void startWriteThread();
+	void stopWriteThread(QQueue<QUaLog>& logOut);
+	void waitWrites();
+	void waitStopped();
+	void writeLoop();
+	bool enqueueWrite(const QUaHistoryNodeDataPoint& point, QQueue<QUaLog>& logOut);
+	bool spillWrite(const QUaHistoryNodeDataPoint& point, QQueue<QUaLog>& logOut);
+	void readSpill(QVector<QUaHistoryNodeDataPoint>& batch);
+	void clearSpill();
+
+	template<typename T>
+	static typename std::enable_if<QUaHasMethodWriteHistoryDataBatch<T>::value, std::function<bool(const QVector<QUaHistoryNodeDataPoint>&, QQueue<QUaLog>&)>>::type
+	writeHistoryDataBatch(T& historizer);
+
+	template<typename T>
+	static typename std::enable_if<!QUaHasMethodWriteHistoryDataBatch<T>::value, std::function<bool(const QVector<QUaHistoryNodeDataPoint>&, QQueue<QUaLog>&)>>::type
+	writeHistoryDataBatch(T& historizer);
+
+	template<typename T>
+	static typename std::enable_if<QUaHasMethodWriteHistoryDataRaw<T>::value, std::function<bool(const UA_NodeId&, const UA_DateTime&, const UA_Variant&, const UA_StatusCode&, QQueue<QUaLog>&)>>::type
+	writeHistoryDataRaw(T& historizer);
+
+	template<typename T>
+	static typename std::enable_if<!QUaHasMethodWriteHistoryDataRaw<T>::value, std::function<bool(const UA_NodeId&, const UA_DateTime&, const UA_Variant&, const UA_StatusCode&, QQueue<QUaLog>&)>>::type
+	writeHistoryDataRaw(T& historizer);
+
+	template<typename T>
+	static typename std::enable_if<QUaHasMethodReadHistoryRollups<T>::value, std::function<bool(const QUaNodeId&, const QDateTime&, const QDateTime&, const qint64&, QVector<QUaHistoryRollup>&, QQueue<QUaLog>&)>>::type
+	readHistoryRollups(T& historizer);
+
+	template<typename T>
+	static typename std::enable_if<!QUaHasMethodReadHistoryRollups<T>::value, std::function<bool(const QUaNodeId&, const QDateTime&, const QDateTime&, const qint64&, QVector<QUaHistoryRollup>&, QQueue<QUaLog>&)>>::type
+	readHistoryRollups(T& historizer);
+
 	// lambdas to capture historizer
 	std::function<bool(const QUaNodeId&, const QUaHistoryDataPoint&, QQueue<QUaLog>&)> m_writeHistoryData;
+	std::function<bool(const QVector<QUaHistoryNodeDataPoint>&, QQueue<QUaLog>&)> m_writeHistoryDataBatch;
+	std::function<bool(const UA_NodeId&, const UA_DateTime&, const UA_Variant&, const UA_StatusCode&, QQueue<QUaLog>&)> m_writeHistoryDataRaw;
 	std::function<bool(const QUaNodeId&, const QUaHistoryDataPoint&, QQueue<QUaLog>&)> m_updateHistoryData;
 	std::function<bool(const QUaNodeId&, const QDateTime&, const QDateTime&, QQueue<QUaLog>&)> m_removeHistoryData;
 	std::function<QDateTime(const QUaNodeId&, QQueue<QUaLog>&)> m_firstTimestamp;
@@ -170,6 +463,7 @@ private:
 	std::function<QDateTime(const QUaNodeId&, const QDateTime&, const TimeMatch&, QQueue<QUaLog>&)> m_findTimestamp;
 	std::function<quint64(const QUaNodeId&, const QDateTime&, const QDateTime&, QQueue<QUaLog>&)> m_numDataPointsInRange;
 	std::function<QVector<QUaHistoryDataPoint>(const QUaNodeId&, const QDateTime&, const quint64&, const quint64&, QQueue<QUaLog>&)> m_readHistoryData;
+	std::function<bool(const QUaNodeId&, const QDateTime&, const QDateTime&, const qint64&, QVector<QUaHistoryRollup>&, QQueue<QUaLog>&)> m_readHistoryRollups;
 
 	// event history support
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
@@ -213,6 +507,20 @@ private:
 		const QList<QUaNodeId>&     emittersNodeIds,
 		const QUaHistoryEventPoint& eventPoint
 	);
+    static void readProcessed(
+        UA_Server*                    server,
+        void*                         hdbContext,
+        const UA_NodeId*              sessionId,
+        void*                         sessionContext,
+        const UA_RequestHeader*       requestHeader,
+        const UA_ReadProcessedDetails* historyReadDetails,
+        UA_TimestampsToReturn         timestampsToReturn,
+        UA_Boolean                    releaseContinuationPoints,
+        size_t                        nodesToReadSize,
+        const UA_HistoryReadValueId*  nodesToRead,
+        UA_HistoryReadResponse*       response,
+        UA_HistoryData* const* const  historyData
+    );
     static void readEvent(
         UA_Server*                    server,
         void*                         hdbContext,
@@ -234,6 +542,18 @@ private:
 template<typename T>
 inline void QUaHistoryBackend::setHistorizer(T& historizer)
 {
+	// commit queued points to the previous historizer before replacing it
+	{
+		QMutexLocker writeLocker(&m_writeMutex);
+		this->waitWrites();
+	}
+	QMutexLocker locker(&m_historizerMutex);
+	// writeHistoryDataBatch (optional)
+	m_writeHistoryDataBatch = QUaHistoryBackend::writeHistoryDataBatch<T>(historizer);
+	// writeHistoryDataRaw (optional)
+	m_writeHistoryDataRaw = QUaHistoryBackend::writeHistoryDataRaw<T>(historizer);
+	// readHistoryRollups (optional)
+	m_readHistoryRollups = QUaHistoryBackend::readHistoryRollups<T>(historizer);
 	// writeHistoryData
 	m_writeHistoryData = [&historizer](
 		const QUaNodeId &nodeId,
@@ -433,6 +753,105 @@ inline void QUaHistoryBackend::setHistorizer(T& historizer)
 
 }
 
+template<typename T>
+inline typename std::enable_if<QUaHasMethodWriteHistoryDataBatch<T>::value, std::function<bool(const QVector<QUaHistoryNodeDataPoint>&, QQueue<QUaLog>&)>>::type
+QUaHistoryBackend::writeHistoryDataBatch(T& historizer)
+{
+	return [&historizer](
+		const QVector<QUaHistoryNodeDataPoint> &points,
+		QQueue<QUaLog> &logOut
+		) -> bool {
+			return historizer.writeHistoryDataBatch(
+				points,
+				logOut
+			);
+	};
+}
+
+template<typename T>
+inline typename std::enable_if<!QUaHasMethodWriteHistoryDataBatch<T>::value, std::function<bool(const QVector<QUaHistoryNodeDataPoint>&, QQueue<QUaLog>&)>>::type
+QUaHistoryBackend::writeHistoryDataBatch(T& historizer)
+{
+	// fallback to one write per point
+	return [&historizer](
+		const QVector<QUaHistoryNodeDataPoint> &points,
+		QQueue<QUaLog> &logOut
+		) -> bool {
+			bool ok = true;
+			for (const auto& point : points)
+			{
+				ok = historizer.writeHistoryData(
+					point.nodeId,
+					point.dataPoint,
+					logOut
+				) && ok;
+			}
+			return ok;
+	};
+}
+
+template<typename T>
+inline typename std::enable_if<QUaHasMethodWriteHistoryDataRaw<T>::value, std::function<bool(const UA_NodeId&, const UA_DateTime&, const UA_Variant&, const UA_StatusCode&, QQueue<QUaLog>&)>>::type
+QUaHistoryBackend::writeHistoryDataRaw(T& historizer)
+{
+	return [&historizer](
+		const UA_NodeId     &nodeId,
+		const UA_DateTime   &timestamp,
+		const UA_Variant    &value,
+		const UA_StatusCode &status,
+		QQueue<QUaLog>      &logOut
+		) -> bool {
+			return historizer.writeHistoryDataRaw(
+				nodeId,
+				timestamp,
+				value,
+				status,
+				logOut
+			);
+	};
+}
+
+template<typename T>
+inline typename std::enable_if<!QUaHasMethodWriteHistoryDataRaw<T>::value, std::function<bool(const UA_NodeId&, const UA_DateTime&, const UA_Variant&, const UA_StatusCode&, QQueue<QUaLog>&)>>::type
+QUaHistoryBackend::writeHistoryDataRaw(T& historizer)
+{
+	// data values are converted and written with writeHistoryData
+	Q_UNUSED(historizer);
+	return nullptr;
+}
+
+template<typename T>
+inline typename std::enable_if<QUaHasMethodReadHistoryRollups<T>::value, std::function<bool(const QUaNodeId&, const QDateTime&, const QDateTime&, const qint64&, QVector<QUaHistoryRollup>&, QQueue<QUaLog>&)>>::type
+QUaHistoryBackend::readHistoryRollups(T& historizer)
+{
+	return [&historizer](
+		const QUaNodeId &nodeId,
+		const QDateTime &timeStart,
+		const QDateTime &timeEnd,
+		const qint64    &interval,
+		QVector<QUaHistoryRollup> &rollups,
+		QQueue<QUaLog>  &logOut
+		) -> bool {
+			return historizer.readHistoryRollups(
+				nodeId,
+				timeStart,
+				timeEnd,
+				interval,
+				rollups,
+				logOut
+			);
+	};
+}
+
+template<typename T>
+inline typename std::enable_if<!QUaHasMethodReadHistoryRollups<T>::value, std::function<bool(const QUaNodeId&, const QDateTime&, const QDateTime&, const qint64&, QVector<QUaHistoryRollup>&, QQueue<QUaLog>&)>>::type
+QUaHistoryBackend::readHistoryRollups(T& historizer)
+{
+	// aggregates are computed from the raw data points
+	Q_UNUSED(historizer);
+	return nullptr;
+}
+
 #endif // UA_ENABLE_HISTORIZING
 
 #endif // QUAHISTORYBACKEND_H
@@ -102,6 +102,40 @@ struct QUaInMemorySerializer
 	QHash<QUaNodeId, QUaNodeData> m_hashNodeTreeData;
 };
 
+// plain data copy of a node, used to clone a subtree many times (see QUaNode::cloneNodes)
+struct QUaCloneNodeData
+{
+	const QMetaObject           * metaObject;
+	QUaQualifiedName              browseName;
+	int                           parentIndex; // -1 for the subtree root
+	QVector<QPair<int, QVariant>> props;       // writable property index and value
+};
+
+struct QUaCloneRefData
+{
+	int              sourceIndex;
+	QUaReferenceType refType;
+	const QUaNode  * target;      // only valid while snapshotting
+	int              targetIndex; // -1 if target is outside of the subtree
+	QUaNodeId        targetNodeId;
+};
+
+struct QUaCloneSnapshot
+{
+	QVector<QUaCloneNodeData> nodes; // pre-order, parents before children
+	QVector<QUaCloneRefData>  refs;  // non-hierarchical references
+};
+
+// how a snapshot node is obtained in each copy, resolved with the first copy
+enum class QUaCloneMode
+{
+	Unresolved,
+	Existing, // created by the parent's type constructor
+	Optional, // optional child of the parent's type
+	New,      // added to the parent after instantiation
+	Invalid
+};
+
 QUaNode::QUaNode(
 	QUaServer* server
 )
@@ -146,33 +180,12 @@ QUaNode::QUaNode(
 		Q_ASSERT(!mapChildren.contains( browseName));
 		mapChildren[browseName] = childNodeId;
 	}
-	// list meta props
-	int propCount  = metaObject.propertyCount();
-	int propOffset = QUaNode::getPropsOffsetHelper(metaObject);
-	int numProps   = 0;
-	for (int i = propOffset; i < propCount; i++)
+	// children bound to meta props and mandatory children of instance declarations,
+	// the Qt meta property name must match the UA browse name
+	// NOTE : resolved by the first instance of the type, so batches only do the lookups
+	const auto childNames = server->typeChildrenTemplate(metaObject, this);
+	for (const auto & browseName : childNames)
 	{
-		QMetaProperty metaProperty = metaObject.property(i);
-		// check if not enum
-		if (!metaProperty.isEnumType())
-		{
-			// check if available in meta-system
-			const QMetaObject *propMetaObject = QMetaType(metaProperty.userType()).metaObject();
-			if (!propMetaObject)
-			{ continue; }
-			// check if OPC UA relevant type
-			if (!propMetaObject->inherits(&QUaNode::staticMetaObject))
-			{ continue; }
-			// check if prop inherits from parent
-			Q_ASSERT_X(!propMetaObject->inherits(&metaObject), "QUaNode Constructor",
-				"Qt MetaProperty type cannot inherit from Class.");
-			if (propMetaObject->inherits(&metaObject))
-			{ continue; }
-		}
-		// inc number of valid props
-		numProps++;
-		// the Qt meta property name must match the UA browse name
-		QUaQualifiedName browseName = QString::fromUtf8(metaProperty.name());
 		Q_ASSERT(mapChildren.contains(browseName));
 		// get child nodeId for child
 		auto childNodeId = mapChildren.take(browseName);
@@ -180,47 +193,10 @@ QUaNode::QUaNode(
 		auto nodeInstance = QUaNode::getNodeContext(childNodeId, server->m_server);
 		Q_CHECK_PTR(nodeInstance);
 		// assign C++ parent
-		nodeInstance->setParent(this);
-		nodeInstance->setObjectName(browseName);
-		Q_ASSERT(!this->browseChild(browseName));
-#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
-		uint key = qHash(browseName);
-#else
-		size_t key = qHash(browseName);
-#endif
-		m_browseCache[key] = nodeInstance;
-		QObject::connect(nodeInstance, &QObject::destroyed, this, [this, key]() {
-			m_browseCache.remove(key);
-		});
+		this->bindChild(nodeInstance, browseName);
 		// [NOTE] writing a pointer value to a Q_PROPERTY did not work, 
 		//        eventhough there appear to be some success cases on the internet
 		//        so in the end we have to query children by object name
-	} // for each prop
-	// handle mandatory children of instance declarations
-	QUaNodeId typeNodeId = this->typeDefinitionNodeId();
-	Q_ASSERT(m_qUaServer->m_hashMandatoryChildren.contains(typeNodeId));
-	const auto &mandatoryList = m_qUaServer->m_hashMandatoryChildren[typeNodeId];
-	for (const auto & browseName : mandatoryList)
-	{
-		Q_ASSERT(mapChildren.contains(browseName));
-		// get child nodeId for child
-		auto childNodeId = mapChildren.take(browseName);
-		// get node context (C++ instance)
-		auto nodeInstance = QUaNode::getNodeContext(childNodeId, server->m_server);
-		Q_CHECK_PTR(nodeInstance);
-		// assign C++ parent
-		nodeInstance->setParent(this);
-		nodeInstance->setObjectName(browseName);
-		Q_ASSERT(!this->browseChild(browseName));
-#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
-		uint key = qHash(browseName);
-#else
-		size_t key = qHash(browseName);
-#endif
-		m_browseCache[key] = nodeInstance;
-		QObject::connect(nodeInstance, &QObject::destroyed, this, [this, key]() {
-			m_browseCache.remove(key);
-		});
 	}
 	// if assert below fails, review filter in QUaNode::getChildrenNodeIds
 	Q_ASSERT_X(mapChildren.count() == 0, "QUaNode::QUaNode", "Children not bound properly.");
@@ -241,6 +217,29 @@ QUaNode::~QUaNode()
 	{
 		delete this->children().at(0);
 	}
+	QUaIterateLocker locker(m_qUaServer);
+	// remove from per-type instance registry and node id lookup table
+	m_qUaServer->unregisterTypeInstance(this);
+	m_qUaServer->unbindCppInstance(this);
+	// whole subtree is deleted at once by deleteSubtree, including parent's children index
+	// NOTE : nodes outside the subtree deleted meanwhile (e.g. by a destructor) are cleaned up here
+	if (this->inDeletingSubtree())
+	{
+		UA_NodeId nodeId;
+		UA_NodeId_copy(&m_nodeId, &nodeId);
+		m_qUaServer->m_listSubtreeNodeIds.append(nodeId);
+		return;
+	}
+	// remove from parent's children index
+	QUaNode* indexParent = qobject_cast<QUaNode*>(this->parent());
+	if (indexParent && !m_browseName.isEmpty())
+	{
+		auto it = indexParent->m_children.find(m_browseName);
+		if (it != indexParent->m_children.end() && it.value() == this)
+		{
+			indexParent->m_children.erase(it);
+		}
+	}
 	// check if node id has been already removed from node store
 	// i.e. child of deleted parent node, or ...
 	UA_NodeId outNodeId;
@@ -277,6 +276,336 @@ QUaNode::~QUaNode()
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 }
 
+QList<QUaNode*> QUaNode::cloneNodes(
+	QUaNode* parentNode,
+	const QList<QUaQualifiedName>& browseNames,
+	const QList<QUaNodeId>& nodeIds/* = QList<QUaNodeId>()*/
+)
+{
+	QUaIterateLocker locker(m_qUaServer);
+	// snapshot this subtree once
+	QUaCloneSnapshot snapshot;
+	QHash<const QUaNode*, int> indices;
+	this->cloneSnapshot(snapshot, -1, indices);
+	for (auto& ref : snapshot.refs)
+	{
+		ref.targetIndex = indices.value(ref.target, -1);
+		if (ref.targetIndex < 0)
+		{
+			ref.targetNodeId = ref.target->nodeId();
+		}
+		ref.target = nullptr;
+	}
+	// create all copies' roots in a single batch
+	QList<QUaNode*> roots = m_qUaServer->createInstancesInternal(
+		*this->metaObject(),
+		parentNode,
+		browseNames,
+		nodeIds
+	);
+	const int nodeCount = snapshot.nodes.count();
+	QVector<QUaCloneMode> modes(nodeCount, QUaCloneMode::Unresolved);
+	QVector<UA_NodeId> optionalIds(nodeCount, UA_NODEID_NULL);
+	QVector<QUaServer::QUaInstanceContext> contexts(nodeCount);
+	QVector<QUaNode*> copy(nodeCount, nullptr);
+	QQueue<QUaLog> logOut;
+	for (auto root : roots)
+	{
+		// root failed (already logged by createInstancesInternal), its slot stays nullptr
+		if (!root)
+		{
+			continue;
+		}
+		for (int i = 0; i < nodeCount; i++)
+		{
+			const auto& data = snapshot.nodes.at(i);
+			copy[i] = nullptr;
+			if (i == 0)
+			{
+				copy[i] = root;
+			}
+			QUaNode* parent = i == 0 ? nullptr : copy.at(data.parentIndex);
+			if (i > 0 && !parent)
+			{
+				// parent failed, so the whole branch fails
+				continue;
+			}
+			// resolve how to get the child with the first copy, the rest of copies are equal
+			if (i > 0 && modes.at(i) == QUaCloneMode::Unresolved)
+			{
+				modes[i] = QUaCloneMode::Invalid;
+				if (parent->hasChild(data.browseName))
+				{
+					modes[i] = QUaCloneMode::Existing;
+				}
+				else
+				{
+					UA_NodeId typeId = parent->typeDefinitionNodeId();
+					UA_QualifiedName uaName = data.browseName;
+					optionalIds[i] = QUaNode::getOptionalChildNodeId(m_qUaServer->m_server, typeId, uaName);
+					UA_NodeId_clear(&typeId);
+					UA_QualifiedName_clear(&uaName);
+					if (!UA_NodeId_isNull(&optionalIds.at(i)))
+					{
+						modes[i] = QUaCloneMode::Optional;
+					}
+					else if (m_qUaServer->initInstanceContext(*data.metaObject, parent, contexts[i]))
+					{
+						modes[i] = QUaCloneMode::New;
+					}
+				}
+			}
+			switch (i == 0 ? QUaCloneMode::Existing : modes.at(i))
+			{
+			case QUaCloneMode::Existing:
+				if (i > 0)
+				{
+					copy[i] = parent->browseChild(data.browseName);
+				}
+				break;
+			case QUaCloneMode::Optional:
+			{
+				UA_QualifiedName uaName = data.browseName;
+				copy[i] = QUaNode::instantiateOptionalChild(
+					m_qUaServer->m_server,
+					parent,
+					optionalIds.at(i),
+					uaName
+				);
+				UA_QualifiedName_clear(&uaName);
+			}
+			break;
+			case QUaCloneMode::New:
+			{
+				// type resolved once in context for all copies
+				UA_NodeId newInstanceNodeId = m_qUaServer->addInstanceNode(
+					contexts.at(i),
+					*data.metaObject,
+					parent,
+					data.browseName,
+					QUaNodeId()
+				);
+				if (!UA_NodeId_isNull(&newInstanceNodeId))
+				{
+					copy[i] = QUaNode::getNodeContext(newInstanceNodeId, m_qUaServer->m_server);
+				}
+				UA_NodeId_clear(&newInstanceNodeId);
+			}
+			break;
+			default:
+				break;
+			}
+			QUaNode* node = copy.at(i);
+			if (!node || node->metaObject() != data.metaObject)
+			{
+				logOut.enqueue({
+					tr("Failed to clone node %1 (type %2) under %3. Ignoring.")
+						.arg(data.browseName.toXmlString())
+						.arg(QString::fromUtf8(data.metaObject->className()))
+						.arg(parent ? QString(parent->nodeId()) : QString()),
+					QUaLogLevel::Error,
+					QUaLogCategory::Serialization
+				});
+				copy[i] = nullptr;
+				continue;
+			}
+			// attributes
+			for (const auto& prop : data.props)
+			{
+				bool ok = data.metaObject->property(prop.first).write(node, prop.second);
+				Q_ASSERT_X(ok, "QUaNode::cloneNodes", "Invalid value for cloned attribute.");
+				Q_UNUSED(ok);
+			}
+		}
+		// non-hierarchical references once the copy is complete
+		for (const auto& ref : qAsConst(snapshot.refs))
+		{
+			QUaNode* srcNode    = copy.at(ref.sourceIndex);
+			QUaNode* targetNode = ref.targetIndex >= 0 ?
+				copy.at(ref.targetIndex) : m_qUaServer->nodeById(ref.targetNodeId);
+			if (!srcNode || !targetNode)
+			{
+				continue;
+			}
+			srcNode->addReference(ref.refType, targetNode, true);
+		}
+	}
+	// cleanup
+	for (int i = 0; i < nodeCount; i++)
+	{
+		if (modes.at(i) == QUaCloneMode::Optional)
+		{
+			UA_NodeId_clear(&optionalIds[i]);
+		}
+		if (modes.at(i) == QUaCloneMode::New)
+		{
+			m_qUaServer->clearInstanceContext(contexts[i]);
+		}
+	}
+	for (auto& log : logOut)
+	{
+		emit m_qUaServer->logMessage(log);
+	}
+	return roots;
+}
+
+void QUaNode::cloneSnapshot(
+	QUaCloneSnapshot& snapshot,
+	const int& parentIndex,
+	QHash<const QUaNode*, int>& indices) const
+{
+	int index = snapshot.nodes.count();
+	indices.insert(this, index);
+	QUaCloneNodeData data;
+	data.metaObject  = this->metaObject();
+	data.browseName  = this->browseName();
+	data.parentIndex = parentIndex;
+	// same attributes as serializeAttrs, but keep property index instead of name
+	int propCount  = data.metaObject->propertyCount();
+	int propOffset = QUaNode::staticMetaObject.propertyOffset();
+	for (int i = propOffset; i < propCount; i++)
+	{
+		QMetaProperty metaProperty = data.metaObject->property(i);
+		if (!metaProperty.isWritable())
+		{
+			continue;
+		}
+		// ignore QUaNode * properties (type children)
+		QMetaType metaType( metaProperty.userType() );
+		auto propMetaObject = metaType.metaObject();
+		if (propMetaObject && propMetaObject->inherits(&QUaNode::staticMetaObject))
+		{
+			continue;
+		}
+		if (!metaType.isValid())
+		{
+			continue;
+		}
+		QVariant value = metaProperty.read(this);
+		if (!value.isValid() || value.isNull())
+		{
+			continue;
+		}
+		data.props.append(qMakePair(i, value));
+	}
+	snapshot.nodes.append(data);
+	// non-hierarchical references, targets resolved once the whole subtree is indexed
+	for (const auto& refType : m_qUaServer->referenceTypes())
+	{
+		if (m_qUaServer->m_hashHierRefTypes.contains(refType))
+		{
+			continue;
+		}
+		const auto references = this->findReferences(refType);
+		for (auto ref : references)
+		{
+			snapshot.refs.append({ index, refType, ref, -1, QUaNodeId() });
+		}
+	}
+	// recurse children (only hierarchical references, same as serializeInternal)
+	const auto refTypes = m_qUaServer->m_hashHierRefTypes.keys();
+	for (const auto& refType : refTypes)
+	{
+		const auto references = this->findReferences(refType);
+		for (auto ref : references)
+		{
+			if (indices.contains(ref))
+			{
+				continue;
+			}
+			ref->cloneSnapshot(snapshot, index, indices);
+		}
+	}
+}
+
+void QUaNode::deleteSubtree()
+{
+	Q_ASSERT_X(this != m_qUaServer->m_pobjectsFolder, "QUaNode::deleteSubtree", "Cannot delete objects folder.");
+	QUaServer* server = m_qUaServer;
+	QUaIterateLocker locker(server);
+	// nested call (i.e. from a destructor), the destructor handles nodes inside and outside
+	// the subtree of the outer call
+	if (server->m_deletingSubtree)
+	{
+		delete this;
+		return;
+	}
+	QUaNode* parent = qobject_cast<QUaNode*>(this->parent());
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	bool notify = parent && parent->inAddressSpace();
+	QUaChangeStructureDataType change;
+	if (notify)
+	{
+		change = {
+			parent->nodeId(),
+			parent->typeDefinitionNodeId(),
+			QUaChangeVerb::ReferenceDeleted // UaExpert does not recognize QUaChangeVerb::NodeAdded
+		};
+	}
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// remove from parent's children index
+	if (parent && !m_browseName.isEmpty())
+	{
+		auto it = parent->m_children.find(m_browseName);
+		if (it != parent->m_children.end() && it.value() == this)
+		{
+			parent->m_children.erase(it);
+		}
+	}
+	UA_NodeId rootNodeId;
+	UA_NodeId_copy(&m_nodeId, &rootNodeId);
+	// delete c++ instances first while ua nodes still exist (sub-type destructors might use them),
+	// each instance skips its own ua cleanup and only collects its node id
+	Q_ASSERT(server->m_listSubtreeNodeIds.isEmpty());
+	server->m_deletingSubtree = this;
+	delete this;
+	// delete ua subtree in a single traversal (uaDestructor ignores dangling contexts)
+	auto st = UA_Server_deleteNode(server->m_server, rootNodeId, true);
+	Q_ASSERT(st == UA_STATUSCODE_GOOD);
+	UA_NodeId_clear(&rootNodeId);
+	// open62541 keeps children with another hierarchical parent, delete them explicitly
+	for (auto& nodeId : server->m_listSubtreeNodeIds)
+	{
+		UA_NodeId outNodeId;
+		st = UA_Server_readNodeId(server->m_server, nodeId, &outNodeId);
+		if (st == UA_STATUSCODE_GOOD)
+		{
+			st = UA_Server_deleteNode(server->m_server, nodeId, true);
+			Q_ASSERT(st == UA_STATUSCODE_GOOD);
+		}
+		UA_NodeId_clear(&outNodeId);
+		UA_NodeId_clear(&nodeId);
+	}
+	server->m_listSubtreeNodeIds.clear();
+	server->m_deletingSubtree = nullptr;
+	Q_UNUSED(st);
+	// single change for the whole subtree
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	if (notify)
+	{
+		server->addChange(change);
+	}
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+}
+
+bool QUaNode::inDeletingSubtree() const
+{
+	const QUaNode* root = m_qUaServer->m_deletingSubtree;
+	if (!root)
+	{
+		return false;
+	}
+	// NOTE : ancestors are still alive, children are deleted before their parent
+	for (const QObject* node = this; node; node = node->parent())
+	{
+		if (node == root)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 bool QUaNode::operator==(const QUaNode & other) const
 {
 	return UA_NodeId_equal(&this->m_nodeId, &other.m_nodeId);
@@ -289,6 +618,7 @@ QUaServer * QUaNode::server() const
 
 QUaLocalizedText QUaNode::displayName() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// read display name
@@ -305,6 +635,7 @@ QUaLocalizedText QUaNode::displayName() const
 
 void QUaNode::setDisplayName(const QUaLocalizedText& displayName)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
     UA_LocalizedText uaDisplayName = displayName;
@@ -320,6 +651,7 @@ void QUaNode::setDisplayName(const QUaLocalizedText& displayName)
 
 QUaLocalizedText QUaNode::description() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// read description
@@ -335,6 +667,7 @@ QUaLocalizedText QUaNode::description() const
 
 void QUaNode::setDescription(const QUaLocalizedText& description)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	UA_LocalizedText uaDescription = description;
@@ -349,6 +682,7 @@ void QUaNode::setDescription(const QUaLocalizedText& description)
 
 quint32 QUaNode::writeMask() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// read writeMask
@@ -362,6 +696,7 @@ quint32 QUaNode::writeMask() const
 
 void QUaNode::setWriteMask(const quint32 & writeMask)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// set value
@@ -376,11 +711,18 @@ QUaNodeId QUaNode::nodeId() const
 {
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
-	return m_nodeId;
+	// NOTE : lazy cache, can be filled from the iterate thread too
+	QUaIterateLocker locker(m_qUaServer);
+	if (m_internedNodeId.isNull())
+	{
+		const_cast<QUaNode*>(this)->m_internedNodeId = QUaNodeId(m_nodeId).interned();
+	}
+	return m_internedNodeId;
 }
 
 QString QUaNode::nodeClass() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// read nodeClass
@@ -394,6 +736,7 @@ QString QUaNode::nodeClass() const
 
 QUaQualifiedName QUaNode::browseName() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	// check cache
@@ -447,6 +790,7 @@ QUaFolderObject* QUaNode::addFolderObject(
 
 QUaNodeId QUaNode::typeDefinitionNodeId() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	if (!m_typeDefinitionNodeId.isNull())
@@ -454,8 +798,8 @@ QUaNodeId QUaNode::typeDefinitionNodeId() const
 		return m_typeDefinitionNodeId;
 	}
 	UA_NodeId retTypeId = QUaNode::typeDefinitionNodeId(m_nodeId, m_qUaServer->m_server);
-	// return in string form
-	const_cast<QUaNode*>(this)->m_typeDefinitionNodeId = retTypeId;
+	// interned, all instances of a type share the same buffer
+	const_cast<QUaNode*>(this)->m_typeDefinitionNodeId = QUaNodeId(retTypeId).interned();
 	UA_NodeId_clear(&retTypeId);
 	return m_typeDefinitionNodeId;
 }
@@ -538,6 +882,7 @@ UA_NodeId QUaNode::superTypeDefinitionNodeId(
 
 QString QUaNode::typeDefinitionDisplayName() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	UA_NodeId typeId = this->typeDefinitionNodeId();
@@ -563,6 +908,7 @@ QHash<QUaNodeId, QUaQualifiedName> QUaNode::m_hashTypeBrowseNames;
 
 QUaQualifiedName QUaNode::typeDefinitionBrowseName() const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	Q_CHECK_PTR(m_qUaServer);
 	Q_ASSERT(!UA_NodeId_isNull(&m_nodeId));
 	QUaNodeId typeId = this->typeDefinitionNodeId();
@@ -592,33 +938,31 @@ QUaQualifiedName QUaNode::typeDefinitionBrowseName() const
 
 QList<QUaNode*> QUaNode::browseChildren() const
 {
-	// TODO : check if faster with open62541 browse API
-	return this->findChildren<QUaNode*>(QString(), Qt::FindDirectChildrenOnly);
+	// NOTE : clients can add or delete children from the iterate thread
+	QUaIterateLocker locker(m_qUaServer);
+	// NOTE : iterate QObject children instead of index to keep creation order
+	QList<QUaNode*> retList;
+	retList.reserve(m_children.count());
+	for (auto obj : this->children())
+	{
+		auto child = qobject_cast<QUaNode*>(obj);
+		if (child)
+		{
+			retList << child;
+		}
+	}
+	return retList;
 }
 
 QUaNode* QUaNode::browseChild(
 	const QUaQualifiedName&  browseName,
 	const bool& instantiateOptional/* = false*/)
 {
-	// first check cache
-	QUaNode* child = nullptr;
-#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
-	uint key = qHash(browseName);
-#else
-	size_t key = qHash(browseName);
-#endif
-	if (m_browseCache.contains(key))
-	{
-		child = m_browseCache.value(key);
-		if (child || !instantiateOptional)
-		{
-			return child;
-		}
-	}
-	if (!instantiateOptional)
+	QUaIterateLocker locker(m_qUaServer);
+	QUaNode* child = m_children.value(browseName, nullptr);
+	if (child || !instantiateOptional)
 	{
-		m_browseCache[key] = nullptr;
-		return nullptr;
+		return child;
 	}
 	child = this->instantiateOptionalChild(browseName);
 	Q_ASSERT_X(child, "QUaNode::browseChild", "TODO : error log");
@@ -627,9 +971,20 @@ QUaNode* QUaNode::browseChild(
 
 bool QUaNode::hasChild(const QUaQualifiedName &browseName)
 {
-	// NOTE : do not use m_browseCache.contains because maybe we tested if existed
-	//        and cached a nullptr. This will giv a false positive
-	return this->browseChild(browseName);
+	QUaIterateLocker locker(m_qUaServer);
+	return m_children.contains(browseName);
+}
+
+void QUaNode::bindChild(QUaNode* child, const QUaQualifiedName& browseName)
+{
+	Q_CHECK_PTR(child);
+	QUaIterateLocker locker(m_qUaServer);
+	Q_ASSERT(!m_children.contains(browseName));
+	child->setParent(this);
+	child->setObjectName(browseName);
+	// cache browse name, used to remove from index in ~QUaNode
+	child->m_browseName = browseName;
+	m_children.insert(browseName, child);
 }
 
 QUaNode * QUaNode::browsePath(const QUaBrowsePath& browsePath) const
@@ -674,6 +1029,7 @@ QUaBrowsePath QUaNode::nodeBrowsePath() const
 
 void QUaNode::addReference(const QUaReferenceType& ref, QUaNode* nodeTarget, const bool& isForward/* = true*/)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// first check if reference type is registered
 	if (!m_qUaServer->m_hashRefTypes.contains(ref))
 	{
@@ -740,6 +1096,7 @@ void QUaNode::addReference(const QUaReferenceType& ref, QUaNode* nodeTarget, con
 
 void QUaNode::removeReference(const QUaReferenceType& ref, QUaNode* nodeTarget, const bool& isForward/* = true*/)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// first check if reference type is removeReference
 	Q_ASSERT_X(m_qUaServer->m_hashRefTypes.contains(ref), "QUaNode::addReference", "Reference not registered.");
 	if (!m_qUaServer->m_hashRefTypes.contains(ref))
@@ -793,6 +1150,7 @@ void QUaNode::removeReference(const QUaReferenceType& ref, QUaNode* nodeTarget,
 
 QList<QUaNode*> QUaNode::findReferences(const QUaReferenceType& ref, const bool& isForward /*= true*/) const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	QList<QUaNode*> retRefList;
 	// call internal method
 	auto set = getRefsInternal(ref, isForward);
@@ -1085,21 +1443,10 @@ QUaNode * QUaNode::instantiateOptionalChild(
 	);
 	Q_ASSERT(st);
 	Q_UNUSED(st);
-	newInstance->m_nodeId = outOptionalNode;
+	srv->bindCppInstanceWithUaNode(newInstance, outOptionalNode);
 	// need to set parent and browse name
 	auto browseName = QUaQualifiedName(childName);
-	newInstance->setParent(parent);
-	newInstance->setObjectName(browseName);
-	Q_ASSERT(!parent->browseChild(browseName));
-#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
-	uint key = qHash(browseName);
-#else
-	size_t key = qHash(browseName);
-#endif
-	parent->m_browseCache[key] = newInstance;
-	QObject::connect(newInstance, &QObject::destroyed, parent, [parent, key]() {
-		parent->m_browseCache.remove(key);
-	});
+	parent->bindChild(newInstance, browseName);
 	// emit child added to parent
 	emit parent->childAdded(newInstance);
 	// success
@@ -1189,6 +1536,7 @@ bool QUaNode::userExecutableInternal(const QString & strUserName)
 // NOTE : some code borrowed from UA_Server_addConditionOptionalField
 QUaNode* QUaNode::instantiateOptionalChild(const QUaQualifiedName&  browseName)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// convert browse name to qualified name
 	UA_QualifiedName childName = browseName;
 	// look if optional child really in model
@@ -1250,6 +1598,7 @@ QUaNode* QUaNode::cloneNode(
 	const QUaNodeId& nodeId/* = ""*/
 )
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// create new clean instance of the same type
 	UA_NodeId newInstanceNodeId = m_qUaServer->createInstanceInternal(
 		*this->metaObject(),
@@ -1311,6 +1660,7 @@ const QUaSession* QUaNode::currentSession() const
 
 bool QUaNode::hasOptionalMethod(const QUaQualifiedName& methodName) const
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// get all ua methods of INSTANCE
 	auto methodsNodeIds = QUaNode::getMethodsNodeIds(m_nodeId, m_qUaServer->m_server);
 	for (const auto & methNodeId : qAsConst(methodsNodeIds))
@@ -1342,6 +1692,7 @@ bool QUaNode::hasOptionalMethod(const QUaQualifiedName& methodName) const
 
 bool QUaNode::addOptionalMethod(const QUaQualifiedName& methodName)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// do not add twice
 	if (this->hasOptionalMethod(methodName))
 	{
@@ -1411,6 +1762,7 @@ bool QUaNode::addOptionalMethod(const QUaQualifiedName& methodName)
 
 bool QUaNode::removeOptionalMethod(const QUaQualifiedName& methodName)
 {
+	QUaIterateLocker locker(m_qUaServer);
 	// do not remove twice
 	if (!this->hasOptionalMethod(methodName))
 	{
@@ -17,6 +17,8 @@ class QUaBaseDataVariable;
 class QUaBaseObject;
 class QUaFolderObject;
 class QUaSession;
+struct QUaTypeInstanceList;
+struct QUaCloneSnapshot;
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
 class QUaCondition;
@@ -130,6 +132,11 @@ public:
 	// https://repl.it/repls/EachSpicyInternalcommand
 	virtual ~QUaNode();
 
+	// delete this node and all its descendants, same as delete but faster for large subtrees
+	// because the open62541 nodes are removed in a single traversal and a single model change
+	// is emitted for the whole subtree (destroyed signals are still emitted)
+	void deleteSubtree();
+
 	bool operator ==(const QUaNode& other) const;
 
 	QUaServer* server() const;
@@ -283,6 +290,16 @@ public:
 		const QUaQualifiedName& browseName = QUaQualifiedName(),
 		const QUaNodeId& nodeId = QUaNodeId()
 	);
+	// clone this node once per browse name, the subtree is snapshotted once into plain data
+	// and each type is resolved once for all copies, non-hierarchical references between nodes
+	// of this subtree point to the copy's own nodes (references outside the subtree are kept)
+	// NOTE : nodeIds is optional, if not empty must be the same size as browseNames
+	// NOTE : result has one entry per browseName, nullptr (and logged) where the copy failed
+	QList<QUaNode*> cloneNodes(
+		QUaNode* parentNode,
+		const QList<QUaQualifiedName>& browseNames,
+		const QList<QUaNodeId>& nodeIds = QList<QUaNodeId>()
+	);
 
 signals:
 
@@ -300,7 +317,8 @@ protected:
 	// to check which session is calling a service (read, write, method call, etc)
 	const QUaSession* currentSession() const;
 	// instatiate child with optional modelling rule
-	QUaNode* instantiateOptionalChild(const QUaQualifiedName& browseName);
+	// NOTE : virtual so nodes with children created on demand can hook browseChild (see QUaVirtualFolder)
+	virtual QUaNode* instantiateOptionalChild(const QUaQualifiedName& browseName);
 	// check if instance has an optional method with given browse name
 	bool hasOptionalMethod(const QUaQualifiedName& methodName) const;
 	// gets optional method from type and adds a reference from this instance to the method
@@ -315,15 +333,21 @@ private:
 	UA_NodeId m_nodeId;
 	// keep a cache since it does not change much
 	QUaNodeId m_typeDefinitionNodeId;
+	// interned copy of m_nodeId, so nodeId() does not allocate
+	QUaNodeId m_internedNodeId;
 	static QHash<QUaNodeId, QUaQualifiedName> m_hashTypeBrowseNames;
 	// with new open62541, browseName is inmutable and reading it is kind of expensive
 	QUaQualifiedName m_browseName;
-	// browse hierarchical children cache
-	// NOTE : use uint as key because is cheaper to cache in QObject::destroyed
-	// lambda callback than the browseName. We need to cache because by the time the
+	// hierarchical children index, kept up to date by bindChild and ~QUaNode
+	// NOTE : child removes itself using its cached m_browseName, because by the time the
 	// QUaNode destructor is called, the browseName is already unavailable from open62541
-	// TODO : consider removing after testing new open62541 tree implementation
-	QHash<uint, QUaNode*> m_browseCache;
+	QHash<QUaQualifiedName, QUaNode*> m_children;
+	// set parent, object name and add to children index
+	void bindChild(QUaNode * child, const QUaQualifiedName& browseName);
+	// intrusive links into the server's per-type instance registry (see QUaServer::forEachTypeInstance)
+	QUaTypeInstanceList * m_typeList = nullptr;
+	QUaNode             * m_typePrev = nullptr;
+	QUaNode             * m_typeNext = nullptr;
 
 	// Static Helpers
 
@@ -400,6 +424,16 @@ private:
 	const QMap<QString, QVariant>    serializeAttrs() const;
 	const QList<QUaForwardReference> serializeRefs() const;
 
+	// true if this node is inside the subtree being deleted by deleteSubtree
+	bool inDeletingSubtree() const;
+
+	// Clone API
+	void cloneSnapshot(
+		QUaCloneSnapshot& snapshot, 
+		const int& parentIndex, 
+		QHash<const QUaNode*, int>& indices
+	) const;
+
 	template<typename T>
 	bool serializeInternal(T& serializer, QQueue<QUaLog>& logOut);
 
@@ -54,6 +54,7 @@ UA_StatusCode QUaServer::addOptionSetValues(UA_Server* server, UA_NodeId* parent
 
 void QUaServer::registerOptionSet(const QString& strOptionSetName, const QUaOptionSetMap& optionSetMap, const QUaNodeId& nodeId)
 {
+	QUaIterateLocker locker(this);
 	// check if already exists
 	if (m_hashOptionSets.contains(strOptionSetName))
 	{
@@ -36,8 +36,209 @@
 #include <QUaOptionSetVariable>
 #endif
 
+#include <QUaVirtualFolder>
+
+#include <QCoreApplication>
 #include <QMetaProperty>
 #include <QTimer>
+#include <QThread>
+#include <QSocketNotifier>
+
+#include <atomic>
+#include <memory>
+
+// thread that loops the open62541 server iterations, see QUaServer::setIterateInThread
+class QUaIterateThread : public QThread
+{
+public:
+	explicit QUaIterateThread(const std::function<void(void)> &loop)
+		: QThread(), m_loop(loop)
+	{
+	};
+protected:
+	void run() override
+	{
+		m_loop();
+	};
+private:
+	std::function<void(void)> m_loop;
+};
+
+// block until any of the sockets is readable or the timeout (ms) expires
+static void waitSockets(const QSet<qintptr>& sockets, const UA_UInt16& msTimeout)
+{
+	if (sockets.isEmpty())
+	{
+		QThread::msleep(msTimeout);
+		return;
+	}
+	fd_set fdset;
+	FD_ZERO(&fdset);
+	UA_SOCKET highestfd = 0;
+	for (auto socket : sockets)
+	{
+		UA_fd_set(static_cast<UA_SOCKET>(socket), &fdset);
+		highestfd = (std::max)(highestfd, static_cast<UA_SOCKET>(socket));
+	}
+	struct timeval tmptv = {
+		static_cast<long>(msTimeout / 1000),
+		static_cast<int>((msTimeout % 1000) * 1000)
+	};
+	UA_select(highestfd + 1, &fdset, nullptr, nullptr, &tmptv);
+}
+
+// value pushed to the ingestion queue, see QUaServer::pushValue
+struct QUaIngestValue
+{
+	bool                      byNodeId = false;
+	QPointer<QUaBaseVariable> variable;
+	QUaNodeId                 nodeId;
+	QVariant                  value;
+	QUaStatusCode             statusCode;
+	QDateTime                 sourceTimestamp;
+};
+
+// bounded lock-free multiple producer single consumer queue,
+// each cell has a sequence number that tells producers and the
+// consumer if the cell is free to write or ready to read
+class QUaIngestionQueue
+{
+public:
+	explicit QUaIngestionQueue(const quint32 &capacity)
+		: m_mask(QUaIngestionQueue::roundCapacity(capacity) - 1),
+		m_cells(new Cell[m_mask + 1]),
+		m_enqueuePos(0),
+		m_dequeuePos(0),
+		m_dropped(0),
+		m_processed(0)
+	{
+		for (size_t i = 0; i <= m_mask; i++)
+		{
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	};
+	// thread-safe, any number of producers
+	bool tryPush(QUaIngestValue &&item)
+	{
+		Cell* cell;
+		size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			cell = &m_cells[pos & m_mask];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (dif == 0)
+			{
+				if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (dif < 0)
+			{
+				// full
+				m_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->data = std::move(item);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	};
+	// NOTE : single consumer only
+	bool tryPop(QUaIngestValue &item)
+	{
+		size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+		Cell* cell = &m_cells[pos & m_mask];
+		size_t seq = cell->sequence.load(std::memory_order_acquire);
+		if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+		{
+			// empty (or producer still writing the cell)
+			return false;
+		}
+		item = std::move(cell->data);
+		// release implicitly shared data now instead of on next push
+		cell->data = QUaIngestValue();
+		cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+		m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+		return true;
+	};
+	quint32 size() const
+	{
+		size_t enq = m_enqueuePos.load(std::memory_order_relaxed);
+		size_t deq = m_dequeuePos.load(std::memory_order_relaxed);
+		return enq > deq ? static_cast<quint32>(enq - deq) : 0;
+	};
+	quint32 capacity() const
+	{
+		return static_cast<quint32>(m_mask + 1);
+	};
+	void addDropped(const quint64 &count)
+	{
+		m_dropped.fetch_add(count, std::memory_order_relaxed);
+	};
+	quint64 dropped() const
+	{
+		return m_dropped.load(std::memory_order_relaxed);
+	};
+	void addProcessed(const quint64 &count)
+	{
+		m_processed.fetch_add(count, std::memory_order_relaxed);
+	};
+	quint64 processed() const
+	{
+		return m_processed.load(std::memory_order_relaxed);
+	};
+	static quint32 roundCapacity(const quint32 &capacity)
+	{
+		quint32 rounded = 2;
+		while (rounded < capacity && rounded < (1u << 31))
+		{
+			rounded <<= 1;
+		}
+		return rounded;
+	};
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		QUaIngestValue      data;
+	};
+	const size_t            m_mask;
+	std::unique_ptr<Cell[]> m_cells;
+	std::atomic<size_t>     m_enqueuePos;
+	std::atomic<size_t>     m_dequeuePos;
+	std::atomic<quint64>    m_dropped;
+	std::atomic<quint64>    m_processed;
+	Q_DISABLE_COPY(QUaIngestionQueue)
+};
+
+QUaIterateLocker::QUaIterateLocker(const QUaServer* server)
+	: m_server(const_cast<QUaServer*>(server)), m_locked(false)
+{
+	// NOTE : only lock if iterating in dedicated thread, else all access is already serialized
+	if (!m_server || !m_server->m_iterThread.loadAcquire())
+	{
+		return;
+	}
+	m_server->m_iterMutex.lock();
+	m_server->m_iterLockDepth++;
+	m_locked = true;
+}
+
+QUaIterateLocker::~QUaIterateLocker()
+{
+	if (!m_locked)
+	{
+		return;
+	}
+	m_server->m_iterLockDepth--;
+	m_server->m_iterMutex.unlock();
+}
 
 /* helper null log for avoiding startup messages */
 void UA_Log_Discard_log(void *context,
@@ -121,6 +322,12 @@ void QUaServer::uaDestructor(UA_Server       * server,
 #else
 	auto srv = static_cast<QUaServer*>(serverContext);
 #endif // QT_DEBUG 
+	// early exit if c++ instances were already deleted by QUaNode::deleteSubtree
+	// NOTE : context is dangling in that case
+	if (srv->m_deletingSubtree)
+	{
+		return;
+	}
 	// check session (objects can be created or destroyed without client connected)
 	//Q_ASSERT(srv->m_hashSessions.contains(*sessionId));
 	srv->m_currentSession = srv->m_hashSessions.contains(*sessionId) ?
@@ -140,6 +347,8 @@ void QUaServer::uaDestructor(UA_Server       * server,
 	{
 		return;
 	}
+	// node id is about to be removed from node store, remove from lookup table
+	srv->unbindCppInstance(node);
 	// handle events if enabled
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	// check if event (not in tree)
@@ -338,28 +547,23 @@ UA_StatusCode QUaServer::uaConstructor(
 		UA_NodeId_clear(&topBoundParentNodeId);
 		return (UA_StatusCode)UA_STATUSCODE_BADUNEXPECTEDERROR;
 	}
+	// nodes added by clients are instantiated in the iterate thread (if any),
+	// move them to the server's thread so they can be parented and signals delivered there
+	if (newInstance->thread() != server->thread())
+	{
+		newInstance->moveToThread(server->thread());
+	}
 	// need to bind again using the official (void ** nodeContext) of the UA constructor
 	// because we set context on C++ instantiation, but later the UA library overwrites it 
 	// after calling the UA constructor
 	*nodeContext = static_cast<void*>(newInstance);
-	newInstance->m_nodeId = *nodeId;
+	server->bindCppInstanceWithUaNode(newInstance, *nodeId);
 	// need to set parent if direct parent is already bound bacause its constructor has already been called
 	UA_NodeId directParentNodeId = QUaNode::getParentNodeId(*nodeId, server->m_server);
 	if (parentContext && UA_NodeId_equal(&topBoundParentNodeId, &directParentNodeId))
 	{
 		auto browseName = QUaNode::getBrowseName(*nodeId, server->m_server);
-		newInstance->setParent(parentContext);
-		newInstance->setObjectName(browseName);
-		Q_ASSERT(!parentContext->browseChild(browseName));
-#if (QT_VERSION < QT_VERSION_CHECK(6,0,0))
-		uint key = qHash(browseName);
-#else
-		size_t key = qHash(browseName);
-#endif
-		parentContext->m_browseCache[key] = newInstance;
-		QObject::connect(newInstance, &QObject::destroyed, parentContext, [parentContext, key]() {
-			parentContext->m_browseCache.remove(key);
-		});	
+		parentContext->bindChild(newInstance, browseName);
 		// emit child added to parent
 		emit parentContext->childAdded(newInstance);
 	}
@@ -490,10 +694,33 @@ UA_StatusCode QUaServer::callMetaMethod(
 	);
 	// reset status code
 	server->m_methodRetStatusCode = UA_STATUSCODE_GOOD;
+	// if iterating in dedicated thread, call method in the object's thread, releasing
+	// the iterate lock while waiting so the object's thread can access the server
+	// NOTE : without dedicated thread the call is direct as always, whatever the object's thread
+	QThread* iterThread = server->m_iterThread.loadAcquire();
+	bool inOtherThread = iterThread &&
+		QThread::currentThread() == iterThread &&
+		QThread::currentThread() != object->thread();
+	int lockDepth = 0;
+	if (inOtherThread)
+	{
+		// do not block on the object's thread if stopping, it might be waiting for this thread
+		if (iterThread->isInterruptionRequested())
+		{
+			return (UA_StatusCode)UA_STATUSCODE_BADSHUTDOWN;
+		}
+		// NOTE : recursive lock, release all levels held by this thread
+		lockDepth = server->m_iterLockDepth;
+		server->m_iterLockDepth = 0;
+		for (int i = 0; i < lockDepth; i++)
+		{
+			server->m_iterMutex.unlock();
+		}
+	}
 	// call metaMethod
 	bool ok = metaMethod.invoke(
 		object,
-		Qt::DirectConnection,
+		inOtherThread ? Qt::BlockingQueuedConnection : Qt::DirectConnection,
 		returnArgument,
 		genListArgs.value(0),
 		genListArgs.value(1),
@@ -506,6 +733,14 @@ UA_StatusCode QUaServer::callMetaMethod(
 		genListArgs.value(8),
 		genListArgs.value(9)
 	);
+	if (inOtherThread)
+	{
+		for (int i = 0; i < lockDepth; i++)
+		{
+			server->m_iterMutex.lock();
+		}
+		server->m_iterLockDepth = lockDepth;
+	}
 	Q_ASSERT(ok);
 	Q_UNUSED(ok);
 	// set return value if any
@@ -994,11 +1229,67 @@ UA_Boolean QUaServer::getUserExecutableOnObject(UA_Server        *server,
 	return true;
 }
 
+#if UA_OPEN62541_VER_MAJOR > 1 || (UA_OPEN62541_VER_MAJOR == 1 && UA_OPEN62541_VER_MINOR >= 3)
+UA_Boolean QUaServer::allowBrowseNode(UA_Server        *server, 
+		                              UA_AccessControl *ac,
+		                              const UA_NodeId  *sessionId, 
+		                              void             *sessionContext,
+		                              const UA_NodeId  *nodeId, 
+		                              void             *nodeContext)
+{
+	Q_UNUSED(ac);
+	Q_UNUSED(sessionId);
+	Q_UNUSED(sessionContext);
+	Q_UNUSED(nodeContext);
+	// NOTE : use node table because context of non-wrapped nodes is not a QUaNode
+	QUaServer *srv = QUaServer::getServerNodeContext(server);
+	QUaVirtualFolder::browseRequested(srv->m_hashNodes.value(*nodeId, nullptr));
+	// browse access is not restricted
+	return true;
+}
+#endif // allowBrowseNode, open62541 < v1.3 has no browse hook (see QUaVirtualFolder)
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+void QUaServer::monitoredItemRegister(UA_Server       *server,
+		                              const UA_NodeId *sessionId, 
+		                              void            *sessionContext,
+		                              const UA_NodeId *nodeId, 
+		                              void            *nodeContext,
+		                              UA_UInt32        attibuteId, 
+		                              UA_Boolean       removed)
+{
+	Q_UNUSED(sessionId);
+	Q_UNUSED(sessionContext);
+	Q_UNUSED(nodeContext);
+	Q_UNUSED(attibuteId);
+	QUaServer *srv = QUaServer::getServerNodeContext(server);
+	QUaNode *node = srv->m_hashNodes.value(*nodeId, nullptr);
+	if (!node)
+	{
+		return;
+	}
+	QUaVirtualFolder::monitoredItemChanged(node, removed);
+}
+#endif // UA_ENABLE_SUBSCRIPTIONS
+
 QUaServer::QUaServer(QObject* parent/* = 0*/)
 	: QObject(parent)
+#if (QT_VERSION < QT_VERSION_CHECK(5,14,0))
+	, m_iterMutex(QMutex::Recursive)
+#endif
 {
 	// defaults
 	m_beingDestroyed = false;
+	m_deletingSubtree = nullptr;
+	m_iterateInThread = false;
+	m_iterThread.storeRelease(nullptr);
+	m_iterLockDepth = 0;
+	m_iterStatsBusyNs = 0;
+	m_iterStatsCount = 0;
+	m_deferWriteSignals = false;
+	m_ingestQueue = new QUaIngestionQueue(65536);
+	m_ingestPending.storeRelease(0);
+	m_valueCacheMemory = 0;
 	m_port = 4840;
 	m_anonymousLoginAllowed = true;
 	m_byteCertificate = QByteArray();
@@ -1009,6 +1300,17 @@ QUaServer::QUaServer(QObject* parent/* = 0*/)
 	m_bytePrivateKey = QByteArray();
 	m_bytePrivateKeyInternal = QByteArray();
 #endif
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	m_changesCollapsed    = false;
+	m_changesScheduled    = false;
+	m_changesStartNs      = 0;
+	m_changeEventWindow   = 0;
+	m_changeEventMaxBatch = 0;
+	this->resetChangeEventStats();
+	m_changesClock.start();
+	m_changesTimer.setSingleShot(true);
+	QObject::connect(&m_changesTimer, &QTimer::timeout, this, &QUaServer::triggerChanges);
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 #ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
 	m_conditionsRefreshRequired = false;
 #endif // UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
@@ -1030,28 +1332,123 @@ void QUaServer::addChange(const QUaChangeStructureDataType& change)
 {
 	// NOTE : do not check if server is running because we might wanna
 	//        historize offline events
-	if (m_listChanges.contains(change))
+	if (m_setChanges.contains(change))
 	{
 		return;
 	}
+	if (m_listChanges.isEmpty())
+	{
+		m_changesStartNs = m_changesClock.nsecsElapsed();
+	}
+	m_setChanges.insert(change);
+	// too many changes, collapse to one per affected node
+	if (!m_changesCollapsed && m_changeEventMaxBatch > 0 && m_listChanges.count() >= m_changeEventMaxBatch)
+	{
+		this->collapseChanges();
+	}
+	if (m_changesCollapsed)
+	{
+		int index = m_hashChangesCollapsed.value(change.m_nodeIdAffected, -1);
+		if (index >= 0)
+		{
+			m_listChanges[index].m_uiVerb |= change.m_uiVerb;
+			return;
+		}
+		// still full, emit buffer in its own event
+		if (m_changeEventMaxBatch > 0 && m_listChanges.count() >= m_changeEventMaxBatch)
+		{
+			this->flushChanges();
+			m_setChanges.insert(change);
+			m_changesStartNs = m_changesClock.nsecsElapsed();
+		}
+	}
+	if (m_changesCollapsed)
+	{
+		m_hashChangesCollapsed.insert(change.m_nodeIdAffected, m_listChanges.count());
+	}
 	m_listChanges.append(change);
 	// if trigger already scheduled, then ealry exit
-	if (m_changeEventSignaler.processing())
+	if (m_changesScheduled)
+	{
+		return;
+	}
+	m_changesScheduled = true;
+	// NOTE : with setIterateInThread(true) nodes deleted by clients are destroyed in the iterate
+	//        thread, the timer (and the signaler) can only be started from the server's thread
+	if (QThread::currentThread() != this->thread())
+	{
+		QMetaObject::invokeMethod(&m_changesTimer, "start", Qt::QueuedConnection,
+			Q_ARG(int, m_changeEventWindow));
+		return;
+	}
+	// wait for coalescing window to buffer more changes
+	if (m_changeEventWindow > 0)
 	{
+		m_changesTimer.start(m_changeEventWindow);
 		return;
 	}
 	// exec trigger on next event loop iteration
 	m_changeEventSignaler.execLater([this]() {
+		this->triggerChanges();
+	});
+}
+
+void QUaServer::collapseChanges()
+{
+	Q_ASSERT(!m_changesCollapsed);
+	QUaChangesList listCollapsed;
+	m_hashChangesCollapsed.clear();
+	for (const auto& change : m_listChanges)
+	{
+		int index = m_hashChangesCollapsed.value(change.m_nodeIdAffected, -1);
+		if (index >= 0)
+		{
+			listCollapsed[index].m_uiVerb |= change.m_uiVerb;
+			continue;
+		}
+		m_hashChangesCollapsed.insert(change.m_nodeIdAffected, listCollapsed.count());
+		listCollapsed.append(change);
+	}
+	m_listChanges = listCollapsed;
+	m_changesCollapsed = true;
+}
+
+void QUaServer::flushChanges()
+{
+	if (m_listChanges.isEmpty())
+	{
+		return;
+	}
+	m_listChangesFull.append(qMakePair(m_listChanges, m_changesStartNs));
+	m_listChanges.clear();
+	m_setChanges.clear();
+	m_hashChangesCollapsed.clear();
+	m_changesCollapsed = false;
+}
+
+void QUaServer::triggerChanges()
+{
+	// NOTE : buffer is shared with the iterate thread (see addChange)
+	QUaIterateLocker locker(this);
+	m_changesScheduled = false;
+	this->flushChanges();
+	for (const auto& changes : m_listChangesFull)
+	{
 		// trigger
 		auto time = QDateTime::currentDateTimeUtc();
-		m_changeEvent->setChanges(m_listChanges);
+		m_changeEvent->setChanges(changes.first);
 		m_changeEvent->setTime(time);
 		m_changeEvent->setReceiveTime(time);
 		m_changeEvent->trigger();
-		// clean list of changes buffer
-		m_listChanges.clear();
-		m_changeEvent->setChanges(m_listChanges);
-	});
+		// update stats
+		m_changeEventLatencyNs    = m_changesClock.nsecsElapsed() - changes.second;
+		m_changeEventMaxLatencyNs = qMax(m_changeEventMaxLatencyNs, m_changeEventLatencyNs);
+		m_changeEventsCount++;
+		m_changesCount += static_cast<quint64>(changes.first.count());
+	}
+	m_listChangesFull.clear();
+	// clean list of changes buffer
+	m_changeEvent->setChanges(QUaChangesList());
 }
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 
@@ -1096,11 +1493,71 @@ quint8 QUaServer::eventNotifier() const
 }
 void QUaServer::setEventNotifier(const quint8& eventNotifier)
 {
+	QUaIterateLocker locker(this);
 	auto st = UA_Server_writeEventNotifier(m_server, UA_NODEID_NUMERIC(0, UA_NS0ID_SERVER), eventNotifier);
 	Q_ASSERT(st == UA_STATUSCODE_GOOD);
 	Q_UNUSED(st);
 	// TODO : emit signal?	
 }
+
+bool QUaServer::historyWriteAsync() const
+{
+	return m_historBackend.writeAsync();
+}
+
+void QUaServer::setHistoryWriteAsync(const bool& async)
+{
+	QQueue<QUaLog> logOut;
+	m_historBackend.setWriteAsync(async, logOut);
+	QUaHistoryBackend::processServerLog(this, logOut);
+}
+
+int QUaServer::historyWriteQueueSize() const
+{
+	return m_historBackend.writeQueueSize();
+}
+
+void QUaServer::setHistoryWriteQueueSize(const int& size)
+{
+	m_historBackend.setWriteQueueSize(size);
+}
+
+QUaHistoryBackend::WriteBackpressure QUaServer::historyWriteBackpressure() const
+{
+	return m_historBackend.writeBackpressure();
+}
+
+void QUaServer::setHistoryWriteBackpressure(const QUaHistoryBackend::WriteBackpressure& policy)
+{
+	m_historBackend.setWriteBackpressure(policy);
+}
+
+QString QUaServer::historySpillFileName() const
+{
+	return m_historBackend.spillFileName();
+}
+
+void QUaServer::setHistorySpillFileName(const QString& fileName)
+{
+	m_historBackend.setSpillFileName(fileName);
+}
+
+void QUaServer::flushHistoryWrites()
+{
+	QQueue<QUaLog> logOut;
+	m_historBackend.flushWrites(logOut);
+	QUaHistoryBackend::processServerLog(this, logOut);
+}
+
+QUaHistoryWriteStats QUaServer::historyWriteStats() const
+{
+	return m_historBackend.writeStats();
+}
+
+void QUaServer::resetHistoryWriteStats()
+{
+	m_historBackend.resetWriteStats();
+}
 #endif // UA_ENABLE_HISTORIZING
 
 void QUaServer::resetConfig()
@@ -1192,6 +1649,9 @@ void QUaServer::resetConfig()
 	config->accessControl.getUserAccessLevel        = &QUaServer::getUserAccessLevel;
 	config->accessControl.getUserExecutable         = &QUaServer::getUserExecutable;
 	config->accessControl.getUserExecutableOnObject = &QUaServer::getUserExecutableOnObject;
+#if UA_OPEN62541_VER_MAJOR > 1 || (UA_OPEN62541_VER_MAJOR == 1 && UA_OPEN62541_VER_MINOR >= 3)
+	config->accessControl.allowBrowseNode           = &QUaServer::allowBrowseNode;
+#endif
 
 	// TODO : implement rest of callbacks
 	//        allowAddNode_default
@@ -1228,6 +1688,11 @@ void QUaServer::resetConfig()
 	// custom instance declaration NodeId mechanism
 	config->nodeLifecycle.generateChildNodeId = &QUaServer::generateChildNodeId;
 
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+	// virtual folders keep track of monitored items
+	config->monitoredItemRegisterCallback = &QUaServer::monitoredItemRegister;
+#endif // UA_ENABLE_SUBSCRIPTIONS
+
 	Q_UNUSED(st);
 }
 
@@ -1279,6 +1744,7 @@ void QUaServer::setupServer()
 	m_pobjectsFolder = new QUaFolderObject(this);
 	m_pobjectsFolder->setParent(this);
 	m_pobjectsFolder->setObjectName( QStringLiteral("Objects") );
+	this->bindCppInstanceWithUaNode(m_pobjectsFolder, objectsNodeId);
 	// register base types (for all types)
 	this->registerSpecificationType<QUaBaseVariable>    (UA_NODEID_NUMERIC(0, UA_NS0ID_BASEVARIABLETYPE    ), true);
 	this->registerSpecificationType<QUaBaseDataVariable>(UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE));
@@ -1441,6 +1907,8 @@ void QUaServer::setupServer()
 #ifdef UA_ENABLE_HISTORIZING
 	UA_HistoryDataGathering gathering = UA_HistoryDataGathering_Default(1000);
 	m_historDatabase = UA_HistoryDatabase_default(gathering);
+	// aggregates are computed by the historizer backend, see QUaHistoryBackend::readHistoryAggregate
+	m_historDatabase.readProcessed = &QUaHistoryBackend::readProcessed;
 	// add historic event handling is supported
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	// NOTE : changed setEvent for optimized call in QUaServer_Anex::UA_Server_triggerEvent_Modified
@@ -1492,8 +1960,27 @@ QUaServer::~QUaServer()
 	{
 		delete this->children().at(0);
 	}
+	// detach remaining (parent-less) instances from the registry before deleting it
+	for (auto list : qAsConst(m_hashTypeInstances))
+	{
+		for (QUaNode* node = list->first; node; node = node->m_typeNext)
+		{
+			node->m_typeList = nullptr;
+		}
+		delete list;
+	}
+	m_hashTypeInstances.clear();
+	m_hashTypeInstancesSubtypes.clear();
+	// free lookup table keys of remaining (parent-less) instances
+	for (auto it = m_hashNodes.begin(); it != m_hashNodes.end(); ++it)
+	{
+		UA_NodeId key = it.key();
+		UA_NodeId_clear(&key);
+	}
+	m_hashNodes.clear();
 	// cleanup open62541
 	UA_Server_delete(this->m_server);
+	delete m_ingestQueue;
 }
 
 quint16 QUaServer::port() const
@@ -1641,16 +2128,50 @@ bool QUaServer::start()
 		return false;
 	}
 	m_running = true;
+	// iterate in dedicated thread if requested
+	if (m_iterateInThread)
+	{
+		QThread* iterThread = new QUaIterateThread([this]() {
+			while (!QThread::currentThread()->isInterruptionRequested())
+			{
+				UA_UInt16 msNextIter = 0;
+				QSet<qintptr> sockets;
+				{
+					QUaIterateLocker locker(this);
+					// NOTE : do not wait internally, else lock is held while waiting on sockets
+					msNextIter = this->runIterate();
+					sockets = this->networkSockets();
+				}
+				// wait without holding the lock, so this server's thread can access the address space
+				// NOTE : at least 1 ms, so a 0 ms deadline does not spin the loop
+				waitSockets(sockets, (std::max)(msNextIter, static_cast<UA_UInt16>(1)));
+			}
+		});
+		m_iterThread.storeRelease(iterThread);
+		iterThread->start();
+		// emit event
+		emit this->isRunningChanged(m_running);
+		return true;
+	}
+	// NOTE : precise timer so publishing and sampling intervals are honoured
+	m_iterWaitTimer.setTimerType(Qt::PreciseTimer);
 	QObject::connect(&m_iterWaitTimer, &QTimer::timeout, this,
 	[this]() {
 		// do not iterate if asked to stop
 		if (!m_running) { return; }
 		// iterate and restart
 		m_iterWaitTimer.stop();
-		// NOTE : any other delay or not waitInternal make subscribing to
-		//        events painfully slow
-		UA_Server_run_iterate(m_server, true);
-		m_iterWaitTimer.start(0);
+		// write values pushed from other threads before iterating
+		if (m_ingestQueue->size() > 0)
+		{
+			this->processIngestionQueue();
+		}
+		// NOTE : do not wait internally so the event loop is not blocked,
+		//        socket notifiers wake up the loop on network activity
+		UA_UInt16 msNextIter = this->runIterate();
+		this->updateSocketNotifiers();
+		// sleep until next open62541 timer deadline, at least 1 ms so the loop does not spin
+		m_iterWaitTimer.start((std::max)(msNextIter, static_cast<UA_UInt16>(1)));
 	}, Qt::QueuedConnection);
 	// start iterations
 	m_iterWaitTimer.start(0);
@@ -1677,6 +2198,26 @@ void QUaServer::stop()
 	m_running = false;
 	m_iterWaitTimer.stop();
 	m_iterWaitTimer.disconnect();
+	// stop dedicated thread if any, after this all access is again from this thread
+	QThread* iterThread = m_iterThread.loadAcquire();
+	if (iterThread)
+	{
+		// NOTE : no new method calls are dispatched once interruption is requested, but the
+		//        iterate thread might be blocked on a method call queued to this thread
+		iterThread->requestInterruption();
+		while (!iterThread->wait(10))
+		{
+			QCoreApplication::sendPostedEvents(nullptr, QEvent::MetaCall);
+		}
+		m_iterThread.storeRelease(nullptr);
+		delete iterThread;
+	}
+	this->clearSocketNotifiers();
+	m_iterStatsTimer.invalidate();
+	m_iterStatsBusyNs = 0;
+	m_iterStatsCount  = 0;
+	m_iterPerSecond.storeRelease(0);
+	m_iterIdlePermille.storeRelease(0);
 	UA_Server_run_shutdown(m_server);
 	// [FIX] force remove channels and sessions
 	// NOTE : cannot use UA_Server_cleanup because it only removes timedout sessions
@@ -1716,74 +2257,285 @@ void QUaServer::setIsRunning(const bool& running)
 	}
 }
 
-quint16 QUaServer::maxSecureChannels() const
+bool QUaServer::iterateInThread() const
 {
-	return m_maxSecureChannels;
+	return m_iterateInThread;
 }
 
-void QUaServer::setMaxSecureChannels(const quint16& maxSecureChannels)
+void QUaServer::setIterateInThread(const bool& iterateInThread)
 {
-	m_maxSecureChannels = maxSecureChannels;
-	emit this->maxSecureChannelsChanged(m_maxSecureChannels);
+	m_iterateInThread = iterateInThread;
+	emit this->iterateInThreadChanged(m_iterateInThread);
 }
 
-quint16 QUaServer::maxSessions() const
+int QUaServer::iterationsPerSecond() const
 {
-	return m_maxSessions;
+	return m_iterPerSecond.loadAcquire();
 }
 
-void QUaServer::setMaxSessions(const quint16& maxSessions)
+double QUaServer::idlePercentage() const
 {
-	m_maxSessions = maxSessions;
-	emit this->maxSessionsChanged(m_maxSessions);
+	return static_cast<double>(m_iterIdlePermille.loadAcquire()) / 10.0;
 }
 
-void QUaServer::setChildNodeIdCallback(const QUaChildNodeIdCallback& callback)
+quint32 QUaServer::ingestionQueueDepth() const
 {
-	m_childNodeIdCallback = callback;
+	return m_ingestQueue->size();
 }
 
-void QUaServer::registerTypeInternal(
-	const QMetaObject& metaObject, 
-	const QUaNodeId& nodeId/* = ""*/
-)
+quint64 QUaServer::ingestionQueueDropped() const
 {
-	// check if OPC UA relevant
-	if (!metaObject.inherits(&QUaNode::staticMetaObject))
-	{
-		Q_ASSERT_X(false, "QUaServer::registerType", "Unsupported base class");
-		return;
-	}
-	// check if already registered
-	QString   strClassName = QString::fromUtf8(metaObject.className());
-	UA_NodeId newTypeNodeId = m_mapTypes.value(strClassName, UA_NODEID_NULL);
-	if (!UA_NodeId_isNull(&newTypeNodeId))
-	{
-		Q_ASSERT(m_mapTypes.contains(strClassName));
-		return;
-	}
-	// create new type browse name
-	UA_QualifiedName browseName;
-	browseName.namespaceIndex = 0;
-	browseName.name = QUaTypesConverter::uaStringFromQString(strClassName);
-	// check if base class is registered
-	QString strBaseClassName = QString::fromUtf8(metaObject.superClass()->className());
-	if (!m_mapTypes.contains(strBaseClassName))
-	{
-		// recursive
-		this->registerTypeInternal(*metaObject.superClass());
-	}
-	Q_ASSERT_X(m_mapTypes.contains(strBaseClassName), "QUaServer::registerType", "Base object type not registered.");
-	// check if requested node id defined
-	if (!nodeId.isNull())
-	{
-		// check if requested node id exists
-		bool isUsed = this->isNodeIdUsed(nodeId);
-		Q_ASSERT_X(!isUsed, "QUaServer::registerType", "Requested NodeId already exists");
-		if (isUsed)
-		{
-			UA_QualifiedName_clear(&browseName);
-			return;
+	return m_ingestQueue->dropped();
+}
+
+quint64 QUaServer::ingestionQueueProcessed() const
+{
+	return m_ingestQueue->processed();
+}
+
+quint64 QUaServer::valueCacheMemory() const
+{
+	QUaIterateLocker locker(this);
+	return m_valueCacheMemory;
+}
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+int QUaServer::changeEventWindow() const
+{
+	return m_changeEventWindow;
+}
+
+void QUaServer::setChangeEventWindow(const int& msecs)
+{
+	m_changeEventWindow = qMax(0, msecs);
+}
+
+int QUaServer::changeEventMaxBatch() const
+{
+	return m_changeEventMaxBatch;
+}
+
+void QUaServer::setChangeEventMaxBatch(const int& maxBatch)
+{
+	m_changeEventMaxBatch = qMax(0, maxBatch);
+}
+
+quint64 QUaServer::changeEventsEmitted() const
+{
+	return m_changeEventsCount;
+}
+
+quint64 QUaServer::changesEmitted() const
+{
+	return m_changesCount;
+}
+
+double QUaServer::changesPerEvent() const
+{
+	return m_changeEventsCount == 0 ? 0.0 :
+		static_cast<double>(m_changesCount) / static_cast<double>(m_changeEventsCount);
+}
+
+qint64 QUaServer::changeEventLatency() const
+{
+	return m_changeEventLatencyNs;
+}
+
+qint64 QUaServer::changeEventMaxLatency() const
+{
+	return m_changeEventMaxLatencyNs;
+}
+
+void QUaServer::resetChangeEventStats()
+{
+	m_changeEventsCount       = 0;
+	m_changesCount            = 0;
+	m_changeEventLatencyNs    = 0;
+	m_changeEventMaxLatencyNs = 0;
+}
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
+quint32 QUaServer::ingestionQueueCapacity() const
+{
+	return m_ingestQueue->capacity();
+}
+
+void QUaServer::setIngestionQueueCapacity(const quint32& capacity)
+{
+	if (QUaIngestionQueue::roundCapacity(capacity) == m_ingestQueue->capacity())
+	{
+		return;
+	}
+	// write pending values before replacing the queue
+	this->processIngestionQueue();
+	auto newQueue = new QUaIngestionQueue(capacity);
+	newQueue->addDropped(m_ingestQueue->dropped());
+	newQueue->addProcessed(m_ingestQueue->processed());
+	delete m_ingestQueue;
+	m_ingestQueue = newQueue;
+}
+
+UA_UInt16 QUaServer::runIterate()
+{
+	if (!m_iterStatsTimer.isValid())
+	{
+		m_iterStatsTimer.start();
+	}
+	QElapsedTimer busyTimer;
+	busyTimer.start();
+	UA_UInt16 msNextIter = UA_Server_run_iterate(m_server, false);
+	m_iterStatsBusyNs += busyTimer.nsecsElapsed();
+	m_iterStatsCount++;
+	// update statistics every second
+	qint64 windowNs = m_iterStatsTimer.nsecsElapsed();
+	if (windowNs >= 1000000000)
+	{
+		m_iterPerSecond.storeRelease(
+			static_cast<int>(static_cast<qint64>(m_iterStatsCount) * 1000000000 / windowNs)
+		);
+		m_iterIdlePermille.storeRelease(
+			1000 - static_cast<int>((std::min)(m_iterStatsBusyNs * 1000 / windowNs, static_cast<qint64>(1000)))
+		);
+		m_iterStatsBusyNs = 0;
+		m_iterStatsCount  = 0;
+		m_iterStatsTimer.restart();
+	}
+	return msNextIter;
+}
+
+QSet<qintptr> QUaServer::networkSockets() const
+{
+	QSet<qintptr> sockets;
+#ifdef QUA_SERVER_NETWORK_LAYER_TCP
+	UA_ServerConfig* config = UA_Server_getConfig(m_server);
+	for (size_t i = 0; i < config->networkLayersSize; i++)
+	{
+		auto layer = static_cast<ServerNetworkLayerTCP*>(config->networkLayers[i].handle);
+		if (!layer)
+		{
+			continue;
+		}
+		for (UA_UInt16 k = 0; k < layer->serverSocketsSize; k++)
+		{
+			sockets << static_cast<qintptr>(layer->serverSockets[k]);
+		}
+		ConnectionEntry* entry;
+		LIST_FOREACH(entry, &layer->connections, pointers)
+		{
+			sockets << static_cast<qintptr>(entry->connection.sockfd);
+		}
+	}
+#endif // QUA_SERVER_NETWORK_LAYER_TCP
+	return sockets;
+}
+
+void QUaServer::updateSocketNotifiers()
+{
+	QSet<qintptr> sockets = this->networkSockets();
+	// remove notifiers of closed sockets
+	auto iter = m_hashSocketNotifiers.begin();
+	while (iter != m_hashSocketNotifiers.end())
+	{
+		if (sockets.contains(iter.key()))
+		{
+			++iter;
+			continue;
+		}
+		delete iter.value();
+		iter = m_hashSocketNotifiers.erase(iter);
+	}
+	// add notifiers of new sockets
+	for (auto socket : sockets)
+	{
+		if (m_hashSocketNotifiers.contains(socket))
+		{
+			continue;
+		}
+		auto notifier = new QSocketNotifier(socket, QSocketNotifier::Read, this);
+		QObject::connect(notifier, &QSocketNotifier::activated, this,
+		[this]() {
+			// iterate on next event loop iteration
+			m_iterWaitTimer.start(0);
+		});
+		m_hashSocketNotifiers[socket] = notifier;
+	}
+}
+
+void QUaServer::clearSocketNotifiers()
+{
+	qDeleteAll(m_hashSocketNotifiers);
+	m_hashSocketNotifiers.clear();
+}
+
+quint16 QUaServer::maxSecureChannels() const
+{
+	return m_maxSecureChannels;
+}
+
+void QUaServer::setMaxSecureChannels(const quint16& maxSecureChannels)
+{
+	m_maxSecureChannels = maxSecureChannels;
+	emit this->maxSecureChannelsChanged(m_maxSecureChannels);
+}
+
+quint16 QUaServer::maxSessions() const
+{
+	return m_maxSessions;
+}
+
+void QUaServer::setMaxSessions(const quint16& maxSessions)
+{
+	m_maxSessions = maxSessions;
+	emit this->maxSessionsChanged(m_maxSessions);
+}
+
+void QUaServer::setChildNodeIdCallback(const QUaChildNodeIdCallback& callback)
+{
+	m_childNodeIdCallback = callback;
+}
+
+void QUaServer::registerTypeInternal(
+	const QMetaObject& metaObject, 
+	const QUaNodeId& nodeId/* = ""*/
+)
+{
+	QUaIterateLocker locker(this);
+	// check if OPC UA relevant
+	if (!metaObject.inherits(&QUaNode::staticMetaObject))
+	{
+		Q_ASSERT_X(false, "QUaServer::registerType", "Unsupported base class");
+		return;
+	}
+	// check if already registered
+	QString   strClassName = QString::fromUtf8(metaObject.className());
+	UA_NodeId newTypeNodeId = m_mapTypes.value(strClassName, UA_NODEID_NULL);
+	if (!UA_NodeId_isNull(&newTypeNodeId))
+	{
+		Q_ASSERT(m_mapTypes.contains(strClassName));
+		return;
+	}
+	// create new type browse name
+	UA_QualifiedName browseName;
+	browseName.namespaceIndex = 0;
+	browseName.name = QUaTypesConverter::uaStringFromQString(strClassName);
+	// check if base class is registered
+	QString strBaseClassName = QString::fromUtf8(metaObject.superClass()->className());
+	if (!m_mapTypes.contains(strBaseClassName))
+	{
+		// recursive
+		this->registerTypeInternal(*metaObject.superClass());
+	}
+	Q_ASSERT_X(m_mapTypes.contains(strBaseClassName), "QUaServer::registerType", "Base object type not registered.");
+	// check if requested node id defined
+	if (!nodeId.isNull())
+	{
+		// check if requested node id exists
+		bool isUsed = this->isNodeIdUsed(nodeId);
+		Q_ASSERT_X(!isUsed, "QUaServer::registerType", "Requested NodeId already exists");
+		if (isUsed)
+		{
+			UA_QualifiedName_clear(&browseName);
+			return;
 		}
 	}
 	UA_NodeId reqNodeId = nodeId;
@@ -1859,7 +2611,8 @@ void QUaServer::registerTypeInternal(
 	if (metaObject.inherits(&QUaBaseEvent::staticMetaObject))
 	{
 		Q_ASSERT(!m_hashTypeVars.contains(newTypeNodeId));
-		m_hashTypeVars[newTypeNodeId] =
+		// NOTE : interned to match instances' typeDefinitionNodeId by pointer
+		m_hashTypeVars[QUaNodeId(newTypeNodeId).interned()] =
 			QUaNode::getTypeVars(
 				newTypeNodeId,
 				this->m_server
@@ -1870,6 +2623,7 @@ void QUaServer::registerTypeInternal(
 
 QList<QUaNode*> QUaServer::typeInstances(const QMetaObject& metaObject)
 {
+	QUaIterateLocker locker(this);
 	QList<QUaNode*> retList;
 	// check if OPC UA relevant
 	if (!metaObject.inherits(&QUaNode::staticMetaObject))
@@ -1880,49 +2634,183 @@ QList<QUaNode*> QUaServer::typeInstances(const QMetaObject& metaObject)
 	// try to get typeNodeId, if null, then register it
 	UA_NodeId typeNodeId = this->typeIdByMetaObject(metaObject);
 	Q_ASSERT(!UA_NodeId_isNull(&typeNodeId));
-	// make ua browse
-	auto refTypeId = UA_NODEID_NUMERIC(0, UA_NS0ID_HASTYPEDEFINITION);
-	QList<UA_NodeId> retRefSet;
-	UA_BrowseDescription* bDesc = UA_BrowseDescription_new();
-	UA_NodeId_copy(&typeNodeId, &bDesc->nodeId);
-	bDesc->browseDirection = UA_BROWSEDIRECTION_INVERSE; //TypeDefinitionOf
-	bDesc->includeSubtypes = true;
-	bDesc->referenceTypeId = refTypeId;
-	bDesc->resultMask = UA_BROWSERESULTMASK_REFERENCETYPEID;
-	// browse
-	UA_BrowseResult bRes = UA_Server_browse(m_server, 0, bDesc);
-	Q_ASSERT(bRes.statusCode == UA_STATUSCODE_GOOD);
-	while (bRes.referencesSize > 0)
-	{
-		for (size_t i = 0; i < bRes.referencesSize; i++)
-		{
-			UA_ReferenceDescription rDesc = bRes.references[i];
-			Q_ASSERT(UA_NodeId_equal(&rDesc.referenceTypeId, &refTypeId));
-			UA_NodeId nodeId/* = rDesc.nodeId.nodeId*/;
-			UA_NodeId_copy(&rDesc.nodeId.nodeId, &nodeId);
-			retRefSet << nodeId;
-		}
-        UA_BrowseResult_clear(&bRes);
-		bRes = UA_Server_browseNext(m_server, true, &bRes.continuationPoint);
+	Q_UNUSED(typeNodeId);
+	// read from instance registry instead of browsing inverse HasTypeDefinition references
+	const auto lists = this->typeInstanceSubtypeLists(metaObject);
+	int count = 0;
+	for (auto list : lists)
+	{
+		count += list->count;
 	}
-	// cleanup
-    UA_BrowseDescription_clear(bDesc);
-	UA_BrowseDescription_delete(bDesc);
-    UA_BrowseResult_clear(&bRes);
-	// get QUaNode references
-	for (int i = 0; i < retRefSet.count(); i++)
+	retList.reserve(count);
+	for (auto list : lists)
 	{
-		// when browsing ObjectsFolder there are children with null context (Server object and children)
-		QUaNode* node = QUaNode::getNodeContext(retRefSet[i], m_server);
-		if (node)
+		for (QUaNode* node = list->first; node; node = node->m_typeNext)
 		{
 			retList << node;
 		}
-		UA_NodeId_clear(&retRefSet[i]);
 	}
 	return retList;
 }
 
+int QUaServer::typeInstanceCount(const QMetaObject& metaObject, const bool& includeSubtypes)
+{
+	QUaIterateLocker locker(this);
+	if (!includeSubtypes)
+	{
+		auto list = m_hashTypeInstances.value(QUaServer::typeInstanceKey(metaObject), nullptr);
+		return list ? list->count : 0;
+	}
+	int count = 0;
+	const auto lists = this->typeInstanceSubtypeLists(metaObject);
+	for (auto list : lists)
+	{
+		count += list->count;
+	}
+	return count;
+}
+
+void QUaServer::registerTypeInstance(QUaNode* node)
+{
+	Q_CHECK_PTR(node);
+	Q_ASSERT(!node->m_typeList);
+	// NOTE : node->metaObject() is the static meta object of the most derived class
+	const QMetaObject* metaObject = node->metaObject();
+	QByteArray key = QUaServer::typeInstanceKey(*metaObject);
+	QUaTypeInstanceList* list = m_hashTypeInstances.value(key, nullptr);
+	if (!list)
+	{
+		list = new QUaTypeInstanceList{ metaObject, nullptr, nullptr, 0 };
+		m_hashTypeInstances.insert(key, list);
+		// new type might be a subtype of cached ones
+		m_hashTypeInstancesSubtypes.clear();
+	}
+	// append to tail
+	node->m_typeList = list;
+	node->m_typePrev = list->last;
+	node->m_typeNext = nullptr;
+	if (list->last)
+	{
+		list->last->m_typeNext = node;
+	}
+	else
+	{
+		list->first = node;
+	}
+	list->last = node;
+	list->count++;
+}
+
+void QUaServer::unregisterTypeInstance(QUaNode* node)
+{
+	Q_CHECK_PTR(node);
+	QUaTypeInstanceList* list = node->m_typeList;
+	if (!list)
+	{
+		return;
+	}
+	if (node->m_typePrev)
+	{
+		node->m_typePrev->m_typeNext = node->m_typeNext;
+	}
+	else
+	{
+		list->first = node->m_typeNext;
+	}
+	if (node->m_typeNext)
+	{
+		node->m_typeNext->m_typePrev = node->m_typePrev;
+	}
+	else
+	{
+		list->last = node->m_typePrev;
+	}
+	list->count--;
+	Q_ASSERT(list->count >= 0);
+	node->m_typeList = nullptr;
+	node->m_typePrev = nullptr;
+	node->m_typeNext = nullptr;
+}
+
+QVector<QUaTypeInstanceList*> QUaServer::typeInstanceSubtypeLists(const QMetaObject& metaObject)
+{
+	QByteArray key = QUaServer::typeInstanceKey(metaObject);
+	auto it = m_hashTypeInstancesSubtypes.find(key);
+	if (it != m_hashTypeInstancesSubtypes.end())
+	{
+		return it.value();
+	}
+	// NOTE : compare class names because metaObject might be a copy (e.g. getRegisteredMetaObject)
+	QVector<QUaTypeInstanceList*> lists;
+	for (auto list : qAsConst(m_hashTypeInstances))
+	{
+		for (auto super = list->metaObject; super; super = super->superClass())
+		{
+			if (qstrcmp(super->className(), metaObject.className()) == 0)
+			{
+				lists << list;
+				break;
+			}
+		}
+	}
+	// NOTE : key must point to static data, className of a copy is shared with the original
+	m_hashTypeInstancesSubtypes.insert(key, lists);
+	return lists;
+}
+
+QList<QUaQualifiedName> QUaServer::typeChildrenTemplate(const QMetaObject& metaObject, QUaNode* instance)
+{
+	QByteArray key = QUaServer::typeInstanceKey(metaObject);
+	auto it = m_hashTypeChildren.find(key);
+	if (it != m_hashTypeChildren.end())
+	{
+		return it.value();
+	}
+	QList<QUaQualifiedName> browseNames;
+	// list meta props
+	int propCount  = metaObject.propertyCount();
+	int propOffset = QUaNode::getPropsOffsetHelper(metaObject);
+	for (int i = propOffset; i < propCount; i++)
+	{
+		QMetaProperty metaProperty = metaObject.property(i);
+		// check if not enum
+		if (!metaProperty.isEnumType())
+		{
+			// check if available in meta-system
+			const QMetaObject *propMetaObject = QMetaType(metaProperty.userType()).metaObject();
+			if (!propMetaObject)
+			{ continue; }
+			// check if OPC UA relevant type
+			if (!propMetaObject->inherits(&QUaNode::staticMetaObject))
+			{ continue; }
+			// check if prop inherits from parent
+			Q_ASSERT_X(!propMetaObject->inherits(&metaObject), "QUaNode Constructor",
+				"Qt MetaProperty type cannot inherit from Class.");
+			if (propMetaObject->inherits(&metaObject))
+			{ continue; }
+		}
+		browseNames << QUaQualifiedName(QString::fromUtf8(metaProperty.name()));
+	}
+	// handle mandatory children of instance declarations
+	QUaNodeId typeNodeId = instance->typeDefinitionNodeId();
+	Q_ASSERT(m_hashMandatoryChildren.contains(typeNodeId));
+	const auto mandatoryList = m_hashMandatoryChildren.value(typeNodeId);
+	for (const auto & browseName : mandatoryList)
+	{
+		browseNames << browseName;
+	}
+	// NOTE : key must point to static data, className of a copy is shared with the original
+	m_hashTypeChildren.insert(key, browseNames);
+	return browseNames;
+}
+
+QByteArray QUaServer::typeInstanceKey(const QMetaObject& metaObject)
+{
+	// NOTE : no allocation, class name is static data
+	const char* className = metaObject.className();
+	return QByteArray::fromRawData(className, static_cast<int>(qstrlen(className)));
+}
+
 void QUaServer::registerTypeLifeCycle(const UA_NodeId& typeNodeId, const QMetaObject& metaObject)
 {
 	Q_ASSERT(!UA_NodeId_isNull(&typeNodeId));
@@ -2392,13 +3280,117 @@ UA_NodeId QUaServer::createInstanceInternal(
 	const QUaQualifiedName& browseName,
 	const QUaNodeId& nodeId
 )
+{
+	QUaIterateLocker locker(this);
+	QUaInstanceContext context;
+	if (!this->initInstanceContext(metaObject, parentNode, context))
+	{
+		return UA_NODEID_NULL;
+	}
+	UA_NodeId nodeIdNewInstance = this->addInstanceNode(
+		context,
+		metaObject,
+		parentNode,
+		browseName,
+		nodeId
+	);
+	this->clearInstanceContext(context);
+	// trigger reference added, model change event, so client (UaExpert) auto refreshes tree
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	if (!UA_NodeId_isNull(&nodeIdNewInstance) && parentNode && parentNode->inAddressSpace())
+	{
+		Q_CHECK_PTR(m_changeEvent);
+		// add reference added change to buffer
+		this->addChange({
+			parentNode->nodeId(),
+			parentNode->typeDefinitionNodeId(),
+			QUaChangeVerb::ReferenceAdded // UaExpert does not recognize QUaChangeVerb::NodeAdded
+		});
+	}
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// return new instance node id
+	return nodeIdNewInstance;
+}
+
+QList<QUaNode*> QUaServer::createInstancesInternal(
+	const QMetaObject& metaObject,
+	QUaNode* parentNode,
+	const QList<QUaQualifiedName>& browseNames,
+	const QList<QUaNodeId>& nodeIds
+)
+{
+	QList<QUaNode*> newInstances;
+	Q_ASSERT_X(nodeIds.isEmpty() || nodeIds.count() == browseNames.count(), 
+		"QUaServer::createInstances", "NodeIds must be empty or the same size as BrowseNames");
+	if (!nodeIds.isEmpty() && nodeIds.count() != browseNames.count())
+	{
+		return newInstances;
+	}
+	// lock once for the whole batch
+	QUaIterateLocker locker(this);
+	// type lookup and type attributes are resolved once for all instances
+	QUaInstanceContext context;
+	if (!this->initInstanceContext(metaObject, parentNode, context))
+	{
+		return newInstances;
+	}
+	newInstances.reserve(browseNames.count());
+	for (int i = 0; i < browseNames.count(); i++)
+	{
+		UA_NodeId nodeIdNewInstance = this->addInstanceNode(
+			context,
+			metaObject,
+			parentNode,
+			browseNames.at(i),
+			nodeIds.isEmpty() ? QUaNodeId() : nodeIds.at(i)
+		);
+		// keep failed slot as nullptr, so results match browseNames by index
+		if (UA_NodeId_isNull(&nodeIdNewInstance))
+		{
+			emit this->logMessage({
+				tr("Failed to create instance %1 of type %2 under %3.")
+				.arg(browseNames.at(i).toXmlString())
+				.arg(metaObject.className())
+				.arg(parentNode ? parentNode->nodeId().toXmlString() : QString()),
+				QUaLogLevel::Error,
+				QUaLogCategory::UserLand
+			});
+			newInstances.append(nullptr);
+			continue;
+		}
+		auto newInstance = QUaNode::getNodeContext(nodeIdNewInstance, m_server);
+		Q_CHECK_PTR(newInstance);
+		newInstances.append(newInstance);
+		UA_NodeId_clear(&nodeIdNewInstance);
+	}
+	this->clearInstanceContext(context);
+	// a single model change event for the whole batch
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	if (newInstances.count(nullptr) < newInstances.count() && parentNode && parentNode->inAddressSpace())
+	{
+		Q_CHECK_PTR(m_changeEvent);
+		this->addChange({
+			parentNode->nodeId(),
+			parentNode->typeDefinitionNodeId(),
+			QUaChangeVerb::ReferenceAdded // UaExpert does not recognize QUaChangeVerb::NodeAdded
+		});
+	}
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	return newInstances;
+}
+
+bool QUaServer::initInstanceContext(
+	const QMetaObject& metaObject,
+	QUaNode* parentNode,
+	QUaInstanceContext& context
+)
 {
 	// check if OPC UA relevant
 	if (!metaObject.inherits(&QUaNode::staticMetaObject))
 	{
 		Q_ASSERT_X(false, "QUaServer::createInstance",
 			"Unsupported base class. It must derive from QUaNode");
-		return UA_NODEID_NULL;
+		return false;
 	}
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	// check if inherits BaseEventType, in which case this method cannot be used
@@ -2410,24 +3402,69 @@ UA_NodeId QUaServer::createInstanceInternal(
 	{
 		Q_ASSERT_X(false, "QUaServer::createInstanceInternal",
 			"Cannot use createInstance to create Non-Condition Events. Use createEvent method instead");
-		return UA_NODEID_NULL;
+		return false;
 	}
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	// try to get typeNodeId, if null, then register it
-	UA_NodeId typeNodeId = this->typeIdByMetaObject(metaObject);
-	Q_ASSERT(!UA_NodeId_isNull(&typeNodeId));
+	context.typeNodeId = this->typeIdByMetaObject(metaObject);
+	Q_ASSERT(!UA_NodeId_isNull(&context.typeNodeId));
 	// adapt parent relation with child according to parent type
 	// NOTE : parent can be null (no address space representation, e.g. events, conditions)
-	UA_NodeId referenceTypeId = parentNode ?
+	context.referenceTypeId = parentNode ?
 		QUaServer::getReferenceTypeId(*parentNode->metaObject(), metaObject) :
 		UA_NODEID_NULL;
+	Q_ASSERT(parentNode ? !UA_NodeId_isNull(&parentNode->m_nodeId) : true);
+	// check if variable or object 
+	// NOTE : a type is considered to inherit itself 
+	// (http://doc.qt.io/qt-5/qmetaobject.html#inherits)
+	context.isVariable = metaObject.inherits(&QUaBaseVariable::staticMetaObject);
+	context.vAttr = UA_VariableAttributes_default;
+	UA_Variant_init(&context.arrayDimensions);
+	if (!context.isVariable)
+	{
+		Q_ASSERT(metaObject.inherits(&QUaBaseObject::staticMetaObject) ||
+			metaObject.className() == QUaBaseObject::staticMetaObject.className());
+		return true;
+	}
+	// some types require the attrs to match because open62541 checks them
+	auto st = UA_Server_readDataType(m_server, context.typeNodeId, &context.vAttr.dataType);
+	Q_ASSERT(st == UA_STATUSCODE_GOOD);
+	Q_UNUSED(st);
+	st = UA_Server_readValueRank(m_server, context.typeNodeId, &context.vAttr.valueRank);
+	Q_ASSERT(st == UA_STATUSCODE_GOOD);
+	Q_UNUSED(st);
+	st = UA_Server_readArrayDimensions(m_server, context.typeNodeId, &context.arrayDimensions);
+	Q_ASSERT(st == UA_STATUSCODE_GOOD);
+	Q_UNUSED(st);
+	context.vAttr.arrayDimensionsSize = context.arrayDimensions.arrayLength;
+	context.vAttr.arrayDimensions = static_cast<quint32*>(context.arrayDimensions.data);
+	return true;
+}
+
+void QUaServer::clearInstanceContext(QUaInstanceContext& context)
+{
+	// NOTE : do not UA_NodeId_clear(&context.typeNodeId); or value in m_mapTypes gets corrupted
+	UA_NodeId_clear(&context.referenceTypeId);
+	UA_NodeId_clear(&context.vAttr.dataType);
+	UA_Variant_clear(&context.arrayDimensions);
+	context.vAttr.arrayDimensionsSize = 0;
+	context.vAttr.arrayDimensions = nullptr;
+}
+
+UA_NodeId QUaServer::addInstanceNode(
+	const QUaInstanceContext& context,
+	const QMetaObject& metaObject,
+	QUaNode* parentNode,
+	const QUaQualifiedName& browseName,
+	const QUaNodeId& nodeId
+)
+{
 	// check if browse name already used with parent (if any parent)
 	if (parentNode && parentNode->hasChild(browseName))
 	{
 		Q_ASSERT_X(false, "QUaServer::createInstance", "Requested BrowseName already exists in parent");
 		return UA_NODEID_NULL;
 	}
-	UA_QualifiedName uaBrowseName = browseName;
 	// check if requested node id defined
 	if (!nodeId.isNull())
 	{
@@ -2439,62 +3476,42 @@ UA_NodeId QUaServer::createInstanceInternal(
 			return UA_NODEID_NULL;
 		}
 	}
+	UA_QualifiedName uaBrowseName = browseName;
+	// default displayName is browseName
+	QByteArray byteDisplayName = browseName.name().toUtf8();
 	// NOTE : calling UA_Server_addXXX below will trigger QUaServer::uaConstructor
 	// which will instantiate the respective Qt instance and binding
 	UA_NodeId reqNodeId = nodeId;
-	UA_NodeId nodeIdNewInstance;
-	// check if variable or object 
-	// NOTE : a type is considered to inherit itself 
-	// (http://doc.qt.io/qt-5/qmetaobject.html#inherits)
-	Q_ASSERT(parentNode ? !UA_NodeId_isNull(&parentNode->m_nodeId) : true);
-	if (metaObject.inherits(&QUaBaseVariable::staticMetaObject))
+	UA_NodeId nodeIdNewInstance = UA_NODEID_NULL;
+	if (context.isVariable)
 	{
-		// some types require the attrs to match because open62541 checks them
-		UA_VariableAttributes vAttr = UA_VariableAttributes_default;
-		auto st = UA_Server_readDataType(m_server, typeNodeId, &vAttr.dataType);
-		Q_ASSERT(st == UA_STATUSCODE_GOOD);
-		Q_UNUSED(st);
-		st = UA_Server_readValueRank(m_server, typeNodeId, &vAttr.valueRank);
-		Q_ASSERT(st == UA_STATUSCODE_GOOD);
-		Q_UNUSED(st);
-		UA_Variant outArrayDimensions;
-		st = UA_Server_readArrayDimensions(m_server, typeNodeId, &outArrayDimensions);
-		Q_ASSERT(st == UA_STATUSCODE_GOOD);
-		Q_UNUSED(st);
-		vAttr.arrayDimensionsSize = outArrayDimensions.arrayLength;
-		vAttr.arrayDimensions = static_cast<quint32*>(outArrayDimensions.data);
-		// default displayName is browseName
-		QByteArray byteDisplayName = browseName.name().toUtf8();
+		// shallow copy, type attributes are owned by context
+		UA_VariableAttributes vAttr = context.vAttr;
 		vAttr.displayName = UA_LOCALIZEDTEXT((char*)"", byteDisplayName.data());
 		// add variable
-        st = UA_Server_addVariableNode(m_server,
+		auto st = UA_Server_addVariableNode(m_server,
 			reqNodeId,            // requested nodeId
 			parentNode ? parentNode->m_nodeId : UA_NODEID_NULL, // parent (can be null)
-			referenceTypeId,      // parent relation with child
+			context.referenceTypeId, // parent relation with child
 			uaBrowseName,
-			typeNodeId,
+			context.typeNodeId,
 			vAttr,
 			nullptr,             // context
 			&nodeIdNewInstance); // set new nodeId to new instance
 		Q_ASSERT(st == UA_STATUSCODE_GOOD);
 		Q_UNUSED(st);
-		UA_Variant_clear(&outArrayDimensions);
 	}
 	else
 	{
-		Q_ASSERT(metaObject.inherits(&QUaBaseObject::staticMetaObject) ||
-			metaObject.className() == QUaBaseObject::staticMetaObject.className());
 		UA_ObjectAttributes oAttr = UA_ObjectAttributes_default;
-		// default displayName is browseName
-		QByteArray byteDisplayName = browseName.name().toUtf8();
 		oAttr.displayName = UA_LOCALIZEDTEXT((char*)"", byteDisplayName.data());
 		// add object
 		auto st = UA_Server_addObjectNode(m_server,
 			reqNodeId,            // requested nodeId
 			parentNode ? parentNode->m_nodeId : UA_NODEID_NULL, // parent
-			referenceTypeId,      // parent relation with child
+			context.referenceTypeId, // parent relation with child
 			uaBrowseName,
-			typeNodeId,
+			context.typeNodeId,
 			oAttr,
 			nullptr,             // context
 			&nodeIdNewInstance); // set new nodeId to new instance
@@ -2504,13 +3521,12 @@ UA_NodeId QUaServer::createInstanceInternal(
 	Q_ASSERT_X(!UA_NodeId_isNull(&nodeIdNewInstance), "QUaServer::createInstanceInternal", "Something went wrong");
 	// clean up
 	UA_NodeId_clear(&reqNodeId);
-	// NOTE : do not UA_NodeId_clear(&typeNodeId); or value in m_mapTypes gets corrupted
-	UA_NodeId_clear(&referenceTypeId);
 	UA_QualifiedName_clear(&uaBrowseName);
 
 	// if child is condition, add non-hierarchical reference and default props
 #ifdef UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
-	if (parentNode && metaObject.inherits(&QUaCondition::staticMetaObject))
+	if (parentNode && !UA_NodeId_isNull(&nodeIdNewInstance) && 
+		metaObject.inherits(&QUaCondition::staticMetaObject))
 	{
 		// add HasCondition reference
 		auto node = QUaNode::getNodeContext(nodeIdNewInstance, this->m_server);
@@ -2519,23 +3535,9 @@ UA_NodeId QUaServer::createInstanceInternal(
 		// set default originator
 		condition->QUaBaseEvent::setSourceNode(parentNode);
 	}
+#else
+	Q_UNUSED(metaObject);
 #endif // UA_ENABLE_SUBSCRIPTIONS_ALARMS_CONDITIONS
-
-	// trigger reference added, model change event, so client (UaExpert) auto refreshes tree
-#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
-	if (parentNode && parentNode->inAddressSpace())
-	{
-		Q_CHECK_PTR(m_changeEvent);
-		// add reference added change to buffer
-		this->addChange({
-			parentNode->nodeId(),
-			parentNode->typeDefinitionNodeId(),
-			QUaChangeVerb::ReferenceAdded // UaExpert does not recognize QUaChangeVerb::NodeAdded
-		});
-	}
-#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
-
-	// return new instance node id
 	return nodeIdNewInstance;
 }
 
@@ -2566,14 +3568,40 @@ UA_NodeId QUaServer::createEventInternal(
 
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 
-void QUaServer::bindCppInstanceWithUaNode(QUaNode* nodeInstance, UA_NodeId& nodeId)
+void QUaServer::bindCppInstanceWithUaNode(QUaNode* nodeInstance, const UA_NodeId& nodeId)
 {
 	Q_CHECK_PTR(nodeInstance);
 	Q_ASSERT(!UA_NodeId_isNull(&nodeId));
-	// set c++ instance as context
-	UA_Server_setNodeContext(m_server, nodeId, (void**)(&nodeInstance));
 	// set node id to c++ instance
 	nodeInstance->m_nodeId = nodeId;
+	nodeInstance->m_internedNodeId.clear();
+	// add to lookup table, overwrite (and free) key if already bound
+	auto it = m_hashNodes.find(nodeId);
+	if (it != m_hashNodes.end())
+	{
+		it.value() = nodeInstance;
+	}
+	else
+	{
+		UA_NodeId key;
+		UA_NodeId_copy(&nodeId, &key);
+		m_hashNodes.insert(key, nodeInstance);
+	}
+	// add to per-type instance registry
+	this->registerTypeInstance(nodeInstance);
+}
+
+void QUaServer::unbindCppInstance(QUaNode* nodeInstance)
+{
+	Q_CHECK_PTR(nodeInstance);
+	auto it = m_hashNodes.find(nodeInstance->m_nodeId);
+	if (it == m_hashNodes.end() || it.value() != nodeInstance)
+	{
+		return;
+	}
+	UA_NodeId key = it.key();
+	m_hashNodes.erase(it);
+	UA_NodeId_clear(&key);
 }
 
 bool QUaServer::isMetaObjectRegistered(const QString& strClassName) const
@@ -2589,6 +3617,7 @@ QMetaObject QUaServer::getRegisteredMetaObject(const QString& strClassName) cons
 
 bool QUaServer::registerReferenceType(const QUaReferenceType& refType, const QUaNodeId& nodeId/* = ""*/)
 {
+	QUaIterateLocker locker(this);
 	// first check if already registered
 	if (m_hashRefTypes.contains(refType))
 	{
@@ -2650,6 +3679,7 @@ bool QUaServer::referenceTypeRegistered(const QUaReferenceType& refType) const
 
 bool QUaServer::isNodeIdUsed(const QUaNodeId& nodeId) const
 {
+	QUaIterateLocker locker(this);
 	// check if requested node id exists
 	UA_NodeId reqNodeId  = nodeId;
 	UA_NodeId testNodeId = nodeId;
@@ -2664,12 +3694,212 @@ QUaFolderObject* QUaServer::objectsFolder() const
 	return m_pobjectsFolder;
 }
 
+void QUaServer::writeValues(const QVector<QUaWriteValue>& values)
+{
+	QUaIterateLocker locker(this);
+	// defer change signals until all values are written
+	Q_ASSERT_X(!m_deferWriteSignals, "QUaServer::writeValues", "Nested calls are not supported.");
+	m_deferWriteSignals = true;
+	for (const auto& writeValue : values)
+	{
+		Q_CHECK_PTR(writeValue.variable);
+		if (!writeValue.variable)
+		{
+			continue;
+		}
+		// no type inference, conversion nor data type rewrite if already of the variable's type
+		if (writeValue.variable->setValueIfNative(
+			writeValue.value,
+			writeValue.statusCode,
+			writeValue.sourceTimestamp,
+			writeValue.serverTimestamp))
+		{
+			continue;
+		}
+		writeValue.variable->setValue(
+			writeValue.value,
+			writeValue.statusCode,
+			writeValue.sourceTimestamp,
+			writeValue.serverTimestamp
+		);
+	}
+	m_deferWriteSignals = false;
+	// emit coalesced change signals
+	this->emitDeferredWriteSignals();
+}
+
+// bits of m_hashDeferredWriteFlags
+#define QUA_DEFERRED_VALUE           0x01
+#define QUA_DEFERRED_STATUS          0x02
+#define QUA_DEFERRED_SOURCETIMESTAMP 0x04
+#define QUA_DEFERRED_SERVERTIMESTAMP 0x08
+
+void QUaServer::deferWriteSignals(QUaBaseVariable* variable, const UA_DataValue* data)
+{
+	quint8 flags = QUA_DEFERRED_VALUE;
+	flags |= data->hasStatus          ? QUA_DEFERRED_STATUS          : 0;
+	flags |= data->hasSourceTimestamp ? QUA_DEFERRED_SOURCETIMESTAMP : 0;
+	flags |= data->hasServerTimestamp ? QUA_DEFERRED_SERVERTIMESTAMP : 0;
+	auto iter = m_hashDeferredWriteFlags.find(variable);
+	if (iter != m_hashDeferredWriteFlags.end())
+	{
+		iter.value() |= flags;
+		return;
+	}
+	m_hashDeferredWriteFlags.insert(variable, flags);
+	m_deferredWriteVars.append(variable);
+}
+
+void QUaServer::emitDeferredWriteSignals()
+{
+	static const QMetaMethod valueSignal  = QMetaMethod::fromSignal(&QUaBaseVariable::valueChanged);
+	static const QMetaMethod statusSignal = QMetaMethod::fromSignal(&QUaBaseVariable::statusCodeChanged);
+	static const QMetaMethod sourceSignal = QMetaMethod::fromSignal(&QUaBaseVariable::sourceTimestampChanged);
+	static const QMetaMethod serverSignal = QMetaMethod::fromSignal(&QUaBaseVariable::serverTimestampChanged);
+	// swap buffers in case a slot writes values again
+	auto listVars  = m_deferredWriteVars;
+	auto hashFlags = m_hashDeferredWriteFlags;
+	m_deferredWriteVars.clear();
+	m_hashDeferredWriteFlags.clear();
+	for (const auto& var : listVars)
+	{
+		// might have been deleted by a previous slot
+		if (!var)
+		{
+			continue;
+		}
+		quint8 flags = hashFlags.value(var.data());
+		// NOTE : all writes are programmatic, so networkChange is always false
+		if ((flags & QUA_DEFERRED_VALUE) && var->isSignalConnected(valueSignal))
+		{
+			emit var->valueChanged(var->value(), false);
+		}
+		if (var && (flags & QUA_DEFERRED_STATUS) && var->isSignalConnected(statusSignal))
+		{
+			emit var->statusCodeChanged(var->statusCode(), false);
+		}
+		if (var && (flags & QUA_DEFERRED_SOURCETIMESTAMP) && var->isSignalConnected(sourceSignal))
+		{
+			emit var->sourceTimestampChanged(var->sourceTimestamp(), false);
+		}
+		if (var && (flags & QUA_DEFERRED_SERVERTIMESTAMP) && var->isSignalConnected(serverSignal))
+		{
+			emit var->serverTimestampChanged(var->serverTimestamp(), false);
+		}
+	}
+}
+
+bool QUaServer::pushValue(
+	QUaBaseVariable* variable,
+	const QVariant& value,
+	const QUaStatusCode& statusCode,
+	const QDateTime& sourceTimestamp)
+{
+	Q_CHECK_PTR(variable);
+	QUaIngestValue item;
+	item.variable        = variable;
+	item.value           = value;
+	item.statusCode      = statusCode;
+	item.sourceTimestamp = sourceTimestamp;
+	if (!m_ingestQueue->tryPush(std::move(item)))
+	{
+		return false;
+	}
+	this->notifyIngestion();
+	return true;
+}
+
+bool QUaServer::pushValue(
+	const QUaNodeId& nodeId,
+	const QVariant& value,
+	const QUaStatusCode& statusCode,
+	const QDateTime& sourceTimestamp)
+{
+	QUaIngestValue item;
+	item.byNodeId        = true;
+	item.nodeId          = nodeId;
+	item.value           = value;
+	item.statusCode      = statusCode;
+	item.sourceTimestamp = sourceTimestamp;
+	if (!m_ingestQueue->tryPush(std::move(item)))
+	{
+		return false;
+	}
+	this->notifyIngestion();
+	return true;
+}
+
+void QUaServer::notifyIngestion()
+{
+	// only post one event per drain, not one per value
+	if (!m_ingestPending.testAndSetOrdered(0, 1))
+	{
+		return;
+	}
+	QMetaObject::invokeMethod(this, "processIngestionQueue", Qt::QueuedConnection);
+}
+
+void QUaServer::processIngestionQueue()
+{
+	// let producers request a new drain for values pushed from now on
+	m_ingestPending.storeRelease(0);
+	// NOTE : only drain what was queued so far, so producers cannot starve the event loop
+	quint32 maxValues = m_ingestQueue->size();
+	if (maxValues == 0)
+	{
+		return;
+	}
+	QVector<QUaWriteValue> values;
+	values.reserve(static_cast<int>(maxValues));
+	quint64 dropped = 0;
+	QUaIngestValue item;
+	while (static_cast<quint32>(values.size()) + dropped < maxValues && m_ingestQueue->tryPop(item))
+	{
+		QUaBaseVariable* variable = item.byNodeId ?
+			this->nodeById<QUaBaseVariable>(item.nodeId) :
+			item.variable.data();
+		// deleted or does not exist
+		if (!variable)
+		{
+			dropped++;
+			continue;
+		}
+		values.append(QUaWriteValue(
+			variable,
+			item.value,
+			item.statusCode,
+			item.sourceTimestamp
+		));
+	}
+	m_ingestQueue->addDropped(dropped);
+	if (!values.isEmpty())
+	{
+		this->writeValues(values);
+		m_ingestQueue->addProcessed(static_cast<quint64>(values.size()));
+	}
+	// more values were pushed meanwhile
+	if (m_ingestQueue->size() > 0)
+	{
+		this->notifyIngestion();
+	}
+}
+
 QUaNode* QUaServer::nodeById(const QUaNodeId& nodeIdIn)
 {
-	UA_NodeId nodeId = nodeIdIn;
-	QUaNode* node = QUaNode::getNodeContext(nodeId, m_server);
-	UA_NodeId_clear(&nodeId);
-	return node;
+	QUaIterateLocker locker(this);
+	return m_hashNodes.value(nodeIdIn.uaNodeId(), nullptr);
+}
+
+QUaNode* QUaServer::nodeById(const quint16& namespaceIndex, const QByteArray& stringId)
+{
+	QUaIterateLocker locker(this);
+	// NOTE : shallow, string points to caller's buffer
+	UA_NodeId nodeId;
+	nodeId.namespaceIndex = namespaceIndex;
+	nodeId.identifierType = UA_NODEIDTYPE_STRING;
+	nodeId.identifier.string.length = static_cast<size_t>(stringId.size());
+	nodeId.identifier.string.data = (UA_Byte*)stringId.constData();
+	return m_hashNodes.value(nodeId, nullptr);
 }
 
 bool QUaServer::isTypeNameRegistered(const QString& strTypeName) const
@@ -2690,13 +3920,10 @@ QUaNode * QUaServer::browsePath(const QUaBrowsePath& browsePath) const
 		return this->objectsFolder()->browsePath(browsePath.mid(1));
 	}
 	// then check if first is a child of ObjectsFolder
-	const auto listChildren = this->objectsFolder()->browseChildren();
-	for (auto child : listChildren)
+	QUaNode* child = this->objectsFolder()->browseChild(first);
+	if (child)
 	{
-		if (first == child->browseName())
-		{
-			return child->browsePath(browsePath.mid(1));
-		}
+		return child->browsePath(browsePath.mid(1));
 	}
 	// if not, then not supported
 	return nullptr;
@@ -4,6 +4,12 @@
 #include <type_traits>
 
 #include <QTimer>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QPointer>
+#include <QSet>
 #include <QSequentialIterable>
 
 #include <QUaTypesConverter>
@@ -31,11 +37,61 @@ class QUaRefreshRequiredEvent;
 
 typedef std::function<QUaNodeId(const QUaNodeId&, const QUaQualifiedName&)> QUaChildNodeIdCallback;
 
+class QThread;
+class QSocketNotifier;
+class QUaServer;
+class QUaIngestionQueue;
+
+// Scoped lock of the open62541 server instance. Only locks if the server
+// is iterating in a dedicated thread (see QUaServer::setIterateInThread),
+// else it is a no-op. Use it to guard custom code that calls the open62541
+// API directly from the server's thread
+class QUaIterateLocker
+{
+public:
+	explicit QUaIterateLocker(const QUaServer * server);
+	~QUaIterateLocker();
+private:
+	QUaServer * m_server;
+	bool        m_locked;
+	Q_DISABLE_COPY(QUaIterateLocker)
+};
+
+// intrusive list of all instances of exactly one C++ type (see QUaServer::forEachTypeInstance)
+struct QUaTypeInstanceList
+{
+	const QMetaObject * metaObject;
+	QUaNode           * first;
+	QUaNode           * last;
+	int                 count;
+};
+
+// value to be written to a variable by QUaServer::writeValues
+struct QUaWriteValue
+{
+	QUaWriteValue(
+		QUaBaseVariable     *variable        = nullptr,
+		const QVariant      &value           = QVariant(),
+		const QUaStatusCode &statusCode      = QUaStatus::Good,
+		const QDateTime     &sourceTimestamp = QDateTime(),
+		const QDateTime     &serverTimestamp = QDateTime()
+	) : variable(variable), value(value), statusCode(statusCode),
+		sourceTimestamp(sourceTimestamp), serverTimestamp(serverTimestamp)
+	{
+	};
+	QUaBaseVariable * variable;
+	QVariant          value;
+	QUaStatusCode     statusCode;
+	QDateTime         sourceTimestamp;
+	QDateTime         serverTimestamp;
+};
+
 class QUaServer : public QObject
 {
 	friend class QUaNode;
 	friend class QUaBaseVariable;
 	friend class QUaBaseObject;
+	friend class QUaIterateLocker;
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	friend class QUaBaseEvent;
     friend class QUaServer_Anex;
@@ -63,6 +119,7 @@ class QUaServer : public QObject
 	Q_PROPERTY(quint16    maxSecureChannels READ maxSecureChannels WRITE setMaxSecureChannels NOTIFY maxSecureChannelsChanged)
 	Q_PROPERTY(quint16    maxSessions       READ maxSessions       WRITE setMaxSessions       NOTIFY maxSessionsChanged      )
 	Q_PROPERTY(bool       isRunning         READ isRunning         WRITE setIsRunning         NOTIFY isRunningChanged        )
+	Q_PROPERTY(bool       iterateInThread   READ iterateInThread   WRITE setIterateInThread   NOTIFY iterateInThreadChanged  )
 	Q_PROPERTY(QString    applicationName   READ applicationName   WRITE setApplicationName   NOTIFY applicationNameChanged  )
 	Q_PROPERTY(QString    applicationUri    READ applicationUri    WRITE setApplicationUri    NOTIFY applicationUriChanged   )
 	Q_PROPERTY(QString    productName       READ productName       WRITE setProductName       NOTIFY productNameChanged      )
@@ -116,6 +173,58 @@ public:
 	bool isRunning() const;
 	void setIsRunning(const bool &running); // same as start/stop, just to complete Qt property
 
+	// Server Threading API
+
+	// iterate the open62541 server (network I/O, subscriptions, client services) in a
+	// dedicated thread instead of the thread this instance lives in (disabled by default)
+	// NOTE : only updates after server restart, see QUaIterateLocker
+	bool iterateInThread() const;
+	void setIterateInThread(const bool &iterateInThread);
+
+	// Server Statistics API
+
+	// number of open62541 server iterations during the last second
+	int    iterationsPerSecond() const;
+	// percentage of the last second not spent iterating (0.0 to 100.0)
+	double idlePercentage() const;
+	// number of values in the ingestion queue waiting to be written (see pushValue)
+	quint32 ingestionQueueDepth() const;
+	// total number of values dropped because the ingestion queue was full,
+	// or because the target variable did not exist anymore when written
+	quint64 ingestionQueueDropped() const;
+	// total number of values written from the ingestion queue
+	quint64 ingestionQueueProcessed() const;
+	// maximum number of values in the ingestion queue (rounded up to power of 2, default 65536)
+	// NOTE : not thread-safe, set before any thread starts pushing values
+	quint32 ingestionQueueCapacity() const;
+	void    setIngestionQueueCapacity(const quint32 &capacity);
+	// approximate memory used by all variable value caches in bytes (see QUaBaseVariable::setValueCacheEnabled)
+	quint64 valueCacheMemory() const;
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
+	// Model Change Event API
+
+	// milliseconds to buffer node added or removed changes before emitting a GeneralModelChangeEvent
+	// (0 emits on the next event loop iteration, default)
+	int  changeEventWindow() const;
+	void setChangeEventWindow(const int &msecs);
+	// maximum changes per GeneralModelChangeEvent (0 unlimited, default), when reached the buffered
+	// changes are collapsed to one per affected (parent) node with or-ed verbs, and when even that
+	// is full the buffer is emitted as its own event
+	int  changeEventMaxBatch() const;
+	void setChangeEventMaxBatch(const int &maxBatch);
+	// total number of GeneralModelChangeEvents emitted
+	quint64 changeEventsEmitted() const;
+	// total number of changes emitted in all GeneralModelChangeEvents
+	quint64 changesEmitted() const;
+	// average number of changes per GeneralModelChangeEvent
+	double  changesPerEvent() const;
+	// nanoseconds from the first buffered change to the emission, of the last event and the maximum
+	qint64  changeEventLatency() const;
+	qint64  changeEventMaxLatency() const;
+	void    resetChangeEventStats();
+#endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
+
 	// Server Limits API
 
 	quint16 maxSecureChannels() const;
@@ -132,6 +241,13 @@ public:
 	// get all instances of a type
 	template<typename T>
 	QList<T*> typeInstances();
+	// number of instances of a type (and its subtypes), read from the instance registry
+	template<typename T>
+	int typeInstanceCount(const bool &includeSubtypes = true);
+	// call callback(T*) for each instance of a type (and its subtypes) without copying a list
+	// NOTE : callback must not create or delete instances of the type
+	template<typename T, typename M>
+	void forEachTypeInstance(const M &callback, const bool &includeSubtypes = true);
 	// subscribe to instance of a type added
 	template<typename T, typename M>
 	QMetaObject::Connection instanceCreated(const M &callback);
@@ -186,6 +302,16 @@ public:
         QUaNode * parentNode, 
         const QUaQualifiedName &browseName,
         const QUaNodeId &nodeId = ""
+    );
+	// create many instances of a given (variable or object) type under the same parent,
+	// type lookup, type attributes and model change notification are done once for all instances
+	// NOTE : nodeIds is optional, if not empty must be the same size as browseNames
+	// NOTE : result has one entry per browseName, nullptr (and logged) where creation failed
+	template<typename T>
+	QList<T*> createInstances(
+        QUaNode * parentNode, 
+        const QList<QUaQualifiedName> &browseNames,
+        const QList<QUaNodeId> &nodeIds = QList<QUaNodeId>()
     );
 	// get objects folder
 	QUaFolderObject * objectsFolder() const;
@@ -194,6 +320,31 @@ public:
 	T* nodeById(const QUaNodeId &nodeId);
 	// get node reference by node id (nullptr if node id does not exist)
 	QUaNode * nodeById(const QUaNodeId& nodeId);
+	// same but for string node ids (utf-8) without building a QUaNodeId
+	// NOTE : does not allocate, use QByteArray::fromRawData to wrap an existing buffer
+	template<typename T>
+	T* nodeById(const quint16 &namespaceIndex, const QByteArray &stringId);
+	QUaNode * nodeById(const quint16 &namespaceIndex, const QByteArray &stringId);
+	// write many variable values in one pass, the change signals of the variables
+	// (valueChanged, statusCodeChanged, etc.) are emitted once per variable after all
+	// values are written, with the last written value
+	void writeValues(const QVector<QUaWriteValue> &values);
+	// thread-safe (lock-free), queue a variable write from any thread, values are written
+	// in bulk on this instance's thread (see writeValues), returns false if the queue is full
+	// NOTE : variable must not be deleted while pushValue is being called
+	bool pushValue(
+		QUaBaseVariable     *variable,
+		const QVariant      &value,
+		const QUaStatusCode &statusCode      = QUaStatus::Good,
+		const QDateTime     &sourceTimestamp = QDateTime()
+	);
+	// same as above, but variable is resolved by node id when written
+	bool pushValue(
+		const QUaNodeId     &nodeId,
+		const QVariant      &value,
+		const QUaStatusCode &statusCode      = QUaStatus::Good,
+		const QDateTime     &sourceTimestamp = QDateTime()
+	);
 	// check if a type with type name (C++ class name) is registered
 	bool isTypeNameRegistered(const QString &strTypeName) const;
 
@@ -255,6 +406,27 @@ public:
     // Historizing API
     template<typename T>
     void setHistorizer(T& historizer);
+    // commit history data points from a writer thread (disabled by default), so a slow historizer
+    // does not block client requests, points are queued and committed in batches
+    // NOTE : historizer calls are serialized with the writer thread, so a historizer bound to the
+    //        thread that created it must implement writeHistoryDataBatch (e.g. QUaSqliteHistorizer),
+    //        the only method called from the writer thread, and queued points are not read until committed
+    bool historyWriteAsync() const;
+    void setHistoryWriteAsync(const bool& async);
+    // maximum number of queued data points (default 10000)
+    int  historyWriteQueueSize() const;
+    void setHistoryWriteQueueSize(const int& size);
+    // what to do with new data points when the queue is full (default Block)
+    QUaHistoryBackend::WriteBackpressure historyWriteBackpressure() const;
+    void setHistoryWriteBackpressure(const QUaHistoryBackend::WriteBackpressure& policy);
+    // file used by SpillToDisk (default a temporary file)
+    QString historySpillFileName() const;
+    void    setHistorySpillFileName(const QString& fileName);
+    // block until all queued data points are committed
+    void flushHistoryWrites();
+    // queue depth, dropped or spilled points and commit latency
+    QUaHistoryWriteStats historyWriteStats() const;
+    void resetHistoryWriteStats();
 #endif // UA_ENABLE_HISTORIZING
 
     inline static int idQTimeZone()
@@ -264,6 +436,7 @@ public:
 
 signals:
 	void isRunningChanged            (const bool       &running           );
+	void iterateInThreadChanged      (const bool       &iterateInThread   );
 	void portChanged                 (const quint16    &port              );
 	void certificateChanged          (const QByteArray &byteCertificate   );
 #ifdef UA_ENABLE_ENCRYPTION		     									  
@@ -290,6 +463,10 @@ signals:
 public slots:
 	
 
+private slots:
+	// write all values pushed so far (see pushValue)
+	void processIngestionQueue();
+
 private:
 	UA_Server             * m_server;
 	quint16                 m_port;
@@ -297,12 +474,43 @@ private:
 	quint16                 m_maxSessions;
 	UA_Boolean              m_running;
 	QTimer                  m_iterWaitTimer;
+	bool                    m_iterateInThread;
+	// NOTE : atomic, written by start/stop and read by every QUaIterateLocker
+	QAtomicPointer<QThread> m_iterThread;
+#if (QT_VERSION < QT_VERSION_CHECK(5,14,0))
+	mutable QMutex          m_iterMutex;
+#else
+	mutable QRecursiveMutex m_iterMutex;
+#endif
+	int                     m_iterLockDepth; // guarded by m_iterMutex
+	QHash<qintptr, QSocketNotifier*> m_hashSocketNotifiers;
+	QElapsedTimer           m_iterStatsTimer;
+	qint64                  m_iterStatsBusyNs;
+	int                     m_iterStatsCount;
+	QAtomicInt              m_iterPerSecond;
+	QAtomicInt              m_iterIdlePermille;
+	// batched writes (see writeValues)
+	bool                                m_deferWriteSignals;
+	QVector<QPointer<QUaBaseVariable>>  m_deferredWriteVars;
+	QHash<QUaBaseVariable*, quint8>     m_hashDeferredWriteFlags;
+	void deferWriteSignals(QUaBaseVariable * variable, const UA_DataValue * data);
+	void emitDeferredWriteSignals();
+	// values pushed from other threads (see pushValue)
+	QUaIngestionQueue                 * m_ingestQueue;
+	QAtomicInt                          m_ingestPending;
+	void notifyIngestion();
+	// sum of QUaBaseVariable::valueCacheMemory
+	quint64                             m_valueCacheMemory;
 	QByteArray              m_byteCertificate;
 	QByteArray              m_byteCertificateInternal; // NOTE : needs to exists as long as server instance
 	bool                    m_anonymousLoginAllowed;
 	QUaFolderObject       * m_pobjectsFolder;
 	char                    m_logBuffer[QUA_MAX_LOG_MESSAGE_SIZE];
     bool                    m_beingDestroyed;
+	// root of the subtree being deleted by QUaNode::deleteSubtree (nullptr otherwise),
+	// nodes inside it skip per node cleanup and collect their node ids
+	QUaNode               * m_deletingSubtree;
+	QList<UA_NodeId>        m_listSubtreeNodeIds;
 
 #ifdef UA_ENABLE_ENCRYPTION
 	QByteArray m_bytePrivateKey;
@@ -329,8 +537,14 @@ private:
 	QHash<QUaReferenceType, UA_NodeId    > m_hashRefTypes;
 	QHash<QUaReferenceType, UA_NodeId    > m_hashHierRefTypes;
 	QHash<UA_NodeId       , QUaSignaler* > m_hashSignalers;
+	// bound c++ instances by node id (keys are deep copies), see bindCppInstanceWithUaNode
+	QHash<UA_NodeId       , QUaNode*     > m_hashNodes;
     // mandatory children browsenames for type definition
     QHash<QUaNodeId, QSet<QUaQualifiedName>> m_hashMandatoryChildren;
+    // browsenames of the children bound on construction, by class name (see typeInstanceKey)
+    QHash<QByteArray, QList<QUaQualifiedName>> m_hashTypeChildren;
+    // meta props plus mandatory children of a type, resolved once from its first instance
+    QList<QUaQualifiedName> typeChildrenTemplate(const QMetaObject &metaObject, QUaNode * instance);
 
 	QUaValidationCallback m_validationCallback;
 
@@ -347,7 +561,24 @@ private:
     QUaSignaler m_changeEventSignaler;
 	QUaGeneralModelChangeEvent * m_changeEvent;
 	QUaChangesList m_listChanges; // buffer
+	QSet<QUaChangeStructureDataType> m_setChanges; // buffered changes, for O(1) dedup
+	QHash<QUaNodeId, int> m_hashChangesCollapsed;  // affected node to buffer index, once collapsed
+	bool   m_changesCollapsed;
+	bool   m_changesScheduled;
+	qint64 m_changesStartNs; // m_changesClock time of first buffered change
+	QList<QPair<QUaChangesList, qint64>> m_listChangesFull; // full buffers waiting to be emitted
+	QTimer        m_changesTimer; // coalescing window
+	QElapsedTimer m_changesClock;
+	int     m_changeEventWindow;
+	int     m_changeEventMaxBatch;
+	quint64 m_changeEventsCount;
+	quint64 m_changesCount;
+	qint64  m_changeEventLatencyNs;
+	qint64  m_changeEventMaxLatencyNs;
 	void addChange(const QUaChangeStructureDataType& change);
+	void collapseChanges();
+	void flushChanges();
+	void triggerChanges();
     // mandatory and optional variable children browsenames for event type definition
     // need this to store historic events in a consistent way, ignoring manually added children
     QHash<QUaNodeId, QUaNode::QUaEventFieldMetaData> m_hashTypeVars;
@@ -373,6 +604,13 @@ private:
 
 	// reset open62541 config
 	void resetConfig();
+	// iterate once without waiting, returns ms until next open62541 timer deadline
+	UA_UInt16 runIterate();
+	// sockets open62541 is listening to (server and client connections)
+	QSet<qintptr> networkSockets() const;
+	// sync socket notifiers with open62541 sockets, to wake up when there is network activity
+	void updateSocketNotifiers();
+	void clearSocketNotifiers();
 
 	// parse and validate certificate
 	static UA_ByteString * parseCertificate(const QByteArray &inByteCert, 
@@ -385,6 +623,17 @@ private:
     void registerSpecificationType(const UA_NodeId& typeNodeId, const bool abstract = false);
 	void registerTypeInternal(const QMetaObject &metaObject, const QUaNodeId &nodeId = QUaNodeId());
 	QList<QUaNode*> typeInstances(const QMetaObject &metaObject);
+	int typeInstanceCount(const QMetaObject &metaObject, const bool &includeSubtypes);
+	// per-type instance registry, kept up to date by uaConstructor and ~QUaNode
+	QHash<QByteArray, QUaTypeInstanceList*> m_hashTypeInstances;
+	// lists of a type and all its subtypes, invalidated when a new type gets its first instance
+	QHash<QByteArray, QVector<QUaTypeInstanceList*>> m_hashTypeInstancesSubtypes;
+	void registerTypeInstance(QUaNode * node);
+	void unregisterTypeInstance(QUaNode * node);
+	QVector<QUaTypeInstanceList*> typeInstanceSubtypeLists(const QMetaObject &metaObject);
+	template<typename T, typename M>
+	static void forEachInstanceInList(const QUaTypeInstanceList * list, const M &callback);
+	static QByteArray typeInstanceKey(const QMetaObject &metaObject);
 	template<typename T, typename M>
 	QMetaObject::Connection instanceCreated(
 		const QMetaObject &metaObject,
@@ -417,6 +666,34 @@ private:
         const QUaQualifiedName &browseName,
         const QUaNodeId &nodeId
     );
+	QList<QUaNode*> createInstancesInternal(
+        const QMetaObject &metaObject, 
+        QUaNode * parentNode, 
+        const QList<QUaQualifiedName> &browseNames,
+        const QList<QUaNodeId> &nodeIds
+    );
+	// type information shared by all instances of the same type under the same parent
+	struct QUaInstanceContext
+	{
+		UA_NodeId             typeNodeId; // NOTE : owned by m_mapTypes, do not clear
+		UA_NodeId             referenceTypeId;
+		bool                  isVariable;
+		UA_VariableAttributes vAttr;
+		UA_Variant            arrayDimensions;
+	};
+	bool initInstanceContext(
+        const QMetaObject &metaObject, 
+        QUaNode * parentNode,
+        QUaInstanceContext &context
+    );
+	void clearInstanceContext(QUaInstanceContext &context);
+	UA_NodeId addInstanceNode(
+        const QUaInstanceContext &context,
+        const QMetaObject &metaObject, 
+        QUaNode * parentNode, 
+        const QUaQualifiedName &browseName,
+        const QUaNodeId &nodeId
+    );
 
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 	// create instance of a given event type
@@ -425,7 +702,9 @@ private:
     );
 #endif // UA_ENABLE_SUBSCRIPTIONS_EVENTS
 
-	void bindCppInstanceWithUaNode(QUaNode * nodeInstance, UA_NodeId &nodeId);
+	// NOTE : node context must be set by caller, because the UA constructor overwrites it
+	void bindCppInstanceWithUaNode(QUaNode * nodeInstance, const UA_NodeId &nodeId);
+	void unbindCppInstance(QUaNode * nodeInstance);
 
 	bool isMetaObjectRegistered(const QString& strClassName) const;
 	QMetaObject getRegisteredMetaObject(const QString& strClassName) const;
@@ -592,6 +871,28 @@ private:
 		                                        const UA_NodeId  *objectId, 
 		                                        void             *objectContext);
 
+	// used to materialize virtual folders when browsed (see QUaVirtualFolder)
+	// NOTE : open62541 < v1.3 has no browse hook, client browses do not materialize anything
+#if UA_OPEN62541_VER_MAJOR > 1 || (UA_OPEN62541_VER_MAJOR == 1 && UA_OPEN62541_VER_MINOR >= 3)
+	static UA_Boolean allowBrowseNode(UA_Server        *server, 
+		                              UA_AccessControl *ac,
+		                              const UA_NodeId  *sessionId, 
+		                              void             *sessionContext,
+		                              const UA_NodeId  *nodeId, 
+		                              void             *nodeContext);
+#endif
+
+#ifdef UA_ENABLE_SUBSCRIPTIONS
+	// used to keep virtual folders with monitored items from being evicted (see QUaVirtualFolder)
+	static void monitoredItemRegister(UA_Server       *server,
+		                              const UA_NodeId *sessionId, 
+		                              void            *sessionContext,
+		                              const UA_NodeId *nodeId, 
+		                              void            *nodeContext,
+		                              UA_UInt32        attibuteId, 
+		                              UA_Boolean       removed);
+#endif // UA_ENABLE_SUBSCRIPTIONS
+
 	// NOTE : temporary values needed to instantiate node, used to simplify user API
 	//        passed-in in QUaServer::uaConstructor and used in QUaNode::QUaNode
 	const UA_NodeId   * m_newNodeNodeId;
@@ -619,6 +920,44 @@ inline QList<T*> QUaServer::typeInstances()
 	return retList;
 }
 
+template<typename T>
+inline int QUaServer::typeInstanceCount(const bool &includeSubtypes/* = true*/)
+{
+	return this->typeInstanceCount(T::staticMetaObject, includeSubtypes);
+}
+
+template<typename T, typename M>
+inline void QUaServer::forEachTypeInstance(const M &callback, const bool &includeSubtypes/* = true*/)
+{
+	QUaIterateLocker locker(this);
+	if (!includeSubtypes)
+	{
+		QUaServer::forEachInstanceInList<T>(
+			m_hashTypeInstances.value(QUaServer::typeInstanceKey(T::staticMetaObject), nullptr),
+			callback
+		);
+		return;
+	}
+	// NOTE : vector is implicitly shared with the cache, no allocation
+	const auto lists = this->typeInstanceSubtypeLists(T::staticMetaObject);
+	for (auto list : lists)
+	{
+		QUaServer::forEachInstanceInList<T>(list, callback);
+	}
+}
+
+template<typename T, typename M>
+inline void QUaServer::forEachInstanceInList(const QUaTypeInstanceList * list, const M &callback)
+{
+	QUaNode * node = list ? list->first : nullptr;
+	while (node)
+	{
+		Q_ASSERT(qobject_cast<T*>(node));
+		callback(static_cast<T*>(node));
+		node = node->m_typeNext;
+	}
+}
+
 template<typename T, typename M>
 inline QMetaObject::Connection QUaServer::instanceCreated(const M & callback)
 {
@@ -664,7 +1003,7 @@ inline void QUaServer::registerSpecificationType(const UA_NodeId& typeNodeId, co
     if (metaObject.inherits(&QUaBaseEvent::staticMetaObject))
     {
         Q_ASSERT(!m_hashTypeVars.contains(typeNodeId));
-        m_hashTypeVars[typeNodeId] =
+        m_hashTypeVars[QUaNodeId(typeNodeId).interned()] =
             QUaNode::getTypeVars(
                 typeNodeId,
                 this->m_server
@@ -759,6 +1098,30 @@ inline T * QUaServer::createInstance(
 	return newInstance;
 }
 
+template<typename T>
+inline QList<T*> QUaServer::createInstances(
+    QUaNode * parentNode, 
+    const QList<QUaQualifiedName> &browseNames,
+    const QList<QUaNodeId> &nodeIds/* = QList<QUaNodeId>()*/
+)
+{
+	auto nodes = this->createInstancesInternal(
+        T::staticMetaObject, 
+        parentNode, 
+        browseNames,
+        nodeIds
+    );
+	QList<T*> newInstances;
+	newInstances.reserve(nodes.count());
+	for (auto node : nodes)
+	{
+		T * newInstance = qobject_cast<T*>(node);
+		Q_ASSERT(!node || newInstance);
+		newInstances.append(newInstance);
+	}
+	return newInstances;
+}
+
 #ifdef UA_ENABLE_SUBSCRIPTIONS_EVENTS
 template<typename T>
 inline T * QUaServer::createEvent()
@@ -796,6 +1159,12 @@ inline T * QUaServer::nodeById(const QUaNodeId &nodeId)
 	return qobject_cast<T*>(this->nodeById(nodeId));
 }
 
+template<typename T>
+inline T * QUaServer::nodeById(const quint16 &namespaceIndex, const QByteArray &stringId)
+{
+	return qobject_cast<T*>(this->nodeById(namespaceIndex, stringId));
+}
+
 template<typename T>
 inline T * QUaServer::browsePath(const QUaBrowsePath& browsePath) const
 {
@@ -23,6 +23,7 @@ SOURCES += \
     $$PWD/quabasedatavariable.cpp \
     $$PWD/quabaseobject.cpp \
     $$PWD/quafolderobject.cpp \
+    $$PWD/quavirtualfolder.cpp \
     $$PWD/quacustomdatatypes.cpp \
     $$PWD/quaenum.cpp
 
@@ -84,6 +85,7 @@ HEADERS += \
     $$PWD/quabasedatavariable.h \
     $$PWD/quabaseobject.h \
     $$PWD/quafolderobject.h \
+    $$PWD/quavirtualfolder.h \
     $$PWD/quacustomdatatypes.h \
     $$PWD/quaenum.h
 
@@ -144,6 +146,7 @@ DISTFILES += \
     $$PWD/QUaBaseDataVariable \
     $$PWD/QUaBaseObject \
     $$PWD/QUaFolderObject \
+    $$PWD/QUaVirtualFolder \
     $$PWD/QUaCustomDataTypes
 
 ua_events || ua_alarms_conditions {
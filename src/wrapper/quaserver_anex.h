@@ -481,6 +481,38 @@ UA_Timer_process(UA_Timer * t, UA_DateTime nowMonotonic,
 /*********************************************************************************************
 Copied from open62541, to be able to implement:
 
+QUaServer::networkSockets
+
+NOTE : private layout of arch/network_tcp.c, only known to match open62541 v1.0 to v1.3,
+       other versions list no sockets (see QUaServer::networkSockets)
+*/
+
+#if UA_OPEN62541_VER_MAJOR == 1 && UA_OPEN62541_VER_MINOR <= 3
+#define QUA_SERVER_NETWORK_LAYER_TCP
+
+static_assert(std::is_same<decltype(UA_Connection::sockfd), UA_SOCKET>::value,
+    "ServerNetworkLayerTCP copy does not match open62541 UA_Connection.");
+
+typedef struct ConnectionEntry {
+    UA_Connection connection;
+    LIST_ENTRY(ConnectionEntry) pointers;
+} ConnectionEntry;
+
+typedef struct {
+    const UA_Logger* logger;
+    UA_UInt16 port;
+    UA_UInt16 maxConnections;
+    UA_SOCKET serverSockets[FD_SETSIZE];
+    UA_UInt16 serverSocketsSize;
+    LIST_HEAD(, ConnectionEntry) connections;
+    UA_UInt16 connectionsSize;
+} ServerNetworkLayerTCP;
+
+#endif // QUA_SERVER_NETWORK_LAYER_TCP
+
+/*********************************************************************************************
+Copied from open62541, to be able to implement:
+
 QUaServer::anonymousLoginAllowed
 QUaServer::setAnonymousLoginAllowed
 set AccessControlContext::allowAnonymous
@@ -0,0 +1,359 @@
+#include "quavirtualfolder.h"
+
+#include <QDateTime>
+#include <QSet>
+#include <QTimerEvent>
+#include <QUaServer>
+#include <QUaBaseDataVariable>
+
+QUaVirtualFolder::QUaVirtualFolder(QUaServer *server)
+	: QUaFolderObject(server),
+	m_root(this),
+	m_materialized(false),
+	m_lastAccess(QDateTime::currentMSecsSinceEpoch()),
+	m_monitoredCount(0),
+	m_idleTimeout(0),
+	m_timerId(0),
+	m_browsePending(false)
+{
+
+}
+
+bool QUaVirtualFolder::hasProvider() const
+{
+	return static_cast<bool>(m_root->m_providerChildren);
+}
+
+QUaVirtualFolder * QUaVirtualFolder::virtualRoot() const
+{
+	return m_root;
+}
+
+QUaBrowsePath QUaVirtualFolder::virtualPath() const
+{
+	return m_path;
+}
+
+void QUaVirtualFolder::materialize()
+{
+	this->touch();
+	if (m_materialized || !this->hasProvider())
+	{
+		return;
+	}
+	QUaIterateLocker locker(m_qUaServer);
+	// split by node class so each group is created in a single batch
+	QList<QUaQualifiedName> folderNames, variableNames;
+	QList<QUaNodeId>        folderIds  , variableIds;
+	QList<QUaBrowsePath>    folderPaths, variablePaths;
+	const auto browseNames = m_root->m_providerChildren(m_path);
+	for (const auto& browseName : browseNames)
+	{
+		// skip children already materialized by browseChild or browseVirtualPath
+		if (this->hasChild(browseName))
+		{
+			continue;
+		}
+		QUaBrowsePath childPath = m_path;
+		childPath << browseName;
+		if (m_root->m_providerIsFolder(childPath))
+		{
+			folderNames << browseName;
+			folderIds   << this->childNodeId(childPath);
+			folderPaths << childPath;
+		}
+		else
+		{
+			variableNames << browseName;
+			variableIds   << this->childNodeId(childPath);
+			variablePaths << childPath;
+		}
+	}
+	if (!folderNames.isEmpty())
+	{
+		auto folders = m_qUaServer->createInstances<QUaVirtualFolder>(this, folderNames, folderIds);
+		Q_ASSERT(folders.count() == folderPaths.count());
+		for (int i = 0; i < folders.count(); i++)
+		{
+			// failed instances are logged by createInstances
+			if (!folders.at(i))
+			{
+				continue;
+			}
+			this->setupFolder(folders.at(i), folderPaths.at(i));
+		}
+	}
+	if (!variableNames.isEmpty())
+	{
+		auto variables = m_qUaServer->createInstances<QUaBaseDataVariable>(this, variableNames, variableIds);
+		Q_ASSERT(variables.count() == variablePaths.count());
+		for (int i = 0; i < variables.count(); i++)
+		{
+			if (!variables.at(i))
+			{
+				continue;
+			}
+			this->setupVariable(variables.at(i), variablePaths.at(i));
+		}
+	}
+	m_materialized = true;
+}
+
+bool QUaVirtualFolder::isMaterialized() const
+{
+	return m_materialized;
+}
+
+void QUaVirtualFolder::dematerialize()
+{
+	QUaIterateLocker locker(m_qUaServer);
+	const auto children = this->browseChildren();
+	for (auto child : children)
+	{
+		delete child;
+	}
+	m_materialized = false;
+}
+
+QUaNode * QUaVirtualFolder::browseVirtualPath(const QUaBrowsePath& path)
+{
+	QUaIterateLocker locker(m_qUaServer);
+	QUaNode * currNode = this;
+	for (const auto& browseName : path)
+	{
+		QUaNode * child = currNode->browseChild(browseName);
+		QUaVirtualFolder * folder = qobject_cast<QUaVirtualFolder*>(currNode);
+		if (!child && folder)
+		{
+			child = folder->materializeChild(browseName);
+		}
+		if (!child)
+		{
+			return nullptr;
+		}
+		currNode = child;
+	}
+	return currNode;
+}
+
+int QUaVirtualFolder::idleTimeout() const
+{
+	return m_idleTimeout;
+}
+
+void QUaVirtualFolder::setIdleTimeout(const int& msecs)
+{
+	Q_ASSERT_X(m_root == this, "QUaVirtualFolder::setIdleTimeout", "Idle timeout can only be set on root virtual folder.");
+	if (m_timerId != 0)
+	{
+		this->killTimer(m_timerId);
+		m_timerId = 0;
+	}
+	m_idleTimeout = qMax(0, msecs);
+	if (m_idleTimeout == 0)
+	{
+		return;
+	}
+	// check twice per timeout, so a level lives at most 1.5 timeouts after last access
+	m_timerId = this->startTimer(qMax(1, m_idleTimeout / 2));
+}
+
+QUaNode * QUaVirtualFolder::instantiateOptionalChild(const QUaQualifiedName& browseName)
+{
+	if (!this->hasProvider())
+	{
+		return QUaFolderObject::instantiateOptionalChild(browseName);
+	}
+	return this->materializeChild(browseName);
+}
+
+void QUaVirtualFolder::timerEvent(QTimerEvent *event)
+{
+	if (event->timerId() != m_timerId)
+	{
+		QUaFolderObject::timerEvent(event);
+		return;
+	}
+	QUaIterateLocker locker(m_qUaServer);
+	this->evictIdle(QDateTime::currentMSecsSinceEpoch());
+}
+
+void QUaVirtualFolder::processBrowseRequests()
+{
+	QUaIterateLocker locker(m_qUaServer);
+	m_browsePending = false;
+	QSet<QUaVirtualFolder*> browsed;
+	for (const auto& folder : m_browseRequests)
+	{
+		if (folder)
+		{
+			browsed << folder.data();
+		}
+	}
+	m_browseRequests.clear();
+	for (auto folder : browsed)
+	{
+		// a browse response also reports its targets, only materialize the browsed folder
+		// and not the subfolders listed in the response, else the whole tree would cascade
+		if (browsed.contains(qobject_cast<QUaVirtualFolder*>(folder->parent())))
+		{
+			continue;
+		}
+		folder->materialize();
+	}
+}
+
+void QUaVirtualFolder::touch()
+{
+	m_lastAccess.store(QDateTime::currentMSecsSinceEpoch());
+}
+
+QUaNode * QUaVirtualFolder::materializeChild(const QUaQualifiedName& browseName)
+{
+	if (!this->hasProvider())
+	{
+		return nullptr;
+	}
+	QUaBrowsePath childPath = m_path;
+	childPath << browseName;
+	if (!this->hasVirtualChild(childPath))
+	{
+		return nullptr;
+	}
+	QUaIterateLocker locker(m_qUaServer);
+	this->touch();
+	if (m_root->m_providerIsFolder(childPath))
+	{
+		auto folder = m_qUaServer->createInstance<QUaVirtualFolder>(
+			this, browseName, this->childNodeId(childPath)
+		);
+		this->setupFolder(folder, childPath);
+		return folder;
+	}
+	auto variable = m_qUaServer->createInstance<QUaBaseDataVariable>(
+		this, browseName, this->childNodeId(childPath)
+	);
+	this->setupVariable(variable, childPath);
+	return variable;
+}
+
+bool QUaVirtualFolder::hasVirtualChild(const QUaBrowsePath& childPath) const
+{
+	if (m_root->m_providerHasChild)
+	{
+		return m_root->m_providerHasChild(childPath);
+	}
+	// lists the whole level, once per path segment in browseVirtualPath
+	return m_root->m_providerChildren(m_path).contains(childPath.last());
+}
+
+QUaNodeId QUaVirtualFolder::childNodeId(const QUaBrowsePath& childPath) const
+{
+	if (m_root->m_providerNodeId)
+	{
+		return m_root->m_providerNodeId(childPath);
+	}
+	// derive a stable string id from the root's string id so it survives eviction,
+	// else let the server assign a numeric id
+	QUaNodeId rootNodeId = m_root->nodeId();
+	if (rootNodeId.type() != QUaNodeIdType::String)
+	{
+		return QUaNodeId();
+	}
+	QString strId = rootNodeId.stringId();
+	for (const auto& browseName : childPath)
+	{
+		strId += QLatin1Char('.') + browseName.name();
+	}
+	return QUaNodeId(rootNodeId.namespaceIndex(), strId);
+}
+
+void QUaVirtualFolder::setupFolder(QUaVirtualFolder * folder, const QUaBrowsePath& childPath)
+{
+	Q_CHECK_PTR(folder);
+	folder->m_root = m_root;
+	folder->m_path = childPath;
+}
+
+void QUaVirtualFolder::setupVariable(QUaBaseDataVariable * variable, const QUaBrowsePath& childPath)
+{
+	Q_CHECK_PTR(variable);
+	// NOTE : variable is a child of this folder and this folder a descendant of root,
+	//        so both outlive the callback
+	QUaVirtualFolder * root   = m_root;
+	QUaVirtualFolder * folder = this;
+	variable->setReadCallback([root, folder, childPath]() -> QVariant {
+		folder->touch();
+		return root->m_providerValue(childPath);
+	});
+}
+
+bool QUaVirtualFolder::evictIdle(const qint64& now)
+{
+	bool keep = m_monitoredCount.load() > 0;
+	// bottom-up, so a busy descendant keeps all its ancestors
+	const auto folders = this->browseChildren<QUaVirtualFolder>();
+	for (auto folder : folders)
+	{
+		keep = folder->evictIdle(now) || keep;
+	}
+	if (keep || now - m_lastAccess.load() < m_root->m_idleTimeout)
+	{
+		return true;
+	}
+	this->dematerialize();
+	return false;
+}
+
+QUaVirtualFolder * QUaVirtualFolder::nearestVirtualFolder(QUaNode * node)
+{
+	QObject * obj = node;
+	while (obj)
+	{
+		QUaVirtualFolder * folder = qobject_cast<QUaVirtualFolder*>(obj);
+		if (folder)
+		{
+			return folder;
+		}
+		obj = obj->parent();
+	}
+	return nullptr;
+}
+
+void QUaVirtualFolder::browseRequested(QUaNode * node)
+{
+	// only folders are materialized on browse
+	QUaVirtualFolder * folder = qobject_cast<QUaVirtualFolder*>(node);
+	if (!folder || !folder->hasProvider())
+	{
+		return;
+	}
+	folder->touch();
+	// NOTE : materialized folders are also queued, so their listed subfolders can be told apart
+	// NOTE : called while the server is processing the browse service, so nodes cannot be
+	//        added yet, the ReferenceAdded model change event tells the client to browse again
+	QUaVirtualFolder * root = folder->m_root;
+	root->m_browseRequests << folder;
+	if (root->m_browsePending)
+	{
+		return;
+	}
+	root->m_browsePending = true;
+	QMetaObject::invokeMethod(root, "processBrowseRequests", Qt::QueuedConnection);
+}
+
+void QUaVirtualFolder::monitoredItemChanged(QUaNode * node, const bool& removed)
+{
+	QUaVirtualFolder * folder = QUaVirtualFolder::nearestVirtualFolder(node);
+	if (!folder)
+	{
+		return;
+	}
+	folder->touch();
+	if (removed)
+	{
+		folder->m_monitoredCount--;
+		return;
+	}
+	folder->m_monitoredCount++;
+}
@@ -0,0 +1,195 @@
+#ifndef QUAVIRTUALFOLDER_H
+#define QUAVIRTUALFOLDER_H
+
+#include <atomic>
+
+#include <QPointer>
+#include <QUaFolderObject>
+
+// trait used to check if provider has QUaNodeId T::nodeId(const QUaBrowsePath&)
+template <typename T, typename = void>
+struct QUaHasMethodNodeId
+	: std::false_type
+{};
+
+template <typename T>
+struct QUaHasMethodNodeId<T,
+	typename std::enable_if<std::is_same<decltype(&T::nodeId), QUaNodeId(T::*)(const QUaBrowsePath&)>::value>::type>
+	: std::true_type
+{};
+
+// trait used to check if provider has bool T::hasChild(const QUaBrowsePath&)
+template <typename T, typename = void>
+struct QUaHasMethodHasChild
+	: std::false_type
+{};
+
+template <typename T>
+struct QUaHasMethodHasChild<T,
+	typename std::enable_if<std::is_same<decltype(&T::hasChild), bool(T::*)(const QUaBrowsePath&)>::value>::type>
+	: std::true_type
+{};
+
+// folder whose subtree is provided on demand by a user provider instead of being created upfront,
+// children are created (materialized) one level at a time when browsed, and deleted again when idle
+// NOTE : client browses only materialize levels with open62541 v1.3 or newer (accessControl.allowBrowseNode),
+//        older versions (e.g. the one in ./depends/open62541.git) have no browse hook, so clients only see
+//        the levels materialized from C++ (materialize, browseVirtualPath, browseChild(name, true)) and
+//        an idle timeout must not be set unless those levels are materialized again from C++
+class QUaVirtualFolder : public QUaFolderObject
+{
+    Q_OBJECT
+
+friend class QUaServer;
+
+public:
+	Q_INVOKABLE explicit QUaVirtualFolder(QUaServer *server);
+
+	// set the provider of the subtree, T must implement :
+	//   QList<QUaQualifiedName> children(const QUaBrowsePath& path); // child browse names of a folder path
+	//   bool                    isFolder(const QUaBrowsePath& path); // folder or variable
+	//   QVariant                value   (const QUaBrowsePath& path); // current value of a variable path
+	// and optionally :
+	//   QUaNodeId               nodeId  (const QUaBrowsePath& path); // node id of a path
+	//   bool                    hasChild(const QUaBrowsePath& path); // path exists
+	// paths are relative to this folder (an empty path is this folder)
+	// without hasChild, materializing a single child lists all the children of its folder
+	// NOTE : provider must outlive this folder, only valid for the root virtual folder
+	// NOTE : value is called from the read callbacks, so in the iterate thread if
+	//        QUaServer::setIterateInThread(true) is set, the other methods are called
+	//        with the iterate lock held from the thread browsing or materializing
+	template<typename T>
+	void setProvider(T& provider);
+	bool hasProvider() const;
+
+	// root virtual folder holding the provider
+	QUaVirtualFolder * virtualRoot() const;
+	// path of this folder relative to the root virtual folder
+	QUaBrowsePath virtualPath() const;
+
+	// create all missing children of this folder (not recursive)
+	// NOTE : folders are created before variables, not in provider order
+	void materialize();
+	bool isMaterialized() const;
+	// delete all children of this folder, they are created again on next browse
+	void dematerialize();
+	// browse a path relative to this folder, materializing the nodes along the path if needed
+	QUaNode * browseVirtualPath(const QUaBrowsePath& path);
+
+	// milliseconds without browse, read or monitored items after which a materialized
+	// level is deleted (0 disables eviction, default), only valid for the root virtual folder
+	int  idleTimeout() const;
+	void setIdleTimeout(const int& msecs);
+
+protected:
+	// materializes a single child, used by browseChild(browseName, true)
+	QUaNode * instantiateOptionalChild(const QUaQualifiedName& browseName) override;
+
+	void timerEvent(QTimerEvent *event) override;
+
+private slots:
+	void processBrowseRequests();
+
+private:
+	QUaVirtualFolder * m_root;
+	QUaBrowsePath      m_path;
+	bool               m_materialized;
+	// updated from the iterate thread (reads, monitored items)
+	std::atomic<qint64> m_lastAccess;
+	std::atomic<int>    m_monitoredCount;
+	// root only
+	int  m_idleTimeout;
+	int  m_timerId;
+	bool m_browsePending;
+	QList<QPointer<QUaVirtualFolder>> m_browseRequests;
+	std::function<QList<QUaQualifiedName>(const QUaBrowsePath&)> m_providerChildren;
+	std::function<bool(const QUaBrowsePath&)>                    m_providerIsFolder;
+	std::function<QVariant(const QUaBrowsePath&)>                m_providerValue;
+	std::function<QUaNodeId(const QUaBrowsePath&)>               m_providerNodeId;
+	std::function<bool(const QUaBrowsePath&)>                    m_providerHasChild;
+
+	void touch();
+	QUaNode * materializeChild(const QUaQualifiedName& browseName);
+	bool hasVirtualChild(const QUaBrowsePath& childPath) const;
+	QUaNodeId childNodeId(const QUaBrowsePath& childPath) const;
+	void setupFolder(QUaVirtualFolder * folder, const QUaBrowsePath& childPath);
+	void setupVariable(QUaBaseDataVariable * variable, const QUaBrowsePath& childPath);
+	// evicts idle levels bottom-up, returns true if this folder must be kept
+	bool evictIdle(const qint64& now);
+
+	// called by QUaServer from the server callbacks
+	static QUaVirtualFolder * nearestVirtualFolder(QUaNode * node);
+	static void browseRequested(QUaNode * node);
+	static void monitoredItemChanged(QUaNode * node, const bool& removed);
+
+	template<typename T>
+	static typename std::enable_if<QUaHasMethodNodeId<T>::value, std::function<QUaNodeId(const QUaBrowsePath&)>>::type
+	providerNodeId(T& provider);
+
+	template<typename T>
+	static typename std::enable_if<!QUaHasMethodNodeId<T>::value, std::function<QUaNodeId(const QUaBrowsePath&)>>::type
+	providerNodeId(T& provider);
+
+	template<typename T>
+	static typename std::enable_if<QUaHasMethodHasChild<T>::value, std::function<bool(const QUaBrowsePath&)>>::type
+	providerHasChild(T& provider);
+
+	template<typename T>
+	static typename std::enable_if<!QUaHasMethodHasChild<T>::value, std::function<bool(const QUaBrowsePath&)>>::type
+	providerHasChild(T& provider);
+};
+
+template<typename T>
+inline void QUaVirtualFolder::setProvider(T& provider)
+{
+	Q_ASSERT_X(m_root == this, "QUaVirtualFolder::setProvider", "Provider can only be set on root virtual folder.");
+	// discard children of a previous provider
+	this->dematerialize();
+	m_providerChildren = [&provider](const QUaBrowsePath& path) -> QList<QUaQualifiedName> {
+		return provider.children(path);
+	};
+	m_providerIsFolder = [&provider](const QUaBrowsePath& path) -> bool {
+		return provider.isFolder(path);
+	};
+	m_providerValue = [&provider](const QUaBrowsePath& path) -> QVariant {
+		return provider.value(path);
+	};
+	m_providerNodeId   = QUaVirtualFolder::providerNodeId<T>(provider);
+	m_providerHasChild = QUaVirtualFolder::providerHasChild<T>(provider);
+}
+
+template<typename T>
+inline typename std::enable_if<QUaHasMethodNodeId<T>::value, std::function<QUaNodeId(const QUaBrowsePath&)>>::type
+QUaVirtualFolder::providerNodeId(T& provider)
+{
+	return [&provider](const QUaBrowsePath& path) -> QUaNodeId {
+		return provider.nodeId(path);
+	};
+}
+
+template<typename T>
+inline typename std::enable_if<!QUaHasMethodNodeId<T>::value, std::function<QUaNodeId(const QUaBrowsePath&)>>::type
+QUaVirtualFolder::providerNodeId(T& provider)
+{
+	Q_UNUSED(provider);
+	return std::function<QUaNodeId(const QUaBrowsePath&)>();
+}
+
+template<typename T>
+inline typename std::enable_if<QUaHasMethodHasChild<T>::value, std::function<bool(const QUaBrowsePath&)>>::type
+QUaVirtualFolder::providerHasChild(T& provider)
+{
+	return [&provider](const QUaBrowsePath& path) -> bool {
+		return provider.hasChild(path);
+	};
+}
+
+template<typename T>
+inline typename std::enable_if<!QUaHasMethodHasChild<T>::value, std::function<bool(const QUaBrowsePath&)>>::type
+QUaVirtualFolder::providerHasChild(T& provider)
+{
+	Q_UNUSED(provider);
+	return std::function<bool(const QUaBrowsePath&)>();
+}
+
+#endif // QUAVIRTUALFOLDER_H